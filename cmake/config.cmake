@@ -37,5 +37,8 @@ set(USE_CUDA OFF)
 # Whether to build cpp unittest executables
 set(BUILD_CPP_TEST OFF)
 
+# Whether to build cpp micro-benchmark executables
+set(BUILD_CPP_BENCHMARK OFF)
+
 # Whether to enable OpenMP
 set(USE_OPENMP ON)
@@ -349,6 +349,9 @@ COOMatrix COOReorder(COOMatrix coo, runtime::NDArray new_row_ids, runtime::NDArr
  * \param prob Unnormalized probability array. Should be of the same length as the data array.
  *             If an empty array is provided, assume uniform.
  * \param replace True if sample with replacement
+ * \param exclude Data indices (i.e. edge IDs) that are never picked, in any order. The
+ *                picks are drawn from the other entries of each row, so a row still
+ *                gets num_samples picks if it has enough entries that are not excluded.
  * \return A COOMatrix storing the picked row and col indices. Its data field stores the
  *         the index of the picked elements in the value array.
  */
@@ -357,7 +360,8 @@ COOMatrix COORowWiseSampling(
     IdArray rows,
     int64_t num_samples,
     FloatArray prob = FloatArray(),
-    bool replace = true);
+    bool replace = true,
+    IdArray exclude = NullArray());
 
 /*!
  * \brief Select K non-zero entries with the largest weights along each given row.
@@ -571,6 +575,9 @@ std::vector<COOMatrix> DisjointPartitionCooBySizes(
  *      [1, 0, 0, 0, 0],
  *      [0, 1, 1, 0, 0]]
  *
+ * The successors of every edge are found through an index of the edges by source,
+ * so the cost is the sum of in-degree times out-degree over the nodes.
+ *
  * \param coo COOMatrix to create the LineGraph
  * \param backtracking whether the pair of (v, u) (u, v) edges are treated as linked
  * \return LineGraph in COO format
@@ -10,6 +10,7 @@
 #include <dmlc/serializer.h>
 #include <vector>
 #include <tuple>
+#include <utility>
 #include <string>
 #include "./types.h"
 #include "./array_ops.h"
@@ -351,9 +352,29 @@ CSRMatrix CSRRemove(CSRMatrix csr, IdArray entries);
  * \param prob Unnormalized probability array. Should be of the same length as the data array.
  *             If an empty array is provided, assume uniform.
  * \param replace True if sample with replacement
+ * \param exclude Data indices (i.e. edge IDs) that are never picked, in any order. The
+ *                picks are drawn from the other entries of each row, so a row still
+ *                gets num_samples picks if it has enough entries that are not excluded.
  * \return A COOMatrix storing the picked row, col and data indices.
  */
 COOMatrix CSRRowWiseSampling(
+    CSRMatrix mat,
+    IdArray rows,
+    int64_t num_samples,
+    FloatArray prob = FloatArray(),
+    bool replace = true,
+    IdArray exclude = NullArray());
+
+/*!
+ * \brief Same as CSRRowWiseSampling, but also returns how many entries are picked
+ *        from each of the given rows.
+ *
+ * The picks of rows[i] come right after those of rows[i - 1] in the returned matrix,
+ * so the counts tell which picks belong to which row even if rows has duplicates.
+ *
+ * \return The picked matrix and an int64 array of the number of picks of each row.
+ */
+std::pair<COOMatrix, IdArray> CSRRowWiseSamplingWithCounts(
     CSRMatrix mat,
     IdArray rows,
     int64_t num_samples,
@@ -495,6 +516,37 @@ CSRMatrix DisjointUnionCsr(
  */
 std::tuple<CSRMatrix, IdArray, IdArray> CSRToSimple(const CSRMatrix& csr);
 
+/*!
+ * \brief Create the LineGraph of a CSR matrix, in CSR format.
+ *
+ * Row and column e of the result stand for the edge of ID e of the input, i.e. the
+ * value of the data array, or the position if there is none. The edge IDs must be
+ * a permutation of [0, nnz). Every row of the result is sorted, and its data array
+ * is empty.
+ *
+ * A = [[0, 0, 1],
+ *      [1, 0, 1],
+ *      [1, 1, 0]]
+ * A.indptr = [0, 1, 3, 5]
+ * A.indices = [2, 0, 2, 0, 1]
+ * A.eid = [0, 1, 2, 3, 4]
+ *
+ * B = CSRLineGraph(A, backtracking=False)
+ *
+ * B.indptr = [0, 1, 2, 3, 3, 4]
+ * B.indices = [4, 0, 3, 1]
+ *
+ * The successors of every edge are found through the input, which indexes the
+ * edges by source, so the cost is the sum of in-degree times out-degree over the
+ * nodes. The successors are counted in parallel and written to their rows in
+ * parallel.
+ *
+ * \param csr CSRMatrix to create the LineGraph
+ * \param backtracking whether the pair of (v, u) (u, v) edges are treated as linked
+ * \return LineGraph in CSR format
+ */
+CSRMatrix CSRLineGraph(const CSRMatrix &csr, bool backtracking);
+
 /*!
  * \brief Split a CSRMatrix into multiple disjoin components.
  *
@@ -774,7 +774,8 @@ std::vector<HeteroGraphPtr> DisjointPartitionHeteroBySizes2(
  * This class can be used as arguments and return values of a C API.
  */
 struct HeteroPickleStates : public runtime::Object {
-  /*! \brief version number */
+  /*! \brief version number: 0 for the old format, 1 for meta and arrays, and 2
+   *         for meta with the arrays in a shared memory arena */
   int64_t version = 0;
 
   /*! \brief Metainformation
@@ -829,6 +830,26 @@ HeteroPickleStates HeteroPickle(HeteroGraphPtr graph);
  */
 HeteroGraphPtr HeteroUnpickleOld(const HeteroPickleStates& states);
 
+/*!
+ * \brief Get the pickling state of a graph whose arrays are copied to a shared memory
+ *        arena, leaving only their location in the state (version 2).
+ *
+ * The arena is leased from a pool of the calling process, and reused once the graph
+ * unpickled from the state is freed. Arrays outside of the CPU are pickled as usual.
+ *
+ * \return a HeteroPickleStates object
+ */
+HeteroPickleStates HeteroPickleToSharedMem(HeteroGraphPtr graph);
+
+/*!
+ * \brief Create a heterograph from pickling states of version 2, without copying its
+ *        arrays out of the shared memory arena.
+ *
+ * \param states Pickle states
+ * \return A heterograph pointer
+ */
+HeteroGraphPtr HeteroUnpickleFromSharedMem(const HeteroPickleStates& states);
+
 #define FORMAT_HAS_CSC(format) \
   ((format) & csc_code)
 
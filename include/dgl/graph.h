@@ -22,7 +22,99 @@ class Graph;
 class GraphOp;
 typedef std::shared_ptr<Graph> MutableGraphPtr;
 
-/*! \brief Mutable graph based on adjacency list. */
+/*!
+ * \brief Adjacency storage of the mutable graph.
+ *
+ * The neighbors and edge ids of every vertex live in a slot of two shared slabs,
+ * so a vertex costs three integers instead of two heap-allocated vectors. A slot
+ * that runs out of room moves to the end of the slabs with at least twice its
+ * capacity. The holes left behind are reclaimed by compaction once they outweigh
+ * the live entries.
+ *
+ * Entries of a vertex are kept in insertion order. Pointers returned by
+ * Neighbors() and EdgeIds() are invalidated by any mutation.
+ */
+class BlockedAdjacency {
+ public:
+  /*! \return the number of vertices */
+  uint64_t NumVertices() const {
+    return offset_.size();
+  }
+
+  /*! \return the number of entries (edges) stored */
+  uint64_t NumEntries() const {
+    return num_entries_;
+  }
+
+  /*! \return the number of entries of the given vertex */
+  uint64_t Degree(dgl_id_t vid) const {
+    return degree_[vid];
+  }
+
+  /*! \return pointer to the neighbors of the given vertex */
+  const dgl_id_t* Neighbors(dgl_id_t vid) const {
+    return nbr_.data() + offset_[vid];
+  }
+
+  /*! \return pointer to the edge ids of the given vertex */
+  const dgl_id_t* EdgeIds(dgl_id_t vid) const {
+    return eid_.data() + offset_[vid];
+  }
+
+  /*! \brief Add vertices with empty slots. */
+  void AddVertices(uint64_t num_vertices);
+
+  /*! \brief Append one entry to the slot of the given vertex. */
+  void Append(dgl_id_t vid, dgl_id_t nbr, dgl_id_t eid);
+
+  /*!
+   * \brief Append a batch of entries.
+   *
+   * Every slot is grown at most once for the whole batch. The entries are split
+   * into groups owning disjoint sets of vertices, by counting per vertex range, or
+   * by sorting when the batch is much smaller than the number of vertices, and the
+   * groups are placed in parallel. The i-th entry gets edge id first_eid + i.
+   *
+   * \param vids The vertex of each entry.
+   * \param nbrs The neighbor of each entry.
+   * \param len Number of entries.
+   * \param first_eid Edge id of the first entry.
+   */
+  void AppendBatch(const dgl_id_t* vids, const dgl_id_t* nbrs, int64_t len,
+                   dgl_id_t first_eid);
+
+  /*!
+   * \brief Write the adjacency in CSR form; the arrays must be pre-allocated.
+   * \param indptr Array of NumVertices() + 1 entries.
+   * \param indices Array of NumEntries() entries.
+   * \param eids Array of NumEntries() entries.
+   */
+  void ToCSR(dgl_id_t* indptr, dgl_id_t* indices, dgl_id_t* eids) const;
+
+  /*! \brief Remove all vertices and entries. */
+  void Clear();
+
+ private:
+  /*! \brief Rewrite all slots back to back, dropping the holes and spare capacity. */
+  void Compact();
+
+  /*! \brief neighbor slab */
+  std::vector<dgl_id_t> nbr_;
+  /*! \brief edge id slab, aligned with nbr_ */
+  std::vector<dgl_id_t> eid_;
+  /*! \brief slot offset of each vertex */
+  std::vector<dgl_id_t> offset_;
+  /*! \brief number of entries of each vertex */
+  std::vector<dgl_id_t> degree_;
+  /*! \brief slot capacity of each vertex */
+  std::vector<dgl_id_t> capacity_;
+  /*! \brief total number of entries */
+  uint64_t num_entries_ = 0;
+  /*! \brief slab entries left behind by moved slots */
+  uint64_t num_holes_ = 0;
+};
+
+/*! \brief Mutable graph based on adjacency list packed in shared slabs. */
 class Graph: public GraphInterface {
  public:
   /*! \brief default constructor */
@@ -81,8 +173,8 @@ class Graph: public GraphInterface {
    * \brief Clear the graph. Remove all vertices/edges.
    */
   void Clear() override {
-    adjlist_.clear();
-    reverse_adjlist_.clear();
+    adjlist_.Clear();
+    reverse_adjlist_.Clear();
     all_edges_src_.clear();
     all_edges_dst_.clear();
     read_only_ = false;
@@ -112,7 +204,7 @@ class Graph: public GraphInterface {
 
   /*! \return the number of vertices in the graph.*/
   uint64_t NumVertices() const override {
-    return adjlist_.size();
+    return adjlist_.NumVertices();
   }
 
   /*! \return the number of edges in the graph.*/
@@ -228,7 +320,7 @@ class Graph: public GraphInterface {
    */
   uint64_t InDegree(dgl_id_t vid) const override {
     CHECK(HasVertex(vid)) << "invalid vertex: " << vid;
-    return reverse_adjlist_[vid].succ.size();
+    return reverse_adjlist_.Degree(vid);
   }
 
   /*!
@@ -245,7 +337,7 @@ class Graph: public GraphInterface {
    */
   uint64_t OutDegree(dgl_id_t vid) const override {
     CHECK(HasVertex(vid)) << "invalid vertex: " << vid;
-    return adjlist_[vid].succ.size();
+    return adjlist_.Degree(vid);
   }
 
   /*!
@@ -297,8 +389,8 @@ class Graph: public GraphInterface {
    * \return the successor vector
    */
   DGLIdIters SuccVec(dgl_id_t vid) const override {
-    auto data = adjlist_[vid].succ.data();
-    auto size = adjlist_[vid].succ.size();
+    auto data = adjlist_.Neighbors(vid);
+    auto size = adjlist_.Degree(vid);
     return DGLIdIters(data, data + size);
   }
 
@@ -308,8 +400,8 @@ class Graph: public GraphInterface {
    * \return the out edge id vector
    */
   DGLIdIters OutEdgeVec(dgl_id_t vid) const override {
-    auto data = adjlist_[vid].edge_id.data();
-    auto size = adjlist_[vid].edge_id.size();
+    auto data = adjlist_.EdgeIds(vid);
+    auto size = adjlist_.Degree(vid);
     return DGLIdIters(data, data + size);
   }
 
@@ -319,8 +411,8 @@ class Graph: public GraphInterface {
    * \return the predecessor vector
    */
   DGLIdIters PredVec(dgl_id_t vid) const override {
-    auto data = reverse_adjlist_[vid].succ.data();
-    auto size = reverse_adjlist_[vid].succ.size();
+    auto data = reverse_adjlist_.Neighbors(vid);
+    auto size = reverse_adjlist_.Degree(vid);
     return DGLIdIters(data, data + size);
   }
 
@@ -330,8 +422,8 @@ class Graph: public GraphInterface {
    * \return the in edge id vector
    */
   DGLIdIters InEdgeVec(dgl_id_t vid) const override {
-    auto data = reverse_adjlist_[vid].edge_id.data();
-    auto size = reverse_adjlist_[vid].edge_id.size();
+    auto data = reverse_adjlist_.EdgeIds(vid);
+    auto size = reverse_adjlist_.Degree(vid);
     return DGLIdIters(data, data + size);
   }
 
@@ -359,19 +451,10 @@ class Graph: public GraphInterface {
 
  protected:
   friend class GraphOp;
-  /*! \brief Internal edge list type */
-  struct EdgeList {
-    /*! \brief successor vertex list */
-    std::vector<dgl_id_t> succ;
-    /*! \brief out edge list */
-    std::vector<dgl_id_t> edge_id;
-  };
-  typedef std::vector<EdgeList> AdjacencyList;
-
-  /*! \brief adjacency list using vector storage */
-  AdjacencyList adjlist_;
-  /*! \brief reverse adjacency list using vector storage */
-  AdjacencyList reverse_adjlist_;
+  /*! \brief adjacency list */
+  BlockedAdjacency adjlist_;
+  /*! \brief reverse adjacency list */
+  BlockedAdjacency reverse_adjlist_;
 
   /*! \brief all edges' src endpoints in their edge id order */
   std::vector<dgl_id_t> all_edges_src_;
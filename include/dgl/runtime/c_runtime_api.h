@@ -115,6 +115,16 @@ typedef DLTensor DGLArray;
 /*! \brief the array handle */
 typedef DGLArray* DGLArrayHandle;
 
+/*!
+ * \brief Array of NDArray handles, passed as a kHandle argument in place of
+ *  a list of NDArrays to save the allocation of one object per NDArray.
+ *  Every handle must be owned by an NDArray, i.e. must not be a view.
+ */
+typedef struct {
+  DGLArrayHandle* data;
+  int64_t size;
+} DGLArrayHandleList;
+
 /*!
  * \brief Union type of values
  *  being passed through API and function calls.
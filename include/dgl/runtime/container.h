@@ -6,6 +6,7 @@
 #ifndef DGL_RUNTIME_CONTAINER_H_
 #define DGL_RUNTIME_CONTAINER_H_
 
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -689,6 +690,32 @@ inline std::vector<T> ListValueToVector(const List<Value>& list) {
   return ret;
 }
 
+/*!
+ * \brief Helper function to convert an argument holding NDArrays to a vector.
+ *
+ * The argument is either a List<Value> or a DGLArrayHandleList, which is
+ * converted without creating any object.
+ *
+ * \tparam T element type
+ * \param arg Input argument.
+ * \return std vector
+ */
+template <typename T>
+inline typename std::enable_if<std::is_same<T, NDArray>::value, std::vector<T>>::type
+ListValueToVector(const DGLArgValue& arg) {
+  if (arg.type_code() != kHandle) {
+    List<Value> list = arg;
+    return ListValueToVector<T>(list);
+  }
+  const auto* list = static_cast<const DGLArrayHandleList*>(arg.operator void*());
+  CHECK(list != nullptr) << "Expect an array of NDArray handles but get null";
+  std::vector<T> ret;
+  ret.reserve(list->size);
+  for (int64_t i = 0; i < list->size; ++i)
+    ret.emplace_back(static_cast<NDArray::Container*>(static_cast<void*>(list->data[i])));
+  return ret;
+}
+
 }  // namespace runtime
 }  // namespace dgl
 
@@ -0,0 +1,116 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file dgl/runtime/memory_tracker.h
+ * \brief Accounting of the memory allocated for NDArrays, by tag.
+ *
+ * Tracking is disabled by default, in which case allocating an NDArray costs one
+ * more relaxed atomic load. Once enabled, every NDArray allocated by NDArray::Empty
+ * or NDArray::EmptyShared is counted under the tag current on the allocating thread,
+ * until the array is freed, even if tracking is disabled in between. Views and arrays
+ * imported from DLPack do not own their memory and are not counted.
+ *
+ * Usage:
+ * <code>
+ *   {
+ *     memory::ScopedTag tag("GraphFormat");
+ *     csr = aten::COOToCSR(coo);  // counted under "GraphFormat"
+ *   }
+ * </code>
+ *
+ * The tag is per thread, so the arrays allocated by the OpenMP workers of a parallel
+ * region are counted under their own tags, "untagged" by default.
+ */
+#ifndef DGL_RUNTIME_MEMORY_TRACKER_H_
+#define DGL_RUNTIME_MEMORY_TRACKER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dgl {
+namespace runtime {
+namespace memory {
+
+/*! \brief Maximum number of tags. Later tags are counted under "other". */
+constexpr int32_t kMaxTags = 64;
+
+/*! \brief ID of the tag of the arrays allocated outside of any ScopedTag. */
+constexpr int32_t kUntaggedTag = 0;
+
+/*! \brief Whether tracking is enabled. Use IsTracking() instead. */
+extern std::atomic<bool> tracking_flag;
+
+/*! \brief Whether newly allocated arrays are tracked. */
+inline bool IsTracking() {
+  return tracking_flag.load(std::memory_order_relaxed);
+}
+
+/*! \brief Start tracking the arrays allocated from now on. */
+void EnableTracking();
+
+/*! \brief Stop tracking new arrays. The arrays tracked so far are still counted when freed. */
+void DisableTracking();
+
+/*! \return The ID of a tag, registering it on first use. */
+int32_t GetTagID(const std::string& name);
+
+/*! \return The tag of the calling thread. */
+int32_t CurrentTag();
+
+/*!
+ * \brief Set the tag of the calling thread.
+ * \return The previous tag, to be restored with SetCurrentTag.
+ */
+int32_t SetCurrentTag(int32_t tag);
+
+/*! \brief Count an allocation of the calling thread, under its tag. */
+void RecordAlloc(int32_t tag, int64_t bytes, bool shared);
+
+/*! \brief Count the release of an allocation counted by RecordAlloc. */
+void RecordFree(int32_t tag, int64_t bytes, bool shared);
+
+/*! \brief Memory of the live arrays allocated under one tag. */
+struct TagStats {
+  std::string tag;
+  /*! \brief Bytes of the live arrays in private memory */
+  int64_t live_bytes = 0;
+  /*! \brief Bytes of the live arrays in shared memory */
+  int64_t shared_live_bytes = 0;
+  /*! \brief Largest sum of live_bytes and shared_live_bytes since the last reset */
+  int64_t peak_bytes = 0;
+  /*! \brief Number of live arrays */
+  int64_t live_arrays = 0;
+  /*! \brief Number of arrays allocated since tracking started */
+  int64_t total_allocs = 0;
+};
+
+/*! \return The statistics of all the tags that have allocated arrays. */
+std::vector<TagStats> GetStats();
+
+/*! \brief Reset the peaks to the current live bytes, and the allocation counts to 0. */
+void ResetPeaks();
+
+/*! \brief Count the arrays allocated by the enclosing scope under a tag. */
+class ScopedTag {
+ public:
+  explicit ScopedTag(const std::string& name)
+    : prev_(IsTracking() ? SetCurrentTag(GetTagID(name)) : -1) {}
+
+  ~ScopedTag() {
+    if (prev_ >= 0)
+      SetCurrentTag(prev_);
+  }
+
+  ScopedTag(const ScopedTag&) = delete;
+  ScopedTag& operator=(const ScopedTag&) = delete;
+
+ private:
+  int32_t prev_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace dgl
+
+#endif  // DGL_RUNTIME_MEMORY_TRACKER_H_
@@ -256,6 +256,12 @@ class NDArray {
   std::shared_ptr<SharedMemory> GetSharedMem() const;
 #endif  // _WIN32
 
+  /*!
+   * \return Whether the data lives in shared memory, either allocated by EmptyShared
+   *         or as a view of such an array.
+   */
+  bool IsSharedMem() const;
+
   /*!
    * \brief Function to copy data from one array to another.
    * \param from The source array.
@@ -324,6 +330,12 @@ struct NDArray::Container {
    *  currently defined by the system.
    */
   void (*deleter)(Container* self) = nullptr;
+  /*!
+   * \brief Tag the data is counted under by the memory tracker, -1 if not tracked
+   */
+  int32_t tracked_tag{-1};
+  /*! \brief Bytes counted by the memory tracker */
+  int64_t tracked_bytes{0};
   /*! \brief default constructor */
   Container() {
     dl_tensor.data = nullptr;
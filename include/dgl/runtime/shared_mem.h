@@ -71,6 +71,23 @@ class SharedMemory {
    */
   void *Open(size_t size);
 
+  /*
+   * \brief give up the ownership of the shared memory.
+   *
+   * The file is kept when the object is destroyed. It is used when the
+   * lifetime of the shared memory is managed by someone else, which
+   * removes the file with Unlink.
+   */
+  void Disown() { own = false; }
+
+  /*
+   * \brief remove the file of the shared memory.
+   *
+   * Processes that have mapped the shared memory can keep using it.
+   * \param name the name of the shared memory.
+   */
+  static void Unlink(const std::string &name);
+
   /*
    * \brief check if the shared memory exist.
    * \param name the name of the shared memory.
@@ -0,0 +1,131 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file dgl/runtime/tracing.h
+ * \brief Lightweight tracing of the hot paths of the library.
+ *
+ * Tracing is disabled by default, in which case a traced scope costs one relaxed
+ * atomic load. Once enabled, every thread records the scopes it runs into its own
+ * ring buffer of fixed capacity, so recording takes an uncontended lock and never
+ * allocates, and keeps per-operator aggregates that are not affected by the ring
+ * buffer wrapping around. The events can be dumped in the Chrome trace format and
+ * viewed in chrome://tracing or Perfetto.
+ *
+ * Usage:
+ * <code>
+ *   void SpMM(...) {
+ *     tracing::ScopedTimer timer("SpMM");
+ *     if (timer.active())
+ *       timer.AddEdges(graph->NumEdges(0));
+ *     ...
+ *   }
+ * </code>
+ */
+#ifndef DGL_RUNTIME_TRACING_H_
+#define DGL_RUNTIME_TRACING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dgl {
+namespace runtime {
+namespace tracing {
+
+/*! \brief Default number of events kept per thread. */
+constexpr int64_t kDefaultCapacity = 1 << 16;
+
+/*! \brief Whether tracing is enabled. Use IsEnabled() instead. */
+extern std::atomic<bool> enabled_flag;
+
+/*! \brief Whether tracing is enabled. */
+inline bool IsEnabled() {
+  return enabled_flag.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Enable tracing and clear the recorded events.
+ * \param capacity Number of events kept per thread. Older events are overwritten.
+ */
+void Enable(int64_t capacity = kDefaultCapacity);
+
+/*! \brief Disable tracing. The recorded events are kept. */
+void Disable();
+
+/*! \brief Clear the recorded events and aggregates of all the threads. */
+void Clear();
+
+/*! \brief Monotonic time in nanoseconds since the tracer was first used. */
+int64_t NowNs();
+
+/*!
+ * \brief Record a finished scope on the calling thread.
+ * \param name The scope name. Must be a string with static storage duration, as only
+ *        the pointer is kept.
+ * \param start_ns Start time from NowNs().
+ * \param end_ns End time from NowNs().
+ * \param bytes Number of bytes moved by the scope.
+ * \param edges Number of edges processed by the scope.
+ */
+void Record(const char* name, int64_t start_ns, int64_t end_ns,
+            int64_t bytes = 0, int64_t edges = 0);
+
+/*! \brief Aggregate statistics of the scopes of one name. */
+struct OpStats {
+  int64_t count = 0;
+  int64_t total_ns = 0;
+  int64_t min_ns = 0;
+  int64_t max_ns = 0;
+  int64_t bytes = 0;
+  int64_t edges = 0;
+};
+
+/*! \brief The aggregate statistics of all the recorded scopes, merged over threads. */
+std::vector<std::pair<std::string, OpStats>> GetStats();
+
+/*!
+ * \brief Dump the events kept in the ring buffers in the Chrome trace event format.
+ * \return A JSON string.
+ */
+std::string DumpChromeTrace();
+
+/*!
+ * \brief Time the enclosing scope if tracing is enabled when the scope starts.
+ *
+ * The name must be a string literal or otherwise have static storage duration.
+ */
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const char* name)
+    : name_(IsEnabled() ? name : nullptr), start_ns_(name_ ? NowNs() : 0) {}
+
+  ~ScopedTimer() {
+    if (name_)
+      Record(name_, start_ns_, NowNs(), bytes_, edges_);
+  }
+
+  /*! \brief Whether the scope is recorded, to skip computing its counters otherwise. */
+  bool active() const { return name_ != nullptr; }
+
+  /*! \brief Count bytes moved by the scope. */
+  void AddBytes(int64_t bytes) { bytes_ += bytes; }
+
+  /*! \brief Count edges processed by the scope. */
+  void AddEdges(int64_t edges) { edges_ += edges; }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  const char* name_;
+  int64_t start_ns_;
+  int64_t bytes_ = 0;
+  int64_t edges_ = 0;
+};
+
+}  // namespace tracing
+}  // namespace runtime
+}  // namespace dgl
+
+#endif  // DGL_RUNTIME_TRACING_H_
@@ -0,0 +1,51 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file dgl/sampling/layer.h
+ * \brief Layer-wise sampling.
+ */
+#ifndef DGL_SAMPLING_LAYER_H_
+#define DGL_SAMPLING_LAYER_H_
+
+#include <dgl/base_heterograph.h>
+#include <dgl/array.h>
+#include <utility>
+
+namespace dgl {
+namespace sampling {
+
+/*!
+ * \brief Sample one layer of nodes shared by all the given nodes and return the edges
+ * between them as a graph, following layer-dependent importance sampling (LADIES).
+ *
+ * The candidates are all the neighbors of the given nodes. Every candidate u is drawn
+ * with probability q(u) proportional to the sum of the squared weights of its edges
+ * to the given nodes. With replacement, each returned edge e = (u, v) gets the weight
+ * w(e) * c(u) / (s * q(u)), where c(u) is the number of times u is drawn and s the
+ * total number of draws, so that aggregating over the sampled edges is an unbiased
+ * estimate of aggregating over all the edges. Without replacement, it gets the weight
+ * w(e) / q(u), and the weights of the edges of each given node are normalized to sum
+ * to the total weight of all its edges, as in LADIES.
+ *
+ * \param hg The input graph with one edge type.
+ * \param nodes The node IDs to sample the layer for.
+ * \param layer_size Number of draws. When sampling without replacement and there are
+ *        fewer candidates, all of them are selected.
+ * \param dir Edge direction.
+ * \param prob A 1D float array of the edge weights w(e). An empty float array
+ *        assumes unit weights.
+ * \param replace If true, sample with replacement.
+ * \return The sampled edges as a graph with the same schema as the original one, and
+ *         the weights of the sampled edges.
+ */
+std::pair<HeteroSubgraph, FloatArray> SampleLayer(
+    const HeteroGraphPtr hg,
+    IdArray nodes,
+    int64_t layer_size,
+    EdgeDir dir,
+    FloatArray prob,
+    bool replace = true);
+
+}  // namespace sampling
+}  // namespace dgl
+
+#endif  // DGL_SAMPLING_LAYER_H_
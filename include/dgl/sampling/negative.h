@@ -0,0 +1,67 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file dgl/sampling/negative.h
+ * \brief Negative sampling for link prediction.
+ */
+#ifndef DGL_SAMPLING_NEGATIVE_H_
+#define DGL_SAMPLING_NEGATIVE_H_
+
+#include <dgl/base_heterograph.h>
+#include <dgl/array.h>
+#include <string>
+#include <utility>
+
+namespace dgl {
+namespace sampling {
+
+/*!
+ * \brief Build the alias table of a discrete distribution, so that drawing from it
+ * takes constant time.
+ * \param weights A 1D float array of the unnormalized non-negative weights.
+ * \return The probability table, of the same data type as the weights, and the alias
+ *         table, of int64.
+ */
+std::pair<FloatArray, IdArray> BuildAliasTable(FloatArray weights);
+
+/*!
+ * \brief Sample negative edges by corrupting one endpoint of the given edges.
+ *
+ * Every edge gets k negative edges, whose corrupted endpoint is drawn
+ *
+ * - uniformly from all the nodes of its type with mode "uniform";
+ * - from the distribution given by the alias table with mode "alias";
+ * - uniformly from the endpoints of the other edges in the same chunk of
+ *   chunk_size consecutive edges with mode "in_batch". An edge alone in its
+ *   chunk gets no negative edge.
+ *
+ * \param hg The input graph.
+ * \param etype The edge type.
+ * \param eids The IDs of the positive edges.
+ * \param k Number of negative edges per positive edge.
+ * \param mode The corruption mode.
+ * \param corrupt_src If true, corrupt the source nodes. Otherwise the destination nodes.
+ * \param chunk_size The chunk size of mode "in_batch".
+ * \param alias_prob The probability table of mode "alias".
+ * \param alias_idx The alias table of mode "alias".
+ * \param exclude_positive If true, the negative edges that exist in the graph are
+ *        drawn again a bounded number of times and dropped if they still exist.
+ * \return The negative edges as a graph with the same schema and nodes as the input
+ *         graph, whose edges of other types are empty, and the index of the positive
+ *         edge in eids that each negative edge is drawn for.
+ */
+std::pair<HeteroGraphPtr, IdArray> SampleNegativeEdges(
+    const HeteroGraphPtr hg,
+    dgl_type_t etype,
+    IdArray eids,
+    int64_t k,
+    const std::string& mode,
+    bool corrupt_src,
+    int64_t chunk_size,
+    FloatArray alias_prob,
+    IdArray alias_idx,
+    bool exclude_positive);
+
+}  // namespace sampling
+}  // namespace dgl
+
+#endif  // DGL_SAMPLING_NEGATIVE_H_
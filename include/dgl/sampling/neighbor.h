@@ -31,6 +31,10 @@ namespace sampling {
  * \param probability A vector of 1D float arrays, indicating the transition probability of
  *        each edge by edge type.  An empty float array assumes uniform transition.
  * \param replace If true, sample with replacement.
+ * \param exclude_edges IDs of the edges never to sample, by edge type, e.g. the target
+ *        edges of link prediction and their reverses. Either empty, or one array per
+ *        edge type, where an empty array excludes nothing. The excluded edges are skipped
+ *        while sampling, so the fanout is still reached with the other edges if possible.
  * \return Sampled neighborhoods as a graph. The return graph has the same schema as the
  *         original one.
  */
@@ -40,6 +44,32 @@ HeteroSubgraph SampleNeighbors(
     const std::vector<int64_t>& fanouts,
     EdgeDir dir,
     const std::vector<FloatArray>& probability,
+    bool replace = true,
+    const std::vector<IdArray>& exclude_edges = {});
+
+/*!
+ * \brief Sample from the neighbors of several sets of nodes at once, as if
+ *        SampleNeighbors was called on every set.
+ *
+ * The sets share the validation, the sparse format lookup and, when the neighbors are
+ * sampled on a CSR or CSC, a single parallel sampling pass over the nodes of all the
+ * sets whose output is split among the sets without copying.
+ *
+ * \param hg The input graph.
+ * \param nodes Node IDs of each type, for every set.
+ * \param fanouts Number of sampled neighbors for each edge type.
+ * \param dir Edge direction.
+ * \param probability A vector of 1D float arrays, indicating the transition probability of
+ *        each edge by edge type.  An empty float array assumes uniform transition.
+ * \param replace If true, sample with replacement.
+ * \return Sampled neighborhoods of every set, as SampleNeighbors returns them.
+ */
+std::vector<HeteroSubgraph> SampleNeighborsBatched(
+    const HeteroGraphPtr hg,
+    const std::vector<std::vector<IdArray>>& nodes,
+    const std::vector<int64_t>& fanouts,
+    EdgeDir dir,
+    const std::vector<FloatArray>& probability,
     bool replace = true);
 
 /*!
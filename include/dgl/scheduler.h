@@ -23,6 +23,9 @@ namespace sched {
  * \param recv_ids The recv nodes (for checking zero degree nodes)
  * \note If there are multiple messages going into the same destination vertex, then
  *       there will be multiple copies of the destination vertex in vids
+ * \note Buckets are ordered by ascending degree with the zero degree bucket (if any)
+ *       placed last. Nodes within a bucket are in ascending id order and the messages
+ *       of a node keep their input order, so the schedule is deterministic.
  * \return a vector of 5 IdArrays for degree bucketing. The 5 arrays are:
  *         degrees: degrees for each bucket
  *         nids: destination node ids
@@ -34,6 +37,36 @@ template <class IdType>
 std::vector<IdArray> DegreeBucketing(const IdArray& msg_ids, const IdArray& vids,
         const IdArray& recv_ids);
 
+/*!
+ * \brief Generate degree bucketing schedule with a bounded number of padded buckets
+ *
+ * Destination nodes with similar in-degrees share a bucket. The messages of each
+ * node are padded up to the largest degree in its bucket so that every bucket can
+ * be reduced with a single batched call, trading some wasted compute for far fewer
+ * and larger reductions than one bucket per distinct degree.
+ *
+ * \tparam IdType Graph's index data type, can be int32_t or int64_t
+ * \param msg_ids The edge id for each message
+ * \param vids The destination vertex for each message
+ * \param recv_ids The recv nodes (for checking zero degree nodes)
+ * \param max_buckets If positive, the bucket boundaries are chosen to minimize the
+ *        total number of padded messages using at most this many buckets. Otherwise,
+ *        degrees are grouped by power-of-two boundaries.
+ * \note Padding slots repeat the first message id of their node so that they can be
+ *       gathered safely; the mask tells them apart.
+ * \return a vector of 6 IdArrays for padded degree bucketing. The 6 arrays are:
+ *         degrees: padded degree for each bucket
+ *         nids: destination node ids
+ *         nid_section: number of nodes in each bucket (used to split nids)
+ *         mids: padded message ids
+ *         mid_section: number of padded messages in each bucket (used to split mids)
+ *         mask: 1 for real messages and 0 for padding, aligned with mids
+ *         As in DegreeBucketing, zero degree nodes form the last bucket.
+ */
+template <class IdType>
+std::vector<IdArray> DegreePaddedBucketing(const IdArray& msg_ids, const IdArray& vids,
+        const IdArray& recv_ids, int64_t max_buckets);
+
 /*!
  * \brief Generate degree bucketing schedule for group_apply edge
  * \tparam IdType Graph's index data type, can be int32_t or int64_t
@@ -44,6 +77,8 @@ std::vector<IdArray> DegreeBucketing(const IdArray& msg_ids, const IdArray& vids
  *       nodes in uids. Therefore, if group_apply by source nodes, then uids
  *       should be source. If group_apply by destination nodes, then uids
  *       should be destination.
+ * \note Buckets are ordered by ascending degree. Nodes within a bucket are in
+ *       ascending id order and the edges of a node keep their input order.
  * \return a vector of 5 IdArrays for degree bucketing. The 5 arrays are:
  *         degrees: degrees for each bucket
  *         new_uids: uids reordered by degree bucket
@@ -15,6 +15,8 @@ from . import random
 from . import sampling
 from . import dataloading
 from . import ops
+from . import tracing
+from . import memory
 
 from ._ffi.runtime_ctypes import TypeCode
 from ._ffi.function import register_func, get_global_func, list_global_func_names, extract_ext_funcs
@@ -10,6 +10,29 @@ from ... import utils
 from . import ir
 from .ir import var
 
+# The maximum number of padded buckets for reduce UDFs, or None to bucket the
+# nodes by their exact degree.
+_PADDED_MAX_BUCKETS = None
+
+def set_padded_bucketing(max_buckets=None):
+    """Choose how the nodes are bucketed before calling a reduce UDF.
+
+    By default, every bucket holds the nodes of one in-degree, so the UDF is called
+    once per distinct degree.  With padded bucketing, nodes of similar degrees share
+    a bucket and their messages are padded up to the largest degree of the bucket,
+    which bounds the number of calls.  The padding slots repeat the first message of
+    their node; the UDF must tell them apart with ``nodes.mailbox_mask``.
+
+    Parameters
+    ----------
+    max_buckets : int, optional
+        None to bucket by exact degree.  Otherwise, enables padded bucketing with at
+        most this many buckets, chosen to pad as few messages as possible; zero or a
+        negative value groups the degrees by powers of two instead.
+    """
+    global _PADDED_MAX_BUCKETS
+    _PADDED_MAX_BUCKETS = None if max_buckets is None else int(max_buckets)
+
 def gen_degree_bucketing_schedule(
         reduce_udf,
         message_ids,
@@ -49,16 +72,25 @@ def gen_degree_bucketing_schedule(
     ntype : str, optional
         The node type, if running on a heterograph.
         If None, assuming it's running on a homogeneous graph.
+
+    See Also
+    --------
+    set_padded_bucketing
     """
-    buckets = _degree_bucketing_schedule(message_ids, dst_nodes, recv_nodes)
-    # generate schedule
-    _, degs, buckets, msg_ids, zero_deg_nodes = buckets
-    # loop over each bucket
+    if _PADDED_MAX_BUCKETS is None:
+        buckets = _degree_bucketing_schedule(message_ids, dst_nodes, recv_nodes)
+        _, degs, buckets, msg_ids, zero_deg_nodes = buckets
+        masks = [None] * len(degs)
+    else:
+        buckets = _padded_degree_bucketing_schedule(
+            message_ids, dst_nodes, recv_nodes, _PADDED_MAX_BUCKETS)
+        _, degs, buckets, msg_ids, masks, zero_deg_nodes = buckets
+    # generate schedule: loop over each bucket
     idx_list = []
     fd_list = []
-    for deg, vbkt, mid in zip(degs, buckets, msg_ids):
+    for deg, vbkt, mid, mask in zip(degs, buckets, msg_ids, masks):
         # create per-bkt rfunc
-        rfunc = _create_per_bkt_rfunc(reduce_udf, deg, vbkt, ntype=ntype)
+        rfunc = _create_per_bkt_rfunc(reduce_udf, deg, vbkt, ntype=ntype, mask=mask)
         # vars
         vbkt = var.IDX(vbkt)
         mid = var.IDX(mid)
@@ -101,6 +133,34 @@ def _degree_bucketing_schedule(mids, dsts, v):
                                        v.todgltensor())
     return _process_node_buckets(buckets)
 
+def _padded_degree_bucketing_schedule(mids, dsts, v, max_buckets):
+    """Return the padded bucketing by degree scheduling for destination nodes of
+    messages
+
+    Parameters
+    ----------
+    mids: utils.Index
+        edge id for each message
+    dsts: utils.Index
+        destination node for each message
+    v: utils.Index
+        all receiving nodes (for checking zero degree nodes)
+    max_buckets: int
+        maximum number of buckets, or non-positive for power-of-two buckets
+
+    Returns
+    -------
+    The results of :func:`_process_node_buckets`, with the list of the message masks
+    of each bucket inserted before the zero-degree nodes.  The masks are float32
+    tensors holding 1 for the real messages and 0 for the padding.
+    """
+    buckets = _CAPI_DGLDegreePaddedBucketing(mids.todgltensor(), dsts.todgltensor(),
+                                             v.todgltensor(), max_buckets)
+    v, degs, dsts, msg_ids, zero_deg_nodes = _process_node_buckets(buckets)
+    mask = F.astype(utils.toindex(buckets(5), buckets(5).dtype).tousertensor(), F.float32)
+    masks = F.split(mask, buckets(4).asnumpy().tolist(), 0)
+    return v, degs, dsts, msg_ids, masks, zero_deg_nodes
+
 def _process_node_buckets(buckets):
     """read bucketing auxiliary data
 
@@ -147,15 +207,26 @@ def _process_node_buckets(buckets):
 
     return v, degs, dsts, msg_ids, zero_deg_nodes
 
-def _create_per_bkt_rfunc(reduce_udf, deg, vbkt, ntype=None):
-    """Internal function to generate the per degree bucket node UDF."""
+def _create_per_bkt_rfunc(reduce_udf, deg, vbkt, ntype=None, mask=None):
+    """Internal function to generate the per degree bucket node UDF.
+
+    If mask is given, the messages are padded and the mask is exposed to the UDF.
+    """
+    if mask is not None:
+        mask = F.reshape(mask, (len(vbkt), deg))
     def _rfunc_wrapper(node_data, mail_data):
         def _reshaped_getter(key):
             msg = mail_data[key]
             new_shape = (len(vbkt), deg) + F.shape(msg)[1:]
             return F.reshape(msg, new_shape)
         reshaped_mail_data = utils.LazyDict(_reshaped_getter, mail_data.keys())
-        nbatch = NodeBatch(vbkt, node_data, reshaped_mail_data, ntype=ntype)
+        bkt_mask = mask
+        if mask is not None and len(mail_data.keys()) > 0:
+            # the schedule is built on CPU, the messages may be elsewhere
+            msg = mail_data[next(iter(mail_data.keys()))]
+            bkt_mask = F.copy_to(mask, F.context(msg))
+        nbatch = NodeBatch(vbkt, node_data, reshaped_mail_data, ntype=ntype,
+                           mailbox_mask=bkt_mask)
         return reduce_udf(nbatch)
     return _rfunc_wrapper
 
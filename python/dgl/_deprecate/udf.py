@@ -116,12 +116,15 @@ class NodeBatch(object):
     ntype : str, optional
         The node type of this node batch, if running
         on a heterograph.
+    mailbox_mask : tensor, optional
+        The mask of the padded messages, see :attr:`mailbox_mask`.
     """
-    def __init__(self, nodes, data, msgs=None, ntype=None):
+    def __init__(self, nodes, data, msgs=None, ntype=None, mailbox_mask=None):
         self._nodes = nodes
         self._data = data
         self._msgs = msgs
         self._ntype = ntype
+        self._mailbox_mask = mailbox_mask
 
     @property
     def data(self):
@@ -148,6 +151,22 @@ class NodeBatch(object):
         """
         return self._msgs
 
+    @property
+    def mailbox_mask(self):
+        """Return the mask of the received messages if the mailbox is padded.
+
+        With padded degree bucketing, the messages of a node are padded up to the
+        degree of its bucket by repeating its first message.  The mask has shape
+        ``(batch_size, degree)`` and holds 1 for the real messages and 0 for the
+        padding.
+
+        Returns
+        -------
+        tensor or None
+            The float32 mask, or None if the mailbox is not padded.
+        """
+        return self._mailbox_mask
+
     def nodes(self):
         """Return the nodes contained in this batch.
 
@@ -40,6 +40,10 @@ cdef class NDArrayBase:
         def __get__(self):
             return <unsigned long long>self.chandle
 
+    property is_view:
+        def __get__(self):
+            return self.c_is_view != 0
+
     property handle:
         def __get__(self):
             if self.chandle == NULL:
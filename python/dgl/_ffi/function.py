@@ -181,15 +181,21 @@ def register_func(func_name, f=None, override=False):
             myf = convert_to_dgl_func(myf)
         check_call(_LIB.DGLFuncRegisterGlobal(
             c_str(func_name), myf.handle, ioverride))
+        _GLOBAL_FUNCS.pop(func_name, None)
         return myf
     if f:
         return register(f)
     return register
 
 
+# Global functions already looked up, by name.
+_GLOBAL_FUNCS = {}
+
 def get_global_func(name, allow_missing=False):
     """Get a global function by name
 
+    The function is looked up once and cached for the later calls.
+
     Parameters
     ----------
     name : str
@@ -203,10 +209,14 @@ def get_global_func(name, allow_missing=False):
     func : dgl.Function
         The function to be returned, None if function is missing.
     """
+    if name in _GLOBAL_FUNCS:
+        return _GLOBAL_FUNCS[name]
     handle = FunctionHandle()
     check_call(_LIB.DGLFuncGetGlobal(c_str(name), ctypes.byref(handle)))
     if handle.value:
-        return Function(handle, False)
+        func = Function(handle, False)
+        _GLOBAL_FUNCS[name] = func
+        return func
     else:
         if allow_missing:
             return None
@@ -6,7 +6,7 @@ import sys
 import ctypes
 import numpy as np
 from .base import _LIB, check_call, c_array, string_types, _FFI_MODE, c_str
-from .runtime_ctypes import DGLType, DGLContext, DGLArray, DGLArrayHandle
+from .runtime_ctypes import DGLType, DGLContext, DGLArray, DGLArrayHandle, DGLArrayHandleList
 from .runtime_ctypes import TypeCode, dgl_shape_index_t
 
 
@@ -317,6 +317,37 @@ class NDArrayBase(_NDArrayBase):
         return target
 
 
+class NDArrayHandleList(ctypes.c_void_p):
+    """Handle to an array of NDArray handles, which keeps the NDArrays alive."""
+
+def pack_ndarrays(arrays):
+    """Pack a list of NDArrays to pass to a C API.
+
+    A list is otherwise converted to a List<Value> object, which involves
+    creating one object per element. The C API must convert the argument
+    with ``ListValueToVector``.
+
+    Parameters
+    ----------
+    arrays : list[NDArray]
+        The NDArrays.
+
+    Returns
+    -------
+    NDArrayHandleList or list
+        The packed handles. The list itself is returned if any element is
+        not an NDArray owning its memory.
+    """
+    handles = (ctypes.c_void_p * len(arrays))()
+    for i, arr in enumerate(arrays):
+        if not isinstance(arr, _NDArrayBase) or arr.is_view:
+            return arrays
+        handles[i] = arr._dgl_handle
+    packed = DGLArrayHandleList(handles, len(arrays))
+    ret = NDArrayHandleList(ctypes.addressof(packed))
+    ret.refs = (packed, handles, arrays)
+    return ret
+
 def free_extension_handle(handle, type_code):
     """Free c++ extension type handle
 
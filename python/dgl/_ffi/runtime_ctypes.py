@@ -33,6 +33,11 @@ class DGLByteArray(ctypes.Structure):
     _fields_ = [("data", ctypes.POINTER(ctypes.c_byte)),
                 ("size", ctypes.c_size_t)]
 
+class DGLArrayHandleList(ctypes.Structure):
+    """Temp data structure for an array of NDArray handles."""
+    _fields_ = [("data", ctypes.POINTER(ctypes.c_void_p)),
+                ("size", ctypes.c_int64)]
+
 class DGLType(ctypes.Structure):
     """DGL datatype structure"""
     _fields_ = [("type_code", ctypes.c_uint8),
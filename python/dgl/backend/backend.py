@@ -1488,6 +1488,98 @@ def edge_softmax(gidx, logits, eids, norm_by):
         Softmax value
     """
 
+def spmm_linear(gidx, X, W, E=None):
+    r"""SpMM with sum reducer followed by a dense linear transform.
+
+    .. math::
+        z_v = \left(\sum_{(u,e,v)\in \mathcal{G}} w_e x_u\right) W
+
+    The aggregation and the projection are fused into one kernel, which also
+    projects first when that is cheaper.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index with one edge type.
+    X : Tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    W : Tensor
+        The weight of shape :math:`(D_{in}, D_{out})`.
+    E : Tensor, optional
+        The scalar edge weights of shape :math:`(E,)` or :math:`(E, 1)`.
+
+    Returns
+    -------
+    Tensor
+        The destination node features of shape :math:`(M, D_{out})`.
+    """
+
+def typed_spmm(gidx, etype, X, W, norm=None):
+    r"""Relation-aware SpMM that transforms every source node feature by the
+    weight of the edge's type and sums the messages on destination nodes.
+
+    .. math::
+        z_v = \sum_{(u,e,v)\in \mathcal{G}} n_e x_u W_{t_e}
+
+    All relations are computed in a single kernel launch instead of one
+    SpMM and one dense matmul per relation.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index with one edge type.
+    etype : Tensor
+        The relation type of each edge, of the same data type as the graph.
+    X : Tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    W : Tensor
+        The relation weights of shape :math:`(T, D_{in}, D_{out})`.
+    norm : Tensor, optional
+        The per-edge scalar norm. It is treated as a constant in the backward pass.
+
+    Returns
+    -------
+    Tensor
+        The destination node features of shape :math:`(M, D_{out})`.
+    """
+
+def segment_reduce(op, x, offsets):
+    """Segment reduction on the first dimension of the input. The rows in
+    ``[offsets[i], offsets[i + 1])`` are reduced into the i-th row of the result
+    in a single pass without atomic operations.
+
+    Parameters
+    ----------
+    op : str
+        The reducer, can be ``sum``, ``mean``, ``max`` or ``min``.
+    x : Tensor
+        The input feature.
+    offsets : Tensor
+        The offsets of the segments, an int64 vector of length :math:`S + 1`
+        starting from 0 and ending with the number of rows of ``x``.
+
+    Returns
+    -------
+    Tensor
+        The result of shape :math:`(S, ...)`. Empty segments produce zeros.
+    """
+
+def segment_softmax(x, offsets):
+    """Softmax over the rows of every segment of the input.
+
+    Parameters
+    ----------
+    x : Tensor
+        The input feature.
+    offsets : Tensor
+        The offsets of the segments, as in :func:`segment_reduce`.
+
+    Returns
+    -------
+    Tensor
+        The result, in the shape of ``x``.
+    """
+
 
 ###############################################################################
 # Other interfaces
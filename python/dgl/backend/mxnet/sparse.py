@@ -1,11 +1,15 @@
 import mxnet as mx
 import numpy as np
 from mxnet import nd
-from ...sparse import _gspmm, _gsddmm
+from ...sparse import _gspmm, _gspmm_cmp_backward, _gsddmm, _spmm_linear
+from ...sparse import _typed_spmm, _typed_spmm_weight_grad
+from ...sparse import _segment_reduce, _segment_reduce_backward
+from ...sparse import _segment_softmax, _segment_softmax_backward
 from ...base import dgl_warning, is_all, ALL
-from .tensor import asnumpy, copy_to, zerocopy_from_numpy, context, to_backend_ctx
+from .tensor import asnumpy, copy_to, zerocopy_from_numpy, context, to_backend_ctx, device_type
 
-__all__ = ['gspmm', 'gsddmm', 'edge_softmax']
+__all__ = ['gspmm', 'gsddmm', 'edge_softmax', 'spmm_linear', 'typed_spmm',
+           'segment_reduce', 'segment_softmax']
 
 
 def _scatter_nd(index, src, n_rows):
@@ -55,6 +59,14 @@ def _gather_nd(index, src):
     return rst
 
 
+def _scatter_arg(gidx, target, argX, argY, grad, n_rows):
+    """Route the gradient of SpMM-Min/Max to the selected source nodes (target
+    ``u``) or edges (target ``e``)."""
+    if device_type(context(grad)) == 'cpu':
+        return _gspmm_cmp_backward(gidx, target, argX, argY, grad)
+    return _scatter_nd(argX if target == 'u' else argY, grad, n_rows)
+
+
 def _reduce_grad(grad, shape):
     """Reduce gradient on the broadcast dimension
     If there is broadcast in forward pass, gradients need to be reduced on
@@ -136,12 +148,12 @@ class GSpMM(mx.autograd.Function):
                     dX = _gspmm(g_rev, 'copy_lhs', 'sum', dZ, None)[0]
             else:
                 if op in ['mul', 'div']:
-                    dX = _scatter_nd(
-                        argX,
+                    dX = _scatter_arg(
+                        gidx, 'u', argX, argY,
                         _muldiv(op, _gather_nd(argY, _expand(Y, dZ.shape[1:]))) * dZ,
                         X.shape[0])
                 elif op in ['add', 'sub', 'copy_lhs']:
-                    dX = _scatter_nd(argX, dZ, X.shape[0])
+                    dX = _scatter_arg(gidx, 'u', argX, argY, dZ, X.shape[0])
             dX = _reduce_grad(dX, X.shape)
         else:
             dX = nd.zeros_like(X)
@@ -157,14 +169,14 @@ class GSpMM(mx.autograd.Function):
                     dY = _gsddmm(gidx, 'copy_rhs', X, _addsub(op, dZ))
             else:
                 if op in ['mul',  'div']:
-                    dY = _scatter_nd(
-                        argY,
+                    dY = _scatter_arg(
+                        gidx, 'e', argX, argY,
                         _gather_nd(argX, _expand(X, dZ.shape[1:])) * dZ,
                         Y.shape[0])
                     if op == 'div':
                         dY = -dY / (Y ** 2)
                 elif op in ['add', 'sub', 'copy_rhs']:
-                    dY = _scatter_nd(argY, _addsub(op, dZ), Y.shape[0])
+                    dY = _scatter_arg(gidx, 'e', argX, argY, _addsub(op, dZ), Y.shape[0])
             dY = _reduce_grad(dY, Y.shape)
         else:
             dY = nd.zeros_like(Y)
@@ -322,3 +334,106 @@ class EdgeSoftmax(mx.autograd.Function):
 def edge_softmax(gidx, logits, eids=ALL, norm_by='dst'):
     softmax_op = EdgeSoftmax(gidx, eids, norm_by)
     return softmax_op(logits)
+
+
+class SpMMLinear(mx.autograd.Function):
+    def __init__(self, gidx):
+        super(SpMMLinear, self).__init__()
+        self.gidx = gidx
+
+    def forward(self, X, W, E=None):
+        out = _spmm_linear(self.gidx, X, W, E)
+        self.save_for_backward(X, W, E)
+        return out
+
+    def backward(self, dZ):
+        X, W, E = self.saved_tensors
+        gidx = self.gidx
+        dX = _spmm_linear(gidx.reverse(), dZ, W, E, transpose_weight=True)
+        AX = _gspmm(gidx, 'copy_lhs' if E is None else 'mul', 'sum', X, E)[0]
+        dW = nd.dot(AX, dZ, transpose_a=True)
+        self.saved_tensors = None
+        if E is None:
+            return dX, dW
+        # the gradient of an edge weight is the projected source feature dotted
+        # with the gradient of the destination
+        dE = _gsddmm(gidx, 'dot', nd.dot(X, W), dZ, 'u', 'v').reshape(E.shape)
+        return dX, dW, dE
+
+
+def spmm_linear(gidx, X, W, E=None):
+    func = SpMMLinear(gidx)
+    if E is None:
+        return func(X, W)
+    return func(X, W, E)
+
+
+class TypedSpMM(mx.autograd.Function):
+    def __init__(self, gidx, etype, norm):
+        super(TypedSpMM, self).__init__()
+        self.gidx = gidx
+        self.etype = etype
+        self.norm = norm
+
+    def forward(self, X, W):
+        out = _typed_spmm(self.gidx, self.etype, X, W, self.norm)
+        self.save_for_backward(X, W)
+        return out
+
+    def backward(self, dZ):
+        X, W = self.saved_tensors
+        gidx, etype, norm = self.gidx, self.etype, self.norm
+        dX = _typed_spmm(gidx.reverse(), etype, dZ, W, norm, transpose_weight=True)
+        dW = _typed_spmm_weight_grad(gidx, etype, X, dZ, W.shape[0], norm)
+        self.saved_tensors = None
+        return dX, dW
+
+
+def typed_spmm(gidx, etype, X, W, norm=None):
+    func = TypedSpMM(gidx, etype, norm)
+    return func(X, W)
+
+
+class SegmentReduce(mx.autograd.Function):
+    def __init__(self, op, offsets):
+        super(SegmentReduce, self).__init__()
+        self.op = op
+        self.offsets = offsets
+
+    def forward(self, x):
+        out, arg = _segment_reduce(self.op, x, self.offsets)
+        self.arg = arg
+        self.num_rows = x.shape[0]
+        return out
+
+    def backward(self, dy):
+        dx = _segment_reduce_backward(self.op, dy, self.offsets, self.arg, self.num_rows)
+        self.arg = None
+        return dx
+
+
+def segment_reduce(op, x, offsets):
+    func = SegmentReduce(op, offsets)
+    return func(x)
+
+
+class SegmentSoftmax(mx.autograd.Function):
+    def __init__(self, offsets):
+        super(SegmentSoftmax, self).__init__()
+        self.offsets = offsets
+
+    def forward(self, x):
+        out = _segment_softmax(x, self.offsets)
+        self.save_for_backward(out)
+        return out
+
+    def backward(self, dy):
+        out, = self.saved_tensors
+        dx = _segment_softmax_backward(out, dy, self.offsets)
+        self.saved_tensors = None
+        return dx
+
+
+def segment_softmax(x, offsets):
+    func = SegmentSoftmax(offsets)
+    return func(x)
@@ -1,8 +1,12 @@
 import torch as th
 from ...base import is_all, ALL
-from ...sparse import _gspmm, _gsddmm
+from ...sparse import _gspmm, _gspmm_cmp_backward, _gsddmm, _spmm_linear
+from ...sparse import _typed_spmm, _typed_spmm_weight_grad
+from ...sparse import _segment_reduce, _segment_reduce_backward
+from ...sparse import _segment_softmax, _segment_softmax_backward
 
-__all__ = ['gspmm', 'gsddmm', 'edge_softmax']
+__all__ = ['gspmm', 'gsddmm', 'edge_softmax', 'spmm_linear', 'typed_spmm',
+           'segment_reduce', 'segment_softmax']
 
 
 def _reduce_grad(grad, shape):
@@ -58,6 +62,15 @@ def _expand(x, shape):
     return x.expand(-1, *shape)
 
 
+def _scatter_arg(gidx, target, argX, argY, grad, x):
+    """Route the gradient of SpMM-Min/Max to the selected source nodes (target
+    ``u``) or edges (target ``e``), where x is the input feature."""
+    if x.device.type == 'cpu':
+        return _gspmm_cmp_backward(gidx, target, argX, argY, grad)
+    dx = th.zeros((x.shape[0],) + grad.shape[1:], dtype=x.dtype, device=x.device)
+    return dx.scatter_add_(0, (argX if target == 'u' else argY).long(), grad)
+
+
 class GSpMM(th.autograd.Function):
     @staticmethod
     def forward(ctx, gidx, op, reduce_op, X, Y):
@@ -80,14 +93,12 @@ class GSpMM(th.autograd.Function):
                 elif op == 'copy_lhs':
                     dX = gspmm(g_rev, 'copy_lhs', 'sum', dZ, None)
             else:  # max/min
-                dX = th.zeros((X.shape[0],) + dZ.shape[1:],
-                              dtype=X.dtype, device=X.device)
                 if op in ['mul', 'div']:
                     grad = _muldiv(op, _expand(Y, dZ.shape[1:]).gather(
                         0, argY.long())) * dZ
-                    dX.scatter_add_(0, argX.long(), grad)
                 elif op in ['add', 'sub', 'copy_lhs']:
-                    dX.scatter_add_(0, argX.long(), dZ)
+                    grad = dZ
+                dX = _scatter_arg(gidx, 'u', argX, argY, grad, X)
             dX = _reduce_grad(dX, X.shape)
         else:  # X has not gradient
             dX = None
@@ -102,16 +113,14 @@ class GSpMM(th.autograd.Function):
                 elif op in ['add', 'sub', 'copy_rhs']:
                     dY = gsddmm(gidx, 'copy_rhs', X, _addsub(op, dZ))
             else:  # max/min
-                dY = th.zeros((Y.shape[0],) + dZ.shape[1:],
-                              dtype=Y.dtype, device=Y.device)
                 if op in ['mul',  'div']:
                     grad = _expand(X, dZ.shape[1:]).gather(
                         0, argX.long()) * dZ
-                    dY.scatter_add_(0, argY.long(), grad)
+                    dY = _scatter_arg(gidx, 'e', argX, argY, grad, Y)
                     if op == 'div':
                         dY = -dY / (Y ** 2)
                 elif op in ['add', 'sub', 'copy_rhs']:
-                    dY.scatter_add_(0, argY.long(), _addsub(op, dZ))
+                    dY = _scatter_arg(gidx, 'e', argX, argY, _addsub(op, dZ), Y)
             dY = _reduce_grad(dY, Y.shape)
         else:  # Y has no gradient
             dY = None
@@ -231,6 +240,83 @@ class EdgeSoftmax(th.autograd.Function):
         return None, grad_score, None, None
 
 
+class SpMMLinear(th.autograd.Function):
+    @staticmethod
+    def forward(ctx, gidx, X, W, E):
+        out = _spmm_linear(gidx, X, W, E)
+        ctx.backward_cache = gidx, E
+        ctx.save_for_backward(X, W)
+        return out
+
+    @staticmethod
+    def backward(ctx, dZ):
+        gidx, E = ctx.backward_cache
+        X, W = ctx.saved_tensors
+        dZ = dZ.contiguous()
+        dX = dW = dE = None
+        if ctx.needs_input_grad[1]:
+            dX = _spmm_linear(gidx.reverse(), dZ, W, E, transpose_weight=True)
+        if ctx.needs_input_grad[2]:
+            AX = _gspmm(gidx, 'copy_lhs' if E is None else 'mul', 'sum', X, E)[0]
+            dW = th.matmul(AX.t(), dZ)
+        if E is not None and ctx.needs_input_grad[3]:
+            # the gradient of an edge weight is the projected source feature
+            # dotted with the gradient of the destination
+            dE = _gsddmm(gidx, 'dot', th.matmul(X, W), dZ, 'u', 'v').view(E.shape)
+        return None, dX, dW, dE
+
+
+class TypedSpMM(th.autograd.Function):
+    @staticmethod
+    def forward(ctx, gidx, etype, X, W, norm):
+        out = _typed_spmm(gidx, etype, X, W, norm)
+        ctx.backward_cache = gidx, etype, norm
+        ctx.save_for_backward(X, W)
+        return out
+
+    @staticmethod
+    def backward(ctx, dZ):
+        gidx, etype, norm = ctx.backward_cache
+        X, W = ctx.saved_tensors
+        dZ = dZ.contiguous()
+        dX = dW = None
+        if ctx.needs_input_grad[2]:
+            dX = _typed_spmm(gidx.reverse(), etype, dZ, W, norm, transpose_weight=True)
+        if ctx.needs_input_grad[3]:
+            dW = _typed_spmm_weight_grad(gidx, etype, X, dZ, W.shape[0], norm)
+        return None, None, dX, dW, None
+
+
+class SegmentReduce(th.autograd.Function):
+    @staticmethod
+    def forward(ctx, op, x, offsets):
+        out, arg = _segment_reduce(op, x, offsets)
+        ctx.backward_cache = op, x.shape[0]
+        ctx.save_for_backward(offsets, arg)
+        return out
+
+    @staticmethod
+    def backward(ctx, dy):
+        op, num_rows = ctx.backward_cache
+        offsets, arg = ctx.saved_tensors
+        dx = _segment_reduce_backward(op, dy.contiguous(), offsets, arg, num_rows)
+        return None, dx, None
+
+
+class SegmentSoftmax(th.autograd.Function):
+    @staticmethod
+    def forward(ctx, x, offsets):
+        out = _segment_softmax(x, offsets)
+        ctx.save_for_backward(out, offsets)
+        return out
+
+    @staticmethod
+    def backward(ctx, dy):
+        out, offsets = ctx.saved_tensors
+        dx = _segment_softmax_backward(out, dy.contiguous(), offsets)
+        return dx, None
+
+
 def gspmm(gidx, op, reduce_op, lhs_data, rhs_data):
     return GSpMM.apply(gidx, op, reduce_op, lhs_data, rhs_data)
 
@@ -241,3 +327,19 @@ def gsddmm(gidx, op, lhs_data, rhs_data, lhs_target='u', rhs_target='v'):
 
 def edge_softmax(gidx, logits, eids=ALL, norm_by='dst'):
     return EdgeSoftmax.apply(gidx, logits, eids, norm_by)
+
+
+def spmm_linear(gidx, X, W, E=None):
+    return SpMMLinear.apply(gidx, X, W, E)
+
+
+def typed_spmm(gidx, etype, X, W, norm=None):
+    return TypedSpMM.apply(gidx, etype, X, W, norm)
+
+
+def segment_reduce(op, x, offsets):
+    return SegmentReduce.apply(op, x, offsets)
+
+
+def segment_softmax(x, offsets):
+    return SegmentSoftmax.apply(x, offsets)
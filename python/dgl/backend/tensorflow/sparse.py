@@ -1,10 +1,14 @@
 import tensorflow as tf
 import numpy as np
-from .tensor import tensor, copy_to, context
+from .tensor import tensor, copy_to, context, device_type
 from ...base import is_all, ALL
-from ...sparse import _gspmm, _gsddmm
+from ...sparse import _gspmm, _gspmm_cmp_backward, _gsddmm, _spmm_linear
+from ...sparse import _typed_spmm, _typed_spmm_weight_grad
+from ...sparse import _segment_reduce, _segment_reduce_backward
+from ...sparse import _segment_softmax, _segment_softmax_backward
 
-__all__ = ['gspmm', 'gsddmm', 'edge_softmax']
+__all__ = ['gspmm', 'gsddmm', 'edge_softmax', 'spmm_linear', 'typed_spmm',
+           'segment_reduce', 'segment_softmax']
 
 
 def _scatter_nd(index, src, n_rows):
@@ -46,6 +50,14 @@ def _gather_nd(index, src):
     return rst
 
 
+def _scatter_arg(gidx, target, argX, argY, grad, n_rows):
+    """Route the gradient of SpMM-Min/Max to the selected source nodes (target
+    ``u``) or edges (target ``e``)."""
+    if device_type(context(grad)) == 'cpu':
+        return _gspmm_cmp_backward(gidx, target, argX, argY, grad)
+    return _scatter_nd(argX if target == 'u' else argY, grad, n_rows)
+
+
 def _reduce_grad(grad, shape):
     """Reduce gradient on the broadcast dimension
     If there is broadcast in forward pass, gradients need to be reduced on
@@ -114,12 +126,12 @@ def gspmm_real(gidx, op, reduce_op, X, Y):
                     dX = _gspmm(g_rev, 'copy_lhs', 'sum', dZ, None)[0]
             else:
                 if op in ['mul', 'div']:
-                    dX = _scatter_nd(
-                        argX,
+                    dX = _scatter_arg(
+                        gidx, 'u', argX, argY,
                         _muldiv(op, _gather_nd(argY, _expand(Y, dZ.shape[1:]))) * dZ,
                         X.shape[0])
                 elif op in ['add', 'sub', 'copy_lhs']:
-                    dX = _scatter_nd(argX, dZ, X.shape[0])
+                    dX = _scatter_arg(gidx, 'u', argX, argY, dZ, X.shape[0])
             dX = _reduce_grad(dX, X.shape)
         else:
             dX = tf.zeros_like(X)
@@ -135,13 +147,13 @@ def gspmm_real(gidx, op, reduce_op, X, Y):
             else:
                 out_shp = (Y.shape[0],) + dZ.shape[1:]
                 if op in ['mul',  'div']:
-                    dY = _scatter_nd(
-                        argY,
+                    dY = _scatter_arg(
+                        gidx, 'e', argX, argY,
                         _gather_nd(argX, _expand(X, dZ.shape[1:])) * dZ,
                         Y.shape[0])
                     if op == 'div': dY = -dY / (Y ** 2)
                 elif op in ['add', 'sub', 'copy_rhs']:
-                    dY = _scatter_nd(argY, _addsub(op, dZ), Y.shape[0])
+                    dY = _scatter_arg(gidx, 'e', argX, argY, _addsub(op, dZ), Y.shape[0])
             dY = _reduce_grad(dY, Y.shape)
         else:
             dY = tf.zeros_like(Y)
@@ -248,3 +260,80 @@ def edge_softmax(gidx, logits, eids=ALL, norm_by='dst'):
         return edge_softmax_real(gidx, logits, eids, norm_by)
     return _lambda(logits)
 
+
+def spmm_linear_real(gidx, X, W, E):
+    out = _spmm_linear(gidx, X, W, E)
+
+    def grad(dZ):
+        dZ = tensor(dZ)
+        dX = _spmm_linear(gidx.reverse(), dZ, W, E, transpose_weight=True)
+        AX = _gspmm(gidx, 'copy_lhs' if E is None else 'mul', 'sum', X, E)[0]
+        dW = tf.matmul(AX, dZ, transpose_a=True)
+        if E is None:
+            return dX, dW
+        # the gradient of an edge weight is the projected source feature dotted
+        # with the gradient of the destination
+        dE = tf.reshape(_gsddmm(gidx, 'dot', tf.matmul(X, W), dZ, 'u', 'v'), E.shape)
+        return dX, dW, dE
+    return out, grad
+
+
+def spmm_linear(gidx, X, W, E=None):
+    if E is None:
+        @tf.custom_gradient
+        def _lambda(X, W):
+            return spmm_linear_real(gidx, X, W, None)
+        return _lambda(X, W)
+
+    @tf.custom_gradient
+    def _lambda_with_weight(X, W, E):
+        return spmm_linear_real(gidx, X, W, E)
+    return _lambda_with_weight(X, W, E)
+
+
+def typed_spmm_real(gidx, etype, X, W, norm):
+    out = _typed_spmm(gidx, etype, X, W, norm)
+
+    def grad(dZ):
+        dZ = tensor(dZ)
+        dX = _typed_spmm(gidx.reverse(), etype, dZ, W, norm, transpose_weight=True)
+        dW = _typed_spmm_weight_grad(gidx, etype, X, dZ, W.shape[0], norm)
+        return dX, dW
+    return out, grad
+
+
+def typed_spmm(gidx, etype, X, W, norm=None):
+    @tf.custom_gradient
+    def _lambda(X, W):
+        return typed_spmm_real(gidx, etype, X, W, norm)
+    return _lambda(X, W)
+
+
+def segment_reduce_real(op, x, offsets):
+    out, arg = _segment_reduce(op, x, offsets)
+
+    def grad(dy):
+        return _segment_reduce_backward(op, tensor(dy), offsets, arg, x.shape[0])
+    return out, grad
+
+
+def segment_reduce(op, x, offsets):
+    @tf.custom_gradient
+    def _lambda(x):
+        return segment_reduce_real(op, x, offsets)
+    return _lambda(x)
+
+
+def segment_softmax_real(x, offsets):
+    out = _segment_softmax(x, offsets)
+
+    def grad(dy):
+        return _segment_softmax_backward(out, tensor(dy), offsets)
+    return out, grad
+
+
+def segment_softmax(x, offsets):
+    @tf.custom_gradient
+    def _lambda(x):
+        return segment_softmax_real(x, offsets)
+    return _lambda(x)
@@ -184,6 +184,33 @@ class BlockSampler(object):
         """
         raise NotImplementedError
 
+    def _sample_frontier_excluding(self, block_id, g, seed_nodes, exclude_eids):
+        """Generate the frontier given the output nodes, never including the edges in
+        :attr:`exclude_eids`.
+
+        The subclasses that can skip the excluded edges while sampling may override
+        this function, so that the frontier is not short of the edges removed
+        afterwards.  It returns None by default, in which case the excluded edges are
+        removed from the frontier returned by :meth:`sample_frontier`.
+
+        Parameters
+        ----------
+        block_id : int
+            Represents which GNN layer the frontier is generated for.
+        g : DGLGraph
+            The original graph.
+        seed_nodes : Tensor or dict[ntype, Tensor]
+            The output nodes by node type.
+        exclude_eids : Tensor or dict[etype, Tensor]
+            The edges to exclude from computation dependency.
+
+        Returns
+        -------
+        DGLGraph or None
+            The frontier generated for the current layer, or None if not supported.
+        """
+        return None
+
     def sample_blocks(self, g, seed_nodes, exclude_eids=None):
         """Generate the a list of blocks given the output nodes.
 
@@ -209,14 +236,21 @@ class BlockSampler(object):
         For the concept of frontiers and blocks, please refer to User Guide Section 6 [TODO].
         """
         blocks = []
+        exclude_eids_tensor = exclude_eids
         exclude_eids = (
             _tensor_or_dict_to_numpy(exclude_eids) if exclude_eids is not None else None)
         for block_id in reversed(range(self.num_layers)):
-            frontier = self.sample_frontier(block_id, g, seed_nodes)
+            frontier = None
+            if exclude_eids is not None:
+                frontier = self._sample_frontier_excluding(
+                    block_id, g, seed_nodes, exclude_eids_tensor)
+            excluded = frontier is not None
+            if not excluded:
+                frontier = self.sample_frontier(block_id, g, seed_nodes)
 
             # Removing edges from the frontier for link prediction training falls
             # into the category of frontier postprocessing
-            if exclude_eids is not None:
+            if exclude_eids is not None and not excluded:
                 parent_eids = frontier.edata[EID]
                 parent_eids_np = _tensor_or_dict_to_numpy(parent_eids)
                 located_eids = _locate_eids_to_exclude(parent_eids_np, exclude_eids)
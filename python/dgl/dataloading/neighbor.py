@@ -1,6 +1,8 @@
 """Data loading components for neighbor sampling"""
+from collections.abc import Mapping
 from .dataloader import BlockSampler
 from .. import sampling, subgraph, distributed
+from .. import backend as F
 
 class MultiLayerNeighborSampler(BlockSampler):
     """Sampler that builds computational dependency of node representations via
@@ -73,6 +75,21 @@ class MultiLayerNeighborSampler(BlockSampler):
                 frontier = sampling.sample_neighbors(g, seed_nodes, fanout, replace=self.replace)
         return frontier
 
+    def _sample_frontier_excluding(self, block_id, g, seed_nodes, exclude_eids):
+        # Subclasses overriding sample_frontier must see every frontier; taking all the
+        # neighbors keeps going through in_subgraph.
+        fanout = self.fanouts[block_id]
+        if type(self).sample_frontier is not MultiLayerNeighborSampler.sample_frontier or \
+                isinstance(g, distributed.DistGraph) or fanout is None:
+            return None
+        # The IDs of the reverse edges may be of another type than those of the graph.
+        if isinstance(exclude_eids, Mapping):
+            exclude_eids = {k: F.astype(v, g.idtype) for k, v in exclude_eids.items()}
+        else:
+            exclude_eids = F.astype(exclude_eids, g.idtype)
+        return sampling.sample_neighbors(g, seed_nodes, fanout, replace=self.replace,
+                                         exclude_edges=exclude_eids)
+
 class MultiLayerFullNeighborSampler(MultiLayerNeighborSampler):
     """Sampler that builds computational dependency of node representations by taking messages
     from all neighbors for multilayer GNN.
@@ -1,6 +1,7 @@
 """RPC components. They are typically functions or utilities used by both
 server and clients."""
 import abc
+import json
 import pickle
 import random
 import numpy as np
@@ -16,7 +17,8 @@ __all__ = ['set_rank', 'get_rank', 'Request', 'Response', 'register_service', \
 'get_num_machines', 'set_num_machines', 'get_machine_id', 'set_machine_id', \
 'send_request', 'recv_request', 'send_response', 'recv_response', 'remote_call', \
 'send_request_to_machine', 'remote_call_to_machine', 'fast_pull', \
-'get_num_client', 'set_num_client', 'client_barrier', 'copy_data_to_shared_memory']
+'get_num_client', 'set_num_client', 'client_barrier', 'copy_data_to_shared_memory', \
+'get_network_metrics', 'reset_network_metrics']
 
 REQUEST_CLASS_TO_SERVICE_ID = {}
 RESPONSE_CLASS_TO_SERVICE_ID = {}
@@ -923,6 +925,32 @@ def recv_rpc_message(timeout=0):
     _CAPI_DGLRPCRecvRPCMessage(timeout, msg)
     return msg
 
+def get_network_metrics():
+    """Return the throughput and latency metrics of the network layer of this process.
+
+    The metrics accumulate from the creation of the sender and receiver, or from the
+    last call of :func:`reset_network_metrics`.  Latencies are summarized by a
+    histogram whose buckets are within 1/16 of their values.
+
+    Returns
+    -------
+    dict
+        ``connections`` lists one entry per peer and direction (``send`` or ``recv``),
+        with the number of ``msgs`` and ``bytes`` transferred, the ``latency`` of the
+        messages in the queue and on the wire, and the ``queue`` occupancy:
+        ``capacity``, ``used`` and ``high_water`` in bytes, and the time in milliseconds
+        spent blocked adding to a full queue or removing from an empty one.
+        ``message_types`` lists one entry per service ID, with the messages and bytes
+        sent and received and the ``send_latency`` of :func:`send_rpc_message`.
+        Latencies hold the ``count`` and the mean, p50, p90, p99, p999 and max in
+        microseconds.
+    """
+    return json.loads(_CAPI_DGLRPCGetNetworkMetrics())
+
+def reset_network_metrics():
+    """Reset the counters, latency histograms and queue high-water marks."""
+    _CAPI_DGLRPCResetNetworkMetrics()
+
 def client_barrier():
     """Barrier all client processes"""
     req = ClientBarrierRequest()
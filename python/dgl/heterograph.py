@@ -3917,6 +3917,55 @@ class DGLHeteroGraph(object):
         """
         return self._graph.create_format_()
 
+    def memory_footprint(self):
+        r"""Report the memory used by the graph structure.
+
+        A relation may hold its edges in COO, CSR and CSC formats at the same time,
+        as the formats missing for an operator are built on demand and kept. This
+        reports the bytes of every format, including the edge IDs, and which ones
+        were built lazily and when, to spot formats that are materialized by accident.
+        Node and edge features are not included.
+
+        Returns
+        -------
+        dict
+            ``'relations'`` maps every canonical edge type to a dict from ``'coo'``,
+            ``'csr'`` and ``'csc'`` to the ``bytes`` and ``shared_bytes`` of the format,
+            and ``materialized_at``, the UNIX time in seconds at which it was built
+            lazily, or None if it was given at creation. Formats that are not
+            created are omitted. ``'private_bytes'``, ``'shared_bytes'`` and
+            ``'total_bytes'`` sum the whole graph, counting once the arrays shared
+            by several formats or relations.
+
+        Examples
+        --------
+
+        >>> g = dgl.graph(([0, 0, 1], [2, 3, 2]))
+        >>> g.memory_footprint()
+        {'relations': {('_N', '_E', '_N'): {'coo': {'bytes': 48, 'shared_bytes': 0,
+        'materialized_at': None}}}, 'private_bytes': 48, 'shared_bytes': 0,
+        'total_bytes': 48}
+        >>> g.create_format_()
+        >>> list(g.memory_footprint()['relations'][('_N', '_E', '_N')])
+        ['coo', 'csr', 'csc']
+
+        See Also
+        --------
+        dgl.memory.get_allocation_stats
+        """
+        private_bytes, shared_bytes, relations = self._graph.memory_footprint()
+        ret = {}
+        for etype, fmts in zip(self.canonical_etypes, relations):
+            ret[etype] = {}
+            for name, (created, materialized_ms, nbytes, shared) in \
+                    zip(['coo', 'csr', 'csc'], fmts.tolist()):
+                if created:
+                    ret[etype][name] = {
+                        'bytes': nbytes, 'shared_bytes': shared,
+                        'materialized_at': None if materialized_ms < 0 else materialized_ms / 1e3}
+        return {'relations': ret, 'private_bytes': private_bytes,
+                'shared_bytes': shared_bytes, 'total_bytes': private_bytes + shared_bytes}
+
     def astype(self, idtype):
         """Cast this graph to use another ID type.
 
@@ -3956,12 +4005,19 @@ class DGLHeteroGraph(object):
         name : str
             The name of the shared memory.
         formats : str or a list of str (optional)
-            Desired formats to be materialized.
+            Desired formats to be materialized. The other formats are created on
+            demand by the first process needing them and then shared with all the
+            processes attached to the graph.
 
         Returns
         -------
         HeteroGraph
             The graph in shared memory
+
+        Notes
+        -----
+        The shared memory is released when the last graph attached to it, in any
+        process, is destroyed.
         """
         assert len(name) > 0, "The name of shared memory cannot be empty"
         assert len(formats) > 0
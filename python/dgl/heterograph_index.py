@@ -910,6 +910,25 @@ class HeteroGraphIndex(ObjectBase):
         """Create all sparse matrices allowed for the graph."""
         return _CAPI_DGLHeteroCreateFormat(self)
 
+    def memory_footprint(self):
+        """Return the memory used by the sparse formats of every relation.
+
+        Returns
+        -------
+        int
+            Bytes of the arrays in private memory, counting shared arrays once.
+        int
+            Bytes of the arrays in shared memory, counting shared arrays once.
+        list[numpy.ndarray]
+            One int64 array of shape (3, 4) per edge type, whose rows are the COO,
+            CSR and CSC formats, and columns are whether the format is created, when it
+            was built lazily in milliseconds since the epoch or -1, its bytes and its
+            bytes in shared memory.
+        """
+        ret = _CAPI_DGLHeteroGetMemoryFootprint(self)
+        private_bytes, shared_bytes = ret[0].data.asnumpy().tolist()
+        return private_bytes, shared_bytes, [v.data.asnumpy() for v in ret[1:]]
+
     def reverse(self):
         """Reverse the heterogeneous graph adjacency
 
@@ -1181,10 +1200,10 @@ class HeteroPickleStates(ObjectBase):
 
     def __setstate__(self, state):
         if isinstance(state[0], int):
-            _, meta, arrays = state
+            version, meta, arrays = state
             arrays = [F.zerocopy_to_dgl_ndarray(arr) for arr in arrays]
             self.__init_handle_by_constructor__(
-                _CAPI_DGLCreateHeteroPickleStates, meta, arrays)
+                _CAPI_DGLCreateHeteroPickleStates, meta, arrays, version)
         else:
             metagraph, num_nodes_per_type, adjs = state
             num_nodes_per_type = F.zerocopy_to_dgl_ndarray(num_nodes_per_type)
@@ -0,0 +1,121 @@
+"""Accounting of the memory allocated by the C++ library.
+
+Tracking is disabled by default. Once enabled, every array the library allocates is
+counted, until it is freed, under the tag that is current on the allocating thread:
+``'untagged'`` by default, ``'GraphFormat'`` for the sparse formats that a graph
+builds on demand, or any name set with :func:`tag`. Arrays allocated by the
+deep learning framework are not counted.
+
+See :meth:`dgl.DGLGraph.memory_footprint` for the memory used by a given graph.
+
+Graphs can also be pickled through shared memory, so that the graphs sent by the
+workers of a multi-process data loader are not copied through pipes. See
+:func:`set_shared_memory_pickling`.
+"""
+import contextlib
+
+from ._ffi.function import _init_api
+
+__all__ = ['enable_tracking', 'disable_tracking', 'is_tracking', 'tag',
+           'get_allocation_stats', 'reset_peaks', 'set_shared_memory_pickling',
+           'is_shared_memory_pickling', 'get_arena_pool_stats', 'clear_arena_pool']
+
+def enable_tracking():
+    """Start counting the arrays allocated from now on."""
+    _CAPI_DGLMemoryEnableTracking()
+
+def disable_tracking():
+    """Stop counting new arrays.  The arrays counted so far are still released when freed."""
+    _CAPI_DGLMemoryDisableTracking()
+
+def is_tracking():
+    """Return whether the allocated arrays are counted."""
+    return bool(_CAPI_DGLMemoryIsTracking())
+
+@contextlib.contextmanager
+def tag(name):
+    """Context manager counting the arrays allocated by the current thread under a tag.
+
+    Parameters
+    ----------
+    name : str
+        The tag.
+
+    Examples
+    --------
+    >>> dgl.memory.enable_tracking()
+    >>> with dgl.memory.tag('sampling'):
+    ...     frontier = dgl.sampling.sample_neighbors(g, seeds, 10)
+    >>> dgl.memory.get_allocation_stats()['sampling']['live_bytes']
+    4096
+    """
+    prev = _CAPI_DGLMemorySetTag(name)
+    try:
+        yield
+    finally:
+        _CAPI_DGLMemoryRestoreTag(prev)
+
+def get_allocation_stats():
+    """Return the memory of the live arrays of every tag.
+
+    Returns
+    -------
+    dict[str, dict[str, int]]
+        Maps the tags to the bytes of their live arrays in private memory
+        ``live_bytes`` and in shared memory ``shared_live_bytes``, the largest sum of
+        both ``peak_bytes``, the number of live arrays ``live_arrays``, and the number
+        of arrays allocated ``total_allocs``.
+    """
+    ret = {}
+    for name, value in _CAPI_DGLMemoryGetStats().items():
+        live, shared, peak, arrays, allocs = value.data.asnumpy().tolist()
+        ret[name] = {'live_bytes': live, 'shared_live_bytes': shared, 'peak_bytes': peak,
+                     'live_arrays': arrays, 'total_allocs': allocs}
+    return ret
+
+def reset_peaks():
+    """Reset the peaks to the current live bytes and the allocation counts to zero."""
+    _CAPI_DGLMemoryResetPeaks()
+
+def set_shared_memory_pickling(enabled):
+    """Enable or disable pickling the graph structures through shared memory.
+
+    Once enabled, pickling a graph copies its structure to a shared memory arena of
+    the pickling process and pickles only the location of the arrays in it. Unpickling
+    the graph in another process maps the arena instead of copying the arrays, and
+    hands the arena back to the pickling process when the graph is freed. The arenas
+    are reused by the later pickles of the same process.
+
+    Every pickle must be unpickled exactly once, as for the graphs sent by the workers
+    of a data loader, and while the pickling process is alive. The setting is per
+    process, and can also be enabled by setting the environment variable
+    ``DGL_PICKLE_SHARED_MEM=1``, which is inherited by the workers.
+
+    Parameters
+    ----------
+    enabled : bool
+        Whether to pickle through shared memory.
+    """
+    _CAPI_DGLMemorySetPickleToSharedMem(enabled)
+
+def is_shared_memory_pickling():
+    """Return whether the graph structures are pickled through shared memory."""
+    return bool(_CAPI_DGLMemoryIsPicklingToSharedMem())
+
+def get_arena_pool_stats():
+    """Return the statistics of the shared memory arenas created by this process.
+
+    Returns
+    -------
+    dict[str, int]
+        The number of arenas ``num_arenas``, the number of them not holding a graph
+        ``num_free``, and their total size ``capacity_bytes``.
+    """
+    num_arenas, num_free, capacity = _CAPI_DGLMemoryGetArenaPoolStats().asnumpy().tolist()
+    return {'num_arenas': num_arenas, 'num_free': num_free, 'capacity_bytes': capacity}
+
+def clear_arena_pool():
+    """Remove the shared memory arenas of this process that do not hold a graph."""
+    _CAPI_DGLMemoryClearArenaPool()
+
+_init_api('dgl.memory')
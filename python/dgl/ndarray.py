@@ -15,6 +15,7 @@ from ._ffi.object import register_object, ObjectBase
 from ._ffi.function import _init_api
 from ._ffi.ndarray import DGLContext, DGLType, NDArrayBase
 from ._ffi.ndarray import context, empty, empty_shared_mem, from_dlpack, numpyasarray
+from ._ffi.ndarray import pack_ndarrays
 from ._ffi.ndarray import _set_class_ndarray
 from . import backend as F
 
@@ -1,11 +1,28 @@
 """Segment aggregation operators implemented using DGL graph."""
 
+import numpy as np
+
 from ..base import DGLError
 from .. import backend as F
 from .. import convert
 from .. import function as fn
 
 
+def _segment_offsets(seglen, num_rows):
+    """Return the int64 offsets of the segments, i.e. the exclusive prefix sum
+    of ``seglen`` with the total length appended."""
+    seglen_np = F.asnumpy(seglen)
+    if np.any(seglen_np < 0):
+        raise DGLError("Invalid seglen array:", seglen,
+                       ". Its elements must be non-negative.")
+    offsets = np.zeros((len(seglen) + 1,), dtype=np.int64)
+    np.cumsum(seglen_np, out=offsets[1:])
+    if offsets[-1] != num_rows:
+        raise DGLError("Invalid seglen array:", seglen,
+                       ". Its summation must be equal to value.shape[0].")
+    return F.zerocopy_from_numpy(offsets)
+
+
 def segment_reduce(seglen, value, reducer='sum'):
     """Segment reduction operator.
 
@@ -41,6 +58,9 @@ def segment_reduce(seglen, value, reducer='sum'):
             [5., 5., 5.],
             [4., 4., 4.]])
     """
+    if F.device_type(F.context(value)) == 'cpu':
+        offsets = _segment_offsets(seglen, F.shape(value)[0])
+        return F.segment_reduce(reducer, value, offsets)
     ctx = F.context(seglen)
     # TODO(minjie): a more efficient implementation is to create a graph
     #   directly from a CSR structure.
@@ -96,6 +116,9 @@ def segment_softmax(seglen, value):
             [0.2500, 0.2500, 0.2500],
             [0.2500, 0.2500, 0.2500]])
     """
+    if F.device_type(F.context(value)) == 'cpu':
+        offsets = _segment_offsets(seglen, F.shape(value)[0])
+        return F.segment_softmax(value, offsets)
     value_max = segment_reduce(seglen, value, reducer='max')
     value = F.exp(value - F.repeat(value_max, seglen, dim=0))
     value_sum = segment_reduce(seglen, value, reducer='sum')
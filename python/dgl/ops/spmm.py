@@ -2,9 +2,11 @@
 import sys
 
 from ..backend import gspmm as gspmm_internal
+from ..backend import spmm_linear as spmm_linear_internal
+from ..backend import typed_spmm as typed_spmm_internal
 from .. import backend as F
 
-__all__ = ['gspmm']
+__all__ = ['gspmm', 'spmm_linear', 'typed_spmm']
 
 
 def gspmm(g, op, reduce_op, lhs_data, rhs_data):
@@ -77,6 +79,84 @@ def gspmm(g, op, reduce_op, lhs_data, rhs_data):
         return ret
 
 
+
+def spmm_linear(g, x, weight, edge_weight=None):
+    r""" Sum the (weighted) source node features on destination nodes and
+    apply a dense linear transform.
+
+    .. math::
+        x_v = \left(\sum_{(u,e,v)\in \mathcal{G}} w_e x_u\right) W
+
+    This is the aggregation and projection of GCN and GraphSAGE layers. The
+    kernel projects the source node features first when :math:`D_{out}` is
+    small enough for that to be cheaper, and otherwise aggregates a tile of
+    destination nodes at a time and projects it while it is still in cache,
+    so the aggregated features are never materialized.
+
+    Parameters
+    ----------
+    g : DGLGraph
+        The input graph.
+    x : tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    weight : tensor
+        The weight of shape :math:`(D_{in}, D_{out})`.
+    edge_weight : tensor, optional
+        The scalar edge weights of shape :math:`(E,)` or :math:`(E, 1)`.
+
+    Returns
+    -------
+    tensor
+        The result tensor of shape :math:`(M, D_{out})`.
+
+    Notes
+    -----
+    This function supports autograd for :attr:`x`, :attr:`weight` and
+    :attr:`edge_weight`. It only runs on CPU.
+    """
+    return spmm_linear_internal(g._graph, x, weight, edge_weight)
+
+def typed_spmm(g, etypes, x, weight, norm=None):
+    r""" Relation-aware sparse matrix multiplication.
+
+    Each message is the source node feature multiplied by the weight matrix
+    of the edge's relation type and scaled by an optional edge norm. The messages
+    are summed on the destination nodes.
+
+    .. math::
+        x_v = \sum_{(u,e,v)\in \mathcal{G}} n_e x_u W_{t_e}
+
+    This is the aggregation of relational graph convolution. Compared with
+    running one SpMM per relation it does not materialize per-relation
+    messages and computes all relations in a single kernel launch.
+
+    Parameters
+    ----------
+    g : DGLGraph
+        The input graph, typically a homogeneous graph converted from a heterograph.
+    etypes : tensor
+        The relation type of each edge, in the range ``[0, T)``.
+    x : tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    weight : tensor
+        The relation weights of shape :math:`(T, D_{in}, D_{out})`.
+    norm : tensor, optional
+        The per-edge scalar norm of shape :math:`(E,)` or :math:`(E, 1)`.
+
+    Returns
+    -------
+    tensor
+        The result tensor of shape :math:`(M, D_{out})`.
+
+    Notes
+    -----
+    This function supports autograd for :attr:`x` and :attr:`weight`. The norm
+    is treated as a constant. It only runs on CPU.
+    """
+    if F.dtype(etypes) != g.idtype:
+        etypes = F.astype(etypes, g.idtype)
+    return typed_spmm_internal(g._graph, etypes, x, weight, norm)
+
 def _attach_zerodeg_note(docstring, reducer):
     note1 = """
     The {} function will return zero for nodes with no incoming messages.""".format(reducer)
@@ -3,3 +3,5 @@
 from .randomwalks import *
 from .pinsage import *
 from .neighbor import *
+from .layer import *
+from .negative import *
@@ -0,0 +1,130 @@
+"""Layer-wise sampling APIs"""
+
+from .._ffi.function import _init_api
+from .. import backend as F
+from ..base import DGLError, EID, NID
+from ..heterograph import DGLHeteroGraph
+from .. import ndarray as nd
+from .. import transform
+from .. import utils
+
+__all__ = [
+    'sample_layer',
+    'sample_blocks']
+
+def sample_layer(g, nodes, layer_size, edge_dir='in', prob=None, replace=True,
+                 weight_name='w'):
+    """Sample a layer of nodes shared by the given nodes and return the sampled
+    edges as a graph, following layer-dependent importance sampling (LADIES).
+
+    Unlike :func:`~dgl.sampling.sample_neighbors`, which samples the neighbors of
+    every node independently, all the given nodes share one set of sampled neighbors.
+    Every neighbor ``u`` is drawn with probability ``q(u)`` proportional to the sum
+    of the squared weights of its edges to the given nodes.  With replacement, every
+    sampled edge ``e = (u, v)`` gets the weight ``w(e) * c(u) / (s * q(u))``, where
+    ``c(u)`` is the number of times ``u`` is drawn out of ``s`` draws.  Summing the
+    messages over the sampled edges multiplied by their weights is thus an unbiased
+    estimate of the sum over all the edges.  Without replacement, every sampled edge
+    gets the weight ``w(e) / q(u)``, and the weights of the sampled edges of each
+    given node are normalized to sum to the total weight of all its edges, as in
+    LADIES.  If all the neighbors are selected, the weights are ``w(e)``.
+
+    The graph returned contains all the nodes in the original graph, but only the
+    sampled edges.  The original IDs of the sampled edges are stored as the
+    `dgl.EID` feature and their weights as the ``weight_name`` feature.
+
+    Parameters
+    ----------
+    g : DGLGraph
+        The graph with one edge type.  Must be on CPU.
+    nodes : tensor
+        Node IDs to sample the layer for.
+    layer_size : int
+        The number of draws.  When sampling without replacement and there are fewer
+        neighbors, all of them are selected.
+    edge_dir : str, optional
+        Determines whether to sample inbound or outbound edges.
+
+        Can take either ``in`` for inbound edges or ``out`` for outbound edges.
+    prob : str, optional
+        Feature name of the non-negative edge weights ``w(e)``, e.g. the normalized
+        adjacency.  The feature must have only one element for each edge.  If None,
+        all the edges have weight one.
+    replace : bool, optional
+        If True, sample with replacement.
+    weight_name : str, optional
+        Feature name to store the weights of the sampled edges.
+
+    Returns
+    -------
+    DGLGraph
+        A sampled subgraph containing only the sampled edges.  It is on CPU.
+
+    Examples
+    --------
+    >>> g = dgl.graph(([0, 0, 1, 1, 2, 2], [1, 2, 0, 1, 2, 0]))
+    >>> sg = dgl.sampling.sample_layer(g, [0, 1], 3, replace=False)
+    >>> sg.edges(order='eid')
+    (tensor([1, 2, 0, 1]), tensor([0, 0, 1, 1]))
+    >>> sg.edata['w']
+    tensor([1., 1., 1., 1.])
+    """
+    if len(g.etypes) != 1:
+        raise DGLError("Layer sampling only supports graphs with one edge type.")
+    assert g.device == F.cpu(), "Graph must be on CPU."
+    nodes = utils.prepare_tensor(g, nodes, 'nodes')
+
+    if prob is None:
+        prob_array = nd.array([], ctx=nd.cpu())
+    else:
+        prob_array = F.to_dgl_nd(g.edata[prob])
+
+    subgidx, weight = _CAPI_DGLSampleLayer(g._graph, F.to_dgl_nd(nodes), int(layer_size),
+                                           edge_dir, prob_array, replace)
+    ret = DGLHeteroGraph(subgidx.graph, g.ntypes, g.etypes)
+    ret.edata[EID] = subgidx.induced_edges[0]
+    ret.edata[weight_name] = F.from_dgl_nd(weight)
+    return ret
+
+def sample_blocks(g, seed_nodes, layer_sizes, prob=None, replace=True, weight_name='w'):
+    """Sample the layers of a multi-layer GNN with :func:`sample_layer` and return
+    them as blocks.
+
+    Starting from the seed nodes, each layer is sampled for the input nodes of the
+    next block, so that message passing from the first block to the last one
+    computes the output of the seed nodes.
+
+    Parameters
+    ----------
+    g : DGLGraph
+        The graph with one edge type.  Must be on CPU.
+    seed_nodes : tensor
+        The output nodes of the last block.
+    layer_sizes : list[int]
+        The layer size of each block, from the first block to the last one.
+    prob : str, optional
+        Feature name of the edge weights, see :func:`sample_layer`.
+    replace : bool, optional
+        If True, sample with replacement.
+    weight_name : str, optional
+        Feature name to store the weights of the sampled edges on every block.
+
+    Returns
+    -------
+    list[DGLBlock]
+        The blocks, whose edge feature ``weight_name`` holds the importance weights
+        and ``dgl.EID`` the original edge IDs.
+    """
+    blocks = []
+    nodes = utils.prepare_tensor(g, seed_nodes, 'seed_nodes')
+    for layer_size in reversed(layer_sizes):
+        frontier = sample_layer(g, nodes, layer_size, prob=prob, replace=replace,
+                                weight_name=weight_name)
+        block = transform.to_block(frontier, nodes)
+        # to_block numbers the edges after the frontier; map them back to the graph.
+        block.edata[EID] = F.gather_row(frontier.edata[EID], block.edata[EID])
+        nodes = block.srcdata[NID]
+        blocks.insert(0, block)
+    return blocks
+
+_init_api('dgl.sampling.layer', __name__)
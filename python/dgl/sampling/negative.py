@@ -0,0 +1,145 @@
+"""Negative sampling APIs"""
+
+from .._ffi.function import _init_api
+from .. import backend as F
+from ..base import DGLError
+from ..heterograph import DGLHeteroGraph
+from .. import ndarray as nd
+from .. import utils
+
+__all__ = [
+    'sample_negative_edges',
+    'NegativeSampler']
+
+def _degree_alias_table(g, etype, corrupt, exponent):
+    if corrupt == 'dst':
+        deg = g.in_degrees(etype=etype)
+    else:
+        deg = g.out_degrees(etype=etype)
+    weights = F.asnumpy(deg).astype('float32') ** exponent
+    prob, alias = _CAPI_DGLBuildAliasTable(nd.array(weights, ctx=nd.cpu()))
+    return prob, alias
+
+def sample_negative_edges(g, eids, k, mode='uniform', etype=None, corrupt='dst',
+                          chunk_size=None, exponent=0.75, exclude_positive=True):
+    """Sample negative edges by corrupting one endpoint of the given edges.
+
+    For each edge ``(u, v)`` of type ``etype``, ``k`` negative edges ``(u, v')`` are
+    drawn, or ``(u', v)`` if ``corrupt`` is ``src``.  The corrupted endpoint is drawn
+
+    * uniformly from all the nodes of its type with mode ``uniform``;
+    * proportionally to its degree raised to ``exponent`` with mode ``degree``, i.e.
+      its in-degree when corrupting the destination and its out-degree when
+      corrupting the source;
+    * uniformly from the corrupted endpoints of the other edges in the same chunk of
+      ``chunk_size`` consecutive edges with mode ``in_batch``.  An edge alone in its
+      chunk gets no negative edge.
+
+    If ``exclude_positive`` is True, negative edges that exist in the graph are drawn
+    again a bounded number of times and dropped if they still exist, so an edge may
+    get fewer than ``k`` negative edges.
+
+    Parameters
+    ----------
+    g : DGLGraph
+        The graph.  Must be on CPU.
+    eids : tensor
+        The IDs of the positive edges.
+    k : int
+        The number of negative edges per positive edge.
+    mode : str, optional
+        ``uniform``, ``degree`` or ``in_batch``.
+    etype : str or tuple of str, optional
+        The edge type.  Can be omitted if the graph has one edge type.
+    corrupt : str, optional
+        Corrupt the ``src`` or the ``dst`` endpoint.
+    chunk_size : int, optional
+        The chunk size of mode ``in_batch``.  If None, all the edges form one chunk.
+    exponent : float, optional
+        The exponent on the degrees of mode ``degree``.
+    exclude_positive : bool, optional
+        If True, filter out the negative edges that exist in the graph.
+
+    Returns
+    -------
+    DGLGraph
+        A graph with the same nodes as ``g`` whose edges of type ``etype`` are the
+        negative edges.  The feature ``pos`` of these edges is the position in
+        ``eids`` of the positive edge each of them is drawn for.  It is on CPU.
+
+    Examples
+    --------
+    >>> g = dgl.graph(([0, 1, 2, 3], [1, 2, 3, 0]))
+    >>> neg = dgl.sampling.sample_negative_edges(g, [0, 1], 2)
+    >>> neg.edges(order='eid')
+    (tensor([0, 0, 1, 1]), tensor([3, 2, 0, 3]))
+    >>> neg.edata['pos']
+    tensor([0, 0, 1, 1])
+    """
+    return NegativeSampler(g, k, mode=mode, etype=etype, corrupt=corrupt,
+                           chunk_size=chunk_size, exponent=exponent,
+                           exclude_positive=exclude_positive)(eids)
+
+class NegativeSampler(object):
+    """Negative sampler bound to one edge type of a graph.
+
+    Calling it on a tensor of edge IDs is equivalent to
+    :func:`sample_negative_edges`, but the alias table of mode ``degree`` is only
+    built once.  See :func:`sample_negative_edges` for the arguments.
+
+    Examples
+    --------
+    >>> g = dgl.graph(([0, 1, 2, 3], [1, 2, 3, 0]))
+    >>> sampler = dgl.sampling.NegativeSampler(g, 256, mode='degree')
+    >>> neg = sampler(torch.tensor([0, 1, 2]))
+    """
+    def __init__(self, g, k, mode='uniform', etype=None, corrupt='dst',
+                 chunk_size=None, exponent=0.75, exclude_positive=True):
+        if mode not in ('uniform', 'degree', 'in_batch'):
+            raise DGLError('Invalid mode "{}". Must be "uniform", "degree" or '
+                           '"in_batch".'.format(mode))
+        if corrupt not in ('src', 'dst'):
+            raise DGLError('Invalid corrupt argument "{}". Must be "src" or "dst".'.format(
+                corrupt))
+        assert g.device == F.cpu(), "Graph must be on CPU."
+        self.g = g
+        self.k = k
+        self.mode = mode
+        if etype is None and len(g.etypes) != 1:
+            raise DGLError('Edge type must be specified for graphs with multiple '
+                           'edge types.')
+        self.etype = g.to_canonical_etype(etype) if etype is not None \
+            else g.canonical_etypes[0]
+        self.corrupt = corrupt
+        self.chunk_size = chunk_size
+        self.exclude_positive = exclude_positive
+        if mode == 'degree':
+            self._prob, self._alias = _degree_alias_table(g, self.etype, corrupt, exponent)
+        else:
+            self._prob = nd.array([], ctx=nd.cpu())
+            self._alias = nd.array([], ctx=nd.cpu())
+
+    def __call__(self, eids):
+        """Sample the negative edges of the given positive edges.
+
+        Parameters
+        ----------
+        eids : tensor
+            The IDs of the positive edges.
+
+        Returns
+        -------
+        DGLGraph
+            The negative edges, see :func:`sample_negative_edges`.
+        """
+        g = self.g
+        eids = utils.prepare_tensor(g, eids, 'eids')
+        gidx, pos = _CAPI_DGLSampleNegativeEdges(
+            g._graph, g.get_etype_id(self.etype), F.to_dgl_nd(eids), int(self.k),
+            'alias' if self.mode == 'degree' else self.mode, self.corrupt == 'src',
+            int(self.chunk_size or 0), self._prob, self._alias, self.exclude_positive)
+        ret = DGLHeteroGraph(gidx, g.ntypes, g.etypes)
+        ret.edges[self.etype].data['pos'] = F.from_dgl_nd(pos)
+        return ret
+
+_init_api('dgl.sampling.negative', __name__)
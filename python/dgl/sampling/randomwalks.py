@@ -169,6 +169,8 @@ def random_walk(g, nodes, *, metapath=None, length=None, prob=None, restart_prob
                 prob_nd = nd.array([], ctx=nodes.ctx)
             p_nd.append(prob_nd)
 
+    p_nd = nd.pack_ndarrays(p_nd)
+
     # Actual random walk
     if restart_prob is None:
         traces, types = _CAPI_DGLSamplingRandomWalk(gidx, nodes, metapath, p_nd)
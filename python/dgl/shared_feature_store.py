@@ -0,0 +1,101 @@
+"""Node and edge features shared among processes."""
+from __future__ import absolute_import
+
+from ._ffi.object import register_object, ObjectBase
+from ._ffi.function import _init_api
+from . import backend as F
+from . import utils
+
+__all__ = ['SharedFeatureStore', 'create_shared_feature_store', 'open_shared_feature_store']
+
+@register_object('graph.SharedFeatureStore')
+class SharedFeatureStore(ObjectBase):
+    """Named tensors in shared memory.
+
+    Every process attached to the store maps the tensors without copying them,
+    so data loader workers share a single copy of the features. The shared memory
+    is released when the last store object attached to it, in any process, is
+    destroyed.
+
+    Do not create the object directly; use :func:`create_shared_feature_store`
+    or :func:`open_shared_feature_store`.
+    """
+
+    def __getitem__(self, key):
+        """Return the tensor of the given name, in shared memory."""
+        return F.zerocopy_from_dgl_ndarray(_CAPI_DGLSharedFeatureStoreGet(self, key))
+
+    def __setitem__(self, key, tensor):
+        """Copy a CPU tensor into the store under the given name.
+
+        A name can only be set once.
+        """
+        _CAPI_DGLSharedFeatureStoreAdd(self, key, F.zerocopy_to_dgl_ndarray(tensor))
+
+    def __contains__(self, key):
+        return bool(_CAPI_DGLSharedFeatureStoreHas(self, key))
+
+    def keys(self):
+        """Return the names of the tensors, in the order they were added."""
+        return [str(key.data) for key in _CAPI_DGLSharedFeatureStoreKeys(self)]
+
+    def gather_rows(self, key, rows, out=None):
+        """Copy rows of a tensor in parallel.
+
+        Parameters
+        ----------
+        key : str
+            The name of the tensor.
+        rows : Tensor
+            The IDs of the rows.
+        out : Tensor, optional
+            A contiguous CPU tensor receiving the rows. A new one is allocated
+            if not given.
+
+        Returns
+        -------
+        Tensor
+            The rows.
+        """
+        rows = utils.toindex(rows)
+        if out is None:
+            tensor = self[key]
+            out = F.zeros((len(rows),) + tuple(F.shape(tensor)[1:]),
+                          F.dtype(tensor), F.cpu())
+        _CAPI_DGLSharedFeatureStoreGatherRows(
+            self, key, rows.todgltensor(), F.zerocopy_to_dgl_ndarray_for_write(out))
+        return out
+
+def create_shared_feature_store(name):
+    """Create an empty feature store in shared memory.
+
+    A store of the same name is replaced, but the processes attached to it
+    keep their tensors.
+
+    Parameters
+    ----------
+    name : str
+        The name of the shared memory.
+
+    Returns
+    -------
+    SharedFeatureStore
+    """
+    assert len(name) > 0, "The name of shared memory cannot be empty"
+    return _CAPI_DGLSharedFeatureStoreCreate(name)
+
+def open_shared_feature_store(name):
+    """Attach to the feature store in shared memory with the given name.
+
+    Parameters
+    ----------
+    name : str
+        The name of the shared memory.
+
+    Returns
+    -------
+    SharedFeatureStore
+    """
+    return _CAPI_DGLSharedFeatureStoreOpen(name)
+
+_init_api("dgl.shared_feature_store")
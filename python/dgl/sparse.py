@@ -170,6 +170,52 @@ def _gspmm(gidx, op, reduce_op, u, e):
     return v, (arg_u, arg_e)
 
 
+def _gspmm_cmp_backward(gidx, target, arg_u, arg_e, grad):
+    r""" Backward of :func:`_gspmm` with ``min`` or ``max`` reducer. It routes
+    the gradient of every element of the result on destination nodes to the
+    source node or the edge that was selected in the forward pass.
+
+    The gradient of source nodes is gathered along the out-edges and the
+    gradient of edges along the in-edges, so no atomic operations are needed.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index.
+    target : str
+        ``u`` to compute the gradient of the source node feature, ``e`` for
+        the edge feature.
+    arg_u : tensor or None
+        The Arg-Min/Max on source nodes returned by :func:`_gspmm`.
+    arg_e : tensor or None
+        The Arg-Min/Max on edges returned by :func:`_gspmm`.
+    grad : tensor
+        The gradient routed through the selected messages, in the shape of
+        the result of :func:`_gspmm`.
+
+    Returns
+    -------
+    tensor
+        The gradient, in the shape of :attr:`grad` except the first dimension.
+
+    Notes
+    -----
+    This function does not handle gradients, and is only implemented on CPU.
+    """
+    if gidx.number_of_etypes() != 1:
+        raise DGLError("We only support gspmm on graph with one edge type")
+    srctype, _ = gidx.metagraph.find_edge(0)
+    num_rows = gidx.number_of_nodes(srctype) if target == 'u' else gidx.number_of_edges(0)
+    out = F.zeros((num_rows,) + F.shape(grad)[1:], F.dtype(grad), F.context(grad))
+    if gidx.number_of_edges(0) > 0:
+        _CAPI_DGLKernelSpMMCmpBackward(gidx, target_mapping[target],
+                                       to_dgl_nd(arg_u),
+                                       to_dgl_nd(arg_e),
+                                       to_dgl_nd(grad),
+                                       to_dgl_nd_for_write(out))
+    return out
+
+
 def _gsddmm(gidx, op, lhs, rhs, lhs_target='u', rhs_target='v'):
     r""" Generalized Sampled-Dense-Dense Matrix Multiplication interface. It
     takes the result of :attr:`op` on source node feature and destination node
@@ -244,4 +290,232 @@ def _gsddmm(gidx, op, lhs, rhs, lhs_target='u', rhs_target='v'):
     return out
 
 
+def _spmm_linear(gidx, u, weight, e=None, transpose_weight=False):
+    r""" Sparse Matrix Multiplication fused with a dense linear transform. It
+    sums the (weighted) source node features on destination nodes and
+    multiplies the result by the weight.
+
+    .. math::
+        x_v = \left(\sum_{(u,e,v)\in \mathcal{G}} w_e x_u\right) W
+
+    The kernel either projects the source node features first or aggregates
+    first, whichever takes fewer operations, and never materializes the
+    aggregated features when aggregating first.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index.
+    u : tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    weight : tensor
+        The weight of shape :math:`(D_{in}, D_{out})`.
+    e : tensor or None
+        The scalar edge weights of shape :math:`(E,)` or :math:`(E, 1)`.
+        None means unweighted.
+    transpose_weight : bool
+        If True, multiply by the transposed weight instead, i.e. the weight is
+        of shape :math:`(D_{out}, D_{in})`.
+
+    Returns
+    -------
+    tensor
+        The result tensor of shape :math:`(M, D_{out})`.
+
+    Notes
+    -----
+    This function does not handle gradients.
+    """
+    if gidx.number_of_etypes() != 1:
+        raise DGLError("We only support spmm linear on graph with one edge type")
+    _, dsttype = gidx.metagraph.find_edge(0)
+    out_dim = F.shape(weight)[0 if transpose_weight else 1]
+    v = F.zeros((gidx.number_of_nodes(dsttype), out_dim), F.dtype(u), F.context(u))
+    if gidx.number_of_edges(0) > 0:
+        _CAPI_DGLKernelSpMMLinear(gidx, to_dgl_nd(u), to_dgl_nd(e), to_dgl_nd(weight),
+                                  to_dgl_nd_for_write(v), transpose_weight)
+    return v
+
+
+def _typed_spmm(gidx, etype, u, weight, norm=None, transpose_weight=False):
+    r""" Typed Sparse Matrix Multiplication interface. It transforms the
+    source node feature by the weight matrix of the edge's type, scales it
+    by the edge norm and sums the messages on destination nodes.
+
+    .. math::
+        x_v = \sum_{(u,e,v)\in \mathcal{G}} n_e x_u W_{t_e}
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index.
+    etype : tensor
+        The type of each edge, of the same data type as the graph.
+    u : tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    weight : tensor
+        The weights of shape :math:`(T, D_{in}, D_{out})`.
+    norm : tensor or None
+        The per-edge scalar norm. None means no normalization.
+    transpose_weight : bool
+        If True, multiply by the transposed weights instead, i.e. the source
+        node features are of shape :math:`(N, D_{out})`.
+
+    Returns
+    -------
+    tensor
+        The result tensor.
+
+    Notes
+    -----
+    This function does not handle gradients.
+    """
+    if gidx.number_of_etypes() != 1:
+        raise DGLError("We only support typed spmm on graph with one edge type")
+    _, dsttype = gidx.metagraph.find_edge(0)
+    out_dim = F.shape(weight)[1 if transpose_weight else 2]
+    v = F.zeros((gidx.number_of_nodes(dsttype), out_dim), F.dtype(u), F.context(u))
+    if gidx.number_of_edges(0) > 0:
+        _CAPI_DGLKernelTypedSpMM(gidx, to_dgl_nd(etype), to_dgl_nd(u),
+                                 to_dgl_nd(norm), to_dgl_nd(weight),
+                                 to_dgl_nd_for_write(v), transpose_weight)
+    return v
+
+
+def _typed_spmm_weight_grad(gidx, etype, u, dv, num_types, norm=None):
+    r""" Compute the gradient of the weights in :func:`_typed_spmm`.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index.
+    etype : tensor
+        The type of each edge, of the same data type as the graph.
+    u : tensor
+        The source node features of shape :math:`(N, D_{in})`.
+    dv : tensor
+        The gradient of the destination node features, of shape :math:`(M, D_{out})`.
+    num_types : int
+        The number of edge types.
+    norm : tensor or None
+        The per-edge scalar norm.
+
+    Returns
+    -------
+    tensor
+        The weight gradient of shape :math:`(T, D_{in}, D_{out})`.
+    """
+    dw = F.zeros((num_types, F.shape(u)[1], F.shape(dv)[1]), F.dtype(u), F.context(u))
+    if gidx.number_of_edges(0) > 0:
+        _CAPI_DGLKernelTypedSpMMWeightGrad(gidx, to_dgl_nd(etype), to_dgl_nd(u),
+                                           to_dgl_nd(norm), to_dgl_nd(dv),
+                                           to_dgl_nd_for_write(dw))
+    return dw
+
+
+
+def _segment_reduce(op, x, offsets):
+    r""" Segment reduction on the first dimension of :attr:`x`. The rows in
+    ``[offsets[i], offsets[i + 1])`` are reduced into the i-th row of the result.
+
+    Parameters
+    ----------
+    op : str
+        The reducer, can be ``sum``, ``mean``, ``max`` or ``min``.
+    x : tensor
+        The input feature.
+    offsets : tensor
+        The offsets of the segments, a 1D integer tensor of length
+        :math:`S + 1` starting from 0 and ending with the number of rows of :attr:`x`.
+
+    Returns
+    -------
+    tuple
+        The result of shape :math:`(S, ...)` and the row of :attr:`x` every
+        element of the result is taken from for ``max`` and ``min`` (None
+        otherwise). Empty segments produce zeros and their arg is -1.
+
+    Notes
+    -----
+    This function does not handle gradients, and is only implemented on CPU.
+    """
+    ctx = F.context(x)
+    num_segs = F.shape(offsets)[0] - 1
+    out_shp = (num_segs,) + F.shape(x)[1:]
+    out = F.zeros(out_shp, F.dtype(x), ctx)
+    arg = None
+    if op in ['max', 'min']:
+        arg = F.zeros(out_shp, F.dtype(offsets), ctx)
+    _CAPI_DGLKernelSegmentReduce(op, to_dgl_nd(x), to_dgl_nd(offsets),
+                                 to_dgl_nd_for_write(out),
+                                 to_dgl_nd_for_write(arg))
+    return out, arg
+
+
+def _segment_reduce_backward(op, grad, offsets, arg, num_rows):
+    r""" Backward of :func:`_segment_reduce`.
+
+    Parameters
+    ----------
+    op : str
+        The reducer of the forward pass.
+    grad : tensor
+        The gradient of the result of :func:`_segment_reduce`.
+    offsets : tensor
+        The offsets of the segments.
+    arg : tensor or None
+        The arg returned by :func:`_segment_reduce` for ``max`` and ``min``.
+    num_rows : int
+        The number of rows of the input feature.
+
+    Returns
+    -------
+    tensor
+        The gradient of the input feature.
+    """
+    dx = F.zeros((num_rows,) + F.shape(grad)[1:], F.dtype(grad), F.context(grad))
+    _CAPI_DGLKernelBackwardSegmentReduce(op, to_dgl_nd(grad), to_dgl_nd(offsets),
+                                         to_dgl_nd(arg), to_dgl_nd_for_write(dx))
+    return dx
+
+
+def _segment_softmax(x, offsets):
+    r""" Softmax over the rows of every segment of :attr:`x`.
+
+    Parameters
+    ----------
+    x : tensor
+        The input feature.
+    offsets : tensor
+        The offsets of the segments.
+
+    Returns
+    -------
+    tensor
+        The result, in the shape of :attr:`x`.
+
+    Notes
+    -----
+    This function does not handle gradients, and is only implemented on CPU.
+    """
+    out = F.zeros(F.shape(x), F.dtype(x), F.context(x))
+    _CAPI_DGLKernelSegmentSoftmax(to_dgl_nd(x), to_dgl_nd(offsets),
+                                  to_dgl_nd_for_write(out))
+    return out
+
+
+def _segment_softmax_backward(out, grad, offsets):
+    r""" Backward of :func:`_segment_softmax`, given its result :attr:`out`
+    and the gradient of the result :attr:`grad`.
+
+    Returns
+    -------
+    tensor
+        The gradient of the input feature.
+    """
+    dx = F.zeros(F.shape(out), F.dtype(out), F.context(out))
+    _CAPI_DGLKernelBackwardSegmentSoftmax(to_dgl_nd(out), to_dgl_nd(grad),
+                                          to_dgl_nd(offsets), to_dgl_nd_for_write(dx))
+    return dx
+
 _init_api("dgl.sparse")
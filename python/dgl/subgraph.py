@@ -330,7 +330,7 @@ def in_subgraph(g, nodes):
         else:
             nodes_all_types.append(nd.NULL[g._idtype_str])
 
-    sgi = _CAPI_DGLInSubgraph(g._graph, nodes_all_types)
+    sgi = _CAPI_DGLInSubgraph(g._graph, nd.pack_ndarrays(nodes_all_types))
     induced_edges = sgi.induced_edges
     return _create_hetero_subgraph(g, sgi, None, induced_edges)
 
@@ -419,7 +419,7 @@ def out_subgraph(g, nodes):
         else:
             nodes_all_types.append(nd.NULL[g._idtype_str])
 
-    sgi = _CAPI_DGLOutSubgraph(g._graph, nodes_all_types)
+    sgi = _CAPI_DGLOutSubgraph(g._graph, nd.pack_ndarrays(nodes_all_types))
     induced_edges = sgi.induced_edges
     return _create_hetero_subgraph(g, sgi, None, induced_edges)
 
@@ -0,0 +1,108 @@
+"""Tracing of the time spent in the C++ library.
+
+Tracing is disabled by default. Once enabled, the kernels, samplers, transforms
+and RPC calls of the library record when they run, how many edges they process and
+how many bytes they move. The records can be saved in the Chrome trace format, to be
+viewed in ``chrome://tracing`` or Perfetto, or aggregated per operator.
+"""
+import contextlib
+
+from ._ffi.function import _init_api
+
+__all__ = ['enable', 'disable', 'is_enabled', 'clear', 'dump_chrome_trace',
+           'get_stats', 'trace']
+
+DEFAULT_CAPACITY = 1 << 16
+
+def enable(capacity=DEFAULT_CAPACITY):
+    """Enable tracing and clear the previous records.
+
+    Parameters
+    ----------
+    capacity : int, optional
+        The number of records kept per thread.  Once a thread has recorded more, its
+        oldest records are overwritten.  The aggregates of :func:`get_stats` are not
+        affected.
+    """
+    _CAPI_DGLTracingEnable(int(capacity))
+
+def disable():
+    """Disable tracing.  The records are kept."""
+    _CAPI_DGLTracingDisable()
+
+def is_enabled():
+    """Return whether tracing is enabled."""
+    return bool(_CAPI_DGLTracingIsEnabled())
+
+def clear():
+    """Clear the records and aggregates."""
+    _CAPI_DGLTracingClear()
+
+def dump_chrome_trace(path=None):
+    """Return the records in the Chrome trace event format.
+
+    Parameters
+    ----------
+    path : str, optional
+        If given, also write the trace to this file.
+
+    Returns
+    -------
+    str
+        The trace as a JSON string.
+    """
+    trace_str = _CAPI_DGLTracingDumpChromeTrace()
+    if path is not None:
+        with open(path, 'w') as f:
+            f.write(trace_str)
+    return trace_str
+
+def get_stats():
+    """Return the aggregate statistics of every operator recorded.
+
+    Returns
+    -------
+    dict[str, dict[str, int or float]]
+        Maps the operator names to their number of calls ``count``, total, minimum
+        and maximum time in milliseconds ``total_ms``, ``min_ms`` and ``max_ms``, and
+        total number of ``bytes`` moved and ``edges`` processed.
+
+    Examples
+    --------
+    >>> dgl.tracing.enable()
+    >>> g.update_all(fn.copy_u('h', 'm'), fn.sum('m', 'h'))
+    >>> dgl.tracing.get_stats()['SpMM']
+    {'count': 1, 'total_ms': 0.41, 'min_ms': 0.41, 'max_ms': 0.41, 'bytes': 1200, 'edges': 100}
+    """
+    ret = {}
+    for name, value in _CAPI_DGLTracingGetStats().items():
+        count, total_ns, min_ns, max_ns, nbytes, edges = value.data.asnumpy().tolist()
+        ret[name] = {'count': count, 'total_ms': total_ns / 1e6, 'min_ms': min_ns / 1e6,
+                     'max_ms': max_ns / 1e6, 'bytes': nbytes, 'edges': edges}
+    return ret
+
+@contextlib.contextmanager
+def trace(path=None, capacity=DEFAULT_CAPACITY):
+    """Context manager enabling tracing within its scope.
+
+    Parameters
+    ----------
+    path : str, optional
+        If given, write the Chrome trace to this file when leaving the scope.
+    capacity : int, optional
+        The number of records kept per thread.
+
+    Examples
+    --------
+    >>> with dgl.tracing.trace('trace.json'):
+    ...     train_one_epoch()
+    """
+    enable(capacity)
+    try:
+        yield
+    finally:
+        disable()
+        if path is not None:
+            dump_chrome_trace(path)
+
+_init_api('dgl.tracing')
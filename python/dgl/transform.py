@@ -1767,7 +1767,7 @@ def to_block(g, dst_nodes=None, include_dst_in_src=True):
             dst_nodes_nd.append(nd.NULL[g._idtype_str])
 
     new_graph_index, src_nodes_nd, induced_edges_nd = _CAPI_DGLToBlock(
-        g._graph, dst_nodes_nd, include_dst_in_src)
+        g._graph, nd.pack_ndarrays(dst_nodes_nd), include_dst_in_src)
 
     # The new graph duplicates the original node types to SRC and DST sets.
     new_ntypes = (g.ntypes, g.ntypes)
@@ -505,21 +505,39 @@ CSRMatrix CSRRemove(CSRMatrix csr, IdArray entries) {
   return ret;
 }
 
-COOMatrix CSRRowWiseSampling(
-    CSRMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace) {
+namespace {
+COOMatrix CSRRowWiseSamplingImpl(
+    CSRMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace,
+    IdArray exclude, IdArray* row_counts) {
   COOMatrix ret;
   ATEN_CSR_SWITCH(mat, XPU, IdType, "CSRRowWiseSampling", {
     if (IsNullArray(prob)) {
-      ret = impl::CSRRowWiseSamplingUniform<XPU, IdType>(mat, rows, num_samples, replace);
+      ret = impl::CSRRowWiseSamplingUniform<XPU, IdType>(
+          mat, rows, num_samples, replace, exclude, row_counts);
     } else {
       ATEN_FLOAT_TYPE_SWITCH(prob->dtype, FloatType, "probability", {
         ret = impl::CSRRowWiseSampling<XPU, IdType, FloatType>(
-            mat, rows, num_samples, prob, replace);
+            mat, rows, num_samples, prob, replace, exclude, row_counts);
       });
     }
   });
   return ret;
 }
+}  // namespace
+
+COOMatrix CSRRowWiseSampling(
+    CSRMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace,
+    IdArray exclude) {
+  return CSRRowWiseSamplingImpl(mat, rows, num_samples, prob, replace, exclude, nullptr);
+}
+
+std::pair<COOMatrix, IdArray> CSRRowWiseSamplingWithCounts(
+    CSRMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace) {
+  IdArray row_counts;
+  const COOMatrix ret = CSRRowWiseSamplingImpl(
+      mat, rows, num_samples, prob, replace, NullArray(), &row_counts);
+  return std::make_pair(ret, row_counts);
+}
 
 COOMatrix CSRRowWiseTopk(
     CSRMatrix mat, IdArray rows, int64_t k, NDArray weight, bool ascending) {
@@ -707,15 +725,17 @@ COOMatrix COORemove(COOMatrix coo, IdArray entries) {
 }
 
 COOMatrix COORowWiseSampling(
-    COOMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace) {
+    COOMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace,
+    IdArray exclude) {
   COOMatrix ret;
   ATEN_COO_SWITCH(mat, XPU, IdType, "COORowWiseSampling", {
     if (IsNullArray(prob)) {
-      ret = impl::COORowWiseSamplingUniform<XPU, IdType>(mat, rows, num_samples, replace);
+      ret = impl::COORowWiseSamplingUniform<XPU, IdType>(
+          mat, rows, num_samples, replace, exclude);
     } else {
       ATEN_FLOAT_TYPE_SWITCH(prob->dtype, FloatType, "probability", {
         ret = impl::COORowWiseSampling<XPU, IdType, FloatType>(
-            mat, rows, num_samples, prob, replace);
+            mat, rows, num_samples, prob, replace, exclude);
       });
     }
   });
@@ -750,6 +770,14 @@ COOMatrix COOLineGraph(const COOMatrix &coo, bool backtracking) {
   return ret;
 }
 
+CSRMatrix CSRLineGraph(const CSRMatrix &csr, bool backtracking) {
+  CSRMatrix ret;
+  ATEN_CSR_SWITCH(csr, XPU, IdType, "CSRLineGraph", {
+    ret = impl::CSRLineGraph<XPU, IdType>(csr, backtracking);
+  });
+  return ret;
+}
+
 COOMatrix UnionCoo(const std::vector<COOMatrix>& coos) {
   COOMatrix ret;
   CHECK_GT(coos.size(), 1) << "UnionCoo creates a union of multiple COOMatrixes";
@@ -144,11 +144,13 @@ CSRMatrix CSRRemove(CSRMatrix csr, IdArray entries);
 // FloatType is the type of probability data.
 template <DLDeviceType XPU, typename IdType, typename FloatType>
 COOMatrix CSRRowWiseSampling(
-    CSRMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace);
+    CSRMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace,
+    IdArray exclude, IdArray* row_counts = nullptr);
 
 template <DLDeviceType XPU, typename IdType>
 COOMatrix CSRRowWiseSamplingUniform(
-    CSRMatrix mat, IdArray rows, int64_t num_samples, bool replace);
+    CSRMatrix mat, IdArray rows, int64_t num_samples, bool replace, IdArray exclude,
+    IdArray* row_counts = nullptr);
 
 // FloatType is the type of weight data.
 template <DLDeviceType XPU, typename IdType, typename DType>
@@ -162,6 +164,17 @@ CSRMatrix UnionCsr(const std::vector<CSRMatrix>& csrs);
 template <DLDeviceType XPU, typename IdType>
 std::tuple<CSRMatrix, IdArray, IdArray> CSRToSimple(CSRMatrix csr);
 
+template <DLDeviceType XPU, typename IdType>
+CSRMatrix DisjointUnionCsr(const std::vector<CSRMatrix>& csrs);
+
+template <DLDeviceType XPU, typename IdType>
+std::vector<CSRMatrix> DisjointPartitionCsrBySizes(
+    const CSRMatrix& csr,
+    const uint64_t batch_size,
+    const std::vector<uint64_t>& edge_cumsum,
+    const std::vector<uint64_t>& src_vertex_cumsum,
+    const std::vector<uint64_t>& dst_vertex_cumsum);
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 template <DLDeviceType XPU, typename IdType>
@@ -220,11 +233,12 @@ COOMatrix COORemove(COOMatrix coo, IdArray entries);
 // FloatType is the type of probability data.
 template <DLDeviceType XPU, typename IdType, typename FloatType>
 COOMatrix COORowWiseSampling(
-    COOMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace);
+    COOMatrix mat, IdArray rows, int64_t num_samples, FloatArray prob, bool replace,
+    IdArray exclude);
 
 template <DLDeviceType XPU, typename IdType>
 COOMatrix COORowWiseSamplingUniform(
-    COOMatrix mat, IdArray rows, int64_t num_samples, bool replace);
+    COOMatrix mat, IdArray rows, int64_t num_samples, bool replace, IdArray exclude);
 
 // FloatType is the type of weight data.
 template <DLDeviceType XPU, typename IdType, typename FloatType>
@@ -255,6 +269,20 @@ Frontiers DGLDFSLabeledEdges(const CSRMatrix& csr,
 template <DLDeviceType XPU, typename IdType>
 COOMatrix COOLineGraph(const COOMatrix &coo, bool backtracking);
 
+template <DLDeviceType XPU, typename IdType>
+CSRMatrix CSRLineGraph(const CSRMatrix &csr, bool backtracking);
+
+template <DLDeviceType XPU, typename IdType>
+COOMatrix DisjointUnionCoo(const std::vector<COOMatrix>& coos);
+
+template <DLDeviceType XPU, typename IdType>
+std::vector<COOMatrix> DisjointPartitionCooBySizes(
+    const COOMatrix& coo,
+    const uint64_t batch_size,
+    const std::vector<uint64_t>& edge_cumsum,
+    const std::vector<uint64_t>& src_vertex_cumsum,
+    const std::vector<uint64_t>& dst_vertex_cumsum);
+
 }  // namespace impl
 }  // namespace aten
 }  // namespace dgl
@@ -75,12 +75,14 @@ class IdHashMap {
     }
   }
 
-  // Return the new id of each id in the given array.
+  // Return the new id of each id in the given array. The lookups only read the
+  // hashmap, so they run in parallel.
   IdArray Map(IdArray ids, IdType default_val) const {
     const IdType* ids_data = static_cast<IdType*>(ids->data);
     const int64_t len = ids->shape[0];
     IdArray values = NewIdArray(len, ids->ctx, ids->dtype.bits);
     IdType* values_data = static_cast<IdType*>(values->data);
+#pragma omp parallel for
     for (int64_t i = 0; i < len; ++i)
       values_data[i] = Map(ids_data[i], default_val);
     return values;
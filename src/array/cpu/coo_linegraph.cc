@@ -7,6 +7,7 @@
 #include <dgl/array.h>
 #include <numeric>
 #include <algorithm>
+#include <limits>
 #include <vector>
 #include <iterator>
 
@@ -14,45 +15,187 @@ namespace dgl {
 namespace aten {
 namespace impl {
 
+namespace {
+
+/*!
+ * \brief Join the edges of a graph with the edges leaving their destinations.
+ *
+ * The edges are numbered from 0 to nnz - 1 and edge i goes from row[i] to col[i].
+ * The edges leaving node v are index[indptr[v]], ..., index[indptr[v + 1] - 1], in
+ * ascending order. Edge j is a successor of edge i if it leaves col[i], is not i,
+ * and, unless backtracking, does not go back to row[i].
+ *
+ * The successors of every edge are first counted in parallel; the prefix sum of the
+ * counts then gives every edge its own range of the output, which it fills in
+ * parallel without synchronization. The cost is the sum of in-degree times
+ * out-degree over the nodes, instead of nnz * nnz.
+ */
+template <typename IdType>
+class LineGraphJoin {
+ public:
+  LineGraphJoin(int64_t nnz, int64_t num_nodes, const IdType* row, const IdType* col,
+                const IdType* indptr, const IdType* index, bool backtracking)
+    : nnz_(nnz), num_nodes_(num_nodes), row_(row), col_(col),
+      indptr_(indptr), index_(index), backtracking_(backtracking) {}
+
+  /*!
+   * \brief Count the successors of every edge.
+   * \return The offsets of the successors of every edge in the output, of size nnz + 1.
+   */
+  std::vector<int64_t> Count() const {
+    std::vector<int64_t> offsets(nnz_ + 1, 0);
+#pragma omp parallel for
+    for (int64_t i = 0; i < nnz_; ++i) {
+      int64_t count = 0;
+      ForEachSuccessor(i, [&count] (IdType) { ++count; });
+      offsets[i + 1] = count;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    CHECK_LE(offsets[nnz_], std::numeric_limits<IdType>::max())
+      << "The line graph has " << offsets[nnz_] << " edges, which overflows "
+      << sizeof(IdType) * 8 << "-bit IDs.";
+    return offsets;
+  }
+
+  /*!
+   * \brief Write the successors j of every edge i, in ascending order, to
+   *        out_row[offsets[i]...] and out_col[offsets[i]...], mapped by row_map and
+   *        col_map. A null out_row is not written.
+   */
+  void Fill(const std::vector<int64_t>& offsets, const IdType* row_map,
+            const IdType* col_map, IdType* out_row, IdType* out_col) const {
+#pragma omp parallel for
+    for (int64_t i = 0; i < nnz_; ++i) {
+      int64_t pos = offsets[i];
+      const IdType new_row = row_map ? row_map[i] : i;
+      ForEachSuccessor(i, [&] (IdType j) {
+        if (out_row)
+          out_row[pos] = new_row;
+        out_col[pos] = col_map ? col_map[j] : j;
+        ++pos;
+      });
+    }
+  }
+
+ private:
+  template <typename Fn>
+  void ForEachSuccessor(int64_t i, Fn fn) const {
+    const IdType u = row_[i];
+    const IdType v = col_[i];
+    if (v >= num_nodes_)
+      return;
+    for (IdType q = indptr_[v]; q < indptr_[v + 1]; ++q) {
+      const IdType j = index_[q];
+      // no self-loop, and no (v, u) after (u, v) unless backtracking
+      if (j != i && (backtracking_ || col_[j] != u))
+        fn(j);
+    }
+  }
+
+  const int64_t nnz_;
+  const int64_t num_nodes_;
+  const IdType* row_;
+  const IdType* col_;
+  const IdType* indptr_;
+  const IdType* index_;
+  const bool backtracking_;
+};
+
+}  // namespace
+
 template <DLDeviceType XPU, typename IdType>
 COOMatrix COOLineGraph(const COOMatrix &coo, bool backtracking) {
   const int64_t nnz = coo.row->shape[0];
-  IdType* coo_row = coo.row.Ptr<IdType>();
-  IdType* coo_col = coo.col.Ptr<IdType>();
+  const int64_t num_nodes = coo.num_rows;
+  const IdType* coo_row = coo.row.Ptr<IdType>();
+  const IdType* coo_col = coo.col.Ptr<IdType>();
   IdArray data = COOHasData(coo) ? coo.data : Range(0,
                                                     nnz,
                                                     coo.row->dtype.bits,
                                                     coo.row->ctx);
-  IdType* data_data = data.Ptr<IdType>();
-  std::vector<IdType> new_row;
-  std::vector<IdType> new_col;
-
-  for (int64_t i = 0; i < nnz; ++i) {
-    IdType u = coo_row[i];
-    IdType v = coo_col[i];
-    for (int64_t j = 0; j < nnz; ++j) {
-      // no self-loop
-      if (i == j)
-        continue;
-
-      // succ_u == v
-      // if not backtracking succ_u != u
-      if (v == coo_row[j] && (backtracking || u != coo_col[j])) {
-        new_row.push_back(data_data[i]);
-        new_col.push_back(data_data[j]);
-      }
-    }
+  const IdType* data_data = data.Ptr<IdType>();
+
+  // Index the edges by source with a stable counting sort, so that the successors
+  // of every edge are visited in the order of the COO.
+  std::vector<IdType> indptr(num_nodes + 1, 0);
+  for (int64_t i = 0; i < nnz; ++i)
+    ++indptr[coo_row[i] + 1];
+  std::partial_sum(indptr.begin(), indptr.end(), indptr.begin());
+  std::vector<IdType> index(nnz);
+  if (coo.row_sorted) {
+    std::iota(index.begin(), index.end(), 0);
+  } else {
+    std::vector<IdType> fill(indptr.begin(), indptr.end() - 1);
+    for (int64_t i = 0; i < nnz; ++i)
+      index[fill[coo_row[i]]++] = i;
   }
 
-  COOMatrix res = COOMatrix(nnz, nnz, NDArray::FromVector(new_row), NDArray::FromVector(new_col),
-    NullArray(), false, false);
+  const LineGraphJoin<IdType> join(
+      nnz, num_nodes, coo_row, coo_col, indptr.data(), index.data(), backtracking);
+  const std::vector<int64_t> offsets = join.Count();
+  IdArray new_row = NewIdArray(offsets[nnz], coo.row->ctx, coo.row->dtype.bits);
+  IdArray new_col = NewIdArray(offsets[nnz], coo.row->ctx, coo.row->dtype.bits);
+  join.Fill(offsets, data_data, data_data, new_row.Ptr<IdType>(), new_col.Ptr<IdType>());
+
+  COOMatrix res = COOMatrix(nnz, nnz, new_row, new_col, NullArray(), false, false);
   return res;
 }
 
-
 template COOMatrix COOLineGraph<kDLCPU, int32_t>(const COOMatrix &coo, bool backtracking);
 template COOMatrix COOLineGraph<kDLCPU, int64_t>(const COOMatrix &coo, bool backtracking);
 
+template <DLDeviceType XPU, typename IdType>
+CSRMatrix CSRLineGraph(const CSRMatrix &csr, bool backtracking) {
+  const int64_t nnz = csr.indices->shape[0];
+  const int64_t num_nodes = csr.num_rows;
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* eids = CSRHasData(csr) ? csr.data.Ptr<IdType>() : nullptr;
+
+  // Number the edges by ID, and index them by source in ascending order of ID, so
+  // that every row of the result is sorted.
+  std::vector<IdType> row(nnz), col(nnz), index(nnz);
+  if (eids) {
+    // Duplicate IDs would leave some rows of the edges unset.
+    std::vector<bool> seen(nnz, false);
+    for (int64_t p = 0; p < nnz; ++p) {
+      const IdType eid = eids[p];
+      CHECK(eid >= 0 && eid < nnz && !seen[eid])
+        << "The edge IDs of the CSR matrix must be a permutation of [0, nnz).";
+      seen[eid] = true;
+    }
+  }
+  bool ids_sorted = true;
+#pragma omp parallel for reduction(&&:ids_sorted)
+  for (int64_t u = 0; u < num_nodes; ++u) {
+    for (IdType p = indptr[u]; p < indptr[u + 1]; ++p) {
+      const IdType eid = eids ? eids[p] : p;
+      row[eid] = u;
+      col[eid] = indices[p];
+      index[p] = eid;
+      ids_sorted = ids_sorted && (p == indptr[u] || index[p - 1] < eid);
+    }
+  }
+  if (!ids_sorted) {
+#pragma omp parallel for
+    for (int64_t u = 0; u < num_nodes; ++u)
+      std::sort(index.begin() + indptr[u], index.begin() + indptr[u + 1]);
+  }
+
+  const LineGraphJoin<IdType> join(
+      nnz, num_nodes, row.data(), col.data(), indptr, index.data(), backtracking);
+  const std::vector<int64_t> offsets = join.Count();
+  IdArray new_indptr = NewIdArray(nnz + 1, csr.indptr->ctx, csr.indptr->dtype.bits);
+  IdArray new_indices = NewIdArray(offsets[nnz], csr.indptr->ctx, csr.indptr->dtype.bits);
+  std::copy(offsets.begin(), offsets.end(), new_indptr.Ptr<IdType>());
+  join.Fill(offsets, nullptr, nullptr, nullptr, new_indices.Ptr<IdType>());
+
+  return CSRMatrix(nnz, nnz, new_indptr, new_indices, NullArray(), true);
+}
+
+template CSRMatrix CSRLineGraph<kDLCPU, int32_t>(const CSRMatrix &csr, bool backtracking);
+template CSRMatrix CSRLineGraph<kDLCPU, int64_t>(const CSRMatrix &csr, bool backtracking);
+
 }  // namespace impl
 }  // namespace aten
 }  // namespace dgl
@@ -0,0 +1,308 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file array/cpu/disjoint_union.cc
+ * \brief Disjoint union and partition of sparse matrices on CPU
+ */
+#include <dgl/array.h>
+#include <algorithm>
+#include <vector>
+
+namespace dgl {
+using runtime::NDArray;
+namespace aten {
+namespace impl {
+
+namespace {
+
+// Number of output entries written by one parallel task.
+constexpr int64_t kGrainSize = 4096;
+
+/*!
+ * \brief Call fn(seg, begin, end) for every piece of [0, offsets.back()) that
+ *        falls into the segment [offsets[seg], offsets[seg + 1]).
+ *
+ * The range is cut into fixed-size blocks that are processed in parallel, so
+ * a batch of many tiny components is balanced as well as a batch with a few
+ * large ones.
+ */
+template <typename Fn>
+void ParallelForSegments(const std::vector<int64_t>& offsets, Fn fn) {
+  const int64_t total = offsets.back();
+  const int64_t num_blocks = (total + kGrainSize - 1) / kGrainSize;
+#pragma omp parallel for
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    int64_t begin = b * kGrainSize;
+    const int64_t end = std::min(total, begin + kGrainSize);
+    int64_t seg = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+    while (begin < end) {
+      const int64_t seg_end = std::min(end, offsets[seg + 1]);
+      if (seg_end > begin)
+        fn(seg, begin, seg_end);
+      begin = seg_end;
+      ++seg;
+    }
+  }
+}
+
+/*!
+ * \brief Slice arr[begins[g], ends[g]) for every g and subtract shifts[g] from it.
+ *
+ * Slices that need no shift are returned as views of arr; the others are
+ * copied together in a single parallel pass.
+ */
+template <typename IdType>
+std::vector<IdArray> SliceAndShift(
+    IdArray arr,
+    const std::vector<int64_t>& begins,
+    const std::vector<int64_t>& ends,
+    const std::vector<int64_t>& shifts) {
+  const int64_t num_slices = begins.size();
+  std::vector<IdArray> ret(num_slices);
+  std::vector<IdType*> out(num_slices, nullptr);
+  std::vector<int64_t> out_offsets(num_slices + 1, 0);
+  for (int64_t g = 0; g < num_slices; ++g) {
+    const int64_t len = ends[g] - begins[g];
+    if (shifts[g] == 0) {
+      ret[g] = arr.CreateView({len}, arr->dtype, begins[g] * sizeof(IdType));
+      out_offsets[g + 1] = out_offsets[g];
+    } else {
+      ret[g] = NewIdArray(len, arr->ctx, arr->dtype.bits);
+      out[g] = ret[g].Ptr<IdType>();
+      out_offsets[g + 1] = out_offsets[g] + len;
+    }
+  }
+
+  const IdType* in = arr.Ptr<IdType>();
+  ParallelForSegments(out_offsets, [&](int64_t g, int64_t begin, int64_t end) {
+    IdType* out_g = out[g];
+    const IdType* in_g = in + begins[g];
+    const IdType shift = shifts[g];
+    for (int64_t i = begin - out_offsets[g]; i < end - out_offsets[g]; ++i)
+      out_g[i] = in_g[i] - shift;
+  });
+  return ret;
+}
+
+}  // namespace
+
+///////////////////////////// COO /////////////////////////////
+
+template <DLDeviceType XPU, typename IdType>
+COOMatrix DisjointUnionCoo(const std::vector<COOMatrix>& coos) {
+  const int64_t batch_size = coos.size();
+  std::vector<int64_t> edge_offsets(batch_size + 1, 0);
+  std::vector<int64_t> src_offsets(batch_size + 1, 0);
+  std::vector<int64_t> dst_offsets(batch_size + 1, 0);
+  std::vector<const IdType*> rows(batch_size), cols(batch_size), data(batch_size, nullptr);
+  bool has_data = false;
+  bool row_sorted = true;
+  bool col_sorted = true;
+  for (int64_t g = 0; g < batch_size; ++g) {
+    const COOMatrix& coo = coos[g];
+    edge_offsets[g + 1] = edge_offsets[g] + coo.row->shape[0];
+    src_offsets[g + 1] = src_offsets[g] + coo.num_rows;
+    dst_offsets[g + 1] = dst_offsets[g] + coo.num_cols;
+    rows[g] = coo.row.Ptr<IdType>();
+    cols[g] = coo.col.Ptr<IdType>();
+    if (COOHasData(coo)) {
+      data[g] = coo.data.Ptr<IdType>();
+      has_data = true;
+    }
+    row_sorted &= coo.row_sorted;
+    col_sorted &= coo.col_sorted;
+  }
+
+  const int64_t nnz = edge_offsets[batch_size];
+  const DLContext ctx = coos[0].row->ctx;
+  const uint8_t nbits = coos[0].row->dtype.bits;
+  IdArray ret_row = NewIdArray(nnz, ctx, nbits);
+  IdArray ret_col = NewIdArray(nnz, ctx, nbits);
+  IdArray ret_data = has_data ? NewIdArray(nnz, ctx, nbits) : NullArray();
+  IdType* ret_row_data = ret_row.Ptr<IdType>();
+  IdType* ret_col_data = ret_col.Ptr<IdType>();
+  IdType* ret_data_data = has_data ? ret_data.Ptr<IdType>() : nullptr;
+
+  ParallelForSegments(edge_offsets, [&](int64_t g, int64_t begin, int64_t end) {
+    const int64_t eoff = edge_offsets[g];
+    const IdType soff = src_offsets[g], doff = dst_offsets[g];
+    for (int64_t i = begin; i < end; ++i) {
+      ret_row_data[i] = rows[g][i - eoff] + soff;
+      ret_col_data[i] = cols[g][i - eoff] + doff;
+    }
+    if (has_data) {
+      // components without a data array number their edges consecutively
+      if (data[g]) {
+        for (int64_t i = begin; i < end; ++i)
+          ret_data_data[i] = data[g][i - eoff] + eoff;
+      } else {
+        for (int64_t i = begin; i < end; ++i)
+          ret_data_data[i] = i;
+      }
+    }
+  });
+
+  return COOMatrix(
+      src_offsets[batch_size], dst_offsets[batch_size],
+      ret_row, ret_col, ret_data,
+      row_sorted, col_sorted);
+}
+
+template COOMatrix DisjointUnionCoo<kDLCPU, int32_t>(const std::vector<COOMatrix>&);
+template COOMatrix DisjointUnionCoo<kDLCPU, int64_t>(const std::vector<COOMatrix>&);
+
+template <DLDeviceType XPU, typename IdType>
+std::vector<COOMatrix> DisjointPartitionCooBySizes(
+    const COOMatrix& coo,
+    const uint64_t batch_size,
+    const std::vector<uint64_t>& edge_cumsum,
+    const std::vector<uint64_t>& src_vertex_cumsum,
+    const std::vector<uint64_t>& dst_vertex_cumsum) {
+  std::vector<int64_t> begins(batch_size), ends(batch_size);
+  std::vector<int64_t> src_shifts(batch_size), dst_shifts(batch_size);
+  for (uint64_t g = 0; g < batch_size; ++g) {
+    begins[g] = edge_cumsum[g];
+    ends[g] = edge_cumsum[g + 1];
+    src_shifts[g] = src_vertex_cumsum[g];
+    dst_shifts[g] = dst_vertex_cumsum[g];
+  }
+
+  const auto rows = SliceAndShift<IdType>(coo.row, begins, ends, src_shifts);
+  const auto cols = SliceAndShift<IdType>(coo.col, begins, ends, dst_shifts);
+  std::vector<IdArray> data(batch_size, NullArray());
+  if (COOHasData(coo))
+    data = SliceAndShift<IdType>(coo.data, begins, ends, begins);
+
+  std::vector<COOMatrix> ret(batch_size);
+  for (uint64_t g = 0; g < batch_size; ++g) {
+    ret[g] = COOMatrix(
+        src_vertex_cumsum[g + 1] - src_vertex_cumsum[g],
+        dst_vertex_cumsum[g + 1] - dst_vertex_cumsum[g],
+        rows[g], cols[g], data[g],
+        coo.row_sorted, coo.col_sorted);
+  }
+  return ret;
+}
+
+template std::vector<COOMatrix> DisjointPartitionCooBySizes<kDLCPU, int32_t>(
+    const COOMatrix&, const uint64_t, const std::vector<uint64_t>&,
+    const std::vector<uint64_t>&, const std::vector<uint64_t>&);
+template std::vector<COOMatrix> DisjointPartitionCooBySizes<kDLCPU, int64_t>(
+    const COOMatrix&, const uint64_t, const std::vector<uint64_t>&,
+    const std::vector<uint64_t>&, const std::vector<uint64_t>&);
+
+///////////////////////////// CSR /////////////////////////////
+
+template <DLDeviceType XPU, typename IdType>
+CSRMatrix DisjointUnionCsr(const std::vector<CSRMatrix>& csrs) {
+  const int64_t batch_size = csrs.size();
+  std::vector<int64_t> edge_offsets(batch_size + 1, 0);
+  std::vector<int64_t> src_offsets(batch_size + 1, 0);
+  std::vector<int64_t> dst_offsets(batch_size + 1, 0);
+  std::vector<const IdType*> indptrs(batch_size), indices(batch_size), data(batch_size, nullptr);
+  bool has_data = false;
+  bool sorted = true;
+  for (int64_t g = 0; g < batch_size; ++g) {
+    const CSRMatrix& csr = csrs[g];
+    edge_offsets[g + 1] = edge_offsets[g] + csr.indices->shape[0];
+    src_offsets[g + 1] = src_offsets[g] + csr.num_rows;
+    dst_offsets[g + 1] = dst_offsets[g] + csr.num_cols;
+    indptrs[g] = csr.indptr.Ptr<IdType>();
+    indices[g] = csr.indices.Ptr<IdType>();
+    if (CSRHasData(csr)) {
+      data[g] = csr.data.Ptr<IdType>();
+      has_data = true;
+    }
+    sorted &= csr.sorted;
+  }
+
+  const int64_t num_rows = src_offsets[batch_size];
+  const int64_t nnz = edge_offsets[batch_size];
+  const DLContext ctx = csrs[0].indptr->ctx;
+  const uint8_t nbits = csrs[0].indptr->dtype.bits;
+  IdArray ret_indptr = NewIdArray(num_rows + 1, ctx, nbits);
+  IdArray ret_indices = NewIdArray(nnz, ctx, nbits);
+  IdArray ret_data = has_data ? NewIdArray(nnz, ctx, nbits) : NullArray();
+  IdType* ret_indptr_data = ret_indptr.Ptr<IdType>();
+  IdType* ret_indices_data = ret_indices.Ptr<IdType>();
+  IdType* ret_data_data = has_data ? ret_data.Ptr<IdType>() : nullptr;
+
+  // the last row pointer of each component is the first one of the next
+  ParallelForSegments(src_offsets, [&](int64_t g, int64_t begin, int64_t end) {
+    const IdType eoff = edge_offsets[g];
+    const int64_t soff = src_offsets[g];
+    for (int64_t i = begin; i < end; ++i)
+      ret_indptr_data[i] = indptrs[g][i - soff] + eoff;
+  });
+  ret_indptr_data[num_rows] = nnz;
+
+  ParallelForSegments(edge_offsets, [&](int64_t g, int64_t begin, int64_t end) {
+    const int64_t eoff = edge_offsets[g];
+    const IdType doff = dst_offsets[g];
+    for (int64_t i = begin; i < end; ++i)
+      ret_indices_data[i] = indices[g][i - eoff] + doff;
+    if (has_data) {
+      // components without a data array number their edges consecutively
+      if (data[g]) {
+        for (int64_t i = begin; i < end; ++i)
+          ret_data_data[i] = data[g][i - eoff] + eoff;
+      } else {
+        for (int64_t i = begin; i < end; ++i)
+          ret_data_data[i] = i;
+      }
+    }
+  });
+
+  return CSRMatrix(
+      num_rows, dst_offsets[batch_size],
+      ret_indptr, ret_indices, ret_data,
+      sorted);
+}
+
+template CSRMatrix DisjointUnionCsr<kDLCPU, int32_t>(const std::vector<CSRMatrix>&);
+template CSRMatrix DisjointUnionCsr<kDLCPU, int64_t>(const std::vector<CSRMatrix>&);
+
+template <DLDeviceType XPU, typename IdType>
+std::vector<CSRMatrix> DisjointPartitionCsrBySizes(
+    const CSRMatrix& csr,
+    const uint64_t batch_size,
+    const std::vector<uint64_t>& edge_cumsum,
+    const std::vector<uint64_t>& src_vertex_cumsum,
+    const std::vector<uint64_t>& dst_vertex_cumsum) {
+  std::vector<int64_t> row_begins(batch_size), row_ends(batch_size);
+  std::vector<int64_t> edge_begins(batch_size), edge_ends(batch_size);
+  std::vector<int64_t> dst_shifts(batch_size);
+  for (uint64_t g = 0; g < batch_size; ++g) {
+    row_begins[g] = src_vertex_cumsum[g];
+    row_ends[g] = src_vertex_cumsum[g + 1] + 1;
+    edge_begins[g] = edge_cumsum[g];
+    edge_ends[g] = edge_cumsum[g + 1];
+    dst_shifts[g] = dst_vertex_cumsum[g];
+  }
+
+  const auto indptrs = SliceAndShift<IdType>(csr.indptr, row_begins, row_ends, edge_begins);
+  const auto indices = SliceAndShift<IdType>(csr.indices, edge_begins, edge_ends, dst_shifts);
+  std::vector<IdArray> data(batch_size, NullArray());
+  if (CSRHasData(csr))
+    data = SliceAndShift<IdType>(csr.data, edge_begins, edge_ends, edge_begins);
+
+  std::vector<CSRMatrix> ret(batch_size);
+  for (uint64_t g = 0; g < batch_size; ++g) {
+    ret[g] = CSRMatrix(
+        src_vertex_cumsum[g + 1] - src_vertex_cumsum[g],
+        dst_vertex_cumsum[g + 1] - dst_vertex_cumsum[g],
+        indptrs[g], indices[g], data[g],
+        csr.sorted);
+  }
+  return ret;
+}
+
+template std::vector<CSRMatrix> DisjointPartitionCsrBySizes<kDLCPU, int32_t>(
+    const CSRMatrix&, const uint64_t, const std::vector<uint64_t>&,
+    const std::vector<uint64_t>&, const std::vector<uint64_t>&);
+template std::vector<CSRMatrix> DisjointPartitionCsrBySizes<kDLCPU, int64_t>(
+    const CSRMatrix&, const uint64_t, const std::vector<uint64_t>&,
+    const std::vector<uint64_t>&, const std::vector<uint64_t>&);
+
+}  // namespace impl
+}  // namespace aten
+}  // namespace dgl
@@ -9,6 +9,7 @@
 #include <dgl/array.h>
 #include <functional>
 #include <algorithm>
+#include <vector>
 
 namespace dgl {
 namespace aten {
@@ -38,15 +39,53 @@ using PickFn = std::function<void(
     const IdxType* col, const IdxType* data,
     IdxType* out_idx)>;
 
+// Set of the data indices (i.e. edge IDs) that must never be picked.
+template <typename IdxType>
+class ExcludedEdges {
+ public:
+  ExcludedEdges() {}
+
+  // The IDs may be given in any order, with duplicates. A null array excludes nothing.
+  explicit ExcludedEdges(IdArray eids) {
+    if (IsNullArray(eids))
+      return;
+    eids = AsNumBits(eids, sizeof(IdxType) * 8);
+    const IdxType* eids_data = static_cast<IdxType*>(eids->data);
+    eids_.assign(eids_data, eids_data + eids->shape[0]);
+    std::sort(eids_.begin(), eids_.end());
+    eids_.erase(std::unique(eids_.begin(), eids_.end()), eids_.end());
+  }
+
+  bool empty() const {
+    return eids_.empty();
+  }
+
+  bool Contains(IdxType eid) const {
+    return std::binary_search(eids_.begin(), eids_.end(), eid);
+  }
+
+ private:
+  std::vector<IdxType> eids_;
+};
+
 // Template for picking non-zero values row-wise. The implementation utilizes
 // OpenMP parallelization on rows because each row performs computation independently.
+//
+// The entries whose data index is in exclude are never passed to pick_fn: the rows
+// having such entries are compacted first, so that the picks are drawn from the other
+// entries and num_picks is still reached whenever the row has enough of them.
+//
+// If row_counts is given, it is set to an int64 array holding the number of entries
+// picked from each of the given rows.
 template <typename IdxType>
 COOMatrix CSRRowWisePick(CSRMatrix mat, IdArray rows,
-                         int64_t num_picks, bool replace, PickFn<IdxType> pick_fn) {
+                         int64_t num_picks, bool replace, PickFn<IdxType> pick_fn,
+                         const ExcludedEdges<IdxType>& exclude = ExcludedEdges<IdxType>(),
+                         IdArray* row_counts = nullptr) {
   using namespace aten;
   const IdxType* indptr = static_cast<IdxType*>(mat.indptr->data);
-  const IdxType* indices = static_cast<IdxType*>(mat.indices->data);
-  const IdxType* data = CSRHasData(mat)? static_cast<IdxType*>(mat.data->data) : nullptr;
+  const IdxType* mat_indices = static_cast<IdxType*>(mat.indices->data);
+  const IdxType* mat_data = CSRHasData(mat)? static_cast<IdxType*>(mat.data->data) : nullptr;
   const IdxType* rows_data = static_cast<IdxType*>(rows->data);
   const int64_t num_rows = rows->shape[0];
   const auto& ctx = mat.indptr->ctx;
@@ -72,8 +111,14 @@ COOMatrix CSRRowWisePick(CSRMatrix mat, IdArray rows,
   IdxType* picked_rdata = static_cast<IdxType*>(picked_row->data);
   IdxType* picked_cdata = static_cast<IdxType*>(picked_col->data);
   IdxType* picked_idata = static_cast<IdxType*>(picked_idx->data);
+  int64_t* counts_data = nullptr;
+  if (row_counts) {
+    *row_counts = NewIdArray(num_rows, ctx, 64);
+    counts_data = static_cast<int64_t*>((*row_counts)->data);
+  }
 
-  bool all_has_fanout = true;
+  // Excluded entries may leave any row short of num_picks.
+  bool all_has_fanout = exclude.empty();
 #pragma omp parallel for reduction(&&:all_has_fanout)
   for (int64_t i = 0; i < num_rows; ++i) {
     const IdxType rid = rows_data[i];
@@ -83,31 +128,63 @@ COOMatrix CSRRowWisePick(CSRMatrix mat, IdArray rows,
     all_has_fanout = all_has_fanout && (len >= (replace ? 1 : num_picks));
   }
 
-#pragma omp parallel for
-  for (int64_t i = 0; i < num_rows; ++i) {
-    const IdxType rid = rows_data[i];
-    CHECK_LT(rid, mat.num_rows);
-    const IdxType off = indptr[rid];
-    const IdxType len = indptr[rid + 1] - off;
-    if (len == 0)
-      continue;
-
-    if (len <= num_picks && !replace) {
-      // nnz <= num_picks and w/o replacement, take all nnz
-      for (int64_t j = 0; j < len; ++j) {
-        picked_rdata[i * num_picks + j] = rid;
-        picked_cdata[i * num_picks + j] = indices[off + j];
-        picked_idata[i * num_picks + j] = data? data[off + j] : off + j;
+#pragma omp parallel
+  {
+    // Entries of the current row that are not excluded, reused across the rows.
+    std::vector<IdxType> kept_indices, kept_data;
+#pragma omp for
+    for (int64_t i = 0; i < num_rows; ++i) {
+      const IdxType rid = rows_data[i];
+      CHECK_LT(rid, mat.num_rows);
+      IdxType off = indptr[rid];
+      IdxType len = indptr[rid + 1] - off;
+      const IdxType* indices = mat_indices;
+      const IdxType* data = mat_data;
+      if (!exclude.empty()) {
+        // Only copy the row once an excluded entry is found.
+        IdxType j = off;
+        while (j < off + len && !exclude.Contains(data? data[j] : j))
+          ++j;
+        if (j < off + len) {
+          kept_indices.assign(indices + off, indices + j);
+          kept_data.clear();
+          for (IdxType k = off; k < j; ++k)
+            kept_data.push_back(data? data[k] : k);
+          for (++j; j < off + len; ++j) {
+            const IdxType eid = data? data[j] : j;
+            if (!exclude.Contains(eid)) {
+              kept_indices.push_back(indices[j]);
+              kept_data.push_back(eid);
+            }
+          }
+          off = 0;
+          len = kept_data.size();
+          indices = kept_indices.data();
+          data = kept_data.data();
+        }
       }
-    } else {
-      pick_fn(rid, off, len,
-              indices, data,
-              picked_idata + i * num_picks);
-      for (int64_t j = 0; j < num_picks; ++j) {
-        const IdxType picked = picked_idata[i * num_picks + j];
-        picked_rdata[i * num_picks + j] = rid;
-        picked_cdata[i * num_picks + j] = indices[picked];
-        picked_idata[i * num_picks + j] = data? data[picked] : picked;
+      if (counts_data)
+        counts_data[i] = (len == 0)? 0 : (len <= num_picks && !replace)? len : num_picks;
+      if (len == 0)
+        continue;
+
+      if (len <= num_picks && !replace) {
+        // nnz <= num_picks and w/o replacement, take all nnz
+        for (int64_t j = 0; j < len; ++j) {
+          picked_rdata[i * num_picks + j] = rid;
+          picked_cdata[i * num_picks + j] = indices[off + j];
+          picked_idata[i * num_picks + j] = data? data[off + j] : off + j;
+        }
+      } else {
+        pick_fn(rid, off, len,
+                indices, data,
+                picked_idata + i * num_picks);
+        for (int64_t j = 0; j < num_picks; ++j) {
+          const IdxType picked = picked_idata[i * num_picks + j];
+          picked_rdata[i * num_picks + j] = rid;
+          picked_cdata[i * num_picks + j] = indices[picked];
+          picked_idata[i * num_picks + j] = data? data[picked] : picked;
+        }
       }
     }
   }
@@ -137,11 +214,13 @@ COOMatrix CSRRowWisePick(CSRMatrix mat, IdArray rows,
 // row-wise pick on the CSR matrix and rectifies the returned results.
 template <typename IdxType>
 COOMatrix COORowWisePick(COOMatrix mat, IdArray rows,
-                         int64_t num_picks, bool replace, PickFn<IdxType> pick_fn) {
+                         int64_t num_picks, bool replace, PickFn<IdxType> pick_fn,
+                         const ExcludedEdges<IdxType>& exclude = ExcludedEdges<IdxType>()) {
   using namespace aten;
   const auto& csr = COOToCSR(COOSliceRows(mat, rows));
   const IdArray new_rows = Range(0, rows->shape[0], rows->dtype.bits, rows->ctx);
-  const auto& picked = CSRRowWisePick<IdxType>(csr, new_rows, num_picks, replace, pick_fn);
+  const auto& picked = CSRRowWisePick<IdxType>(
+      csr, new_rows, num_picks, replace, pick_fn, exclude);
   return COOMatrix(mat.num_rows, mat.num_cols,
                    IndexSelect(rows, picked.row),  // map the row index to the correct one
                    picked.col,
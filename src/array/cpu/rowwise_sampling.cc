@@ -65,63 +65,69 @@ inline PickFn<IdxType> GetSamplingUniformPickFn(
 
 template <DLDeviceType XPU, typename IdxType, typename FloatType>
 COOMatrix CSRRowWiseSampling(CSRMatrix mat, IdArray rows, int64_t num_samples,
-                             FloatArray prob, bool replace) {
+                             FloatArray prob, bool replace, IdArray exclude,
+                             IdArray* row_counts) {
   CHECK(prob.defined());
   auto pick_fn = GetSamplingPickFn<IdxType, FloatType>(num_samples, prob, replace);
-  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn);
+  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn,
+                        ExcludedEdges<IdxType>(exclude), row_counts);
 }
 
 template COOMatrix CSRRowWiseSampling<kDLCPU, int32_t, float>(
-    CSRMatrix, IdArray, int64_t, FloatArray, bool);
+    CSRMatrix, IdArray, int64_t, FloatArray, bool, IdArray, IdArray*);
 template COOMatrix CSRRowWiseSampling<kDLCPU, int64_t, float>(
-    CSRMatrix, IdArray, int64_t, FloatArray, bool);
+    CSRMatrix, IdArray, int64_t, FloatArray, bool, IdArray, IdArray*);
 template COOMatrix CSRRowWiseSampling<kDLCPU, int32_t, double>(
-    CSRMatrix, IdArray, int64_t, FloatArray, bool);
+    CSRMatrix, IdArray, int64_t, FloatArray, bool, IdArray, IdArray*);
 template COOMatrix CSRRowWiseSampling<kDLCPU, int64_t, double>(
-    CSRMatrix, IdArray, int64_t, FloatArray, bool);
+    CSRMatrix, IdArray, int64_t, FloatArray, bool, IdArray, IdArray*);
 
 template <DLDeviceType XPU, typename IdxType>
 COOMatrix CSRRowWiseSamplingUniform(CSRMatrix mat, IdArray rows,
-                                    int64_t num_samples, bool replace) {
+                                    int64_t num_samples, bool replace, IdArray exclude,
+                                    IdArray* row_counts) {
   auto pick_fn = GetSamplingUniformPickFn<IdxType>(num_samples, replace);
-  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn);
+  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn,
+                        ExcludedEdges<IdxType>(exclude), row_counts);
 }
 
 template COOMatrix CSRRowWiseSamplingUniform<kDLCPU, int32_t>(
-    CSRMatrix, IdArray, int64_t, bool);
+    CSRMatrix, IdArray, int64_t, bool, IdArray, IdArray*);
 template COOMatrix CSRRowWiseSamplingUniform<kDLCPU, int64_t>(
-    CSRMatrix, IdArray, int64_t, bool);
+    CSRMatrix, IdArray, int64_t, bool, IdArray, IdArray*);
 
 /////////////////////////////// COO ///////////////////////////////
 
 template <DLDeviceType XPU, typename IdxType, typename FloatType>
 COOMatrix COORowWiseSampling(COOMatrix mat, IdArray rows, int64_t num_samples,
-                             FloatArray prob, bool replace) {
+                             FloatArray prob, bool replace, IdArray exclude) {
   CHECK(prob.defined());
   auto pick_fn = GetSamplingPickFn<IdxType, FloatType>(num_samples, prob, replace);
-  return COORowWisePick(mat, rows, num_samples, replace, pick_fn);
+  return COORowWisePick(mat, rows, num_samples, replace, pick_fn,
+                        ExcludedEdges<IdxType>(exclude));
 }
 
 template COOMatrix COORowWiseSampling<kDLCPU, int32_t, float>(
-    COOMatrix, IdArray, int64_t, FloatArray, bool);
+    COOMatrix, IdArray, int64_t, FloatArray, bool, IdArray);
 template COOMatrix COORowWiseSampling<kDLCPU, int64_t, float>(
-    COOMatrix, IdArray, int64_t, FloatArray, bool);
+    COOMatrix, IdArray, int64_t, FloatArray, bool, IdArray);
 template COOMatrix COORowWiseSampling<kDLCPU, int32_t, double>(
-    COOMatrix, IdArray, int64_t, FloatArray, bool);
+    COOMatrix, IdArray, int64_t, FloatArray, bool, IdArray);
 template COOMatrix COORowWiseSampling<kDLCPU, int64_t, double>(
-    COOMatrix, IdArray, int64_t, FloatArray, bool);
+    COOMatrix, IdArray, int64_t, FloatArray, bool, IdArray);
 
 template <DLDeviceType XPU, typename IdxType>
 COOMatrix COORowWiseSamplingUniform(COOMatrix mat, IdArray rows,
-                                    int64_t num_samples, bool replace) {
+                                    int64_t num_samples, bool replace, IdArray exclude) {
   auto pick_fn = GetSamplingUniformPickFn<IdxType>(num_samples, replace);
-  return COORowWisePick(mat, rows, num_samples, replace, pick_fn);
+  return COORowWisePick(mat, rows, num_samples, replace, pick_fn,
+                        ExcludedEdges<IdxType>(exclude));
 }
 
 template COOMatrix COORowWiseSamplingUniform<kDLCPU, int32_t>(
-    COOMatrix, IdArray, int64_t, bool);
+    COOMatrix, IdArray, int64_t, bool, IdArray);
 template COOMatrix COORowWiseSamplingUniform<kDLCPU, int64_t>(
-    COOMatrix, IdArray, int64_t, bool);
+    COOMatrix, IdArray, int64_t, bool, IdArray);
 
 }  // namespace impl
 }  // namespace aten
@@ -54,7 +54,11 @@ void SDDMMCsr(const std::string& op,
               int rhs_target) {
   SWITCH_OP(op, Op, {
     SWITCH_TARGET(lhs_target, rhs_target, LhsTarget, RhsTarget, {
-      cpu::SDDMMCsr<IdType, DType, Op, LhsTarget, RhsTarget>(bcast, csr, lhs, rhs, out);
+      if (bcast.use_bcast) {
+        cpu::SDDMMCsr<IdType, DType, Op, LhsTarget, RhsTarget, true>(bcast, csr, lhs, rhs, out);
+      } else {
+        cpu::SDDMMCsr<IdType, DType, Op, LhsTarget, RhsTarget, false>(bcast, csr, lhs, rhs, out);
+      }
     });
   });
 }
@@ -88,7 +92,11 @@ void SDDMMCoo(const std::string& op,
               int rhs_target) {
   SWITCH_OP(op, Op, {
     SWITCH_TARGET(lhs_target, rhs_target, LhsTarget, RhsTarget, {
-      cpu::SDDMMCoo<IdType, DType, Op, LhsTarget, RhsTarget>(bcast, coo, lhs, rhs, out);
+      if (bcast.use_bcast) {
+        cpu::SDDMMCoo<IdType, DType, Op, LhsTarget, RhsTarget, true>(bcast, coo, lhs, rhs, out);
+      } else {
+        cpu::SDDMMCoo<IdType, DType, Op, LhsTarget, RhsTarget, false>(bcast, coo, lhs, rhs, out);
+      }
     });
   });
 }
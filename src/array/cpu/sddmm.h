@@ -8,12 +8,68 @@
 
 #include <dgl/array.h>
 #include <dgl/bcast.h>
+#include <algorithm>
 #include "../selector.h"
 
 namespace dgl {
 namespace aten {
 namespace cpu {
 
+/*! \brief Number of edges ahead whose operand rows are prefetched. */
+constexpr int64_t kSDDMMPrefetchDistance = 8;
+/*! \brief Maximal number of cache lines prefetched per operand row. */
+constexpr int64_t kSDDMMPrefetchLines = 8;
+/*! \brief Number of consecutive edges assigned to a thread at a time in COO. */
+constexpr int64_t kSDDMMEdgeBlock = 256;
+
+/*!
+ * \brief Hint the CPU to fetch the beginning of a feature row into cache.
+ * \param row The feature row.
+ * \param len The number of elements in the row.
+ */
+template <typename DType>
+inline void PrefetchRow(const DType* row, int64_t len) {
+#if defined(__GNUC__) || defined(__clang__)
+  constexpr int64_t kLine = 64 / sizeof(DType) > 0 ? 64 / sizeof(DType) : 1;
+  const int64_t end = std::min(len, kLine * kSDDMMPrefetchLines);
+  for (int64_t i = 0; i < end; i += kLine)
+    __builtin_prefetch(row + i, 0, 1);
+#endif
+}
+
+/*!
+ * \brief Compute the SDDMM result of one edge.
+ * \param bcast Broadcast information.
+ * \param lhs_row The lhs feature row of the edge, nullptr if not used by the op.
+ * \param rhs_row The rhs feature row of the edge, nullptr if not used by the op.
+ * \param out_row The output feature row of the edge.
+ * \note The broadcast case is a separate instantiation, so the common case
+ *       without broadcasting walks both operands contiguously and the loop
+ *       is free of offset lookups.
+ */
+template <typename DType, typename Op, bool UseBcast>
+inline void SDDMMEdge(const BcastOff& bcast,
+                      const DType* lhs_row, const DType* rhs_row, DType* out_row) {
+  const int64_t dim = bcast.out_len, reduce_size = bcast.reduce_size;
+  if (UseBcast) {
+    const int64_t* lhs_offset = bcast.lhs_offset.data();
+    const int64_t* rhs_offset = bcast.rhs_offset.data();
+    for (int64_t k = 0; k < dim; ++k) {
+      out_row[k] = Op::Call(
+          Op::use_lhs ? lhs_row + lhs_offset[k] * reduce_size : nullptr,
+          Op::use_rhs ? rhs_row + rhs_offset[k] * reduce_size : nullptr,
+          reduce_size);
+    }
+  } else {
+    for (int64_t k = 0; k < dim; ++k) {
+      out_row[k] = Op::Call(
+          Op::use_lhs ? lhs_row + k * reduce_size : nullptr,
+          Op::use_rhs ? rhs_row + k * reduce_size : nullptr,
+          reduce_size);
+    }
+  }
+}
+
 /*!
  * \brief CPU kernel of g-SDDMM on Csr format.
  * \param bcast Broadcast information.
@@ -22,10 +78,11 @@ namespace cpu {
  * \param rhs The right hand size operand feature.
  * \param out The result feature on edges.
  * \note it uses node parallel strategy, different threads are responsible
- *       for the computation of different nodes.
+ *       for the computation of different nodes. The operand rows of the
+ *       edge kSDDMMPrefetchDistance positions ahead in the row are prefetched.
  */
 template <typename IdType, typename DType, typename Op,
-          int LhsTarget = 0, int RhsTarget = 2>
+          int LhsTarget = 0, int RhsTarget = 2, bool UseBcast = false>
 void SDDMMCsr(const BcastOff& bcast,
               const CSRMatrix& csr,
               NDArray lhs, NDArray rhs, NDArray out) {
@@ -37,25 +94,28 @@ void SDDMMCsr(const BcastOff& bcast,
   const DType* Y = rhs.Ptr<DType>();
   const int64_t dim = bcast.out_len,
                 lhs_dim = bcast.lhs_len,
-                rhs_dim = bcast.rhs_len,
-                reduce_size = bcast.reduce_size;
+                rhs_dim = bcast.rhs_len;
   DType* O = out.Ptr<DType>();
 #pragma omp parallel for
   for (IdType rid = 0; rid < csr.num_rows; ++rid) {
     const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
     for (IdType j = row_start; j < row_end; ++j) {
-      const IdType cid = indices[j];
-      const IdType eid = has_idx? edges[j] : j;
-      DType* out_off = O + eid * dim;
-      for (int64_t k = 0; k < dim; ++k) {
-        const int64_t lhs_add = bcast.use_bcast ? bcast.lhs_offset[k] : k;
-        const int64_t rhs_add = bcast.use_bcast ? bcast.rhs_offset[k] : k;
-        const DType* lhs_off = Op::use_lhs?
-          X + Selector<LhsTarget>::Call(rid, eid, cid) * lhs_dim + lhs_add * reduce_size : nullptr;
-        const DType* rhs_off = Op::use_rhs?
-          Y + Selector<RhsTarget>::Call(rid, eid, cid) * rhs_dim + rhs_add * reduce_size : nullptr;
-        out_off[k] = Op::Call(lhs_off, rhs_off, reduce_size);
+      const int64_t pj = j + kSDDMMPrefetchDistance;
+      if (pj < row_end) {
+        const IdType pcid = indices[pj];
+        const IdType peid = has_idx ? edges[pj] : static_cast<IdType>(pj);
+        if (Op::use_lhs && LhsTarget != 0)
+          PrefetchRow(X + Selector<LhsTarget>::Call(rid, peid, pcid) * lhs_dim, lhs_dim);
+        if (Op::use_rhs && RhsTarget != 0)
+          PrefetchRow(Y + Selector<RhsTarget>::Call(rid, peid, pcid) * rhs_dim, rhs_dim);
       }
+      const IdType cid = indices[j];
+      const IdType eid = has_idx ? edges[j] : j;
+      SDDMMEdge<DType, Op, UseBcast>(
+          bcast,
+          Op::use_lhs ? X + Selector<LhsTarget>::Call(rid, eid, cid) * lhs_dim : nullptr,
+          Op::use_rhs ? Y + Selector<RhsTarget>::Call(rid, eid, cid) * rhs_dim : nullptr,
+          O + eid * dim);
     }
   }
 }
@@ -68,10 +128,12 @@ void SDDMMCsr(const BcastOff& bcast,
  * \param rhs The right hand size operand feature.
  * \param out The result feature on edges.
  * \note it uses edge parallel strategy, different threads are responsible
- *       for the computation of different edges.
+ *       for the computation of different blocks of kSDDMMEdgeBlock edges.
+ *       The operand rows of the edge kSDDMMPrefetchDistance positions ahead
+ *       in the block are prefetched.
  */
 template <typename IdType, typename DType, typename Op,
-          int LhsTarget = 0, int RhsTarget = 2>
+          int LhsTarget = 0, int RhsTarget = 2, bool UseBcast = false>
 void SDDMMCoo(const BcastOff& bcast,
               const COOMatrix& coo,
               NDArray lhs, NDArray rhs, NDArray out) {
@@ -83,24 +145,32 @@ void SDDMMCoo(const BcastOff& bcast,
   const DType* Y = rhs.Ptr<DType>();
   const int64_t dim = bcast.out_len,
                 lhs_dim = bcast.lhs_len,
-                rhs_dim = bcast.rhs_len,
-                reduce_size = bcast.reduce_size;
+                rhs_dim = bcast.rhs_len;
   DType* O = out.Ptr<DType>();
   const int64_t nnz = coo.row->shape[0];
+  const int64_t num_blocks = (nnz + kSDDMMEdgeBlock - 1) / kSDDMMEdgeBlock;
 #pragma omp parallel for
-  for (IdType i = 0; i < nnz; ++i) {
-    const IdType rid = row[i];
-    const IdType cid = col[i];
-    const IdType eid = has_idx? edges[i] : i;
-    DType* out_off = O + eid * dim;
-    for (int64_t k = 0; k < dim; ++k) {
-      const int64_t lhs_add = bcast.use_bcast ? bcast.lhs_offset[k] : k;
-      const int64_t rhs_add = bcast.use_bcast ? bcast.rhs_offset[k] : k;
-      const DType* lhs_off = Op::use_lhs ?
-        X + Selector<LhsTarget>::Call(rid, eid, cid) * lhs_dim + lhs_add * reduce_size : nullptr;
-      const DType* rhs_off = Op::use_rhs ?
-        Y + Selector<RhsTarget>::Call(rid, eid, cid) * rhs_dim + rhs_add * reduce_size : nullptr;
-      out_off[k] = Op::Call(lhs_off, rhs_off, bcast.reduce_size);
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    const int64_t block_start = b * kSDDMMEdgeBlock;
+    const int64_t block_end = std::min(nnz, block_start + kSDDMMEdgeBlock);
+    for (int64_t i = block_start; i < block_end; ++i) {
+      const int64_t pi = i + kSDDMMPrefetchDistance;
+      if (pi < block_end) {
+        const IdType prid = row[pi], pcid = col[pi];
+        const IdType peid = has_idx ? edges[pi] : static_cast<IdType>(pi);
+        if (Op::use_lhs)
+          PrefetchRow(X + Selector<LhsTarget>::Call(prid, peid, pcid) * lhs_dim, lhs_dim);
+        if (Op::use_rhs)
+          PrefetchRow(Y + Selector<RhsTarget>::Call(prid, peid, pcid) * rhs_dim, rhs_dim);
+      }
+      const IdType rid = row[i];
+      const IdType cid = col[i];
+      const IdType eid = has_idx ? edges[i] : static_cast<IdType>(i);
+      SDDMMEdge<DType, Op, UseBcast>(
+          bcast,
+          Op::use_lhs ? X + Selector<LhsTarget>::Call(rid, eid, cid) * lhs_dim : nullptr,
+          Op::use_rhs ? Y + Selector<RhsTarget>::Call(rid, eid, cid) * rhs_dim : nullptr,
+          O + eid * dim);
     }
   }
 }
@@ -168,6 +238,9 @@ struct Dot {
   static constexpr bool use_rhs = true;
   inline static DType Call(const DType* lhs_off, const DType* rhs_off, int64_t len = 1) {
     DType rst = 0;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd reduction(+:rst)
+#endif
     for (int64_t l = 0; l < len; ++l) {
       rst += lhs_off[l] * rhs_off[l];
     }
@@ -0,0 +1,97 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file array/cpu/segment_reduce.cc
+ * \brief Segment reduce and segment softmax C APIs and definitions.
+ */
+#include "./segment_reduce.h"
+#include <dgl/array.h>
+#include <string>
+
+namespace dgl {
+namespace aten {
+
+/*! \brief Segment reduce. */
+template <int XPU, typename IdType, typename DType>
+void SegmentReduce(const std::string& op,
+                   NDArray feat,
+                   NDArray offsets,
+                   NDArray out,
+                   NDArray arg) {
+  if (op == "sum" || op == "mean") {
+    cpu::SegmentSum<IdType, DType>(feat, offsets, out, op == "mean");
+  } else if (op == "max") {
+    cpu::SegmentCmp<IdType, DType, true>(feat, offsets, out, arg);
+  } else if (op == "min") {
+    cpu::SegmentCmp<IdType, DType, false>(feat, offsets, out, arg);
+  } else {
+    LOG(FATAL) << "Unsupported segment reducer: " << op;
+  }
+}
+
+/*! \brief Backward of segment reduce. */
+template <int XPU, typename IdType, typename DType>
+void BackwardSegmentReduce(const std::string& op,
+                           NDArray grad,
+                           NDArray offsets,
+                           NDArray arg,
+                           NDArray out) {
+  if (op == "sum" || op == "mean") {
+    cpu::BackwardSegmentReduce<IdType, DType>(grad, offsets, NullArray(), out, op == "mean");
+  } else if (op == "max" || op == "min") {
+    CHECK(!IsNullArray(arg)) << "Expect the arg of segment " << op;
+    cpu::BackwardSegmentReduce<IdType, DType>(grad, offsets, arg, out, false);
+  } else {
+    LOG(FATAL) << "Unsupported segment reducer: " << op;
+  }
+}
+
+/*! \brief Segment softmax. */
+template <int XPU, typename IdType, typename DType>
+void SegmentSoftmax(NDArray feat, NDArray offsets, NDArray out) {
+  cpu::SegmentSoftmax<IdType, DType>(feat, offsets, out);
+}
+
+/*! \brief Backward of segment softmax. */
+template <int XPU, typename IdType, typename DType>
+void BackwardSegmentSoftmax(NDArray out, NDArray grad, NDArray offsets, NDArray ret) {
+  cpu::BackwardSegmentSoftmax<IdType, DType>(out, grad, offsets, ret);
+}
+
+template void SegmentReduce<kDLCPU, int32_t, float>(
+    const std::string& op, NDArray feat, NDArray offsets, NDArray out, NDArray arg);
+template void SegmentReduce<kDLCPU, int64_t, float>(
+    const std::string& op, NDArray feat, NDArray offsets, NDArray out, NDArray arg);
+template void SegmentReduce<kDLCPU, int32_t, double>(
+    const std::string& op, NDArray feat, NDArray offsets, NDArray out, NDArray arg);
+template void SegmentReduce<kDLCPU, int64_t, double>(
+    const std::string& op, NDArray feat, NDArray offsets, NDArray out, NDArray arg);
+
+template void BackwardSegmentReduce<kDLCPU, int32_t, float>(
+    const std::string& op, NDArray grad, NDArray offsets, NDArray arg, NDArray out);
+template void BackwardSegmentReduce<kDLCPU, int64_t, float>(
+    const std::string& op, NDArray grad, NDArray offsets, NDArray arg, NDArray out);
+template void BackwardSegmentReduce<kDLCPU, int32_t, double>(
+    const std::string& op, NDArray grad, NDArray offsets, NDArray arg, NDArray out);
+template void BackwardSegmentReduce<kDLCPU, int64_t, double>(
+    const std::string& op, NDArray grad, NDArray offsets, NDArray arg, NDArray out);
+
+template void SegmentSoftmax<kDLCPU, int32_t, float>(
+    NDArray feat, NDArray offsets, NDArray out);
+template void SegmentSoftmax<kDLCPU, int64_t, float>(
+    NDArray feat, NDArray offsets, NDArray out);
+template void SegmentSoftmax<kDLCPU, int32_t, double>(
+    NDArray feat, NDArray offsets, NDArray out);
+template void SegmentSoftmax<kDLCPU, int64_t, double>(
+    NDArray feat, NDArray offsets, NDArray out);
+
+template void BackwardSegmentSoftmax<kDLCPU, int32_t, float>(
+    NDArray out, NDArray grad, NDArray offsets, NDArray ret);
+template void BackwardSegmentSoftmax<kDLCPU, int64_t, float>(
+    NDArray out, NDArray grad, NDArray offsets, NDArray ret);
+template void BackwardSegmentSoftmax<kDLCPU, int32_t, double>(
+    NDArray out, NDArray grad, NDArray offsets, NDArray ret);
+template void BackwardSegmentSoftmax<kDLCPU, int64_t, double>(
+    NDArray out, NDArray grad, NDArray offsets, NDArray ret);
+
+}  // namespace aten
+}  // namespace dgl
@@ -0,0 +1,279 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file array/cpu/segment_reduce.h
+ * \brief Segment reduce and segment softmax CPU kernel function header.
+ */
+#ifndef DGL_ARRAY_CPU_SEGMENT_REDUCE_H_
+#define DGL_ARRAY_CPU_SEGMENT_REDUCE_H_
+
+#include <dgl/array.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace dgl {
+namespace aten {
+namespace cpu {
+
+// Segments usually have very different lengths (e.g. graphs in a batch, or the
+// in-degrees of a power-law graph), so they are handed out to the threads
+// dynamically in chunks of this many segments.
+constexpr int kSegmentChunk = 16;
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define DGL_SEGMENT_SIMD _Pragma("omp simd")
+#else
+#define DGL_SEGMENT_SIMD
+#endif
+
+/*! \brief Return the feature size of every row of the given array. */
+inline int64_t RowSize(NDArray arr) {
+  return arr->shape[0] ? arr.NumElements() / arr->shape[0] : 0;
+}
+
+/*!
+ * \brief Check that the offsets never decrease and cover all the rows of the
+ *        feature, so that every segment lies within the feature.
+ */
+template <typename IdType>
+inline void CheckOffsets(NDArray offsets, int64_t num_rows) {
+  const IdType* off = offsets.Ptr<IdType>();
+  const int64_t n = offsets->shape[0] - 1;
+  CHECK_GE(n, 0) << "Expect offsets to have at least one element";
+  CHECK_EQ(off[0], 0) << "Expect offsets to start from 0";
+  CHECK_EQ(off[n], num_rows)
+    << "Expect the last element of offsets to be the number of rows " << num_rows;
+  bool sorted = true;
+#pragma omp parallel for reduction(&&:sorted)
+  for (int64_t i = 0; i < n; ++i)
+    sorted = sorted && off[i] <= off[i + 1];
+  CHECK(sorted) << "Expect offsets to be non-decreasing";
+}
+
+/*!
+ * \brief CPU kernel of segment sum/mean.
+ * \param feat The input feature, whose rows are grouped into segments.
+ * \param offsets The offsets of the segments, of length num_segments + 1.
+ * \param out The result feature with one row per segment.
+ * \param mean Whether to divide the sum by the segment length.
+ * \note Every segment is reduced by a single thread, so no atomic operations are
+ *       needed. Empty segments are filled with zeros.
+ */
+template <typename IdType, typename DType>
+void SegmentSum(NDArray feat, NDArray offsets, NDArray out, bool mean) {
+  const int64_t n = out->shape[0];
+  const int64_t dim = RowSize(out);
+  const IdType* off = offsets.Ptr<IdType>();
+  const DType* X = feat.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  CheckOffsets<IdType>(offsets, feat->shape[0]);
+#pragma omp parallel for schedule(dynamic, kSegmentChunk)
+  for (int64_t i = 0; i < n; ++i) {
+    DType* out_off = O + i * dim;
+    std::fill(out_off, out_off + dim, static_cast<DType>(0));
+    for (IdType j = off[i]; j < off[i + 1]; ++j) {
+      const DType* x_off = X + j * dim;
+      DGL_SEGMENT_SIMD
+      for (int64_t k = 0; k < dim; ++k)
+        out_off[k] += x_off[k];
+    }
+    if (mean && off[i + 1] > off[i]) {
+      const DType scale = static_cast<DType>(1) / (off[i + 1] - off[i]);
+      DGL_SEGMENT_SIMD
+      for (int64_t k = 0; k < dim; ++k)
+        out_off[k] *= scale;
+    }
+  }
+}
+
+/*!
+ * \brief CPU kernel of segment max/min.
+ * \param feat The input feature, whose rows are grouped into segments.
+ * \param offsets The offsets of the segments, of length num_segments + 1.
+ * \param out The result feature with one row per segment.
+ * \param arg The row of the input feature that every element of the result is
+ *        taken from, in the shape of the result.
+ * \note Empty segments are filled with zeros and their arg is -1.
+ */
+template <typename IdType, typename DType, bool IsMax>
+void SegmentCmp(NDArray feat, NDArray offsets, NDArray out, NDArray arg) {
+  const int64_t n = out->shape[0];
+  const int64_t dim = RowSize(out);
+  const IdType* off = offsets.Ptr<IdType>();
+  const DType* X = feat.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  IdType* A = arg.Ptr<IdType>();
+  CheckOffsets<IdType>(offsets, feat->shape[0]);
+#pragma omp parallel for schedule(dynamic, kSegmentChunk)
+  for (int64_t i = 0; i < n; ++i) {
+    DType* out_off = O + i * dim;
+    IdType* arg_off = A + i * dim;
+    if (off[i] == off[i + 1]) {
+      std::fill(out_off, out_off + dim, static_cast<DType>(0));
+      std::fill(arg_off, arg_off + dim, static_cast<IdType>(-1));
+      continue;
+    }
+    std::copy(X + off[i] * dim, X + (off[i] + 1) * dim, out_off);
+    std::fill(arg_off, arg_off + dim, off[i]);
+    for (IdType j = off[i] + 1; j < off[i + 1]; ++j) {
+      const DType* x_off = X + j * dim;
+      DGL_SEGMENT_SIMD
+      for (int64_t k = 0; k < dim; ++k) {
+        const bool better = IsMax ? (x_off[k] > out_off[k]) : (x_off[k] < out_off[k]);
+        out_off[k] = better ? x_off[k] : out_off[k];
+        arg_off[k] = better ? j : arg_off[k];
+      }
+    }
+  }
+}
+
+/*!
+ * \brief CPU kernel of the backward of segment reduce.
+ * \param grad The gradient of the result, with one row per segment.
+ * \param offsets The offsets of the segments.
+ * \param arg The arg of the forward pass for max/min, or a null array for sum/mean.
+ * \param out The gradient of the input feature.
+ * \param mean Whether the forward pass is segment mean.
+ * \note Every row of the input belongs to exactly one segment, so each element
+ *       of the output is written by exactly one thread.
+ */
+template <typename IdType, typename DType>
+void BackwardSegmentReduce(NDArray grad, NDArray offsets, NDArray arg,
+                           NDArray out, bool mean) {
+  const int64_t n = grad->shape[0];
+  const int64_t dim = RowSize(grad);
+  const bool use_arg = !IsNullArray(arg);
+  const IdType* off = offsets.Ptr<IdType>();
+  const IdType* A = use_arg ? arg.Ptr<IdType>() : nullptr;
+  const DType* G = grad.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  CheckOffsets<IdType>(offsets, out->shape[0]);
+#pragma omp parallel for schedule(dynamic, kSegmentChunk)
+  for (int64_t i = 0; i < n; ++i) {
+    const DType* grad_off = G + i * dim;
+    if (use_arg) {
+      std::fill(O + off[i] * dim, O + off[i + 1] * dim, static_cast<DType>(0));
+      const IdType* arg_off = A + i * dim;
+      for (int64_t k = 0; k < dim; ++k) {
+        if (arg_off[k] >= 0)
+          O[arg_off[k] * dim + k] = grad_off[k];
+      }
+    } else {
+      const DType scale = (mean && off[i + 1] > off[i]) ?
+        static_cast<DType>(1) / (off[i + 1] - off[i]) : static_cast<DType>(1);
+      for (IdType j = off[i]; j < off[i + 1]; ++j) {
+        DType* out_off = O + j * dim;
+        DGL_SEGMENT_SIMD
+        for (int64_t k = 0; k < dim; ++k)
+          out_off[k] = grad_off[k] * scale;
+      }
+    }
+  }
+}
+
+/*!
+ * \brief CPU kernel of segment softmax.
+ * \param feat The input feature, whose rows are grouped into segments.
+ * \param offsets The offsets of the segments.
+ * \param out The result, in the shape of the input feature.
+ * \note Each segment is normalized by a single thread with the running maximum
+ *       kept in a per-thread buffer.
+ */
+template <typename IdType, typename DType>
+void SegmentSoftmax(NDArray feat, NDArray offsets, NDArray out) {
+  const int64_t n = offsets->shape[0] - 1;
+  const int64_t dim = RowSize(feat);
+  const IdType* off = offsets.Ptr<IdType>();
+  const DType* X = feat.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  CheckOffsets<IdType>(offsets, feat->shape[0]);
+#pragma omp parallel
+  {
+    std::vector<DType> buf(2 * dim);
+    DType* max_val = buf.data();
+    DType* sum_val = buf.data() + dim;
+#pragma omp for schedule(dynamic, kSegmentChunk)
+    for (int64_t i = 0; i < n; ++i) {
+      if (off[i] == off[i + 1])
+        continue;
+      std::fill(max_val, max_val + dim, -std::numeric_limits<DType>::infinity());
+      std::fill(sum_val, sum_val + dim, static_cast<DType>(0));
+      for (IdType j = off[i]; j < off[i + 1]; ++j) {
+        const DType* x_off = X + j * dim;
+        DGL_SEGMENT_SIMD
+        for (int64_t k = 0; k < dim; ++k)
+          max_val[k] = std::max(max_val[k], x_off[k]);
+      }
+      for (IdType j = off[i]; j < off[i + 1]; ++j) {
+        const DType* x_off = X + j * dim;
+        DType* out_off = O + j * dim;
+        for (int64_t k = 0; k < dim; ++k) {
+          out_off[k] = std::exp(x_off[k] - max_val[k]);
+          sum_val[k] += out_off[k];
+        }
+      }
+      for (int64_t k = 0; k < dim; ++k)
+        sum_val[k] = static_cast<DType>(1) / sum_val[k];
+      for (IdType j = off[i]; j < off[i + 1]; ++j) {
+        DType* out_off = O + j * dim;
+        DGL_SEGMENT_SIMD
+        for (int64_t k = 0; k < dim; ++k)
+          out_off[k] *= sum_val[k];
+      }
+    }
+  }
+}
+
+/*!
+ * \brief CPU kernel of the backward of segment softmax.
+ * \param out The result of the forward pass.
+ * \param grad The gradient of the result.
+ * \param offsets The offsets of the segments.
+ * \param ret The gradient of the input feature, computed as
+ *        out * (grad - sum(out * grad)) where the sum is taken within segments.
+ */
+template <typename IdType, typename DType>
+void BackwardSegmentSoftmax(NDArray out, NDArray grad, NDArray offsets, NDArray ret) {
+  const int64_t n = offsets->shape[0] - 1;
+  const int64_t dim = RowSize(out);
+  const IdType* off = offsets.Ptr<IdType>();
+  const DType* Y = out.Ptr<DType>();
+  const DType* G = grad.Ptr<DType>();
+  DType* R = ret.Ptr<DType>();
+  CheckOffsets<IdType>(offsets, out->shape[0]);
+#pragma omp parallel
+  {
+    std::vector<DType> dot(dim);
+#pragma omp for schedule(dynamic, kSegmentChunk)
+    for (int64_t i = 0; i < n; ++i) {
+      if (off[i] == off[i + 1])
+        continue;
+      std::fill(dot.begin(), dot.end(), static_cast<DType>(0));
+      DType* dot_off = dot.data();
+      for (IdType j = off[i]; j < off[i + 1]; ++j) {
+        const DType* y_off = Y + j * dim;
+        const DType* g_off = G + j * dim;
+        DGL_SEGMENT_SIMD
+        for (int64_t k = 0; k < dim; ++k)
+          dot_off[k] += y_off[k] * g_off[k];
+      }
+      for (IdType j = off[i]; j < off[i + 1]; ++j) {
+        const DType* y_off = Y + j * dim;
+        const DType* g_off = G + j * dim;
+        DType* r_off = R + j * dim;
+        DGL_SEGMENT_SIMD
+        for (int64_t k = 0; k < dim; ++k)
+          r_off[k] = y_off[k] * (g_off[k] - dot_off[k]);
+      }
+    }
+  }
+}
+
+#undef DGL_SEGMENT_SIMD
+
+}  // namespace cpu
+}  // namespace aten
+}  // namespace dgl
+
+#endif  // DGL_ARRAY_CPU_SEGMENT_REDUCE_H_
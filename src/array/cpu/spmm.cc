@@ -97,5 +97,137 @@ template void SpMMCoo<kDLCPU, int64_t, double>(
     const BcastOff& bcast, const COOMatrix& coo,
     NDArray ufeat, NDArray efeat, NDArray out, std::vector<NDArray> out_aux);
 
+/*! \brief Typed SpMM on Csr format. */
+template <int XPU, typename IdType, typename DType>
+void TypedSpMMCsr(const CSRMatrix& csr,
+                  NDArray etype,
+                  NDArray ufeat,
+                  NDArray norm,
+                  NDArray weight,
+                  NDArray out,
+                  bool transpose_weight) {
+  cpu::TypedSpMMCsr<IdType, DType>(csr, etype, ufeat, norm, weight, out, transpose_weight);
+}
+
+template void TypedSpMMCsr<kDLCPU, int32_t, float>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray weight, NDArray out, bool transpose_weight);
+template void TypedSpMMCsr<kDLCPU, int64_t, float>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray weight, NDArray out, bool transpose_weight);
+template void TypedSpMMCsr<kDLCPU, int32_t, double>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray weight, NDArray out, bool transpose_weight);
+template void TypedSpMMCsr<kDLCPU, int64_t, double>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray weight, NDArray out, bool transpose_weight);
+
+/*! \brief Gradient of typed SpMM on Csr format with respect to the weights. */
+template <int XPU, typename IdType, typename DType>
+void TypedSpMMWeightGradCsr(const CSRMatrix& csr,
+                            NDArray etype,
+                            NDArray ufeat,
+                            NDArray norm,
+                            NDArray out_grad,
+                            NDArray weight_grad) {
+  cpu::TypedSpMMWeightGradCsr<IdType, DType>(csr, etype, ufeat, norm, out_grad, weight_grad);
+}
+
+template void TypedSpMMWeightGradCsr<kDLCPU, int32_t, float>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray out_grad, NDArray weight_grad);
+template void TypedSpMMWeightGradCsr<kDLCPU, int64_t, float>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray out_grad, NDArray weight_grad);
+template void TypedSpMMWeightGradCsr<kDLCPU, int32_t, double>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray out_grad, NDArray weight_grad);
+template void TypedSpMMWeightGradCsr<kDLCPU, int64_t, double>(
+    const CSRMatrix& csr, NDArray etype, NDArray ufeat, NDArray norm,
+    NDArray out_grad, NDArray weight_grad);
+
+/*!
+ * \brief SpMM-Sum followed by a dense linear transform on Csr format.
+ *
+ * The two orders cost nnz * D_in + M * D_in * D_out multiply-adds when the
+ * features are aggregated first, and N * D_in * D_out + nnz * D_out when they
+ * are projected first. Projecting first is done with a dense GEMM followed by
+ * SpMMCsr; aggregating first is fused tile by tile.
+ */
+template <int XPU, typename IdType, typename DType>
+void SpMMLinearCsr(const CSRMatrix& csr,
+                   NDArray ufeat,
+                   NDArray efeat,
+                   NDArray weight,
+                   NDArray out,
+                   bool transpose_weight) {
+  if (transpose_weight) {
+    const int64_t rows = weight->shape[0], cols = weight->shape[1];
+    NDArray trans = NDArray::Empty({cols, rows}, weight->dtype, weight->ctx);
+    const DType* src = weight.Ptr<DType>();
+    DType* dst = trans.Ptr<DType>();
+    for (int64_t i = 0; i < rows; ++i)
+      for (int64_t j = 0; j < cols; ++j)
+        dst[j * rows + i] = src[i * cols + j];
+    weight = trans;
+  }
+  const double in_dim = weight->shape[0], out_dim = weight->shape[1];
+  const double nnz = csr.indices->shape[0];
+  const double agg_first_cost = nnz * in_dim + csr.num_rows * in_dim * out_dim;
+  const double proj_first_cost = ufeat->shape[0] * in_dim * out_dim + nnz * out_dim;
+  if (proj_first_cost < agg_first_cost) {
+    NDArray proj = NDArray::Empty({ufeat->shape[0], weight->shape[1]}, out->dtype, out->ctx);
+    cpu::DenseLinear<DType>(ufeat, weight, proj);
+    const std::string op = IsNullArray(efeat) ? "copy_lhs" : "mul";
+    SpMMCsr<XPU, IdType, DType>(
+        op, "sum", CalcBcastOff(op, proj, efeat), csr, proj, efeat, out, {});
+  } else {
+    cpu::SpMMLinearCsr<IdType, DType>(csr, ufeat, efeat, weight, out);
+  }
+}
+
+template void SpMMLinearCsr<kDLCPU, int32_t, float>(
+    const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray weight, NDArray out, bool transpose_weight);
+template void SpMMLinearCsr<kDLCPU, int64_t, float>(
+    const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray weight, NDArray out, bool transpose_weight);
+template void SpMMLinearCsr<kDLCPU, int32_t, double>(
+    const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray weight, NDArray out, bool transpose_weight);
+template void SpMMLinearCsr<kDLCPU, int64_t, double>(
+    const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray weight, NDArray out, bool transpose_weight);
+
+/*! \brief Backward of SpMM-Min/Max on Csr format. */
+template <int XPU, typename IdType, typename DType>
+void SpMMCmpBackwardCsr(const CSRMatrix& csr,
+                        int target,
+                        NDArray argu,
+                        NDArray arge,
+                        NDArray grad,
+                        NDArray out) {
+  if (target == 0) {
+    cpu::SpMMCmpBackwardCsr<IdType, DType>(csr, argu, arge, grad, out);
+  } else if (target == 1) {
+    cpu::SpMMCmpBackwardEdgeCsr<IdType, DType>(csr, arge, grad, out);
+  } else {
+    LOG(FATAL) << "Invalid target of SpMM-Min/Max backward: " << target;
+  }
+}
+
+template void SpMMCmpBackwardCsr<kDLCPU, int32_t, float>(
+    const CSRMatrix& csr, int target, NDArray argu, NDArray arge,
+    NDArray grad, NDArray out);
+template void SpMMCmpBackwardCsr<kDLCPU, int64_t, float>(
+    const CSRMatrix& csr, int target, NDArray argu, NDArray arge,
+    NDArray grad, NDArray out);
+template void SpMMCmpBackwardCsr<kDLCPU, int32_t, double>(
+    const CSRMatrix& csr, int target, NDArray argu, NDArray arge,
+    NDArray grad, NDArray out);
+template void SpMMCmpBackwardCsr<kDLCPU, int64_t, double>(
+    const CSRMatrix& csr, int target, NDArray argu, NDArray arge,
+    NDArray grad, NDArray out);
+
 }  // namespace aten
 }  // namespace dgl
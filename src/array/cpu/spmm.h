@@ -10,6 +10,7 @@
 #include <dgl/bcast.h>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 namespace dgl {
 namespace aten {
@@ -247,6 +248,504 @@ void SpMMCmpCoo(
   }
 }
 
+/*!
+ * \brief CPU kernel of the backward of SpMM-Min/Max with respect to the source
+ *        node feature, on the Csr format of the graph.
+ * \param csr The Csr matrix whose rows are source nodes and columns are destination
+ *        nodes, i.e. the transpose of the matrix of the forward pass.
+ * \param argu Arg-Min/Max on source nodes of the forward pass.
+ * \param arge Arg-Min/Max on edges of the forward pass, or a null array if the
+ *        forward pass did not use edge features.
+ * \param grad The gradient routed back through the selected messages, in the
+ *        shape of the forward result.
+ * \param out The gradient of the source node feature, in the shape of the forward
+ *        result except the first dimension. It must be filled with zeros.
+ * \note It uses node parallel strategy, each thread gathers the gradient of its
+ *       source nodes from their out-edges, so no atomic operators are needed.
+ *       Without arge, parallel edges are counted once because they carry the
+ *       same message. Unless the rows are sorted, each thread stamps the
+ *       destination nodes already visited by its current row to find them.
+ */
+template <typename IdType, typename DType>
+void SpMMCmpBackwardCsr(
+    const CSRMatrix& csr,
+    NDArray argu, NDArray arge,
+    NDArray grad, NDArray out) {
+  const bool has_idx = !IsNullArray(csr.data);
+  const bool use_arge = !IsNullArray(arge);
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* edges = csr.data.Ptr<IdType>();
+  const IdType* argX = argu.Ptr<IdType>();
+  const IdType* argW = use_arge ? arge.Ptr<IdType>() : nullptr;
+  const DType* G = grad.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  const int64_t dim = grad->shape[0] ? grad.NumElements() / grad->shape[0] : 0;
+  const bool use_stamp = !use_arge && !csr.sorted;
+#pragma omp parallel
+  {
+    // The last row of this thread that visited each destination node.
+    std::vector<IdType> stamp(use_stamp ? csr.num_cols : 0, -1);
+#pragma omp for
+    for (IdType rid = 0; rid < csr.num_rows; ++rid) {
+      const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
+      DType* out_off = O + rid * dim;
+      for (IdType j = row_start; j < row_end; ++j) {
+        const IdType cid = indices[j];
+        const IdType eid = has_idx ? edges[j] : j;
+        if (use_stamp) {
+          if (stamp[cid] == rid)
+            continue;
+          stamp[cid] = rid;
+        } else if (!use_arge && j > row_start && indices[j - 1] == cid) {
+          continue;
+        }
+        const IdType* argx_off = argX + cid * dim;
+        const IdType* argw_off = use_arge ? argW + cid * dim : nullptr;
+        const DType* grad_off = G + cid * dim;
+        for (int64_t k = 0; k < dim; ++k) {
+          if (argx_off[k] == rid && (!use_arge || argw_off[k] == eid))
+            out_off[k] += grad_off[k];
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief CPU kernel of the backward of SpMM-Min/Max with respect to the edge
+ *        feature, on the Csr format of the graph.
+ * \param csr The Csr matrix of the forward pass, whose rows are destination nodes.
+ * \param arge Arg-Min/Max on edges of the forward pass.
+ * \param grad The gradient routed back through the selected messages, in the
+ *        shape of the forward result.
+ * \param out The gradient of the edge feature, in the shape of the forward
+ *        result except the first dimension. It must be filled with zeros.
+ * \note Every edge has a single destination node, so each element of the output
+ *       is written by exactly one thread.
+ */
+template <typename IdType, typename DType>
+void SpMMCmpBackwardEdgeCsr(
+    const CSRMatrix& csr,
+    NDArray arge,
+    NDArray grad, NDArray out) {
+  const bool has_idx = !IsNullArray(csr.data);
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* edges = csr.data.Ptr<IdType>();
+  const IdType* argW = arge.Ptr<IdType>();
+  const DType* G = grad.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  const int64_t dim = grad->shape[0] ? grad.NumElements() / grad->shape[0] : 0;
+#pragma omp parallel for
+  for (IdType rid = 0; rid < csr.num_rows; ++rid) {
+    const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
+    const IdType* argw_off = argW + rid * dim;
+    const DType* grad_off = G + rid * dim;
+    for (IdType j = row_start; j < row_end; ++j) {
+      const IdType eid = has_idx ? edges[j] : j;
+      DType* out_off = O + eid * dim;
+      for (int64_t k = 0; k < dim; ++k) {
+        if (argw_off[k] == eid)
+          out_off[k] = grad_off[k];
+      }
+    }
+  }
+}
+
+/*!
+ * \brief The in-edges of each row of a Csr matrix, grouped into segments of
+ *        edges of the same type.
+ *
+ * The segments of a row are consecutive, in increasing order of their types.
+ */
+template <typename IdType>
+struct TypedSegments {
+  /*! \brief Positions in the Csr matrix of the edges, ordered by row and type */
+  std::vector<IdType> pos;
+  /*! \brief The segments of row i are [row_seg[i], row_seg[i + 1]) */
+  std::vector<int64_t> row_seg;
+  /*! \brief The edges of segment s are pos[seg_begin[s]:seg_begin[s + 1]] */
+  std::vector<int64_t> seg_begin;
+  /*! \brief The row of each segment */
+  std::vector<IdType> seg_row;
+  /*! \brief The edge type of each segment */
+  std::vector<IdType> seg_type;
+
+  int64_t NumSegments() const {
+    return seg_row.size();
+  }
+};
+
+/*!
+ * \brief Group the edges of each row of a Csr matrix by their types.
+ * \param csr The Csr matrix.
+ * \param etype The type of each edge, indexed by edge ID.
+ * \param num_types The number of edge types.
+ */
+template <typename IdType>
+TypedSegments<IdType> GroupEdgesByType(
+    const CSRMatrix& csr, NDArray etype, int64_t num_types) {
+  const bool has_idx = !IsNullArray(csr.data);
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* edges = csr.data.Ptr<IdType>();
+  const IdType* types = etype.Ptr<IdType>();
+  const int64_t num_rows = csr.num_rows;
+  const int64_t nnz = indptr[num_rows];
+  TypedSegments<IdType> ret;
+  ret.pos.resize(nnz);
+  ret.row_seg.resize(num_rows + 1, 0);
+  IdType* pos = ret.pos.data();
+  int64_t* row_seg = ret.row_seg.data();
+  int64_t num_invalid = 0;
+
+  // sort the edges of each row by type and count the segments
+#pragma omp parallel for reduction(+:num_invalid)
+  for (int64_t rid = 0; rid < num_rows; ++rid) {
+    const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
+    bool sorted = true;
+    for (IdType j = row_start; j < row_end; ++j) {
+      pos[j] = j;
+      const IdType t = types[has_idx ? edges[j] : j];
+      num_invalid += (t < 0 || t >= num_types);
+      if (j > row_start && t < types[has_idx ? edges[j - 1] : j - 1])
+        sorted = false;
+    }
+    auto type_of = [&] (IdType j) { return types[has_idx ? edges[j] : j]; };
+    if (!sorted)
+      std::stable_sort(pos + row_start, pos + row_end, [&] (IdType a, IdType b) {
+          return type_of(a) < type_of(b);
+        });
+    int64_t num_segs = 0;
+    for (IdType j = row_start; j < row_end; ++j)
+      num_segs += (j == row_start || type_of(pos[j]) != type_of(pos[j - 1]));
+    row_seg[rid + 1] = num_segs;
+  }
+  CHECK_EQ(num_invalid, 0) << num_invalid << " edge types are out of range [0, "
+                           << num_types << ")";
+  for (int64_t rid = 0; rid < num_rows; ++rid)
+    row_seg[rid + 1] += row_seg[rid];
+
+  const int64_t num_segs = row_seg[num_rows];
+  ret.seg_begin.resize(num_segs + 1);
+  ret.seg_row.resize(num_segs);
+  ret.seg_type.resize(num_segs);
+  ret.seg_begin[num_segs] = nnz;
+#pragma omp parallel for
+  for (int64_t rid = 0; rid < num_rows; ++rid) {
+    int64_t s = row_seg[rid];
+    for (IdType j = indptr[rid]; j < indptr[rid + 1]; ++j) {
+      const IdType t = types[has_idx ? edges[pos[j]] : pos[j]];
+      if (j == indptr[rid] || t != ret.seg_type[s - 1]) {
+        ret.seg_begin[s] = j;
+        ret.seg_row[s] = rid;
+        ret.seg_type[s] = t;
+        ++s;
+      }
+    }
+  }
+  return ret;
+}
+
+/*!
+ * \brief Sum the features of the columns of the edges in a segment, scaled by the
+ *        edge weights if there are any.
+ */
+template <typename IdType, typename DType>
+inline void AggregateSegment(
+    const TypedSegments<IdType>& segs, int64_t s,
+    const IdType* indices, const IdType* edges,
+    const DType* X, const DType* norm, int64_t dim, DType* agg) {
+  std::fill(agg, agg + dim, 0);
+  for (int64_t j = segs.seg_begin[s]; j < segs.seg_begin[s + 1]; ++j) {
+    const IdType p = segs.pos[j];
+    const IdType eid = edges ? edges[p] : p;
+    const DType w = norm ? norm[eid] : 1;
+    const DType* x = X + indices[p] * dim;
+    for (int64_t k = 0; k < dim; ++k)
+      agg[k] += w * x[k];
+  }
+}
+
+/*! \brief Number of rows whose segments are processed together by a thread */
+constexpr int64_t kTypedSpMMRowBlock = 64;
+
+/*!
+ * \brief CPU kernel of typed SpMM on Csr format.
+ *
+ * Computes out[r] = sum_{j in row r} norm[e_j] * ufeat[c_j] * weight[t_j]
+ * with weight[t] of shape (in_dim, out_dim), or its transpose if transpose_weight
+ * is true, where c_j, e_j and t_j are the column, the ID and the type of edge j.
+ *
+ * \param csr The Csr matrix.
+ * \param etype The type of each edge, indexed by edge ID.
+ * \param ufeat The feature on columns, of shape (num_cols, in_dim).
+ * \param norm The weight of each edge, or a null array.
+ * \param weight The weight matrices of the edge types.
+ * \param out The result feature on rows, of shape (num_rows, out_dim).
+ * \param transpose_weight Whether to multiply with the transposed weights.
+ * \note The edges of each row are aggregated by type first, so a weight matrix
+ *       is applied once per row and type. The rows are processed in blocks, in
+ *       each of which the segments are visited by type to reuse the weights
+ *       in cache.
+ */
+template <typename IdType, typename DType>
+void TypedSpMMCsr(
+    const CSRMatrix& csr, NDArray etype,
+    NDArray ufeat, NDArray norm, NDArray weight,
+    NDArray out, bool transpose_weight) {
+  const int64_t num_types = weight->shape[0];
+  const int64_t in_dim = transpose_weight ? weight->shape[2] : weight->shape[1];
+  const int64_t out_dim = transpose_weight ? weight->shape[1] : weight->shape[2];
+  const auto segs = GroupEdgesByType<IdType>(csr, etype, num_types);
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* edges = IsNullArray(csr.data) ? nullptr : csr.data.Ptr<IdType>();
+  const DType* X = ufeat.Ptr<DType>();
+  const DType* N = IsNullArray(norm) ? nullptr : norm.Ptr<DType>();
+  const DType* W = weight.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  std::fill(O, O + csr.num_rows * out_dim, 0);
+  const int64_t num_blocks = (csr.num_rows + kTypedSpMMRowBlock - 1) / kTypedSpMMRowBlock;
+#pragma omp parallel for
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    const int64_t seg_start = segs.row_seg[b * kTypedSpMMRowBlock];
+    const int64_t seg_end = segs.row_seg[
+      std::min((b + 1) * kTypedSpMMRowBlock, csr.num_rows)];
+    std::vector<int64_t> order(seg_end - seg_start);
+    for (int64_t s = seg_start; s < seg_end; ++s)
+      order[s - seg_start] = s;
+    std::stable_sort(order.begin(), order.end(), [&segs] (int64_t a, int64_t b) {
+        return segs.seg_type[a] < segs.seg_type[b];
+      });
+    std::vector<DType> agg(in_dim);
+    for (int64_t s : order) {
+      AggregateSegment(segs, s, indices, edges, X, N, in_dim, agg.data());
+      const DType* w = W + segs.seg_type[s] * in_dim * out_dim;
+      DType* o = O + segs.seg_row[s] * out_dim;
+      if (transpose_weight) {
+        for (int64_t k = 0; k < out_dim; ++k) {
+          DType accum = 0;
+          for (int64_t i = 0; i < in_dim; ++i)
+            accum += agg[i] * w[k * in_dim + i];
+          o[k] += accum;
+        }
+      } else {
+        for (int64_t i = 0; i < in_dim; ++i) {
+          const DType a = agg[i];
+          if (a == 0)
+            continue;
+          for (int64_t k = 0; k < out_dim; ++k)
+            o[k] += a * w[i * out_dim + k];
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief CPU kernel of the gradient of typed SpMM on Csr format with respect
+ *        to the weights.
+ *
+ * Computes weight_grad[t] = sum_{j of type t} norm[e_j] * ufeat[c_j]^T * out_grad[r_j],
+ * where r_j is the row of edge j.
+ *
+ * \param csr The Csr matrix.
+ * \param etype The type of each edge, indexed by edge ID.
+ * \param ufeat The feature on columns, of shape (num_cols, in_dim).
+ * \param norm The weight of each edge, or a null array.
+ * \param out_grad The gradient on rows, of shape (num_rows, out_dim).
+ * \param weight_grad The gradient of the weights, of shape (num_types, in_dim, out_dim).
+ * \note Each edge type is handled by a single thread, so no atomic operation
+ *       is needed.
+ */
+template <typename IdType, typename DType>
+void TypedSpMMWeightGradCsr(
+    const CSRMatrix& csr, NDArray etype,
+    NDArray ufeat, NDArray norm, NDArray out_grad,
+    NDArray weight_grad) {
+  const int64_t num_types = weight_grad->shape[0];
+  const int64_t in_dim = weight_grad->shape[1];
+  const int64_t out_dim = weight_grad->shape[2];
+  const auto segs = GroupEdgesByType<IdType>(csr, etype, num_types);
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* edges = IsNullArray(csr.data) ? nullptr : csr.data.Ptr<IdType>();
+  const DType* X = ufeat.Ptr<DType>();
+  const DType* N = IsNullArray(norm) ? nullptr : norm.Ptr<DType>();
+  const DType* G = out_grad.Ptr<DType>();
+  DType* WG = weight_grad.Ptr<DType>();
+  std::fill(WG, WG + num_types * in_dim * out_dim, 0);
+
+  // bucket the segments by type
+  const int64_t num_segs = segs.NumSegments();
+  std::vector<int64_t> type_ptr(num_types + 1, 0), type_segs(num_segs);
+  for (int64_t s = 0; s < num_segs; ++s)
+    ++type_ptr[segs.seg_type[s] + 1];
+  for (int64_t t = 0; t < num_types; ++t)
+    type_ptr[t + 1] += type_ptr[t];
+  {
+    std::vector<int64_t> cursor(type_ptr.begin(), type_ptr.end() - 1);
+    for (int64_t s = 0; s < num_segs; ++s)
+      type_segs[cursor[segs.seg_type[s]]++] = s;
+  }
+
+#pragma omp parallel for
+  for (int64_t t = 0; t < num_types; ++t) {
+    std::vector<DType> agg(in_dim);
+    DType* wg = WG + t * in_dim * out_dim;
+    for (int64_t i = type_ptr[t]; i < type_ptr[t + 1]; ++i) {
+      const int64_t s = type_segs[i];
+      AggregateSegment(segs, s, indices, edges, X, N, in_dim, agg.data());
+      const DType* g = G + segs.seg_row[s] * out_dim;
+      for (int64_t k = 0; k < in_dim; ++k) {
+        const DType a = agg[k];
+        if (a == 0)
+          continue;
+        for (int64_t o = 0; o < out_dim; ++o)
+          wg[k * out_dim + o] += a * g[o];
+      }
+    }
+  }
+}
+
+/*! \brief Number of destination rows aggregated at a time by the fused SpMM-Linear. */
+constexpr int64_t kSpMMLinearRowTile = 64;
+/*! \brief Number of rows of the weight kept in cache at a time by the GEMM. */
+constexpr int64_t kGemmBlockK = 128;
+/*! \brief Number of columns of the weight kept in cache at a time by the GEMM. */
+constexpr int64_t kGemmBlockN = 256;
+
+/*!
+ * \brief Add the product of a dense row-major m x k block A and a dense
+ *        row-major k x n matrix B to a row-major m x n block C.
+ * \param A The left block, whose rows are lda elements apart.
+ * \param B The right matrix.
+ * \param C The result block, whose rows are ldc elements apart.
+ * \note B is processed in kGemmBlockK x kGemmBlockN blocks that stay in cache,
+ *       and four rows of A are multiplied at a time so that every element of B
+ *       loaded is used four times. The innermost loop runs over contiguous
+ *       columns and is vectorized by the compiler.
+ */
+template <typename DType>
+void GemmBlockAdd(const DType* A, int64_t m, int64_t k, int64_t lda,
+                  const DType* B, int64_t n,
+                  DType* C, int64_t ldc) {
+  for (int64_t k0 = 0; k0 < k; k0 += kGemmBlockK) {
+    const int64_t k1 = std::min(k, k0 + kGemmBlockK);
+    for (int64_t n0 = 0; n0 < n; n0 += kGemmBlockN) {
+      const int64_t n1 = std::min(n, n0 + kGemmBlockN);
+      int64_t i = 0;
+      for (; i + 4 <= m; i += 4) {
+        const DType* a0 = A + i * lda;
+        const DType* a1 = a0 + lda;
+        const DType* a2 = a1 + lda;
+        const DType* a3 = a2 + lda;
+        DType* c0 = C + i * ldc;
+        DType* c1 = c0 + ldc;
+        DType* c2 = c1 + ldc;
+        DType* c3 = c2 + ldc;
+        for (int64_t kk = k0; kk < k1; ++kk) {
+          const DType* b = B + kk * n;
+          const DType v0 = a0[kk], v1 = a1[kk], v2 = a2[kk], v3 = a3[kk];
+          for (int64_t j = n0; j < n1; ++j) {
+            const DType bj = b[j];
+            c0[j] += v0 * bj;
+            c1[j] += v1 * bj;
+            c2[j] += v2 * bj;
+            c3[j] += v3 * bj;
+          }
+        }
+      }
+      for (; i < m; ++i) {
+        const DType* a = A + i * lda;
+        DType* c = C + i * ldc;
+        for (int64_t kk = k0; kk < k1; ++kk) {
+          const DType* b = B + kk * n;
+          const DType v = a[kk];
+          for (int64_t j = n0; j < n1; ++j)
+            c[j] += v * b[j];
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief Multiply a dense row-major matrix by a dense row-major weight.
+ * \param feat The matrix of shape (N, D_in).
+ * \param weight The weight of shape (D_in, D_out).
+ * \param out The result of shape (N, D_out).
+ * \note Rows are split into tiles of kSpMMLinearRowTile processed in parallel.
+ */
+template <typename DType>
+void DenseLinear(NDArray feat, NDArray weight, NDArray out) {
+  const int64_t num_rows = feat->shape[0];
+  const int64_t in_dim = weight->shape[0], out_dim = weight->shape[1];
+  const DType* X = feat.Ptr<DType>();
+  const DType* W = weight.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  const int64_t num_tiles = (num_rows + kSpMMLinearRowTile - 1) / kSpMMLinearRowTile;
+#pragma omp parallel for
+  for (int64_t t = 0; t < num_tiles; ++t) {
+    const int64_t row_start = t * kSpMMLinearRowTile;
+    const int64_t rows = std::min(kSpMMLinearRowTile, num_rows - row_start);
+    DType* out_off = O + row_start * out_dim;
+    std::fill(out_off, out_off + rows * out_dim, static_cast<DType>(0));
+    GemmBlockAdd(X + row_start * in_dim, rows, in_dim, in_dim, W, out_dim, out_off, out_dim);
+  }
+}
+
+/*!
+ * \brief CPU kernel of SpMM-Sum followed by a dense linear transform on Csr format,
+ *        i.e. out = (A X) W, where A is the (weighted) adjacency matrix.
+ * \param csr The Csr matrix.
+ * \param ufeat The feature on source nodes of shape (N, D_in).
+ * \param efeat The scalar weight on edges, or a null array if unweighted.
+ * \param weight The dense weight of shape (D_in, D_out).
+ * \param out The result feature on destination nodes of shape (M, D_out).
+ * \note Destination rows are processed in tiles of kSpMMLinearRowTile. The
+ *       aggregated features of a tile are kept in a per-thread buffer small
+ *       enough to stay in L2 and multiplied by the weight right away, so the
+ *       intermediate (M, D_in) result is never written to memory.
+ */
+template <typename IdType, typename DType>
+void SpMMLinearCsr(const CSRMatrix& csr,
+                   NDArray ufeat, NDArray efeat,
+                   NDArray weight, NDArray out) {
+  const bool has_idx = !IsNullArray(csr.data);
+  const bool has_efeat = !IsNullArray(efeat);
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* edges = csr.data.Ptr<IdType>();
+  const DType* X = ufeat.Ptr<DType>();
+  const DType* E = has_efeat ? efeat.Ptr<DType>() : nullptr;
+  const DType* W = weight.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  const int64_t in_dim = weight->shape[0], out_dim = weight->shape[1];
+  const int64_t num_tiles = (csr.num_rows + kSpMMLinearRowTile - 1) / kSpMMLinearRowTile;
+#pragma omp parallel
+  {
+    std::vector<DType> buf(kSpMMLinearRowTile * in_dim);
+#pragma omp for
+    for (int64_t t = 0; t < num_tiles; ++t) {
+      const int64_t row_start = t * kSpMMLinearRowTile;
+      const int64_t rows = std::min(kSpMMLinearRowTile, csr.num_rows - row_start);
+      std::fill(buf.begin(), buf.begin() + rows * in_dim, static_cast<DType>(0));
+      for (int64_t r = 0; r < rows; ++r) {
+        const IdType rid = row_start + r;
+        DType* buf_off = buf.data() + r * in_dim;
+        for (IdType j = indptr[rid]; j < indptr[rid + 1]; ++j) {
+          const DType* in_off = X + indices[j] * in_dim;
+          const DType e = has_efeat ? E[has_idx ? edges[j] : j] : static_cast<DType>(1);
+          for (int64_t k = 0; k < in_dim; ++k)
+            buf_off[k] += e * in_off[k];
+        }
+      }
+      DType* out_off = O + row_start * out_dim;
+      std::fill(out_off, out_off + rows * out_dim, static_cast<DType>(0));
+      GemmBlockAdd(buf.data(), rows, in_dim, in_dim, W, out_dim, out_off, out_dim);
+    }
+  }
+}
+
 namespace op {
 
 //////////////////////////////// binary operators on CPU ////////////////////////////////
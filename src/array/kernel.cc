@@ -5,6 +5,8 @@
  */
 #include <dgl/packed_func_ext.h>
 #include <dgl/base_heterograph.h>
+#include <dgl/runtime/tracing.h>
+#include <algorithm>
 
 #include "kernel_decl.h"
 #include "../c_api_common.h"
@@ -62,6 +64,72 @@ inline void CheckShape(
   }
 }
 
+// Check the arguments of typed SpMM, whose features on source and destination
+// nodes have src_dim and dst_dim columns.
+void CheckTypedSpMMArgs(
+    HeteroGraphPtr graph, IdArray etype, NDArray norm, NDArray weight,
+    NDArray src_feat, int64_t src_dim, NDArray dst_feat, int64_t dst_dim) {
+  CheckCtx(graph->Context(), {etype, norm, weight, src_feat, dst_feat},
+      {"etype", "norm", "weight", "src_feat", "dst_feat"});
+  CheckContiguous({etype, norm, weight, src_feat, dst_feat},
+      {"etype", "norm", "weight", "src_feat", "dst_feat"});
+  CHECK_EQ(graph->NumEdgeTypes(), 1);
+  auto pair = graph->meta_graph()->FindEdge(0);  // only one etype in the graph.
+  CheckShape(
+      {graph->NumVertices(pair.first), graph->NumEdges(0), graph->NumVertices(pair.second)},
+      {0, 2},
+      {src_feat, dst_feat},
+      {"src_feat", "dst_feat"});
+  CHECK(etype->dtype == graph->DataType())
+    << "Expect the edge types to have the same data type as the graph";
+  CHECK_EQ(etype->ndim, 1) << "Expect the edge types to be a vector";
+  CHECK_EQ(etype->shape[0], graph->NumEdges(0))
+    << "Expect " << graph->NumEdges(0) << " edge types, but got " << etype->shape[0];
+  if (!IsNullArray(norm)) {
+    CHECK_EQ(norm.NumElements(), graph->NumEdges(0))
+      << "Expect the edge norm to have one element per edge";
+    CHECK(norm->dtype == weight->dtype) << "Expect norm to have the same data type as weight";
+  }
+  CHECK_EQ(weight->ndim, 3) << "Expect weight to have shape (num_types, in_dim, out_dim)";
+  CHECK(src_feat->dtype == weight->dtype && dst_feat->dtype == weight->dtype)
+    << "Expect the features to have the same data type as weight";
+  CHECK_EQ(src_feat.NumElements(), src_feat->shape[0] * src_dim)
+    << "Expect src_feat to have " << src_dim << " columns";
+  CHECK_EQ(dst_feat.NumElements(), dst_feat->shape[0] * dst_dim)
+    << "Expect dst_feat to have " << dst_dim << " columns";
+}
+
+// Check the arguments of segment operators. The rows of feat are grouped into
+// segments by offsets, and seg_feat has one row per segment.
+void CheckSegmentArgs(
+    NDArray offsets, NDArray feat, NDArray seg_feat, NDArray arg) {
+  CheckCtx(offsets->ctx, {feat, seg_feat, arg}, {"feat", "seg_feat", "arg"});
+  CheckContiguous({offsets, feat, seg_feat, arg}, {"offsets", "feat", "seg_feat", "arg"});
+  CHECK_EQ(offsets->ndim, 1) << "Expect offsets to be a vector";
+  CHECK_GE(feat->ndim, 1) << "Expect feat to have ndim >= 1";
+  CHECK_EQ(seg_feat->shape[0], offsets->shape[0] - 1)
+    << "Expect seg_feat to have one row per segment";
+  CHECK(seg_feat->dtype == feat->dtype) << "Expect seg_feat to have the same data type as feat";
+  CHECK_EQ(seg_feat.NumElements() / std::max<int64_t>(seg_feat->shape[0], 1),
+           feat.NumElements() / std::max<int64_t>(feat->shape[0], 1))
+    << "Expect seg_feat to have the same feature shape as feat";
+  if (!IsNullArray(arg)) {
+    CHECK(arg->dtype == offsets->dtype) << "Expect arg to have the same data type as offsets";
+    CHECK_EQ(arg.NumElements(), seg_feat.NumElements())
+      << "Expect arg to have the same shape as seg_feat";
+  }
+}
+
+// Count the edges processed and the bytes of the arrays touched by a traced kernel.
+void CountKernel(tracing::ScopedTimer* timer, int64_t num_edges,
+                 const std::vector<NDArray>& arrays) {
+  timer->AddEdges(num_edges);
+  for (const NDArray& arr : arrays) {
+    if (arr.defined())
+      timer->AddBytes(arr.GetSize());
+  }
+}
+
 }  // namespace
 
 /*! \brief Generalized Sparse Matrix-Matrix Multiplication. */
@@ -71,6 +139,9 @@ void SpMM(const std::string& op, const std::string& reduce,
           NDArray efeat,
           NDArray out,
           std::vector<NDArray> out_aux) {
+  tracing::ScopedTimer timer("SpMM");
+  if (timer.active())
+    CountKernel(&timer, graph->NumEdges(0), {ufeat, efeat, out});
   // TODO(zihao): format tuning
   SparseFormat format = graph->SelectFormat(0, csc_code);
   const auto& bcast = CalcBcastOff(op, ufeat, efeat);
@@ -102,6 +173,9 @@ void SDDMM(const std::string& op,
            NDArray out,
            int lhs_target,
            int rhs_target) {
+  tracing::ScopedTimer timer("SDDMM");
+  if (timer.active())
+    CountKernel(&timer, graph->NumEdges(0), {lhs, rhs, out});
   // TODO(zihao): format tuning
   SparseFormat format = graph->SelectFormat(0, coo_code);
   const auto &bcast = CalcBcastOff(op, lhs, rhs);
@@ -125,6 +199,159 @@ void SDDMM(const std::string& op,
   });
 }
 
+/*!
+ * \brief Backward of Generalized Sparse Matrix-Matrix Multiplication with
+ *        Min/Max reducer.
+ *
+ * The gradient of the source node feature is gathered along the out-edges with
+ * the Csr matrix of the graph, which is built once and kept by the graph, and
+ * the gradient of the edge feature along the in-edges with the Csc matrix.
+ */
+void SpMMCmpBackward(HeteroGraphPtr graph,
+                     int target,
+                     NDArray argu,
+                     NDArray arge,
+                     NDArray grad,
+                     NDArray out) {
+  tracing::ScopedTimer timer("SpMMCmpBackward");
+  if (timer.active())
+    CountKernel(&timer, graph->NumEdges(0), {grad, out});
+  ATEN_XPU_SWITCH(graph->Context().device_type, XPU, "SpMMCmpBackward", {
+    ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(out->dtype, DType, "Feature data", {
+        SpMMCmpBackwardCsr<XPU, IdType, DType>(
+            target == 0 ? graph->GetCSRMatrix(0) : graph->GetCSCMatrix(0),
+            target, argu, arge, grad, out);
+      });
+    });
+  });
+}
+
+/*! \brief Sparse Matrix-Matrix Multiplication fused with a dense linear transform. */
+void SpMMLinear(HeteroGraphPtr graph,
+                NDArray ufeat,
+                NDArray efeat,
+                NDArray weight,
+                NDArray out,
+                bool transpose_weight) {
+  tracing::ScopedTimer timer("SpMMLinear");
+  if (timer.active())
+    CountKernel(&timer, graph->NumEdges(0), {ufeat, efeat, weight, out});
+  ATEN_XPU_SWITCH(graph->Context().device_type, XPU, "SpMMLinear", {
+    ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(out->dtype, DType, "Feature data", {
+        SpMMLinearCsr<XPU, IdType, DType>(
+            graph->GetCSCMatrix(0), ufeat, efeat, weight, out, transpose_weight);
+      });
+    });
+  });
+}
+
+/*! \brief Typed Sparse Matrix-Matrix Multiplication. */
+void TypedSpMM(HeteroGraphPtr graph,
+               IdArray etype,
+               NDArray ufeat,
+               NDArray norm,
+               NDArray weight,
+               NDArray out,
+               bool transpose_weight) {
+  tracing::ScopedTimer timer("TypedSpMM");
+  if (timer.active())
+    CountKernel(&timer, graph->NumEdges(0), {ufeat, weight, out});
+  ATEN_XPU_SWITCH(graph->Context().device_type, XPU, "TypedSpMM", {
+    ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(out->dtype, DType, "Feature data", {
+        TypedSpMMCsr<XPU, IdType, DType>(
+            graph->GetCSCMatrix(0), etype, ufeat, norm, weight, out, transpose_weight);
+      });
+    });
+  });
+}
+
+/*! \brief Gradient of Typed Sparse Matrix-Matrix Multiplication w.r.t. the weights. */
+void TypedSpMMWeightGrad(HeteroGraphPtr graph,
+                         IdArray etype,
+                         NDArray ufeat,
+                         NDArray norm,
+                         NDArray out_grad,
+                         NDArray weight_grad) {
+  tracing::ScopedTimer timer("TypedSpMMWeightGrad");
+  if (timer.active())
+    CountKernel(&timer, graph->NumEdges(0), {ufeat, out_grad, weight_grad});
+  ATEN_XPU_SWITCH(graph->Context().device_type, XPU, "TypedSpMMWeightGrad", {
+    ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(weight_grad->dtype, DType, "Feature data", {
+        TypedSpMMWeightGradCsr<XPU, IdType, DType>(
+            graph->GetCSCMatrix(0), etype, ufeat, norm, out_grad, weight_grad);
+      });
+    });
+  });
+}
+
+/*! \brief Segment reduce. */
+void SegmentReduce(const std::string& op,
+                   NDArray feat,
+                   NDArray offsets,
+                   NDArray out,
+                   NDArray arg) {
+  tracing::ScopedTimer timer("SegmentReduce");
+  if (timer.active())
+    CountKernel(&timer, 0, {feat, out});
+  ATEN_XPU_SWITCH(feat->ctx.device_type, XPU, "SegmentReduce", {
+    ATEN_ID_TYPE_SWITCH(offsets->dtype, IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(feat->dtype, DType, "Feature data", {
+        SegmentReduce<XPU, IdType, DType>(op, feat, offsets, out, arg);
+      });
+    });
+  });
+}
+
+/*! \brief Backward of segment reduce. */
+void BackwardSegmentReduce(const std::string& op,
+                           NDArray grad,
+                           NDArray offsets,
+                           NDArray arg,
+                           NDArray out) {
+  tracing::ScopedTimer timer("BackwardSegmentReduce");
+  if (timer.active())
+    CountKernel(&timer, 0, {grad, out});
+  ATEN_XPU_SWITCH(grad->ctx.device_type, XPU, "BackwardSegmentReduce", {
+    ATEN_ID_TYPE_SWITCH(offsets->dtype, IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(grad->dtype, DType, "Feature data", {
+        BackwardSegmentReduce<XPU, IdType, DType>(op, grad, offsets, arg, out);
+      });
+    });
+  });
+}
+
+/*! \brief Segment softmax. */
+void SegmentSoftmax(NDArray feat, NDArray offsets, NDArray out) {
+  tracing::ScopedTimer timer("SegmentSoftmax");
+  if (timer.active())
+    CountKernel(&timer, 0, {feat, out});
+  ATEN_XPU_SWITCH(feat->ctx.device_type, XPU, "SegmentSoftmax", {
+    ATEN_ID_TYPE_SWITCH(offsets->dtype, IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(feat->dtype, DType, "Feature data", {
+        SegmentSoftmax<XPU, IdType, DType>(feat, offsets, out);
+      });
+    });
+  });
+}
+
+/*! \brief Backward of segment softmax. */
+void BackwardSegmentSoftmax(NDArray out, NDArray grad, NDArray offsets, NDArray ret) {
+  tracing::ScopedTimer timer("BackwardSegmentSoftmax");
+  if (timer.active())
+    CountKernel(&timer, 0, {out, grad, ret});
+  ATEN_XPU_SWITCH(out->ctx.device_type, XPU, "BackwardSegmentSoftmax", {
+    ATEN_ID_TYPE_SWITCH(offsets->dtype, IdType, {
+      ATEN_FLOAT_TYPE_SWITCH(out->dtype, DType, "Feature data", {
+        BackwardSegmentSoftmax<XPU, IdType, DType>(out, grad, offsets, ret);
+      });
+    });
+  });
+}
+
 DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSpMM")
 .set_body([] (DGLArgs args, DGLRetValue* rv) {
     HeteroGraphRef graph = args[0];
@@ -174,5 +401,163 @@ DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSDDMM")
     SDDMM(op, graph.sptr(), lhs, rhs, out, lhs_target, rhs_target);
   });
 
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSpMMCmpBackward")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    HeteroGraphRef graph = args[0];
+    const int target = args[1];
+    NDArray ArgU = args[2];
+    NDArray ArgE = args[3];
+    NDArray grad = args[4];
+    NDArray out = args[5];
+    CheckCtx(graph->Context(), {ArgU, ArgE, grad, out},
+        {"Arg_U", "Arg_E", "grad", "out"});
+    CheckContiguous({ArgU, ArgE, grad, out},
+        {"Arg_U", "Arg_E", "grad", "out"});
+    CHECK_EQ(graph->NumEdgeTypes(), 1);
+    auto pair = graph->meta_graph()->FindEdge(0);  // only one etype in the graph.
+    const dgl_type_t src_vtype = pair.first;
+    const dgl_type_t dst_vtype = pair.second;
+    CHECK(target == 0 || target == 1) << "Invalid target: " << target;
+    CHECK(!IsNullArray(target == 0 ? ArgU : ArgE))
+      << "Expect the Arg-Min/Max of the " << (target == 0 ? "source nodes" : "edges");
+    CheckShape(
+        {graph->NumVertices(src_vtype), graph->NumEdges(0), graph->NumVertices(dst_vtype)},
+        {2, 2, 2, target},
+        {ArgU, ArgE, grad, out},
+        {"Arg_U", "Arg_E", "grad", "out"});
+    for (const auto& arg : {ArgU, ArgE}) {
+      if (IsNullArray(arg))
+        continue;
+      CHECK(arg->dtype == graph->DataType())
+        << "Expect Arg-Min/Max to have the same data type as the graph";
+      CHECK_EQ(arg.NumElements(), grad.NumElements())
+        << "Expect Arg-Min/Max to have the same shape as grad";
+    }
+    CHECK(out->dtype == grad->dtype) << "Expect out to have the same data type as grad";
+    CHECK_EQ(out.NumElements() / std::max<int64_t>(out->shape[0], 1),
+             grad.NumElements() / std::max<int64_t>(grad->shape[0], 1))
+      << "Expect out to have the same feature shape as grad";
+    SpMMCmpBackward(graph.sptr(), target, ArgU, ArgE, grad, out);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSpMMLinear")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    HeteroGraphRef graph = args[0];
+    NDArray U = args[1];
+    NDArray E = args[2];
+    NDArray W = args[3];
+    NDArray V = args[4];
+    const bool transpose_weight = args[5];
+    CheckCtx(graph->Context(), {U, E, W, V}, {"U_data", "E_data", "weight", "out"});
+    CheckContiguous({U, E, W, V}, {"U_data", "E_data", "weight", "out"});
+    CHECK_EQ(graph->NumEdgeTypes(), 1);
+    auto pair = graph->meta_graph()->FindEdge(0);  // only one etype in the graph.
+    const dgl_type_t src_vtype = pair.first;
+    const dgl_type_t dst_vtype = pair.second;
+    CheckShape(
+        {graph->NumVertices(src_vtype), graph->NumEdges(0), graph->NumVertices(dst_vtype)},
+        {0, 2},
+        {U, V},
+        {"U_data", "out"});
+    CHECK_EQ(W->ndim, 2) << "Expect weight to be a matrix";
+    const int64_t in_dim = transpose_weight ? W->shape[1] : W->shape[0];
+    const int64_t out_dim = transpose_weight ? W->shape[0] : W->shape[1];
+    CHECK(U->dtype == W->dtype && V->dtype == W->dtype)
+      << "Expect the features to have the same data type as weight";
+    CHECK_EQ(U.NumElements(), U->shape[0] * in_dim)
+      << "Expect U_data to have " << in_dim << " columns";
+    CHECK_EQ(V.NumElements(), V->shape[0] * out_dim)
+      << "Expect out to have " << out_dim << " columns";
+    if (!IsNullArray(E)) {
+      CHECK_EQ(E.NumElements(), graph->NumEdges(0))
+        << "Expect the edge weight to have one element per edge";
+      CHECK(E->dtype == W->dtype) << "Expect E_data to have the same data type as weight";
+      E = E.CreateView({E.NumElements(), 1}, E->dtype);
+    }
+    SpMMLinear(graph.sptr(), U, E, W, V, transpose_weight);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelTypedSpMM")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    HeteroGraphRef graph = args[0];
+    IdArray etype = args[1];
+    NDArray U = args[2];
+    NDArray norm = args[3];
+    NDArray W = args[4];
+    NDArray V = args[5];
+    const bool transpose_weight = args[6];
+    CHECK_EQ(W->ndim, 3) << "Expect weight to have shape (num_types, in_dim, out_dim)";
+    const int64_t in_dim = transpose_weight ? W->shape[2] : W->shape[1];
+    const int64_t out_dim = transpose_weight ? W->shape[1] : W->shape[2];
+    CheckTypedSpMMArgs(graph.sptr(), etype, norm, W, U, in_dim, V, out_dim);
+    TypedSpMM(graph.sptr(), etype, U, norm, W, V, transpose_weight);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelTypedSpMMWeightGrad")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    HeteroGraphRef graph = args[0];
+    IdArray etype = args[1];
+    NDArray U = args[2];
+    NDArray norm = args[3];
+    NDArray dV = args[4];
+    NDArray dW = args[5];
+    CHECK_EQ(dW->ndim, 3) << "Expect weight to have shape (num_types, in_dim, out_dim)";
+    CheckTypedSpMMArgs(graph.sptr(), etype, norm, dW, U, dW->shape[1], dV, dW->shape[2]);
+    TypedSpMMWeightGrad(graph.sptr(), etype, U, norm, dV, dW);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSegmentReduce")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const std::string op = args[0];
+    NDArray feat = args[1];
+    NDArray offsets = args[2];
+    NDArray out = args[3];
+    NDArray arg = args[4];
+    CheckSegmentArgs(offsets, feat, out, arg);
+    SegmentReduce(op, feat, offsets, out, arg);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelBackwardSegmentReduce")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const std::string op = args[0];
+    NDArray grad = args[1];
+    NDArray offsets = args[2];
+    NDArray arg = args[3];
+    NDArray out = args[4];
+    CheckSegmentArgs(offsets, out, grad, arg);
+    BackwardSegmentReduce(op, grad, offsets, arg, out);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSegmentSoftmax")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    NDArray feat = args[0];
+    NDArray offsets = args[1];
+    NDArray out = args[2];
+    CheckCtx(feat->ctx, {offsets, out}, {"offsets", "out"});
+    CheckContiguous({feat, offsets, out}, {"feat", "offsets", "out"});
+    CHECK_EQ(offsets->ndim, 1) << "Expect offsets to be a vector";
+    CHECK(out->dtype == feat->dtype) << "Expect out to have the same data type as feat";
+    CHECK_EQ(out.NumElements(), feat.NumElements())
+      << "Expect out to have the same shape as feat";
+    SegmentSoftmax(feat, offsets, out);
+  });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelBackwardSegmentSoftmax")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    NDArray out = args[0];
+    NDArray grad = args[1];
+    NDArray offsets = args[2];
+    NDArray ret = args[3];
+    CheckCtx(out->ctx, {grad, offsets, ret}, {"grad", "offsets", "ret"});
+    CheckContiguous({out, grad, offsets, ret}, {"out", "grad", "offsets", "ret"});
+    CHECK_EQ(offsets->ndim, 1) << "Expect offsets to be a vector";
+    for (const auto& arr : {grad, ret}) {
+      CHECK(arr->dtype == out->dtype) << "Expect the gradients to have the same data type as out";
+      CHECK_EQ(arr.NumElements(), out.NumElements())
+        << "Expect the gradients to have the same shape as out";
+    }
+    BackwardSegmentSoftmax(out, grad, offsets, ret);
+  });
+
 }  // namespace aten
 }  // namespace dgl
@@ -40,6 +40,65 @@ void SpMMCoo(const std::string& op, const std::string& reduce,
              NDArray out,
              std::vector<NDArray> out_aux);
 
+/*!
+ * \brief Sparse Matrix Dense Matrix Multiplication with sum reducer followed by
+ *        a dense linear transform on Csr format.
+ *
+ * The result is (A X) W, where A is the Csr matrix weighted by the optional
+ * scalar edge feature and W is the weight, or its transpose if transpose_weight
+ * is true.
+ */
+template <int XPU, typename IdType, typename DType>
+void SpMMLinearCsr(const aten::CSRMatrix& csr,
+                   NDArray ufeat,
+                   NDArray efeat,
+                   NDArray weight,
+                   NDArray out,
+                   bool transpose_weight);
+
+/*!
+ * \brief Backward of Sparse Matrix Dense Matrix Multiplication with Min/Max
+ *        reducer on Csr format.
+ *
+ * With target 0 the rows of the Csr matrix are source nodes and the gradient of
+ * the source node feature is computed; with target 1 the rows are destination
+ * nodes and the gradient of the edge feature is computed.
+ */
+template <int XPU, typename IdType, typename DType>
+void SpMMCmpBackwardCsr(const aten::CSRMatrix& csr,
+                        int target,
+                        NDArray argu,
+                        NDArray arge,
+                        NDArray grad,
+                        NDArray out);
+
+/*!
+ * \brief Typed Sparse Matrix Dense Matrix Multiplication on Csr format.
+ *
+ * Every edge transforms the feature of its column by the weight matrix of its
+ * type, and the transformed features are summed on rows.
+ */
+template <int XPU, typename IdType, typename DType>
+void TypedSpMMCsr(const aten::CSRMatrix& csr,
+                  NDArray etype,
+                  NDArray ufeat,
+                  NDArray norm,
+                  NDArray weight,
+                  NDArray out,
+                  bool transpose_weight);
+
+/*!
+ * \brief Gradient of typed Sparse Matrix Dense Matrix Multiplication on Csr
+ *        format with respect to the weight matrices.
+ */
+template <int XPU, typename IdType, typename DType>
+void TypedSpMMWeightGradCsr(const aten::CSRMatrix& csr,
+                            NDArray etype,
+                            NDArray ufeat,
+                            NDArray norm,
+                            NDArray out_grad,
+                            NDArray weight_grad);
+
 /*!
  * \brief Generalized Sampled Dense-Dense Matrix Multiplication on Csr format.
  */
@@ -66,6 +125,47 @@ void SDDMMCoo(const std::string& op,
               int lhs_target,
               int rhs_target);
 
+/*!
+ * \brief Segment reduce with sum, mean, max or min reducer.
+ *
+ * The rows of the feature in [offsets[i], offsets[i + 1]) are reduced into the
+ * i-th row of the result. For max and min, arg records the row every element of
+ * the result is taken from.
+ */
+template <int XPU, typename IdType, typename DType>
+void SegmentReduce(const std::string& op,
+                   NDArray feat,
+                   NDArray offsets,
+                   NDArray out,
+                   NDArray arg);
+
+/*!
+ * \brief Backward of segment reduce.
+ */
+template <int XPU, typename IdType, typename DType>
+void BackwardSegmentReduce(const std::string& op,
+                           NDArray grad,
+                           NDArray offsets,
+                           NDArray arg,
+                           NDArray out);
+
+/*!
+ * \brief Softmax over the rows of every segment given by offsets.
+ */
+template <int XPU, typename IdType, typename DType>
+void SegmentSoftmax(NDArray feat,
+                    NDArray offsets,
+                    NDArray out);
+
+/*!
+ * \brief Backward of segment softmax.
+ */
+template <int XPU, typename IdType, typename DType>
+void BackwardSegmentSoftmax(NDArray out,
+                            NDArray grad,
+                            NDArray offsets,
+                            NDArray ret);
+
 }  // namespace aten
 }  // namespace dgl
 
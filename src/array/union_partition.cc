@@ -5,6 +5,7 @@
  */
 #include <dgl/array.h>
 #include <vector>
+#include "./array_op.h"
 
 namespace dgl {
 namespace aten {
@@ -25,6 +26,14 @@ COOMatrix DisjointUnionCoo(const std::vector<COOMatrix>& coos) {
     has_data |= COOHasData(coos[i]);
   }
 
+  if (coos[0].row->ctx.device_type == kDLCPU) {
+    COOMatrix ret;
+    ATEN_COO_SWITCH(coos[0], XPU, IdType, "DisjointUnionCoo", {
+      ret = impl::DisjointUnionCoo<XPU, IdType>(coos);
+    });
+    return ret;
+  }
+
   std::vector<IdArray> res_src;
   std::vector<IdArray> res_dst;
   std::vector<IdArray> res_data;
@@ -81,6 +90,15 @@ std::vector<COOMatrix> DisjointPartitionCooBySizes(
   CHECK_EQ(src_vertex_cumsum.size(), batch_size + 1);
   CHECK_EQ(dst_vertex_cumsum.size(), batch_size + 1);
   std::vector<COOMatrix> ret;
+
+  if (coo.row->ctx.device_type == kDLCPU) {
+    ATEN_COO_SWITCH(coo, XPU, IdType, "DisjointPartitionCooBySizes", {
+      ret = impl::DisjointPartitionCooBySizes<XPU, IdType>(
+          coo, batch_size, edge_cumsum, src_vertex_cumsum, dst_vertex_cumsum);
+    });
+    return ret;
+  }
+
   ret.resize(batch_size);
 
   for (size_t g = 0; g < batch_size; ++g) {
@@ -128,6 +146,14 @@ CSRMatrix DisjointUnionCsr(const std::vector<CSRMatrix>& csrs) {
     has_data |= CSRHasData(csrs[i]);
   }
 
+  if (csrs[0].indptr->ctx.device_type == kDLCPU) {
+    CSRMatrix ret;
+    ATEN_CSR_SWITCH(csrs[0], XPU, IdType, "DisjointUnionCsr", {
+      ret = impl::DisjointUnionCsr<XPU, IdType>(csrs);
+    });
+    return ret;
+  }
+
   std::vector<IdArray> res_indptr;
   std::vector<IdArray> res_indices;
   std::vector<IdArray> res_data;
@@ -160,8 +186,8 @@ CSRMatrix DisjointUnionCsr(const std::vector<CSRMatrix>& csrs) {
         edges_data = csr.data + indices_offset;
       }
       res_data.push_back(edges_data);
-      indices_offset += csr.indices->shape[0];
     }
+    indices_offset += csr.indices->shape[0];
   }
 
   IdArray result_indptr = Concat(res_indptr);
@@ -186,6 +212,15 @@ std::vector<CSRMatrix> DisjointPartitionCsrBySizes(
   CHECK_EQ(src_vertex_cumsum.size(), batch_size + 1);
   CHECK_EQ(dst_vertex_cumsum.size(), batch_size + 1);
   std::vector<CSRMatrix> ret;
+
+  if (csr.indptr->ctx.device_type == kDLCPU) {
+    ATEN_CSR_SWITCH(csr, XPU, IdType, "DisjointPartitionCsrBySizes", {
+      ret = impl::DisjointPartitionCsrBySizes<XPU, IdType>(
+          csr, batch_size, edge_cumsum, src_vertex_cumsum, dst_vertex_cumsum);
+    });
+    return ret;
+  }
+
   ret.resize(batch_size);
 
   for (size_t g = 0; g < batch_size; ++g) {
@@ -5,7 +5,9 @@
  */
 #include <dgl/graph.h>
 #include <dgl/sampler.h>
+#include <dmlc/omp.h>
 #include <algorithm>
+#include <numeric>
 #include <unordered_map>
 #include <set>
 #include <functional>
@@ -14,31 +16,214 @@
 
 namespace dgl {
 
+namespace {
+/*! \brief Batches shorter than this are appended entry by entry. */
+constexpr int64_t kMinAppendBatch = 64;
+/*! \brief Batches this many times smaller than the vertex count are grouped by sorting. */
+constexpr int64_t kSortAppendRatio = 16;
+/*! \brief Hole entries below which the slabs are never compacted. */
+constexpr uint64_t kMinCompactSize = 1 << 16;
+}  // namespace
+
+void BlockedAdjacency::AddVertices(uint64_t num_vertices) {
+  const uint64_t new_size = offset_.size() + num_vertices;
+  offset_.resize(new_size, nbr_.size());
+  degree_.resize(new_size, 0);
+  capacity_.resize(new_size, 0);
+}
+
+void BlockedAdjacency::Append(dgl_id_t vid, dgl_id_t nbr, dgl_id_t eid) {
+  if (degree_[vid] == capacity_[vid]) {
+    // move the slot to the end of the slabs
+    const dgl_id_t new_cap = std::max<dgl_id_t>(4, capacity_[vid] * 2);
+    const dgl_id_t new_off = nbr_.size();
+    nbr_.resize(new_off + new_cap);
+    eid_.resize(new_off + new_cap);
+    std::copy(nbr_.begin() + offset_[vid], nbr_.begin() + offset_[vid] + degree_[vid],
+              nbr_.begin() + new_off);
+    std::copy(eid_.begin() + offset_[vid], eid_.begin() + offset_[vid] + degree_[vid],
+              eid_.begin() + new_off);
+    num_holes_ += capacity_[vid];
+    offset_[vid] = new_off;
+    capacity_[vid] = new_cap;
+  }
+  const dgl_id_t pos = offset_[vid] + degree_[vid]++;
+  nbr_[pos] = nbr;
+  eid_[pos] = eid;
+  ++num_entries_;
+  if (num_holes_ > kMinCompactSize && num_holes_ > num_entries_)
+    Compact();
+}
+
+void BlockedAdjacency::AppendBatch(const dgl_id_t* vids, const dgl_id_t* nbrs, int64_t len,
+                                   dgl_id_t first_eid) {
+  if (len < kMinAppendBatch) {
+    for (int64_t i = 0; i < len; ++i)
+      Append(vids[i], nbrs[i], first_eid + i);
+    return;
+  }
+  // Split the entries into groups owning disjoint sets of vertices, keeping the
+  // entries of a vertex in edge id order, and list the number of new entries of
+  // each vertex of a group.
+  const int64_t num_vertices = offset_.size();
+  const int64_t num_groups = std::max(1, omp_get_max_threads());
+  std::vector<int64_t> order(len);
+  std::vector<int64_t> group_begin(num_groups + 1, 0);
+  std::vector<std::vector<std::pair<dgl_id_t, dgl_id_t>>> touched(num_groups);
+  if (len * kSortAppendRatio < num_vertices) {
+    // Few entries per vertex: sort them by vertex, so that the cost follows the batch
+    // size rather than the number of vertices, and cut at vertex boundaries.
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [vids] (int64_t a, int64_t b) { return vids[a] < vids[b]; });
+    for (int64_t g = 1; g < num_groups; ++g) {
+      int64_t k = std::max(group_begin[g - 1], len * g / num_groups);
+      while (k > 0 && k < len && vids[order[k]] == vids[order[k - 1]])
+        ++k;
+      group_begin[g] = k;
+    }
+    group_begin[num_groups] = len;
+#pragma omp parallel for
+    for (int64_t g = 0; g < num_groups; ++g) {
+      for (int64_t i = group_begin[g], j = i; i < group_begin[g + 1]; i = j) {
+        const dgl_id_t v = vids[order[i]];
+        while (j < group_begin[g + 1] && vids[order[j]] == v)
+          ++j;
+        touched[g].emplace_back(v, j - i);
+      }
+    }
+  } else {
+    // Group g owns a range of vertices; each chunk of the batch is counted and
+    // scattered by owner in parallel, which keeps the edge id order.
+    auto owner = [num_vertices, num_groups] (dgl_id_t v) {
+      return static_cast<int64_t>(v * num_groups / num_vertices);
+    };
+    std::vector<int64_t> chunk_count(num_groups * num_groups, 0);
+#pragma omp parallel for
+    for (int64_t c = 0; c < num_groups; ++c) {
+      for (int64_t i = len * c / num_groups; i < len * (c + 1) / num_groups; ++i)
+        ++chunk_count[owner(vids[i]) * num_groups + c];
+    }
+    std::vector<int64_t> chunk_begin(num_groups * num_groups + 1, 0);
+    std::partial_sum(chunk_count.begin(), chunk_count.end(), chunk_begin.begin() + 1);
+    for (int64_t g = 0; g <= num_groups; ++g)
+      group_begin[g] = chunk_begin[g * num_groups];
+#pragma omp parallel for
+    for (int64_t c = 0; c < num_groups; ++c) {
+      std::vector<int64_t> cursor(num_groups);
+      for (int64_t g = 0; g < num_groups; ++g)
+        cursor[g] = chunk_begin[g * num_groups + c];
+      for (int64_t i = len * c / num_groups; i < len * (c + 1) / num_groups; ++i)
+        order[cursor[owner(vids[i])]++] = i;
+    }
+    std::vector<dgl_id_t> extra(num_vertices, 0);
+#pragma omp parallel for
+    for (int64_t g = 0; g < num_groups; ++g) {
+      std::vector<dgl_id_t> seen;
+      for (int64_t k = group_begin[g]; k < group_begin[g + 1]; ++k) {
+        const dgl_id_t v = vids[order[k]];
+        if (extra[v]++ == 0)
+          seen.push_back(v);
+      }
+      for (const dgl_id_t v : seen)
+        touched[g].emplace_back(v, extra[v]);
+    }
+  }
+
+  // New slots for the vertices that run out of room, at the end of the slabs.
+  std::vector<dgl_id_t> group_slab(num_groups + 1, nbr_.size());
+#pragma omp parallel for
+  for (int64_t g = 0; g < num_groups; ++g) {
+    dgl_id_t size = 0;
+    for (const auto& p : touched[g]) {
+      const dgl_id_t v = p.first;
+      if (degree_[v] + p.second > capacity_[v])
+        size += std::max(capacity_[v] * 2, degree_[v] + p.second);
+    }
+    group_slab[g + 1] = size;
+  }
+  std::partial_sum(group_slab.begin(), group_slab.end(), group_slab.begin());
+  nbr_.resize(group_slab[num_groups]);
+  eid_.resize(group_slab[num_groups]);
+  int64_t holes = 0;
+#pragma omp parallel for reduction(+:holes)
+  for (int64_t g = 0; g < num_groups; ++g) {
+    dgl_id_t slab_end = group_slab[g];
+    for (const auto& p : touched[g]) {
+      const dgl_id_t v = p.first;
+      if (degree_[v] + p.second <= capacity_[v])
+        continue;
+      std::copy(nbr_.begin() + offset_[v], nbr_.begin() + offset_[v] + degree_[v],
+                nbr_.begin() + slab_end);
+      std::copy(eid_.begin() + offset_[v], eid_.begin() + offset_[v] + degree_[v],
+                eid_.begin() + slab_end);
+      holes += capacity_[v];
+      offset_[v] = slab_end;
+      capacity_[v] = std::max(capacity_[v] * 2, degree_[v] + p.second);
+      slab_end += capacity_[v];
+    }
+    // no other group writes to the slots of these vertices
+    for (int64_t k = group_begin[g]; k < group_begin[g + 1]; ++k) {
+      const int64_t i = order[k];
+      const dgl_id_t vid = vids[i];
+      const dgl_id_t pos = offset_[vid] + degree_[vid]++;
+      nbr_[pos] = nbrs[i];
+      eid_[pos] = first_eid + i;
+    }
+  }
+  num_holes_ += holes;
+  num_entries_ += len;
+  if (num_holes_ > kMinCompactSize && num_holes_ > num_entries_)
+    Compact();
+}
+
+void BlockedAdjacency::ToCSR(dgl_id_t* indptr, dgl_id_t* indices, dgl_id_t* eids) const {
+  const int64_t num_vertices = offset_.size();
+  indptr[0] = 0;
+  for (int64_t v = 0; v < num_vertices; ++v)
+    indptr[v + 1] = indptr[v] + degree_[v];
+#pragma omp parallel for
+  for (int64_t v = 0; v < num_vertices; ++v) {
+    std::copy(nbr_.begin() + offset_[v], nbr_.begin() + offset_[v] + degree_[v],
+              indices + indptr[v]);
+    std::copy(eid_.begin() + offset_[v], eid_.begin() + offset_[v] + degree_[v],
+              eids + indptr[v]);
+  }
+}
+
+void BlockedAdjacency::Clear() {
+  nbr_.clear();
+  eid_.clear();
+  offset_.clear();
+  degree_.clear();
+  capacity_.clear();
+  num_entries_ = 0;
+  num_holes_ = 0;
+}
+
+void BlockedAdjacency::Compact() {
+  const int64_t num_vertices = offset_.size();
+  std::vector<dgl_id_t> new_offset(num_vertices + 1);
+  new_offset[0] = 0;
+  for (int64_t v = 0; v < num_vertices; ++v)
+    new_offset[v + 1] = new_offset[v] + degree_[v];
+  std::vector<dgl_id_t> nbr(num_entries_), eid(num_entries_);
+  ToCSR(new_offset.data(), nbr.data(), eid.data());
+  nbr_.swap(nbr);
+  eid_.swap(eid);
+  new_offset.pop_back();
+  offset_.swap(new_offset);
+  capacity_ = degree_;
+  num_holes_ = 0;
+}
+
 Graph::Graph(IdArray src_ids, IdArray dst_ids, size_t num_nodes) {
   CHECK(aten::IsValidIdArray(src_ids));
   CHECK(aten::IsValidIdArray(dst_ids));
   this->AddVertices(num_nodes);
-  num_edges_ = src_ids->shape[0];
-  CHECK(static_cast<int64_t>(num_edges_) == dst_ids->shape[0])
+  CHECK(src_ids->shape[0] == dst_ids->shape[0])
     << "vectors in COO must have the same length";
-  const dgl_id_t *src_data = static_cast<dgl_id_t*>(src_ids->data);
-  const dgl_id_t *dst_data = static_cast<dgl_id_t*>(dst_ids->data);
-  all_edges_src_.reserve(num_edges_);
-  all_edges_dst_.reserve(num_edges_);
-  for (uint64_t i = 0; i < num_edges_; i++) {
-    auto src = src_data[i];
-    auto dst = dst_data[i];
-    CHECK(HasVertex(src) && HasVertex(dst))
-      << "Invalid vertices: src=" << src << " dst=" << dst;
-
-    adjlist_[src].succ.push_back(dst);
-    adjlist_[src].edge_id.push_back(i);
-    reverse_adjlist_[dst].succ.push_back(src);
-    reverse_adjlist_[dst].edge_id.push_back(i);
-
-    all_edges_src_.push_back(src);
-    all_edges_dst_.push_back(dst);
-  }
+  this->AddEdges(src_ids, dst_ids);
 }
 
 bool Graph::IsMultigraph() const {
@@ -70,8 +255,8 @@ bool Graph::IsMultigraph() const {
 
 void Graph::AddVertices(uint64_t num_vertices) {
   CHECK(!read_only_) << "Graph is read-only. Mutations are not allowed.";
-  adjlist_.resize(adjlist_.size() + num_vertices);
-  reverse_adjlist_.resize(reverse_adjlist_.size() + num_vertices);
+  adjlist_.AddVertices(num_vertices);
+  reverse_adjlist_.AddVertices(num_vertices);
 }
 
 void Graph::AddEdge(dgl_id_t src, dgl_id_t dst) {
@@ -81,10 +266,8 @@ void Graph::AddEdge(dgl_id_t src, dgl_id_t dst) {
 
   dgl_id_t eid = num_edges_++;
 
-  adjlist_[src].succ.push_back(dst);
-  adjlist_[src].edge_id.push_back(eid);
-  reverse_adjlist_[dst].succ.push_back(src);
-  reverse_adjlist_[dst].edge_id.push_back(eid);
+  adjlist_.Append(src, dst, eid);
+  reverse_adjlist_.Append(dst, src, eid);
 
   all_edges_src_.push_back(src);
   all_edges_dst_.push_back(dst);
@@ -111,9 +294,26 @@ void Graph::AddEdges(IdArray src_ids, IdArray dst_ids) {
   } else {
     // many-many
     CHECK(srclen == dstlen) << "Invalid src and dst id array.";
+    const int64_t nverts = NumVertices();
+    bool all_valid = true;
+#pragma omp parallel for reduction(&&:all_valid)
     for (int64_t i = 0; i < srclen; ++i) {
-      AddEdge(src_data[i], dst_data[i]);
+      all_valid = all_valid && src_data[i] >= 0 && src_data[i] < nverts
+        && dst_data[i] >= 0 && dst_data[i] < nverts;
     }
+    if (!all_valid) {
+      for (int64_t i = 0; i < srclen; ++i) {
+        CHECK(HasVertex(src_data[i]) && HasVertex(dst_data[i]))
+          << "Invalid vertices: src=" << src_data[i] << " dst=" << dst_data[i];
+      }
+    }
+    const dgl_id_t* src = reinterpret_cast<const dgl_id_t*>(src_data);
+    const dgl_id_t* dst = reinterpret_cast<const dgl_id_t*>(dst_data);
+    adjlist_.AppendBatch(src, dst, srclen, num_edges_);
+    reverse_adjlist_.AppendBatch(dst, src, srclen, num_edges_);
+    all_edges_src_.insert(all_edges_src_.end(), src, src + srclen);
+    all_edges_dst_.insert(all_edges_dst_.end(), dst, dst + srclen);
+    num_edges_ += srclen;
   }
 }
 
@@ -133,8 +333,9 @@ BoolArray Graph::HasVertices(IdArray vids) const {
 // O(E)
 bool Graph::HasEdgeBetween(dgl_id_t src, dgl_id_t dst) const {
   if (!HasVertex(src) || !HasVertex(dst)) return false;
-  const auto& succ = adjlist_[src].succ;
-  return std::find(succ.begin(), succ.end(), dst) != succ.end();
+  const dgl_id_t* succ = adjlist_.Neighbors(src);
+  const dgl_id_t* succ_end = succ + adjlist_.Degree(src);
+  return std::find(succ, succ_end, dst) != succ_end;
 }
 
 // O(E*k) pretty slow
@@ -174,8 +375,8 @@ IdArray Graph::Predecessors(dgl_id_t vid, uint64_t radius) const {
   CHECK(radius >= 1) << "invalid radius: " << radius;
   std::set<dgl_id_t> vset;
 
-  for (auto& it : reverse_adjlist_[vid].succ)
-    vset.insert(it);
+  const dgl_id_t* pred = reverse_adjlist_.Neighbors(vid);
+  vset.insert(pred, pred + reverse_adjlist_.Degree(vid));
 
   const int64_t len = vset.size();
   IdArray rst = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
@@ -191,8 +392,8 @@ IdArray Graph::Successors(dgl_id_t vid, uint64_t radius) const {
   CHECK(radius >= 1) << "invalid radius: " << radius;
   std::set<dgl_id_t> vset;
 
-  for (auto& it : adjlist_[vid].succ)
-    vset.insert(it);
+  const dgl_id_t* succ = adjlist_.Neighbors(vid);
+  vset.insert(succ, succ + adjlist_.Degree(vid));
 
   const int64_t len = vset.size();
   IdArray rst = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
@@ -206,12 +407,14 @@ IdArray Graph::Successors(dgl_id_t vid, uint64_t radius) const {
 IdArray Graph::EdgeId(dgl_id_t src, dgl_id_t dst) const {
   CHECK(HasVertex(src) && HasVertex(dst)) << "invalid edge: " << src << " -> " << dst;
 
-  const auto& succ = adjlist_[src].succ;
+  const dgl_id_t* succ = adjlist_.Neighbors(src);
+  const dgl_id_t* succ_eids = adjlist_.EdgeIds(src);
+  const uint64_t deg = adjlist_.Degree(src);
   std::vector<dgl_id_t> edgelist;
 
-  for (size_t i = 0; i < succ.size(); ++i) {
+  for (uint64_t i = 0; i < deg; ++i) {
     if (succ[i] == dst)
-      edgelist.push_back(adjlist_[src].edge_id[i]);
+      edgelist.push_back(succ_eids[i]);
   }
 
   // FIXME: signed?  Also it seems that we are using int64_t everywhere...
@@ -247,12 +450,14 @@ EdgeArray Graph::EdgeIds(IdArray src_ids, IdArray dst_ids) const {
     const dgl_id_t src_id = src_data[i], dst_id = dst_data[j];
     CHECK(HasVertex(src_id) && HasVertex(dst_id)) <<
         "invalid edge: " << src_id << " -> " << dst_id;
-    const auto& succ = adjlist_[src_id].succ;
-    for (size_t k = 0; k < succ.size(); ++k) {
+    const dgl_id_t* succ = adjlist_.Neighbors(src_id);
+    const dgl_id_t* succ_eids = adjlist_.EdgeIds(src_id);
+    const uint64_t deg = adjlist_.Degree(src_id);
+    for (uint64_t k = 0; k < deg; ++k) {
       if (succ[k] == dst_id) {
         src.push_back(src_id);
         dst.push_back(dst_id);
-        eid.push_back(adjlist_[src_id].edge_id[k]);
+        eid.push_back(succ_eids[k]);
       }
     }
   }
@@ -300,17 +505,15 @@ EdgeArray Graph::FindEdges(IdArray eids) const {
 // O(E)
 EdgeArray Graph::InEdges(dgl_id_t vid) const {
   CHECK(HasVertex(vid)) << "invalid vertex: " << vid;
-  const int64_t len = reverse_adjlist_[vid].succ.size();
+  const int64_t len = reverse_adjlist_.Degree(vid);
   IdArray src = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
   IdArray dst = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
   IdArray eid = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
   int64_t* src_data = static_cast<int64_t*>(src->data);
   int64_t* dst_data = static_cast<int64_t*>(dst->data);
   int64_t* eid_data = static_cast<int64_t*>(eid->data);
-  for (int64_t i = 0; i < len; ++i) {
-    src_data[i] = reverse_adjlist_[vid].succ[i];
-    eid_data[i] = reverse_adjlist_[vid].edge_id[i];
-  }
+  std::copy(reverse_adjlist_.Neighbors(vid), reverse_adjlist_.Neighbors(vid) + len, src_data);
+  std::copy(reverse_adjlist_.EdgeIds(vid), reverse_adjlist_.EdgeIds(vid) + len, eid_data);
   std::fill(dst_data, dst_data + len, vid);
   return EdgeArray{src, dst, eid};
 }
@@ -323,7 +526,7 @@ EdgeArray Graph::InEdges(IdArray vids) const {
   int64_t rstlen = 0;
   for (int64_t i = 0; i < len; ++i) {
     CHECK(HasVertex(vid_data[i])) << "Invalid vertex: " << vid_data[i];
-    rstlen += reverse_adjlist_[vid_data[i]].succ.size();
+    rstlen += reverse_adjlist_.Degree(vid_data[i]);
   }
   IdArray src = IdArray::Empty({rstlen}, vids->dtype, vids->ctx);
   IdArray dst = IdArray::Empty({rstlen}, vids->dtype, vids->ctx);
@@ -332,9 +535,10 @@ EdgeArray Graph::InEdges(IdArray vids) const {
   int64_t* dst_ptr = static_cast<int64_t*>(dst->data);
   int64_t* eid_ptr = static_cast<int64_t*>(eid->data);
   for (int64_t i = 0; i < len; ++i) {
-    const auto& pred = reverse_adjlist_[vid_data[i]].succ;
-    const auto& eids = reverse_adjlist_[vid_data[i]].edge_id;
-    for (size_t j = 0; j < pred.size(); ++j) {
+    const dgl_id_t* pred = reverse_adjlist_.Neighbors(vid_data[i]);
+    const dgl_id_t* eids = reverse_adjlist_.EdgeIds(vid_data[i]);
+    const uint64_t deg = reverse_adjlist_.Degree(vid_data[i]);
+    for (uint64_t j = 0; j < deg; ++j) {
       *(src_ptr++) = pred[j];
       *(dst_ptr++) = vid_data[i];
       *(eid_ptr++) = eids[j];
@@ -346,17 +550,15 @@ EdgeArray Graph::InEdges(IdArray vids) const {
 // O(E)
 EdgeArray Graph::OutEdges(dgl_id_t vid) const {
   CHECK(HasVertex(vid)) << "invalid vertex: " << vid;
-  const int64_t len = adjlist_[vid].succ.size();
+  const int64_t len = adjlist_.Degree(vid);
   IdArray src = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
   IdArray dst = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
   IdArray eid = IdArray::Empty({len}, DLDataType{kDLInt, 64, 1}, DLContext{kDLCPU, 0});
   int64_t* src_data = static_cast<int64_t*>(src->data);
   int64_t* dst_data = static_cast<int64_t*>(dst->data);
   int64_t* eid_data = static_cast<int64_t*>(eid->data);
-  for (int64_t i = 0; i < len; ++i) {
-    dst_data[i] = adjlist_[vid].succ[i];
-    eid_data[i] = adjlist_[vid].edge_id[i];
-  }
+  std::copy(adjlist_.Neighbors(vid), adjlist_.Neighbors(vid) + len, dst_data);
+  std::copy(adjlist_.EdgeIds(vid), adjlist_.EdgeIds(vid) + len, eid_data);
   std::fill(src_data, src_data + len, vid);
   return EdgeArray{src, dst, eid};
 }
@@ -369,7 +571,7 @@ EdgeArray Graph::OutEdges(IdArray vids) const {
   int64_t rstlen = 0;
   for (int64_t i = 0; i < len; ++i) {
     CHECK(HasVertex(vid_data[i])) << "Invalid vertex: " << vid_data[i];
-    rstlen += adjlist_[vid_data[i]].succ.size();
+    rstlen += adjlist_.Degree(vid_data[i]);
   }
   IdArray src = IdArray::Empty({rstlen}, vids->dtype, vids->ctx);
   IdArray dst = IdArray::Empty({rstlen}, vids->dtype, vids->ctx);
@@ -378,9 +580,10 @@ EdgeArray Graph::OutEdges(IdArray vids) const {
   int64_t* dst_ptr = static_cast<int64_t*>(dst->data);
   int64_t* eid_ptr = static_cast<int64_t*>(eid->data);
   for (int64_t i = 0; i < len; ++i) {
-    const auto& succ = adjlist_[vid_data[i]].succ;
-    const auto& eids = adjlist_[vid_data[i]].edge_id;
-    for (size_t j = 0; j < succ.size(); ++j) {
+    const dgl_id_t* succ = adjlist_.Neighbors(vid_data[i]);
+    const dgl_id_t* eids = adjlist_.EdgeIds(vid_data[i]);
+    const uint64_t deg = adjlist_.Degree(vid_data[i]);
+    for (uint64_t j = 0; j < deg; ++j) {
       *(src_ptr++) = vid_data[i];
       *(dst_ptr++) = succ[j];
       *(eid_ptr++) = eids[j];
@@ -443,7 +646,7 @@ DegreeArray Graph::InDegrees(IdArray vids) const {
   for (int64_t i = 0; i < len; ++i) {
     const auto vid = vid_data[i];
     CHECK(HasVertex(vid)) << "Invalid vertex: " << vid;
-    rst_data[i] = reverse_adjlist_[vid].succ.size();
+    rst_data[i] = reverse_adjlist_.Degree(vid);
   }
   return rst;
 }
@@ -458,7 +661,7 @@ DegreeArray Graph::OutDegrees(IdArray vids) const {
   for (int64_t i = 0; i < len; ++i) {
     const auto vid = vid_data[i];
     CHECK(HasVertex(vid)) << "Invalid vertex: " << vid;
-    rst_data[i] = adjlist_[vid].succ.size();
+    rst_data[i] = adjlist_.Degree(vid);
   }
   return rst;
 }
@@ -479,11 +682,13 @@ Subgraph Graph::VertexSubgraph(IdArray vids) const {
   for (int64_t i = 0; i < len; ++i) {
     const dgl_id_t oldvid = vid_data[i];
     const dgl_id_t newvid = i;
-    for (size_t j = 0; j < adjlist_[oldvid].succ.size(); ++j) {
-      const dgl_id_t oldsucc = adjlist_[oldvid].succ[j];
+    const dgl_id_t* succ = adjlist_.Neighbors(oldvid);
+    const dgl_id_t* succ_eids = adjlist_.EdgeIds(oldvid);
+    for (uint64_t j = 0; j < adjlist_.Degree(oldvid); ++j) {
+      const dgl_id_t oldsucc = succ[j];
       if (oldv2newv.count(oldsucc)) {
         const dgl_id_t newsucc = oldv2newv[oldsucc];
-        edges.push_back(adjlist_[oldvid].edge_id[j]);
+        edges.push_back(succ_eids[j]);
         rst.graph->AddEdge(newvid, newsucc);
       }
     }
@@ -588,21 +793,16 @@ std::vector<IdArray> Graph::GetAdj(bool transpose, const std::string &fmt) const
     int64_t *indptr_data = static_cast<int64_t*>(indptr->data);
     int64_t *indices_data = static_cast<int64_t*>(indices->data);
     int64_t *eid_data = static_cast<int64_t*>(eid->data);
-    const AdjacencyList *adjlist;
     if (transpose) {
       // Out-edges.
-      adjlist = &adjlist_;
+      adjlist_.ToCSR(reinterpret_cast<dgl_id_t*>(indptr_data),
+                     reinterpret_cast<dgl_id_t*>(indices_data),
+                     reinterpret_cast<dgl_id_t*>(eid_data));
     } else {
       // In-edges.
-      adjlist = &reverse_adjlist_;
-    }
-    indptr_data[0] = 0;
-    for (size_t i = 0; i < adjlist->size(); i++) {
-      indptr_data[i + 1] = indptr_data[i] + adjlist->at(i).succ.size();
-      std::copy(adjlist->at(i).succ.begin(), adjlist->at(i).succ.end(),
-                indices_data + indptr_data[i]);
-      std::copy(adjlist->at(i).edge_id.begin(), adjlist->at(i).edge_id.end(),
-                eid_data + indptr_data[i]);
+      reverse_adjlist_.ToCSR(reinterpret_cast<dgl_id_t*>(indptr_data),
+                             reinterpret_cast<dgl_id_t*>(indices_data),
+                             reinterpret_cast<dgl_id_t*>(eid_data));
     }
     return std::vector<IdArray>{indptr, indices, eid};
   } else {
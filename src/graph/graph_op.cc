@@ -65,9 +65,11 @@ GraphPtr GraphOp::LineGraph(GraphPtr g, bool backtracking) {
   for (size_t i = 0; i < mg->all_edges_src_.size(); ++i) {
     const auto u = mg->all_edges_src_[i];
     const auto v = mg->all_edges_dst_[i];
-    for (size_t j = 0; j < mg->adjlist_[v].succ.size(); ++j) {
-      if (backtracking || (!backtracking && mg->adjlist_[v].succ[j] != u)) {
-        lg->AddEdge(i, mg->adjlist_[v].edge_id[j]);
+    const dgl_id_t* succ = mg->adjlist_.Neighbors(v);
+    const dgl_id_t* succ_eids = mg->adjlist_.EdgeIds(v);
+    for (uint64_t j = 0; j < mg->adjlist_.Degree(v); ++j) {
+      if (backtracking || (!backtracking && succ[j] != u)) {
+        lg->AddEdge(i, succ_eids[j]);
       }
     }
   }
@@ -167,37 +169,21 @@ std::vector<GraphPtr> GraphOp::DisjointPartitionBySizes(
     dgl_id_t node_offset = 0, edge_offset = 0;
     for (int64_t i = 0; i < len; ++i) {
       MutableGraphPtr mg = Graph::Create();
-      // TODO(minjie): quite ugly to expose internal members
-      // copy adj
-      mg->adjlist_.insert(mg->adjlist_.end(),
-          graph->adjlist_.begin() + node_offset,
-          graph->adjlist_.begin() + node_offset + sizes_data[i]);
-      mg->reverse_adjlist_.insert(mg->reverse_adjlist_.end(),
-          graph->reverse_adjlist_.begin() + node_offset,
-          graph->reverse_adjlist_.begin() + node_offset + sizes_data[i]);
-      // relabel adjs
+      // Edges of a component are contiguous in the batched graph, so rebuilding
+      // the component from its edge range reproduces the same adjacency.
       size_t num_edges = 0;
-      for (auto& elist : mg->adjlist_) {
-        for (size_t j = 0; j < elist.succ.size(); ++j) {
-          elist.succ[j] -= node_offset;
-          elist.edge_id[j] -= edge_offset;
-        }
-        num_edges += elist.succ.size();
-      }
-      for (auto& elist : mg->reverse_adjlist_) {
-        for (size_t j = 0; j < elist.succ.size(); ++j) {
-          elist.succ[j] -= node_offset;
-          elist.edge_id[j] -= edge_offset;
-        }
-      }
-      // copy edges
-      mg->all_edges_src_.reserve(num_edges);
-      mg->all_edges_dst_.reserve(num_edges);
-      mg->num_edges_ = num_edges;
-      for (size_t j = edge_offset; j < edge_offset + num_edges; ++j) {
-        mg->all_edges_src_.push_back(graph->all_edges_src_[j] - node_offset);
-        mg->all_edges_dst_.push_back(graph->all_edges_dst_[j] - node_offset);
+      for (dgl_id_t v = node_offset; v < node_offset + sizes_data[i]; ++v)
+        num_edges += graph->adjlist_.Degree(v);
+      IdArray src = aten::NewIdArray(num_edges);
+      IdArray dst = aten::NewIdArray(num_edges);
+      int64_t* src_data = static_cast<int64_t*>(src->data);
+      int64_t* dst_data = static_cast<int64_t*>(dst->data);
+      for (size_t j = 0; j < num_edges; ++j) {
+        src_data[j] = graph->all_edges_src_[edge_offset + j] - node_offset;
+        dst_data[j] = graph->all_edges_dst_[edge_offset + j] - node_offset;
       }
+      mg->AddVertices(sizes_data[i]);
+      mg->AddEdges(src, dst);
       // push to rst
       rst.push_back(mg);
       // update offset
@@ -0,0 +1,201 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/graph_stats.cc
+ * \brief Cached structural statistics of a relation graph.
+ */
+#include "./graph_stats.h"
+
+#include <algorithm>
+
+#include "./unit_graph.h"
+
+namespace dgl {
+
+namespace {
+
+template <typename IdType>
+void RowNNZ(const IdType* indptr, int64_t num_rows, IdType* out) {
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_rows; ++i)
+    out[i] = indptr[i + 1] - indptr[i];
+}
+
+// Count the occurrences of every ID into out, which must be zero-filled.
+template <typename IdType>
+void CountIds(const IdType* ids, int64_t len, IdType* out) {
+#pragma omp parallel for
+  for (int64_t i = 0; i < len; ++i) {
+#pragma omp atomic
+    ++out[ids[i]];
+  }
+}
+
+template <typename IdType>
+int64_t Max(const IdType* data, int64_t len) {
+  int64_t ret = 0;
+#pragma omp parallel for reduction(max:ret)
+  for (int64_t i = 0; i < len; ++i)
+    ret = std::max<int64_t>(ret, data[i]);
+  return ret;
+}
+
+template <typename IdType>
+void Histogram(const IdType* data, int64_t len, int64_t* out) {
+#pragma omp parallel for
+  for (int64_t i = 0; i < len; ++i) {
+#pragma omp atomic
+    ++out[data[i]];
+  }
+}
+
+template <typename IdType>
+int64_t CountEqual(const IdType* row, const IdType* col, int64_t len) {
+  int64_t ret = 0;
+#pragma omp parallel for reduction(+:ret)
+  for (int64_t i = 0; i < len; ++i)
+    ret += (row[i] == col[i]);
+  return ret;
+}
+
+template <typename IdType>
+int64_t CountDiagonal(const aten::CSRMatrix& csr) {
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  int64_t ret = 0;
+#pragma omp parallel for reduction(+:ret)
+  for (int64_t i = 0; i < csr.num_rows; ++i)
+    for (IdType j = indptr[i]; j < indptr[i + 1]; ++j)
+      ret += (indices[j] == i);
+  return ret;
+}
+
+void CheckCPU(const UnitGraph& graph) {
+  CHECK_EQ(graph.Context().device_type, kDLCPU)
+    << "Graph statistics are only available for graphs on CPU";
+}
+
+// Number of nonzeros of each row (transpose = false) or column (transpose = true)
+// of the adjacency matrix, computed from a format that exists.
+DegreeArray ComputeDegrees(const UnitGraph& graph, bool transpose) {
+  CheckCPU(graph);
+  const dgl_format_code_t created = graph.GetCreatedFormats();
+  const int64_t num_rows = graph.NumVertices(transpose ? graph.DstType() : graph.SrcType());
+  DegreeArray ret;
+  ATEN_ID_TYPE_SWITCH(graph.DataType(), IdType, {
+    if (created & (transpose ? csc_code : csr_code)) {
+      const auto csr = transpose ? graph.GetCSCMatrix(0) : graph.GetCSRMatrix(0);
+      ret = NDArray::Empty({num_rows}, graph.DataType(), graph.Context());
+      RowNNZ(csr.indptr.Ptr<IdType>(), num_rows, ret.Ptr<IdType>());
+    } else {
+      ret = aten::Full(0, num_rows, graph.NumBits(), graph.Context());
+      if (created & (transpose ? csr_code : csc_code)) {
+        const auto csr = transpose ? graph.GetCSRMatrix(0) : graph.GetCSCMatrix(0);
+        CountIds(csr.indices.Ptr<IdType>(), csr.indices->shape[0], ret.Ptr<IdType>());
+      } else {
+        const auto coo = graph.GetCOOMatrix(0);
+        const IdArray ids = transpose ? coo.col : coo.row;
+        CountIds(ids.Ptr<IdType>(), ids->shape[0], ret.Ptr<IdType>());
+      }
+    }
+  });
+  return ret;
+}
+
+int64_t ComputeMax(DegreeArray degrees) {
+  int64_t ret = 0;
+  ATEN_ID_TYPE_SWITCH(degrees->dtype, IdType, {
+    ret = Max(degrees.Ptr<IdType>(), degrees->shape[0]);
+  });
+  return ret;
+}
+
+IdArray ComputeHistogram(DegreeArray degrees, int64_t max_degree) {
+  IdArray ret = aten::Full(0, max_degree + 1, 64, degrees->ctx);
+  ATEN_ID_TYPE_SWITCH(degrees->dtype, IdType, {
+    Histogram(degrees.Ptr<IdType>(), degrees->shape[0], ret.Ptr<int64_t>());
+  });
+  return ret;
+}
+
+}  // namespace
+
+DegreeArray GraphStats::InDegrees(const UnitGraph& graph) {
+  std::call_once(in_degrees_.once, [&] () {
+    in_degrees_.value = ComputeDegrees(graph, true);
+  });
+  return in_degrees_.value;
+}
+
+DegreeArray GraphStats::OutDegrees(const UnitGraph& graph) {
+  std::call_once(out_degrees_.once, [&] () {
+    out_degrees_.value = ComputeDegrees(graph, false);
+  });
+  return out_degrees_.value;
+}
+
+int64_t GraphStats::MaxInDegree(const UnitGraph& graph) {
+  std::call_once(max_in_degree_.once, [&] () {
+    max_in_degree_.value = ComputeMax(InDegrees(graph));
+  });
+  return max_in_degree_.value;
+}
+
+int64_t GraphStats::MaxOutDegree(const UnitGraph& graph) {
+  std::call_once(max_out_degree_.once, [&] () {
+    max_out_degree_.value = ComputeMax(OutDegrees(graph));
+  });
+  return max_out_degree_.value;
+}
+
+IdArray GraphStats::InDegreeHistogram(const UnitGraph& graph) {
+  std::call_once(in_degree_hist_.once, [&] () {
+    in_degree_hist_.value = ComputeHistogram(InDegrees(graph), MaxInDegree(graph));
+  });
+  return in_degree_hist_.value;
+}
+
+IdArray GraphStats::OutDegreeHistogram(const UnitGraph& graph) {
+  std::call_once(out_degree_hist_.once, [&] () {
+    out_degree_hist_.value = ComputeHistogram(OutDegrees(graph), MaxOutDegree(graph));
+  });
+  return out_degree_hist_.value;
+}
+
+bool GraphStats::HasDuplicate(const UnitGraph& graph) {
+  std::call_once(has_duplicate_.once, [&] () {
+    has_duplicate_.value = graph.GetFormat(graph.SelectFormat(csc_code))->IsMultigraph();
+  });
+  return has_duplicate_.value;
+}
+
+int64_t GraphStats::NumSelfLoops(const UnitGraph& graph) {
+  std::call_once(num_self_loops_.once, [&] () {
+    CheckCPU(graph);
+    const dgl_format_code_t created = graph.GetCreatedFormats();
+    ATEN_ID_TYPE_SWITCH(graph.DataType(), IdType, {
+      if (created & coo_code) {
+        const auto coo = graph.GetCOOMatrix(0);
+        num_self_loops_.value = CountEqual(
+            coo.row.Ptr<IdType>(), coo.col.Ptr<IdType>(), coo.row->shape[0]);
+      } else {
+        num_self_loops_.value = CountDiagonal<IdType>(
+            (created & csr_code) ? graph.GetCSRMatrix(0) : graph.GetCSCMatrix(0));
+      }
+    });
+  });
+  return num_self_loops_.value;
+}
+
+std::pair<bool, bool> GraphStats::COOSorted(const UnitGraph& graph) {
+  std::call_once(coo_sorted_.once, [&] () {
+    CHECK(graph.GetCreatedFormats() & coo_code) << "The graph has no COO matrix";
+    const auto coo = graph.GetCOOMatrix(0);
+    if (coo.row_sorted && coo.col_sorted)
+      coo_sorted_.value = {true, true};
+    else
+      coo_sorted_.value = aten::COOIsSorted(coo);
+  });
+  return coo_sorted_.value;
+}
+
+}  // namespace dgl
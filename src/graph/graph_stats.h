@@ -0,0 +1,88 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/graph_stats.h
+ * \brief Cached structural statistics of a relation graph.
+ */
+#ifndef DGL_GRAPH_GRAPH_STATS_H_
+#define DGL_GRAPH_GRAPH_STATS_H_
+
+#include <dgl/array.h>
+#include <mutex>
+#include <utility>
+
+namespace dgl {
+
+class UnitGraph;
+
+/*!
+ * \brief Structural statistics of a relation graph, computed on first use.
+ *
+ * The structure of a UnitGraph never changes once it is created; only more
+ * sparse formats get materialized. Each statistic is hence computed at most
+ * once, in parallel, from a format that already exists, and is shared by all
+ * the graphs with the same structure, e.g. the ones returned by
+ * GetGraphInFormat. A graph whose structure is replaced, e.g. by loading it
+ * from a stream, must get new statistics.
+ *
+ * All the methods are thread-safe. The statistics are only available for
+ * graphs on CPU.
+ */
+class GraphStats {
+ public:
+  /*! \return The in-degree of every destination node. */
+  DegreeArray InDegrees(const UnitGraph& graph);
+
+  /*! \return The out-degree of every source node. */
+  DegreeArray OutDegrees(const UnitGraph& graph);
+
+  /*! \return The largest in-degree, 0 if there is no destination node. */
+  int64_t MaxInDegree(const UnitGraph& graph);
+
+  /*! \return The largest out-degree, 0 if there is no source node. */
+  int64_t MaxOutDegree(const UnitGraph& graph);
+
+  /*!
+   * \return An int64 array whose d-th element is the number of destination
+   *         nodes of in-degree d, for d up to the largest in-degree.
+   */
+  IdArray InDegreeHistogram(const UnitGraph& graph);
+
+  /*!
+   * \return An int64 array whose d-th element is the number of source nodes
+   *         of out-degree d, for d up to the largest out-degree.
+   */
+  IdArray OutDegreeHistogram(const UnitGraph& graph);
+
+  /*! \return Whether the graph has parallel edges. */
+  bool HasDuplicate(const UnitGraph& graph);
+
+  /*! \return The number of edges whose source and destination IDs are equal. */
+  int64_t NumSelfLoops(const UnitGraph& graph);
+
+  /*!
+   * \brief Whether the COO matrix of the graph is sorted by row, and by column
+   *        within each row.
+   *
+   * The graph must have its COO matrix.
+   */
+  std::pair<bool, bool> COOSorted(const UnitGraph& graph);
+
+ private:
+  /*! \brief A statistic and the flag of its computation */
+  template <typename T>
+  struct Lazy {
+    std::once_flag once;
+    T value;
+  };
+
+  Lazy<DegreeArray> in_degrees_, out_degrees_;
+  Lazy<int64_t> max_in_degree_, max_out_degree_;
+  Lazy<IdArray> in_degree_hist_, out_degree_hist_;
+  Lazy<bool> has_duplicate_;
+  Lazy<int64_t> num_self_loops_;
+  Lazy<std::pair<bool, bool>> coo_sorted_;
+};
+
+}  // namespace dgl
+
+#endif  // DGL_GRAPH_GRAPH_STATS_H_
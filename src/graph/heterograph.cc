@@ -265,7 +265,7 @@ HeteroGraphPtr HeteroGraph::CopyTo(HeteroGraphPtr g, const DLContext& ctx) {
 }
 
 std::string HeteroGraph::SharedMemName() const {
-  return shared_mem_ ? shared_mem_->GetName() : "";
+  return shared_store_ ? shared_store_->name() : "";
 }
 
 HeteroGraphPtr HeteroGraph::CopyToSharedMem(
@@ -277,100 +277,65 @@ HeteroGraphPtr HeteroGraph::CopyToSharedMem(
   if (hg->SharedMemName() == name)
     return g;
 
-  // Copy buffer to share memory
-  auto mem = std::make_shared<SharedMemory>(name);
-  auto mem_buf = mem->CreateNew(SHARED_MEM_METAINFO_SIZE_MAX);
-  dmlc::MemoryFixedSizeStream strm(mem_buf, SHARED_MEM_METAINFO_SIZE_MAX);
-  SharedMemManager shm(name, &strm);
-
-  bool has_coo = fmts.find("coo") != fmts.end();
-  bool has_csr = fmts.find("csr") != fmts.end();
-  bool has_csc = fmts.find("csc") != fmts.end();
-  shm.Write(g->NumBits());
-  shm.Write(has_coo);
-  shm.Write(has_csr);
-  shm.Write(has_csc);
-  shm.Write(ImmutableGraph::ToImmutable(hg->meta_graph_));
-  shm.Write(hg->num_verts_per_type_);
-
+  auto store = SharedGraphStore::Create(name, g->NumEdgeTypes());
+  dmlc::Stream* strm = store->MetaStream();
+  strm->Write(g->NumBits());
+  strm->Write(ImmutableGraph::ToImmutable(hg->meta_graph_));
+  strm->Write(hg->num_verts_per_type_);
+  strm->Write(ntypes);
+  strm->Write(etypes);
+
+  // Publish the requested formats now; the others are published by the first
+  // process that needs them.
+  const bool has_coo = fmts.find("coo") != fmts.end();
+  const bool has_csr = fmts.find("csr") != fmts.end();
+  const bool has_csc = fmts.find("csc") != fmts.end();
   std::vector<HeteroGraphPtr> relgraphs(g->NumEdgeTypes());
-
   for (dgl_type_t etype = 0 ; etype < g->NumEdgeTypes() ; ++etype) {
-    aten::COOMatrix coo;
-    aten::CSRMatrix csr, csc;
-    std::string prefix = name + "_" + std::to_string(etype);
-    if (has_coo) {
-      coo = shm.CopyToSharedMem(hg->GetCOOMatrix(etype), prefix + "_coo");
-    }
-    if (has_csr) {
-      csr = shm.CopyToSharedMem(hg->GetCSRMatrix(etype), prefix + "_csr");
-    }
-    if (has_csc) {
-      csc = shm.CopyToSharedMem(hg->GetCSCMatrix(etype), prefix + "_csc");
-    }
-    relgraphs[etype] = UnitGraph::CreateHomographFrom(csc, csr, coo, has_csc, has_csr, has_coo);
+    if (has_coo)
+      store->FetchOrBuildCOO(etype, [&] () { return hg->GetCOOMatrix(etype); });
+    if (has_csr)
+      store->FetchOrBuildCSR(etype, csr_code, [&] () { return hg->GetCSRMatrix(etype); });
+    if (has_csc)
+      store->FetchOrBuildCSR(etype, csc_code, [&] () { return hg->GetCSCMatrix(etype); });
+    relgraphs[etype] = UnitGraph::CreateFromSharedStore(store, etype);
   }
 
   auto ret = std::shared_ptr<HeteroGraph>(
       new HeteroGraph(hg->meta_graph_, relgraphs, hg->num_verts_per_type_));
-  ret->shared_mem_ = mem;
-
-  shm.Write(ntypes);
-  shm.Write(etypes);
+  ret->shared_store_ = store;
   return ret;
 }
 
 std::tuple<HeteroGraphPtr, std::vector<std::string>, std::vector<std::string>>
     HeteroGraph::CreateFromSharedMem(const std::string &name) {
-  bool exist = SharedMemory::Exist(name);
-  if (!exist) {
+  auto store = SharedGraphStore::Open(name);
+  if (!store) {
     return std::make_tuple(nullptr, std::vector<std::string>(), std::vector<std::string>());
   }
-  auto mem = std::make_shared<SharedMemory>(name);
-  auto mem_buf = mem->Open(SHARED_MEM_METAINFO_SIZE_MAX);
-  dmlc::MemoryFixedSizeStream strm(mem_buf, SHARED_MEM_METAINFO_SIZE_MAX);
-  SharedMemManager shm(name, &strm);
+  dmlc::Stream* strm = store->MetaStream();
 
   uint8_t nbits;
-  CHECK(shm.Read(&nbits)) << "invalid nbits (unit8_t)";
-
-  bool has_coo, has_csr, has_csc;
-  CHECK(shm.Read(&has_coo)) << "invalid nbits (unit8_t)";
-  CHECK(shm.Read(&has_csr)) << "invalid csr (unit8_t)";
-  CHECK(shm.Read(&has_csc)) << "invalid csc (unit8_t)";
+  CHECK(strm->Read(&nbits)) << "invalid nbits (unit8_t)";
 
   auto meta_imgraph = Serializer::make_shared<ImmutableGraph>();
-  CHECK(shm.Read(&meta_imgraph)) << "Invalid meta graph";
+  CHECK(strm->Read(&meta_imgraph)) << "Invalid meta graph";
   GraphPtr metagraph = meta_imgraph;
 
   std::vector<int64_t> num_verts_per_type;
-  CHECK(shm.Read(&num_verts_per_type)) << "Invalid number of vertices per type";
+  CHECK(strm->Read(&num_verts_per_type)) << "Invalid number of vertices per type";
 
-  std::vector<HeteroGraphPtr> relgraphs(metagraph->NumEdges());
-  for (dgl_type_t etype = 0 ; etype < metagraph->NumEdges() ; ++etype) {
-    aten::COOMatrix coo;
-    aten::CSRMatrix csr, csc;
-    std::string prefix = name + "_" + std::to_string(etype);
-    if (has_coo) {
-      shm.CreateFromSharedMem(&coo, prefix + "_coo");
-    }
-    if (has_csr) {
-      shm.CreateFromSharedMem(&csr, prefix + "_csr");
-    }
-    if (has_csc) {
-      shm.CreateFromSharedMem(&csc, prefix + "_csc");
-    }
+  std::vector<std::string> ntypes;
+  std::vector<std::string> etypes;
+  CHECK(strm->Read(&ntypes)) << "invalid ntypes";
+  CHECK(strm->Read(&etypes)) << "invalid etypes";
 
-    relgraphs[etype] = UnitGraph::CreateHomographFrom(csc, csr, coo, has_csc, has_csr, has_coo);
-  }
+  std::vector<HeteroGraphPtr> relgraphs(metagraph->NumEdges());
+  for (dgl_type_t etype = 0 ; etype < metagraph->NumEdges() ; ++etype)
+    relgraphs[etype] = UnitGraph::CreateFromSharedStore(store, etype);
 
   auto ret = std::make_shared<HeteroGraph>(metagraph, relgraphs, num_verts_per_type);
-  ret->shared_mem_ = mem;
-
-  std::vector<std::string> ntypes;
-  std::vector<std::string> etypes;
-  CHECK(shm.Read(&ntypes)) << "invalid ntypes";
-  CHECK(shm.Read(&etypes)) << "invalid etypes";
+  ret->shared_store_ = store;
   return std::make_tuple(ret, ntypes, etypes);
 }
 
@@ -386,20 +351,68 @@ HeteroGraphPtr HeteroGraph::GetGraphInFormat(dgl_format_code_t formats) const {
 
 FlattenedHeteroGraphPtr HeteroGraph::Flatten(
     const std::vector<dgl_type_t>& etypes) const {
+  {
+    std::lock_guard<std::mutex> lock(flatten_cache_->mutex);
+    auto it = flatten_cache_->graphs.find(etypes);
+    if (it != flatten_cache_->graphs.end())
+      return it->second;
+  }
+  FlattenedHeteroGraphPtr result;
   const int64_t bits = NumBits();
   if (bits == 32) {
-    return FlattenImpl<int32_t>(etypes);
+    result = FlattenImpl<int32_t>(etypes);
   } else {
-    return FlattenImpl<int64_t>(etypes);
+    result = FlattenImpl<int64_t>(etypes);
   }
+  // Another thread flattening the same edge types meanwhile wins.
+  std::lock_guard<std::mutex> lock(flatten_cache_->mutex);
+  return flatten_cache_->graphs.emplace(etypes, result).first->second;
 }
 
+namespace {
+
+// Fill the type and the per-type ID of the nodes of the given types, which
+// are numbered consecutively from the given offsets.
+void FillInducedNodes(const std::vector<dgl_type_t>& ntypes,
+                      const std::vector<int64_t>& offsets,
+                      const std::vector<int64_t>& num_nodes,
+                      int64_t* induced_type, int64_t* induced_id) {
+  for (size_t i = 0; i < ntypes.size(); ++i) {
+    const int64_t ntype = ntypes[i];
+    int64_t* type_data = induced_type + offsets[i];
+    int64_t* id_data = induced_id + offsets[i];
+#pragma omp parallel for
+    for (int64_t j = 0; j < num_nodes[i]; ++j) {
+      type_data[j] = ntype;
+      id_data[j] = j;
+    }
+  }
+}
+
+// Copy the edges of a relation to position offset of the flattened edge arrays.
+template <class IdType>
+void FillFlattenedEdges(const EdgeArray& edges, IdType src_offset, IdType dst_offset,
+                        IdType etype, int64_t offset, IdType* src, IdType* dst,
+                        IdType* eid, IdType* induced_etype) {
+  const IdType* src_data = static_cast<IdType*>(edges.src->data);
+  const IdType* dst_data = static_cast<IdType*>(edges.dst->data);
+  const IdType* eid_data = static_cast<IdType*>(edges.id->data);
+  const int64_t num_edges = edges.src->shape[0];
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_edges; ++i) {
+    src[offset + i] = src_data[i] + src_offset;
+    dst[offset + i] = dst_data[i] + dst_offset;
+    eid[offset + i] = eid_data[i];
+    induced_etype[offset + i] = etype;
+  }
+}
+
+}  // namespace
+
 template <class IdType>
 FlattenedHeteroGraphPtr HeteroGraph::FlattenImpl(const std::vector<dgl_type_t>& etypes) const {
   std::unordered_map<dgl_type_t, size_t> srctype_offsets, dsttype_offsets;
   size_t src_nodes = 0, dst_nodes = 0;
-  std::vector<dgl_type_t> induced_srctype, induced_dsttype;
-  std::vector<IdType> induced_srcid, induced_dstid;
   std::vector<dgl_type_t> srctype_set, dsttype_set;
 
   // XXXtype_offsets contain the mapping from node type and number of nodes after this
@@ -429,74 +442,124 @@ FlattenedHeteroGraphPtr HeteroGraph::FlattenImpl(const std::vector<dgl_type_t>&
 
   // XXXtype_offsets contain the mapping from node type to node ID offsets after these
   // two loops.
-  for (size_t i = 0; i < srctype_set.size(); ++i) {
-    dgl_type_t ntype = srctype_set[i];
-    size_t num_nodes = srctype_offsets[ntype];
+  std::vector<int64_t> src_offsets, src_counts, dst_offsets, dst_counts;
+  for (dgl_type_t ntype : srctype_set) {
+    const size_t num_nodes = srctype_offsets[ntype];
     srctype_offsets[ntype] = src_nodes;
+    src_offsets.push_back(src_nodes);
+    src_counts.push_back(num_nodes);
     src_nodes += num_nodes;
-    for (size_t j = 0; j < num_nodes; ++j) {
-      induced_srctype.push_back(ntype);
-      induced_srcid.push_back(j);
-    }
   }
-  for (size_t i = 0; i < dsttype_set.size(); ++i) {
-    dgl_type_t ntype = dsttype_set[i];
-    size_t num_nodes = dsttype_offsets[ntype];
+  for (dgl_type_t ntype : dsttype_set) {
+    const size_t num_nodes = dsttype_offsets[ntype];
     dsttype_offsets[ntype] = dst_nodes;
+    dst_offsets.push_back(dst_nodes);
+    dst_counts.push_back(num_nodes);
     dst_nodes += num_nodes;
-    for (size_t j = 0; j < num_nodes; ++j) {
-      induced_dsttype.push_back(ntype);
-      induced_dstid.push_back(j);
-    }
   }
-
-  // TODO(minjie): Using concat operations cause many fragmented memory.
-  //   Need to optimize it in the future.
-  std::vector<IdArray> src_arrs, dst_arrs, eid_arrs, induced_etypes;
-  src_arrs.reserve(etypes.size());
-  dst_arrs.reserve(etypes.size());
-  eid_arrs.reserve(etypes.size());
-  induced_etypes.reserve(etypes.size());
-  for (dgl_type_t etype : etypes) {
-    auto src_dsttype = meta_graph_->FindEdge(etype);
-    dgl_type_t srctype = src_dsttype.first;
-    dgl_type_t dsttype = src_dsttype.second;
-    size_t srctype_offset = srctype_offsets[srctype];
-    size_t dsttype_offset = dsttype_offsets[dsttype];
-
-    EdgeArray edges = Edges(etype);
-    size_t num_edges = NumEdges(etype);
-    src_arrs.push_back(edges.src + srctype_offset);
-    dst_arrs.push_back(edges.dst + dsttype_offset);
-    eid_arrs.push_back(edges.id);
-    induced_etypes.push_back(aten::Full(etype, num_edges, NumBits(), Context()));
+  const DLContext cpu_ctx{kDLCPU, 0};
+  IdArray induced_srctype = aten::NewIdArray(src_nodes, cpu_ctx, 64);
+  IdArray induced_srcid = aten::NewIdArray(src_nodes, cpu_ctx, 64);
+  IdArray induced_dsttype = aten::NewIdArray(dst_nodes, cpu_ctx, 64);
+  IdArray induced_dstid = aten::NewIdArray(dst_nodes, cpu_ctx, 64);
+  FillInducedNodes(srctype_set, src_offsets, src_counts,
+                   induced_srctype.Ptr<int64_t>(), induced_srcid.Ptr<int64_t>());
+  FillInducedNodes(dsttype_set, dst_offsets, dst_counts,
+                   induced_dsttype.Ptr<int64_t>(), induced_dstid.Ptr<int64_t>());
+
+  IdArray src, dst, eid, induced_etype;
+  if (Context().device_type == kDLCPU) {
+    // Write the edges of all the relations at once into the flattened arrays.
+    int64_t num_edges = 0;
+    for (dgl_type_t etype : etypes)
+      num_edges += NumEdges(etype);
+    src = aten::NewIdArray(num_edges, Context(), NumBits());
+    dst = aten::NewIdArray(num_edges, Context(), NumBits());
+    eid = aten::NewIdArray(num_edges, Context(), NumBits());
+    induced_etype = aten::NewIdArray(num_edges, Context(), NumBits());
+    int64_t offset = 0;
+    for (dgl_type_t etype : etypes) {
+      auto src_dsttype = meta_graph_->FindEdge(etype);
+      const EdgeArray edges = Edges(etype);
+      FillFlattenedEdges<IdType>(
+          edges, srctype_offsets[src_dsttype.first], dsttype_offsets[src_dsttype.second],
+          etype, offset, src.Ptr<IdType>(), dst.Ptr<IdType>(), eid.Ptr<IdType>(),
+          induced_etype.Ptr<IdType>());
+      offset += edges.src->shape[0];
+    }
+  } else {
+    // TODO(minjie): Using concat operations cause many fragmented memory.
+    //   Need to optimize it in the future.
+    std::vector<IdArray> src_arrs, dst_arrs, eid_arrs, induced_etypes;
+    src_arrs.reserve(etypes.size());
+    dst_arrs.reserve(etypes.size());
+    eid_arrs.reserve(etypes.size());
+    induced_etypes.reserve(etypes.size());
+    for (dgl_type_t etype : etypes) {
+      auto src_dsttype = meta_graph_->FindEdge(etype);
+      dgl_type_t srctype = src_dsttype.first;
+      dgl_type_t dsttype = src_dsttype.second;
+      size_t srctype_offset = srctype_offsets[srctype];
+      size_t dsttype_offset = dsttype_offsets[dsttype];
+
+      EdgeArray edges = Edges(etype);
+      size_t num_edges = NumEdges(etype);
+      src_arrs.push_back(edges.src + srctype_offset);
+      dst_arrs.push_back(edges.dst + dsttype_offset);
+      eid_arrs.push_back(edges.id);
+      induced_etypes.push_back(aten::Full(etype, num_edges, NumBits(), Context()));
+    }
+    src = aten::Concat(src_arrs);
+    dst = aten::Concat(dst_arrs);
+    eid = aten::Concat(eid_arrs);
+    induced_etype = aten::Concat(induced_etypes);
   }
 
   HeteroGraphPtr gptr = UnitGraph::CreateFromCOO(
       homograph ? 1 : 2,
       src_nodes,
       dst_nodes,
-      aten::Concat(src_arrs),
-      aten::Concat(dst_arrs));
+      src,
+      dst);
 
   // Sanity check
   CHECK_EQ(gptr->Context(), Context());
   CHECK_EQ(gptr->NumBits(), NumBits());
 
+  // The induced nodes are computed on CPU.
+  auto to_ctx = [this] (IdArray arr) {
+    return Context().device_type == kDLCPU ? arr : arr.CopyTo(Context());
+  };
   FlattenedHeteroGraph* result = new FlattenedHeteroGraph;
   result->graph = HeteroGraphRef(gptr);
-  result->induced_srctype = aten::VecToIdArray(induced_srctype).CopyTo(Context());
+  result->induced_srctype = to_ctx(induced_srctype);
   result->induced_srctype_set = aten::VecToIdArray(srctype_set).CopyTo(Context());
-  result->induced_srcid = aten::VecToIdArray(induced_srcid).CopyTo(Context());
-  result->induced_etype = aten::Concat(induced_etypes);
+  result->induced_srcid = to_ctx(induced_srcid);
+  result->induced_etype = induced_etype;
   result->induced_etype_set = aten::VecToIdArray(etypes).CopyTo(Context());
-  result->induced_eid = aten::Concat(eid_arrs);
-  result->induced_dsttype = aten::VecToIdArray(induced_dsttype).CopyTo(Context());
+  result->induced_eid = eid;
+  result->induced_dsttype = to_ctx(induced_dsttype);
   result->induced_dsttype_set = aten::VecToIdArray(dsttype_set).CopyTo(Context());
-  result->induced_dstid = aten::VecToIdArray(induced_dstid).CopyTo(Context());
+  result->induced_dstid = to_ctx(induced_dstid);
   return FlattenedHeteroGraphPtr(result);
 }
 
+HeteroGraphPtr HeteroGraph::Reverse() const {
+  std::lock_guard<std::mutex> lock(reverse_cache_->mutex);
+  if (reverse_cache_->graph)
+    return reverse_cache_->graph;
+  std::vector<HeteroGraphPtr> rev_ugs(relation_graphs_.size());
+  for (size_t i = 0; i < relation_graphs_.size(); ++i)
+    rev_ugs[i] = relation_graphs_[i]->Reverse();
+  // node types are not changed
+  const auto& meta_edges = meta_graph_->Edges("eid");
+  // reverse the metagraph
+  const auto& rev_meta = ImmutableGraph::CreateFromCOO(meta_graph_->NumVertices(),
+                                                       meta_edges.dst, meta_edges.src);
+  reverse_cache_->graph = CreateHeteroGraph(rev_meta, rev_ugs, num_verts_per_type_);
+  return reverse_cache_->graph;
+}
+
 constexpr uint64_t kDGLSerialize_HeteroGraph = 0xDD589FBE35224ABF;
 
 bool HeteroGraph::Load(dmlc::Stream* fs) {
@@ -508,6 +571,8 @@ bool HeteroGraph::Load(dmlc::Stream* fs) {
   meta_graph_ = meta_imgraph;
   CHECK(fs->Read(&relation_graphs_)) << "Invalid relation_graphs_";
   CHECK(fs->Read(&num_verts_per_type_)) << "Invalid num_verts_per_type_";
+  flatten_cache_ = std::make_shared<FlattenCache>();
+  reverse_cache_ = std::make_shared<ReverseCache>();
   return true;
 }
 
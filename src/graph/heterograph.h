@@ -10,6 +10,8 @@
 #include <dgl/runtime/shared_mem.h>
 #include <dgl/base_heterograph.h>
 #include <dgl/lazy.h>
+#include <map>
+#include <mutex>
 #include <utility>
 #include <string>
 #include <vector>
@@ -17,6 +19,7 @@
 #include <tuple>
 #include <memory>
 #include "./unit_graph.h"
+#include "./shared_graph_store.h"
 #include "shared_mem_manager.h"
 
 namespace dgl {
@@ -229,7 +232,10 @@ class HeteroGraph : public BaseHeteroGraph {
 
   /*! \brief Copy the data to shared memory.
   *
-  * Also save names of node types and edge types of the HeteroGraph object to shared memory
+  * Also save names of node types and edge types of the HeteroGraph object to shared memory.
+  * Only the formats in fmts are copied right away; the other formats are built and
+  * shared by the first process that uses them. The shared memory is removed when the
+  * last graph attached to it, in any process, is destroyed.
   */
   static HeteroGraphPtr CopyToSharedMem(
       HeteroGraphPtr g, const std::string& name, const std::vector<std::string>& ntypes,
@@ -244,6 +250,16 @@ class HeteroGraph : public BaseHeteroGraph {
   /*! \brief Creat a LineGraph of self */
   HeteroGraphPtr LineGraph(bool backtracking) const;
 
+  /*!
+   * \brief Return the graph with every edge reversed.
+   *
+   * The reversed graph is cached, and its relation graphs share the sparse
+   * matrices with this graph, so the CSC of the reversed graph (the transposed
+   * CSR with the edge permutation) is built at most once. Backward passes that
+   * aggregate in the reverse direction therefore reuse it across iterations.
+   */
+  HeteroGraphPtr Reverse() const;
+
   const std::vector<UnitGraphPtr>& relation_graphs() const {
     return relation_graphs_;
   }
@@ -261,8 +277,31 @@ class HeteroGraph : public BaseHeteroGraph {
   /*! \brief A map from vert type to the number of verts in the type */
   std::vector<int64_t> num_verts_per_type_;
 
-  /*! \brief The shared memory object for meta info*/
-  std::shared_ptr<runtime::SharedMemory> shared_mem_;
+  /*! \brief The shared memory store of the graph, if it is in shared memory */
+  std::shared_ptr<SharedGraphStore> shared_store_;
+
+  /*! \brief Flattened graphs already computed, by the list of flattened edge types */
+  struct FlattenCache {
+    std::mutex mutex;
+    std::map<std::vector<dgl_type_t>, FlattenedHeteroGraphPtr> graphs;
+  };
+
+  /*!
+   * \brief The flattened graphs of this graph.
+   *
+   * The structure of a heterograph never changes once it is created, so repeated
+   * flattening of the same edge types returns the same result.
+   */
+  std::shared_ptr<FlattenCache> flatten_cache_ = std::make_shared<FlattenCache>();
+
+  /*! \brief The reversed graph, if already computed */
+  struct ReverseCache {
+    std::mutex mutex;
+    HeteroGraphPtr graph;
+  };
+
+  /*! \brief The reversed graph of this graph. */
+  std::shared_ptr<ReverseCache> reverse_cache_ = std::make_shared<ReverseCache>();
 
   /*! \brief The name of the shared memory. Return empty string if it is not in shared memory. */
   std::string SharedMemName() const;
@@ -623,6 +623,38 @@ DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLHeteroGetAllowedFormats")
     *rv = format_list;
 });
 
+DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLHeteroGetMemoryFootprint")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    HeteroGraphRef hg = args[0];
+    // The first element is [private_bytes, shared_bytes] of the whole graph, counting
+    // once the arrays used by several formats or relations. It is followed by one
+    // array per edge type, whose rows are the COO, CSR and CSC formats and columns
+    // are [created, materialized_ms, bytes, shared_bytes].
+    List<Value> ret;
+    std::set<std::pair<const void*, uint64_t>> counted;
+    std::vector<int64_t> total(2, 0);
+    std::vector<NDArray> relations;
+    for (dgl_type_t etype = 0; etype < hg->NumEdgeTypes(); ++etype) {
+      auto bg = std::dynamic_pointer_cast<UnitGraph>(hg->GetRelationGraph(etype));
+      CHECK(bg) << "Relation graphs must be UnitGraphs.";
+      std::vector<int64_t> values;
+      for (const auto& fmt : bg->GetMemoryFootprint()) {
+        values.insert(values.end(), {
+          fmt.created, fmt.materialized_ms, fmt.bytes, fmt.shared_bytes});
+        for (const IdArray& arr : fmt.arrays) {
+          if (counted.emplace(arr->data, arr->byte_offset).second)
+            total[arr.IsSharedMem() ? 1 : 0] += arr.GetSize();
+        }
+      }
+      relations.push_back(NDArray::FromVector(values).CreateView(
+          {3, 4}, DLDataType{kDLInt, 64, 1}));
+    }
+    ret.push_back(Value(MakeValue(NDArray::FromVector(total))));
+    for (const NDArray& arr : relations)
+      ret.push_back(Value(MakeValue(arr)));
+    *rv = ret;
+});
+
 DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLHeteroCreateFormat")
 .set_body([] (DGLArgs args, DGLRetValue* rv) {
     HeteroGraphRef hg = args[0];
@@ -704,20 +736,6 @@ DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLHeteroReverse")
     HeteroGraphRef hg = args[0];
     CHECK_GT(hg->NumEdgeTypes(), 0);
     auto g = std::dynamic_pointer_cast<HeteroGraph>(hg.sptr());
-    std::vector<HeteroGraphPtr> rev_ugs;
-    const auto &ugs = g->relation_graphs();
-    rev_ugs.resize(ugs.size());
-
-    for (size_t i = 0; i < ugs.size(); ++i) {
-      const auto &rev_ug = ugs[i]->Reverse();
-      rev_ugs[i] = rev_ug;
-    }
-    // node types are not changed
-    const auto& num_nodes = g->NumVerticesPerType();
-    const auto& meta_edges = hg->meta_graph()->Edges("eid");
-    // reverse the metagraph
-    const auto& rev_meta = ImmutableGraph::CreateFromCOO(hg->meta_graph()->NumVertices(),
-                                                         meta_edges.dst, meta_edges.src);
-    *rv = CreateHeteroGraph(rev_meta, rev_ugs, num_nodes);
+    *rv = HeteroGraphRef(g->Reverse());
   });
 }  // namespace dgl
@@ -8,7 +8,9 @@
 #include <dgl/immutable_graph.h>
 #include <dgl/graph_serializer.h>
 #include <dmlc/memory_io.h>
+#include <cstring>
 #include "./heterograph.h"
+#include "./shared_mem_arena.h"
 #include "../c_api_common.h"
 #include "unit_graph.h"
 
@@ -36,8 +38,11 @@ HeteroPickleStates HeteroPickle(HeteroGraphPtr graph) {
       }
       case SparseFormat::kCSR:
       case SparseFormat::kCSC: {
-        strm->Write(SparseFormat::kCSR);
-        const auto &csr = graph->GetCSRMatrix(etype);
+        // Keep the format the graph has, e.g. the CSC of a block, so that neither end
+        // converts it.
+        strm->Write(fmt);
+        const auto &csr = (fmt == SparseFormat::kCSR)?
+          graph->GetCSRMatrix(etype) : graph->GetCSCMatrix(etype);
         strm->Write(csr.sorted);
         states.arrays.push_back(csr.indptr);
         states.arrays.push_back(csr.indices);
@@ -87,19 +92,24 @@ HeteroGraphPtr HeteroUnpickle(const HeteroPickleStates& states) {
         relgraph = CreateFromCOO(num_vtypes, coo, all_code);
         break;
       }
-      case SparseFormat::kCSR: {
+      case SparseFormat::kCSR:
+      case SparseFormat::kCSC: {
         CHECK_GE(states.arrays.end() - array_itr, 3);
         const auto &indptr = *(array_itr++);
         const auto &indices = *(array_itr++);
         const auto &edge_id = *(array_itr++);
         bool sorted;
         CHECK(strm->Read(&sorted)) << "Invalid flag 'sorted'";
-        auto csr = aten::CSRMatrix(num_src, num_dst, indptr, indices, edge_id, sorted);
         // TODO(zihao) fix
-        relgraph = CreateFromCSR(num_vtypes, csr, all_code);
+        if (fmt == SparseFormat::kCSR) {
+          auto csr = aten::CSRMatrix(num_src, num_dst, indptr, indices, edge_id, sorted);
+          relgraph = CreateFromCSR(num_vtypes, csr, all_code);
+        } else {
+          auto csc = aten::CSRMatrix(num_dst, num_src, indptr, indices, edge_id, sorted);
+          relgraph = CreateFromCSC(num_vtypes, csc, all_code);
+        }
         break;
       }
-      case SparseFormat::kCSC:
       default:
         LOG(FATAL) << "Unsupported sparse format.";
     }
@@ -108,6 +118,84 @@ HeteroGraphPtr HeteroUnpickle(const HeteroPickleStates& states) {
   return CreateHeteroGraph(metagraph, relgraphs, num_nodes_per_type);
 }
 
+HeteroPickleStates HeteroPickleToSharedMem(HeteroGraphPtr graph) {
+  HeteroPickleStates states = HeteroPickle(graph);
+#ifndef _WIN32
+  int64_t size = 0;
+  for (const auto &arr : states.arrays) {
+    // Fall back to pickling the arrays themselves if they cannot be copied as is.
+    if (arr->ctx.device_type != kDLCPU || !arr.IsContiguous())
+      return states;
+    size = (size + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+    size += arr.GetSize();
+  }
+
+  const ArenaPool::Lease lease = ArenaPool::Global()->Acquire(size);
+  std::string meta;
+  dmlc::MemoryStringStream ofs(&meta);
+  dmlc::Stream *strm = &ofs;
+  strm->Write(lease.arena->name);
+  strm->Write(lease.arena->capacity);
+  strm->Write(lease.id);
+  strm->Write(static_cast<int64_t>(states.arrays.size()));
+  int64_t offset = kArenaHeaderSize;
+  for (const auto &arr : states.arrays) {
+    offset = (offset + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+    const int64_t nbytes = arr.GetSize();
+    strm->Write(offset);
+    strm->Write(static_cast<int32_t>(arr->dtype.code));
+    strm->Write(static_cast<int32_t>(arr->dtype.bits));
+    strm->Write(static_cast<int32_t>(arr->dtype.lanes));
+    strm->Write(std::vector<int64_t>(arr->shape, arr->shape + arr->ndim));
+    if (nbytes > 0)
+      std::memcpy(lease.arena->base + offset,
+                  static_cast<const char*>(arr->data) + arr->byte_offset, nbytes);
+    offset += nbytes;
+  }
+  strm->Write(states.meta);
+
+  states.version = 2;
+  states.meta = std::move(meta);
+  states.arrays.clear();
+#endif  // _WIN32
+  return states;
+}
+
+HeteroGraphPtr HeteroUnpickleFromSharedMem(const HeteroPickleStates& states) {
+  char *buf = const_cast<char *>(states.meta.c_str());  // a readonly stream?
+  dmlc::MemoryFixedSizeStream ifs(buf, states.meta.size());
+  dmlc::Stream *strm = &ifs;
+  std::string name;
+  int64_t capacity, lease, num_arrays;
+  CHECK(strm->Read(&name)) << "Invalid arena name";
+  CHECK(strm->Read(&capacity)) << "Invalid arena capacity";
+  CHECK(strm->Read(&lease)) << "Invalid arena lease";
+  CHECK(strm->Read(&num_arrays)) << "Invalid number of arrays";
+
+  // The arrays are views of the arena, which is returned once all of them are freed.
+  NDArray arena = ArenaMapper::Adopt(ArenaMapper::Global()->Map(name, capacity), lease);
+  HeteroPickleStates graph_states;
+  graph_states.version = 1;
+  for (int64_t i = 0; i < num_arrays; ++i) {
+    int64_t offset;
+    int32_t code, bits, lanes;
+    std::vector<int64_t> shape;
+    CHECK(strm->Read(&offset)) << "Invalid array offset";
+    CHECK(strm->Read(&code)) << "Invalid array dtype";
+    CHECK(strm->Read(&bits)) << "Invalid array dtype";
+    CHECK(strm->Read(&lanes)) << "Invalid array dtype";
+    CHECK(strm->Read(&shape)) << "Invalid array shape";
+    const DLDataType dtype{static_cast<uint8_t>(code), static_cast<uint8_t>(bits),
+                           static_cast<uint16_t>(lanes)};
+    NDArray arr = arena.CreateView(shape, dtype, offset);
+    CHECK_LE(offset + static_cast<int64_t>(arr.GetSize()), capacity)
+      << "Array " << i << " exceeds arena " << name;
+    graph_states.arrays.push_back(arr);
+  }
+  CHECK(strm->Read(&graph_states.meta)) << "Invalid graph meta";
+  return HeteroUnpickle(graph_states);
+}
+
 // For backward compatibility
 HeteroGraphPtr HeteroUnpickleOld(const HeteroPickleStates& states) {
   const auto metagraph = states.metagraph;
@@ -169,7 +257,7 @@ DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLCreateHeteroPickleStates")
     std::string meta = args[0];
     const List<Value> arrays = args[1];
     std::shared_ptr<HeteroPickleStates> st( new HeteroPickleStates );
-    st->version = 1;
+    st->version = (args.size() > 2)? static_cast<int64_t>(args[2]) : 1;
     st->meta = meta;
     st->arrays.reserve(arrays.size());
     for (const auto& ref : arrays) {
@@ -182,7 +270,7 @@ DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLHeteroPickle")
 .set_body([] (DGLArgs args, DGLRetValue* rv) {
     HeteroGraphRef ref = args[0];
     std::shared_ptr<HeteroPickleStates> st( new HeteroPickleStates );
-    *st = HeteroPickle(ref.sptr());
+    *st = IsPicklingToSharedMem()? HeteroPickleToSharedMem(ref.sptr()) : HeteroPickle(ref.sptr());
     *rv = HeteroPickleStatesRef(st);
   });
 
@@ -197,8 +285,11 @@ DGL_REGISTER_GLOBAL("heterograph_index._CAPI_DGLHeteroUnpickle")
       case 1:
         graph = HeteroUnpickle(*ref.sptr());
         break;
+      case 2:
+        graph = HeteroUnpickleFromSharedMem(*ref.sptr());
+        break;
       default:
-        LOG(FATAL) << "Version can only be 0 or 1.";
+        LOG(FATAL) << "Version can only be 0, 1 or 2.";
     }
     *rv = HeteroGraphRef(graph);
   });
@@ -0,0 +1,282 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/sampling/layer.cc
+ * \brief Definition of layer-wise sampler APIs.
+ */
+
+#include <dgl/runtime/container.h>
+#include <dgl/packed_func_ext.h>
+#include <dgl/array.h>
+#include <dgl/random.h>
+#include <dgl/runtime/tracing.h>
+#include <dgl/sampling/layer.h>
+#include <dmlc/thread_local.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "../../../c_api_common.h"
+#include "../../unit_graph.h"
+
+using namespace dgl::runtime;
+using namespace dgl::aten;
+
+namespace dgl {
+namespace sampling {
+
+namespace {
+
+// Dense index from node ID to the position of the node in the candidate list of
+// the layer being sampled, or -1. It is kept per calling thread and only the touched
+// entries are reset after each layer, so collecting the candidates neither hashes
+// nor allocates once the index has grown to the number of nodes. The entries are
+// atomic so that the rows can be scanned in parallel.
+struct CandidateIndex {
+  std::unique_ptr<std::atomic<int64_t>[]> pos;
+  int64_t size = 0;
+
+  void Reserve(int64_t n) {
+    if (n <= size)
+      return;
+    pos.reset(new std::atomic<int64_t>[n]);
+    for (int64_t i = 0; i < n; ++i)
+      pos[i].store(-1, std::memory_order_relaxed);
+    size = n;
+  }
+};
+
+/*!
+ * \brief Sample one layer of columns shared by the given rows of a CSR matrix.
+ * \return The sampled entries as a COO matrix whose data are the entry IDs, and the
+ *         importance weight of each sampled entry.
+ */
+template <typename IdType, typename FloatType>
+std::pair<COOMatrix, FloatArray> CSRLayerSampling(
+    const CSRMatrix& csr, IdArray rows, int64_t layer_size,
+    FloatArray prob, bool replace) {
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* data = CSRHasData(csr) ? csr.data.Ptr<IdType>() : nullptr;
+  const IdType* rows_data = rows.Ptr<IdType>();
+  const FloatType* weight = IsNullArray(prob) ? nullptr : prob.Ptr<FloatType>();
+  const int64_t num_rows = rows->shape[0];
+
+  for (int64_t i = 0; i < num_rows; ++i)
+    CHECK(rows_data[i] >= 0 && rows_data[i] < csr.num_rows)
+      << "Invalid node ID " << rows_data[i];
+
+  CandidateIndex* index = dmlc::ThreadLocalStore<CandidateIndex>::Get();
+  index->Reserve(csr.num_cols);
+  std::atomic<int64_t>* pos = index->pos.get();
+
+  // Collect the candidates: the thread marking a column first adds it to the list.
+  std::vector<IdType> candidates;
+#pragma omp parallel
+  {
+    std::vector<IdType> found;
+#pragma omp for
+    for (int64_t i = 0; i < num_rows; ++i) {
+      const IdType rid = rows_data[i];
+      for (IdType j = indptr[rid]; j < indptr[rid + 1]; ++j) {
+        int64_t unseen = -1;
+        if (pos[indices[j]].compare_exchange_strong(unseen, 0, std::memory_order_relaxed))
+          found.push_back(indices[j]);
+      }
+    }
+#pragma omp critical
+    candidates.insert(candidates.end(), found.begin(), found.end());
+  }
+  // Number the candidates by ID, so that the draws do not depend on the threads.
+  std::sort(candidates.begin(), candidates.end());
+  const int64_t num_candidates = candidates.size();
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_candidates; ++i)
+    pos[candidates[i]].store(i, std::memory_order_relaxed);
+
+  // The importance of a candidate is the squared norm of its column restricted to
+  // the given rows.
+  std::vector<FloatType> score(num_candidates, 0);
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_rows; ++i) {
+    const IdType rid = rows_data[i];
+    for (IdType j = indptr[rid]; j < indptr[rid + 1]; ++j) {
+      const FloatType w = weight ? weight[data ? data[j] : j] : 1;
+      FloatType& s = score[pos[indices[j]].load(std::memory_order_relaxed)];
+#pragma omp atomic
+      s += w * w;
+    }
+  }
+  const int64_t num_nonzero = std::count_if(
+      score.begin(), score.end(), [] (FloatType s) { return s > 0; });
+  const FloatType total = std::accumulate(score.begin(), score.end(), FloatType(0));
+
+  // Draw the layer. The scale of a candidate multiplies the weight of its edges, and
+  // is zero if it is not drawn. With replacement, it is c(u) / (s * q(u)), which makes
+  // the weights an unbiased estimate. Without replacement, the chance of drawing u is
+  // not s * q(u), so the scale is 1 / q(u) and the rows are normalized below.
+  std::vector<FloatType> scale(num_candidates, 0);
+  bool normalize_rows = false;
+  if (!replace && layer_size >= num_nonzero) {
+    for (int64_t i = 0; i < num_candidates; ++i)
+      scale[i] = score[i] > 0 ? 1 : 0;
+  } else if (num_nonzero > 0) {
+    std::vector<IdType> picked(layer_size);
+    RandomEngine::ThreadLocal()->Choice<IdType, FloatType>(
+        layer_size, NDArray::FromVector(score), picked.data(), replace);
+    for (const IdType p : picked)
+      scale[p] += 1;
+    const FloatType num_draws = replace ? layer_size : 1;
+    for (int64_t i = 0; i < num_candidates; ++i) {
+      if (scale[i] > 0)
+        scale[i] *= total / (num_draws * score[i]);
+    }
+    normalize_rows = !replace;
+  }
+
+  // Keep the entries pointing to the drawn candidates. Rows are independent, so
+  // the entries are counted and then written in parallel. Normalizing scales the
+  // sampled weights of a row to the total weight of all its entries.
+  std::vector<int64_t> offsets(num_rows + 1, 0);
+  std::vector<FloatType> row_scale(num_rows, 1);
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_rows; ++i) {
+    const IdType rid = rows_data[i];
+    int64_t cnt = 0;
+    FloatType row_total = 0, sampled_total = 0;
+    for (IdType j = indptr[rid]; j < indptr[rid + 1]; ++j) {
+      const FloatType s = scale[pos[indices[j]].load(std::memory_order_relaxed)];
+      cnt += s > 0;
+      if (normalize_rows) {
+        const FloatType w = weight ? weight[data ? data[j] : j] : 1;
+        row_total += w;
+        sampled_total += w * s;
+      }
+    }
+    offsets[i + 1] = cnt;
+    if (normalize_rows && sampled_total > 0)
+      row_scale[i] = row_total / sampled_total;
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  const int64_t nnz = offsets[num_rows];
+  IdArray ret_row = NewIdArray(nnz, csr.indptr->ctx, csr.indptr->dtype.bits);
+  IdArray ret_col = NewIdArray(nnz, csr.indptr->ctx, csr.indptr->dtype.bits);
+  IdArray ret_data = NewIdArray(nnz, csr.indptr->ctx, csr.indptr->dtype.bits);
+  FloatArray ret_weight = NDArray::Empty(
+      {nnz}, DLDataType{kDLFloat, sizeof(FloatType) * 8, 1}, csr.indptr->ctx);
+  IdType* row_out = ret_row.Ptr<IdType>();
+  IdType* col_out = ret_col.Ptr<IdType>();
+  IdType* data_out = ret_data.Ptr<IdType>();
+  FloatType* weight_out = ret_weight.Ptr<FloatType>();
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_rows; ++i) {
+    const IdType rid = rows_data[i];
+    int64_t k = offsets[i];
+    for (IdType j = indptr[rid]; j < indptr[rid + 1]; ++j) {
+      const FloatType s = scale[pos[indices[j]].load(std::memory_order_relaxed)];
+      if (s > 0) {
+        const IdType eid = data ? data[j] : j;
+        row_out[k] = rid;
+        col_out[k] = indices[j];
+        data_out[k] = eid;
+        weight_out[k] = (weight ? weight[eid] : 1) * s * row_scale[i];
+        ++k;
+      }
+    }
+  }
+
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_candidates; ++i)
+    pos[candidates[i]].store(-1, std::memory_order_relaxed);
+  return {COOMatrix(csr.num_rows, csr.num_cols, ret_row, ret_col, ret_data), ret_weight};
+}
+
+}  // namespace
+
+std::pair<HeteroSubgraph, FloatArray> SampleLayer(
+    const HeteroGraphPtr hg,
+    IdArray nodes,
+    int64_t layer_size,
+    EdgeDir dir,
+    FloatArray prob,
+    bool replace) {
+  tracing::ScopedTimer timer("SampleLayer");
+  // sanity check
+  CHECK_EQ(hg->NumEdgeTypes(), 1)
+    << "Layer sampling only supports graphs with one edge type.";
+  CHECK_EQ(hg->Context().device_type, kDLCPU) << "Layer sampling only supports CPU.";
+  CHECK_GE(layer_size, 0) << "Layer size must be non-negative.";
+  CHECK(nodes->dtype == hg->DataType())
+    << "Node IDs must have the same data type as the graph.";
+  if (!IsNullArray(prob)) {
+    CHECK_EQ(prob->dtype.code, kDLFloat) << "Edge weights must be floats.";
+    CHECK_EQ(prob->ndim, 1) << "Edge weights must be a 1D array.";
+    CHECK_EQ(prob->shape[0], hg->NumEdges(0))
+      << "Edge weights must have one element per edge.";
+  }
+
+  const dgl_type_t etype = 0;
+  auto pair = hg->meta_graph()->FindEdge(etype);
+  const dgl_type_t src_vtype = pair.first;
+  const dgl_type_t dst_vtype = pair.second;
+
+  COOMatrix sampled_coo;
+  FloatArray weights;
+  ATEN_ID_TYPE_SWITCH(hg->DataType(), IdType, {
+    const DLDataType prob_dtype = IsNullArray(prob) ?
+      DLDataType{kDLFloat, 32, 1} : prob->dtype;
+    ATEN_FLOAT_TYPE_SWITCH(prob_dtype, FloatType, "edge weights", {
+      if (dir == EdgeDir::kIn) {
+        std::tie(sampled_coo, weights) = CSRLayerSampling<IdType, FloatType>(
+            hg->GetCSCMatrix(etype), nodes, layer_size, prob, replace);
+        sampled_coo = COOTranspose(sampled_coo);
+      } else {
+        std::tie(sampled_coo, weights) = CSRLayerSampling<IdType, FloatType>(
+            hg->GetCSRMatrix(etype), nodes, layer_size, prob, replace);
+      }
+    });
+  });
+
+  std::vector<HeteroGraphPtr> subrels(1);
+  subrels[0] = UnitGraph::CreateFromCOO(
+      hg->GetRelationGraph(etype)->NumVertexTypes(),
+      hg->NumVertices(src_vtype), hg->NumVertices(dst_vtype),
+      sampled_coo.row, sampled_coo.col);
+
+  if (timer.active())
+    timer.AddEdges(sampled_coo.row->shape[0]);
+
+  HeteroSubgraph ret;
+  ret.graph = CreateHeteroGraph(hg->meta_graph(), subrels, hg->NumVerticesPerType());
+  ret.induced_vertices.resize(hg->NumVertexTypes());
+  ret.induced_edges = {sampled_coo.data};
+  return {ret, weights};
+}
+
+DGL_REGISTER_GLOBAL("sampling.layer._CAPI_DGLSampleLayer")
+.set_body([] (DGLArgs args, DGLRetValue *rv) {
+    HeteroGraphRef hg = args[0];
+    IdArray nodes = args[1];
+    const int64_t layer_size = args[2];
+    const std::string dir_str = args[3];
+    FloatArray prob = args[4];
+    const bool replace = args[5];
+
+    CHECK(dir_str == "in" || dir_str == "out")
+      << "Invalid edge direction. Must be \"in\" or \"out\".";
+    EdgeDir dir = (dir_str == "in")? EdgeDir::kIn : EdgeDir::kOut;
+
+    std::shared_ptr<HeteroSubgraph> subg(new HeteroSubgraph);
+    FloatArray weights;
+    std::tie(*subg, weights) = sampling::SampleLayer(
+        hg.sptr(), nodes, layer_size, dir, prob, replace);
+
+    List<ObjectRef> ret;
+    ret.push_back(HeteroSubgraphRef(subg));
+    ret.push_back(Value(MakeValue(weights)));
+    *rv = ret;
+  });
+
+}  // namespace sampling
+}  // namespace dgl
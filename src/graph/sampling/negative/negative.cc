@@ -0,0 +1,348 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/sampling/negative.cc
+ * \brief Definition of negative sampler APIs.
+ */
+
+#include <dgl/runtime/container.h>
+#include <dgl/packed_func_ext.h>
+#include <dgl/array.h>
+#include <dgl/random.h>
+#include <dgl/runtime/tracing.h>
+#include <dgl/sampling/negative.h>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../../../c_api_common.h"
+#include "../../unit_graph.h"
+
+using namespace dgl::runtime;
+using namespace dgl::aten;
+
+namespace dgl {
+namespace sampling {
+
+namespace {
+
+/*! \brief How the corrupted endpoint of a negative edge is drawn. */
+enum class NegativeMode {
+  kUniform,
+  kAlias,
+  kInBatch,
+};
+
+// Number of times a negative edge that turns out to exist is drawn again.
+constexpr int kMaxRetries = 8;
+// Rows of an unsorted Csr matrix longer than this are sorted once per batch
+// before the negative edges are looked up in them.
+constexpr int64_t kLinearScanLimit = 16;
+
+template <typename FloatType>
+std::pair<FloatArray, IdArray> BuildAliasTableImpl(FloatArray weights) {
+  const int64_t n = weights->shape[0];
+  const FloatType* w = weights.Ptr<FloatType>();
+  FloatArray prob = NDArray::Empty({n}, weights->dtype, weights->ctx);
+  IdArray alias = NewIdArray(n, weights->ctx, 64);
+  FloatType* P = prob.Ptr<FloatType>();
+  int64_t* A = alias.Ptr<int64_t>();
+  const FloatType total = std::accumulate(w, w + n, FloatType(0));
+  CHECK_GT(total, 0) << "The weights must have a positive sum.";
+
+  // Vose's alias method.
+  std::vector<int64_t> small, large;
+  for (int64_t i = 0; i < n; ++i) {
+    CHECK_GE(w[i], 0) << "The weights must be non-negative.";
+    P[i] = w[i] * n / total;
+    A[i] = i;
+    (P[i] < 1 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    const int64_t s = small.back(), l = large.back();
+    small.pop_back();
+    A[s] = l;
+    P[l] -= 1 - P[s];
+    if (P[l] < 1) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // What remains is only off from one by rounding errors.
+  for (const int64_t i : small) P[i] = 1;
+  for (const int64_t i : large) P[i] = 1;
+  return {prob, alias};
+}
+
+/*! \brief Whether the sorted or unsorted range contains the given value. */
+template <typename IdType>
+inline bool Contains(const IdType* begin, const IdType* end, bool sorted, IdType val) {
+  return sorted ? std::binary_search(begin, end, val) : (std::find(begin, end, val) != end);
+}
+
+/*!
+ * \brief Corrupt the endpoints of the given edges.
+ * \param csr The matrix whose rows are the kept endpoints, used to look up the
+ *        negative edges.
+ * \param anchor The kept endpoint of each positive edge.
+ * \param target The corrupted endpoint of each positive edge.
+ * \param num_nodes The number of nodes of the corrupted endpoint type.
+ * \return The kept and the corrupted endpoints of the negative edges, and the index of
+ *         the positive edge each of them is drawn for.
+ */
+template <typename IdType, typename FloatType>
+std::tuple<IdArray, IdArray, IdArray> CorruptEdges(
+    const CSRMatrix& csr, IdArray anchor, IdArray target, int64_t num_nodes,
+    int64_t k, NegativeMode mode, int64_t chunk_size,
+    FloatArray alias_prob, IdArray alias_idx, bool exclude_positive) {
+  const int64_t num_pos = anchor->shape[0];
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* anchor_data = anchor.Ptr<IdType>();
+  const IdType* target_data = target.Ptr<IdType>();
+  const FloatType* P = (mode == NegativeMode::kAlias) ? alias_prob.Ptr<FloatType>() : nullptr;
+  const int64_t* A = (mode == NegativeMode::kAlias) ? alias_idx.Ptr<int64_t>() : nullptr;
+  if (chunk_size <= 0)
+    chunk_size = std::max<int64_t>(num_pos, 1);
+
+  // Sorted copies of the long rows of the distinct anchors of an unsorted matrix,
+  // so that every row is sorted once however many positive edges share it.
+  std::vector<IdType> long_rows;
+  std::vector<int64_t> long_off;
+  std::vector<IdType> long_buf;
+  if (exclude_positive && !csr.sorted) {
+    long_rows.assign(anchor_data, anchor_data + num_pos);
+    std::sort(long_rows.begin(), long_rows.end());
+    long_rows.erase(std::unique(long_rows.begin(), long_rows.end()), long_rows.end());
+    long_rows.erase(std::remove_if(long_rows.begin(), long_rows.end(),
+                                   [indptr] (IdType v) {
+                                     return indptr[v + 1] - indptr[v] <= kLinearScanLimit;
+                                   }),
+                    long_rows.end());
+    const int64_t num_long = long_rows.size();
+    long_off.resize(num_long + 1, 0);
+    for (int64_t r = 0; r < num_long; ++r)
+      long_off[r + 1] = long_off[r] + indptr[long_rows[r] + 1] - indptr[long_rows[r]];
+    long_buf.resize(long_off[num_long]);
+#pragma omp parallel for
+    for (int64_t r = 0; r < num_long; ++r) {
+      std::copy(indices + indptr[long_rows[r]], indices + indptr[long_rows[r] + 1],
+                long_buf.begin() + long_off[r]);
+      std::sort(long_buf.begin() + long_off[r], long_buf.begin() + long_off[r + 1]);
+    }
+  }
+
+  // Corrupted endpoints of the k negative edges of every positive edge, or -1 for
+  // the negative edges that are dropped.
+  std::vector<IdType> corrupted(num_pos * k);
+  std::vector<int64_t> offsets(num_pos + 1, 0);
+#pragma omp parallel
+  {
+    RandomEngine* re = RandomEngine::ThreadLocal();
+#pragma omp for
+    for (int64_t i = 0; i < num_pos; ++i) {
+      const int64_t chunk_start = i / chunk_size * chunk_size;
+      const int64_t chunk_len = std::min(chunk_start + chunk_size, num_pos) - chunk_start;
+      auto draw = [&] () -> IdType {
+        switch (mode) {
+          case NegativeMode::kAlias: {
+            const int64_t j = re->RandInt<int64_t>(num_nodes);
+            return (re->Uniform<FloatType>() < P[j]) ? j : A[j];
+          }
+          case NegativeMode::kInBatch: {
+            // no other edge to draw from; the edge itself is not a negative edge
+            if (chunk_len == 1)
+              return -1;
+            // another edge of the same chunk
+            int64_t j = chunk_start + re->RandInt<int64_t>(chunk_len - 1);
+            return target_data[j >= i ? j + 1 : j];
+          }
+          default:
+            return re->RandInt<int64_t>(num_nodes);
+        }
+      };
+
+      const IdType* row_begin = indices + indptr[anchor_data[i]];
+      const IdType* row_end = indices + indptr[anchor_data[i] + 1];
+      bool sorted = csr.sorted;
+      if (!long_rows.empty() && row_end - row_begin > kLinearScanLimit) {
+        const int64_t r = std::lower_bound(long_rows.begin(), long_rows.end(), anchor_data[i])
+          - long_rows.begin();
+        row_begin = long_buf.data() + long_off[r];
+        row_end = long_buf.data() + long_off[r + 1];
+        sorted = true;
+      }
+      IdType* out = corrupted.data() + i * k;
+      int64_t cnt = 0;
+      for (int64_t t = 0; t < k; ++t) {
+        IdType val = draw();
+        if (exclude_positive && val >= 0) {
+          for (int r = 0; r < kMaxRetries && Contains(row_begin, row_end, sorted, val); ++r)
+            val = draw();
+          if (Contains(row_begin, row_end, sorted, val))
+            val = -1;
+        }
+        out[t] = val;
+        cnt += (val >= 0);
+      }
+      offsets[i + 1] = cnt;
+    }
+  }
+
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  const int64_t num_neg = offsets[num_pos];
+  const uint8_t nbits = anchor->dtype.bits;
+  IdArray neg_anchor = NewIdArray(num_neg, anchor->ctx, nbits);
+  IdArray neg_target = NewIdArray(num_neg, anchor->ctx, nbits);
+  IdArray pos_idx = NewIdArray(num_neg, anchor->ctx, nbits);
+  IdType* neg_anchor_data = neg_anchor.Ptr<IdType>();
+  IdType* neg_target_data = neg_target.Ptr<IdType>();
+  IdType* pos_idx_data = pos_idx.Ptr<IdType>();
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_pos; ++i) {
+    int64_t j = offsets[i];
+    for (int64_t t = 0; t < k; ++t) {
+      const IdType val = corrupted[i * k + t];
+      if (val >= 0) {
+        neg_anchor_data[j] = anchor_data[i];
+        neg_target_data[j] = val;
+        pos_idx_data[j] = i;
+        ++j;
+      }
+    }
+  }
+  return std::make_tuple(neg_anchor, neg_target, pos_idx);
+}
+
+}  // namespace
+
+std::pair<FloatArray, IdArray> BuildAliasTable(FloatArray weights) {
+  CHECK_EQ(weights->ctx.device_type, kDLCPU) << "Alias table only supports CPU.";
+  CHECK_EQ(weights->ndim, 1) << "The weights must be a 1D array.";
+  CHECK(weights.IsContiguous()) << "The weights must be contiguous.";
+  std::pair<FloatArray, IdArray> ret;
+  ATEN_FLOAT_TYPE_SWITCH(weights->dtype, FloatType, "weights", {
+    ret = BuildAliasTableImpl<FloatType>(weights);
+  });
+  return ret;
+}
+
+std::pair<HeteroGraphPtr, IdArray> SampleNegativeEdges(
+    const HeteroGraphPtr hg,
+    dgl_type_t etype,
+    IdArray eids,
+    int64_t k,
+    const std::string& mode_str,
+    bool corrupt_src,
+    int64_t chunk_size,
+    FloatArray alias_prob,
+    IdArray alias_idx,
+    bool exclude_positive) {
+  tracing::ScopedTimer timer("SampleNegativeEdges");
+  // sanity check
+  CHECK_EQ(hg->Context().device_type, kDLCPU) << "Negative sampling only supports CPU.";
+  CHECK_LT(etype, hg->NumEdgeTypes()) << "Invalid edge type " << etype;
+  CHECK_GE(k, 0) << "The number of negative edges must be non-negative.";
+  NegativeMode mode;
+  if (mode_str == "uniform") {
+    mode = NegativeMode::kUniform;
+  } else if (mode_str == "alias") {
+    mode = NegativeMode::kAlias;
+  } else if (mode_str == "in_batch") {
+    mode = NegativeMode::kInBatch;
+  } else {
+    LOG(FATAL) << "Unsupported negative sampling mode: " << mode_str;
+  }
+
+  auto pair = hg->meta_graph()->FindEdge(etype);
+  const dgl_type_t src_vtype = pair.first;
+  const dgl_type_t dst_vtype = pair.second;
+  const int64_t num_nodes = hg->NumVertices(corrupt_src ? src_vtype : dst_vtype);
+  if (mode != NegativeMode::kInBatch)
+    CHECK_GT(num_nodes, 0) << "Cannot corrupt edges with no nodes to draw from.";
+  if (mode == NegativeMode::kAlias) {
+    CHECK_EQ(alias_prob->shape[0], num_nodes)
+      << "The alias table must have one entry per node.";
+    CHECK_EQ(alias_idx->shape[0], num_nodes)
+      << "The alias table must have one entry per node.";
+    CHECK_EQ(alias_idx->dtype.bits, 64) << "The alias table must be int64.";
+  }
+
+  const EdgeArray pos = hg->FindEdges(etype, eids);
+  IdArray neg_anchor, neg_target, pos_idx;
+  ATEN_ID_TYPE_SWITCH(hg->DataType(), IdType, {
+    const DLDataType prob_dtype = (mode == NegativeMode::kAlias) ?
+      alias_prob->dtype : DLDataType{kDLFloat, 32, 1};
+    ATEN_FLOAT_TYPE_SWITCH(prob_dtype, FloatType, "alias table", {
+      if (corrupt_src) {
+        std::tie(neg_anchor, neg_target, pos_idx) = CorruptEdges<IdType, FloatType>(
+            hg->GetCSCMatrix(etype), pos.dst, pos.src, num_nodes, k, mode, chunk_size,
+            alias_prob, alias_idx, exclude_positive);
+      } else {
+        std::tie(neg_anchor, neg_target, pos_idx) = CorruptEdges<IdType, FloatType>(
+            hg->GetCSRMatrix(etype), pos.src, pos.dst, num_nodes, k, mode, chunk_size,
+            alias_prob, alias_idx, exclude_positive);
+      }
+    });
+  });
+
+  if (timer.active())
+    timer.AddEdges(pos_idx->shape[0]);
+
+  std::vector<HeteroGraphPtr> subrels(hg->NumEdgeTypes());
+  for (dgl_type_t i = 0; i < hg->NumEdgeTypes(); ++i) {
+    auto ipair = hg->meta_graph()->FindEdge(i);
+    const int64_t num_vtypes = hg->GetRelationGraph(i)->NumVertexTypes();
+    if (i == etype) {
+      subrels[i] = UnitGraph::CreateFromCOO(
+          num_vtypes, hg->NumVertices(ipair.first), hg->NumVertices(ipair.second),
+          corrupt_src ? neg_target : neg_anchor,
+          corrupt_src ? neg_anchor : neg_target);
+    } else {
+      subrels[i] = UnitGraph::Empty(
+          num_vtypes, hg->NumVertices(ipair.first), hg->NumVertices(ipair.second),
+          hg->DataType(), hg->Context());
+    }
+  }
+  return {CreateHeteroGraph(hg->meta_graph(), subrels, hg->NumVerticesPerType()), pos_idx};
+}
+
+DGL_REGISTER_GLOBAL("sampling.negative._CAPI_DGLBuildAliasTable")
+.set_body([] (DGLArgs args, DGLRetValue *rv) {
+    FloatArray weights = args[0];
+    FloatArray prob;
+    IdArray alias;
+    std::tie(prob, alias) = BuildAliasTable(weights);
+    List<Value> ret;
+    ret.push_back(Value(MakeValue(prob)));
+    ret.push_back(Value(MakeValue(alias)));
+    *rv = ret;
+  });
+
+DGL_REGISTER_GLOBAL("sampling.negative._CAPI_DGLSampleNegativeEdges")
+.set_body([] (DGLArgs args, DGLRetValue *rv) {
+    HeteroGraphRef hg = args[0];
+    const dgl_type_t etype = static_cast<int64_t>(args[1]);
+    IdArray eids = args[2];
+    const int64_t k = args[3];
+    const std::string mode = args[4];
+    const bool corrupt_src = args[5];
+    const int64_t chunk_size = args[6];
+    FloatArray alias_prob = args[7];
+    IdArray alias_idx = args[8];
+    const bool exclude_positive = args[9];
+
+    HeteroGraphPtr neg;
+    IdArray pos_idx;
+    std::tie(neg, pos_idx) = SampleNegativeEdges(
+        hg.sptr(), etype, eids, k, mode, corrupt_src, chunk_size,
+        alias_prob, alias_idx, exclude_positive);
+
+    List<ObjectRef> ret;
+    ret.push_back(HeteroGraphRef(neg));
+    ret.push_back(Value(MakeValue(pos_idx)));
+    *rv = ret;
+  });
+
+}  // namespace sampling
+}  // namespace dgl
@@ -5,9 +5,12 @@
  */
 
 #include <dgl/runtime/container.h>
+#include <dgl/runtime/tracing.h>
 #include <dgl/packed_func_ext.h>
 #include <dgl/array.h>
 #include <dgl/sampling/neighbor.h>
+#include <algorithm>
+#include <vector>
 #include "../../../c_api_common.h"
 #include "../../unit_graph.h"
 
@@ -17,14 +20,137 @@ using namespace dgl::aten;
 namespace dgl {
 namespace sampling {
 
+namespace {
+
+// Whether sampling without replacement and uniformly picks all the neighbors
+// of every node, i.e. the fanout is no less than the largest degree.
+bool PicksAllNeighbors(
+    const HeteroGraphPtr hg, dgl_type_t etype, EdgeDir dir, int64_t fanout,
+    FloatArray prob, bool replace) {
+  if (replace || !IsNullArray(prob) || hg->Context().device_type != kDLCPU)
+    return false;
+  const auto rel = std::dynamic_pointer_cast<UnitGraph>(hg->GetRelationGraph(etype));
+  if (!rel)
+    return false;
+  const int64_t max_degree = (dir == EdgeDir::kOut) ?
+    rel->Stats().MaxOutDegree(*rel) : rel->Stats().MaxInDegree(*rel);
+  return fanout >= max_degree;
+}
+
+// Remove the edges whose ID is in exclude.
+EdgeArray RemoveExcludedEdges(const EdgeArray& earr, IdArray exclude) {
+  EdgeArray ret;
+  ATEN_ID_TYPE_SWITCH(earr.id->dtype, IdType, {
+    exclude = aten::AsNumBits(exclude, sizeof(IdType) * 8);
+    std::vector<IdType> excluded(exclude.Ptr<IdType>(),
+                                 exclude.Ptr<IdType>() + exclude->shape[0]);
+    std::sort(excluded.begin(), excluded.end());
+    const int64_t num_edges = earr.id->shape[0];
+    const IdType* src = earr.src.Ptr<IdType>();
+    const IdType* dst = earr.dst.Ptr<IdType>();
+    const IdType* eid = earr.id.Ptr<IdType>();
+    std::vector<IdType> new_src, new_dst, new_eid;
+    for (int64_t i = 0; i < num_edges; ++i) {
+      if (!std::binary_search(excluded.begin(), excluded.end(), eid[i])) {
+        new_src.push_back(src[i]);
+        new_dst.push_back(dst[i]);
+        new_eid.push_back(eid[i]);
+      }
+    }
+    const uint8_t nbits = earr.id->dtype.bits;
+    ret.src = VecToIdArray(new_src, nbits, earr.id->ctx);
+    ret.dst = VecToIdArray(new_dst, nbits, earr.id->ctx);
+    ret.id = VecToIdArray(new_eid, nbits, earr.id->ctx);
+  });
+  return ret;
+}
+
+// Sample the neighbors of the given nodes on one relation graph, never picking the
+// edges in exclude.
+void SampleNeighborsOfEtype(
+    const HeteroGraphPtr hg, dgl_type_t etype, const IdArray nodes_ntype, int64_t fanout,
+    EdgeDir dir, const FloatArray prob, bool replace, const IdArray exclude,
+    HeteroGraphPtr* subrel, IdArray* induced_edges) {
+  const bool excluding = !IsNullArray(exclude);
+  auto pair = hg->meta_graph()->FindEdge(etype);
+  const dgl_type_t src_vtype = pair.first;
+  const dgl_type_t dst_vtype = pair.second;
+  const int64_t num_nodes = nodes_ntype->shape[0];
+  if (num_nodes == 0 || fanout == 0) {
+    // Nothing to sample for this etype, create a placeholder relation graph
+    *subrel = UnitGraph::Empty(
+      hg->GetRelationGraph(etype)->NumVertexTypes(),
+      hg->NumVertices(src_vtype),
+      hg->NumVertices(dst_vtype),
+      hg->DataType(), hg->Context());
+    *induced_edges = aten::NullArray();
+  } else if (fanout == -1 ||
+             (!excluding && PicksAllNeighbors(hg, etype, dir, fanout, prob, replace))) {
+    EdgeArray earr = (dir == EdgeDir::kOut) ?
+      hg->OutEdges(etype, nodes_ntype) :
+      hg->InEdges(etype, nodes_ntype);
+    if (excluding)
+      earr = RemoveExcludedEdges(earr, exclude);
+    *subrel = UnitGraph::CreateFromCOO(
+      hg->GetRelationGraph(etype)->NumVertexTypes(),
+      hg->NumVertices(src_vtype),
+      hg->NumVertices(dst_vtype),
+      earr.src,
+      earr.dst);
+    *induced_edges = earr.id;
+  } else {
+    // sample from one relation graph
+    auto req_fmt = (dir == EdgeDir::kOut)? csr_code : csc_code;
+    auto avail_fmt = hg->SelectFormat(etype, req_fmt);
+    COOMatrix sampled_coo;
+    switch (avail_fmt) {
+      case SparseFormat::kCOO:
+        if (dir == EdgeDir::kIn) {
+          sampled_coo = aten::COOTranspose(aten::COORowWiseSampling(
+            aten::COOTranspose(hg->GetCOOMatrix(etype)),
+            nodes_ntype, fanout, prob, replace, exclude));
+        } else {
+          sampled_coo = aten::COORowWiseSampling(
+            hg->GetCOOMatrix(etype), nodes_ntype, fanout, prob, replace, exclude);
+        }
+        break;
+      case SparseFormat::kCSR:
+        CHECK(dir == EdgeDir::kOut) << "Cannot sample out edges on CSC matrix.";
+        sampled_coo = aten::CSRRowWiseSampling(
+          hg->GetCSRMatrix(etype), nodes_ntype, fanout, prob, replace, exclude);
+        break;
+      case SparseFormat::kCSC:
+        CHECK(dir == EdgeDir::kIn) << "Cannot sample in edges on CSR matrix.";
+        sampled_coo = aten::CSRRowWiseSampling(
+          hg->GetCSCMatrix(etype), nodes_ntype, fanout, prob, replace, exclude);
+        sampled_coo = aten::COOTranspose(sampled_coo);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported sparse format.";
+    }
+    *subrel = UnitGraph::CreateFromCOO(
+      hg->GetRelationGraph(etype)->NumVertexTypes(), sampled_coo.num_rows, sampled_coo.num_cols,
+      sampled_coo.row, sampled_coo.col);
+    *induced_edges = sampled_coo.data;
+  }
+}
+
+// View the elements [start, start + len) of a 1D array.
+IdArray Slice1D(IdArray arr, int64_t start, int64_t len) {
+  return arr.CreateView({len}, arr->dtype, start * (arr->dtype.bits / 8));
+}
+
+}  // namespace
+
 HeteroSubgraph SampleNeighbors(
     const HeteroGraphPtr hg,
     const std::vector<IdArray>& nodes,
     const std::vector<int64_t>& fanouts,
     EdgeDir dir,
     const std::vector<FloatArray>& prob,
-    bool replace) {
-
+    bool replace,
+    const std::vector<IdArray>& exclude_edges) {
+  tracing::ScopedTimer timer("SampleNeighbors");
   // sanity check
   CHECK_EQ(nodes.size(), hg->NumVertexTypes())
     << "Number of node ID tensors must match the number of node types.";
@@ -32,69 +158,22 @@ HeteroSubgraph SampleNeighbors(
     << "Number of fanout values must match the number of edge types.";
   CHECK_EQ(prob.size(), hg->NumEdgeTypes())
     << "Number of probability tensors must match the number of edge types.";
+  CHECK(exclude_edges.empty() || exclude_edges.size() == hg->NumEdgeTypes())
+    << "Number of excluded edge ID tensors must match the number of edge types.";
 
   std::vector<HeteroGraphPtr> subrels(hg->NumEdgeTypes());
   std::vector<IdArray> induced_edges(hg->NumEdgeTypes());
   for (dgl_type_t etype = 0; etype < hg->NumEdgeTypes(); ++etype) {
     auto pair = hg->meta_graph()->FindEdge(etype);
-    const dgl_type_t src_vtype = pair.first;
-    const dgl_type_t dst_vtype = pair.second;
-    const IdArray nodes_ntype = nodes[(dir == EdgeDir::kOut)? src_vtype : dst_vtype];
-    const int64_t num_nodes = nodes_ntype->shape[0];
-    if (num_nodes == 0 || fanouts[etype] == 0) {
-      // Nothing to sample for this etype, create a placeholder relation graph
-      subrels[etype] = UnitGraph::Empty(
-        hg->GetRelationGraph(etype)->NumVertexTypes(),
-        hg->NumVertices(src_vtype),
-        hg->NumVertices(dst_vtype),
-        hg->DataType(), hg->Context());
-      induced_edges[etype] = aten::NullArray();
-    } else if (fanouts[etype] == -1) {
-      const auto &earr = (dir == EdgeDir::kOut) ?
-        hg->OutEdges(etype, nodes_ntype) :
-        hg->InEdges(etype, nodes_ntype);
-      subrels[etype] = UnitGraph::CreateFromCOO(
-        hg->GetRelationGraph(etype)->NumVertexTypes(),
-        hg->NumVertices(src_vtype),
-        hg->NumVertices(dst_vtype),
-        earr.src,
-        earr.dst);
-      induced_edges[etype] = earr.id;
-    } else {
-      // sample from one relation graph
-      auto req_fmt = (dir == EdgeDir::kOut)? csr_code : csc_code;
-      auto avail_fmt = hg->SelectFormat(etype, req_fmt);
-      COOMatrix sampled_coo;
-      switch (avail_fmt) {
-        case SparseFormat::kCOO:
-          if (dir == EdgeDir::kIn) {
-            sampled_coo = aten::COOTranspose(aten::COORowWiseSampling(
-              aten::COOTranspose(hg->GetCOOMatrix(etype)),
-              nodes_ntype, fanouts[etype], prob[etype], replace));
-          } else {
-            sampled_coo = aten::COORowWiseSampling(
-              hg->GetCOOMatrix(etype), nodes_ntype, fanouts[etype], prob[etype], replace);
-          }
-          break;
-        case SparseFormat::kCSR:
-          CHECK(dir == EdgeDir::kOut) << "Cannot sample out edges on CSC matrix.";
-          sampled_coo = aten::CSRRowWiseSampling(
-            hg->GetCSRMatrix(etype), nodes_ntype, fanouts[etype], prob[etype], replace);
-          break;
-        case SparseFormat::kCSC:
-          CHECK(dir == EdgeDir::kIn) << "Cannot sample in edges on CSR matrix.";
-          sampled_coo = aten::CSRRowWiseSampling(
-            hg->GetCSCMatrix(etype), nodes_ntype, fanouts[etype], prob[etype], replace);
-          sampled_coo = aten::COOTranspose(sampled_coo);
-          break;
-        default:
-          LOG(FATAL) << "Unsupported sparse format.";
-      }
-      subrels[etype] = UnitGraph::CreateFromCOO(
-        hg->GetRelationGraph(etype)->NumVertexTypes(), sampled_coo.num_rows, sampled_coo.num_cols,
-        sampled_coo.row, sampled_coo.col);
-      induced_edges[etype] = sampled_coo.data;
-    }
+    const IdArray nodes_ntype = nodes[(dir == EdgeDir::kOut)? pair.first : pair.second];
+    const IdArray exclude = exclude_edges.empty()? aten::NullArray() : exclude_edges[etype];
+    SampleNeighborsOfEtype(hg, etype, nodes_ntype, fanouts[etype], dir, prob[etype], replace,
+                           exclude, &subrels[etype], &induced_edges[etype]);
+  }
+
+  if (timer.active()) {
+    for (const IdArray& eids : induced_edges)
+      timer.AddEdges(eids->shape[0]);
   }
 
   HeteroSubgraph ret;
@@ -104,6 +183,97 @@ HeteroSubgraph SampleNeighbors(
   return ret;
 }
 
+std::vector<HeteroSubgraph> SampleNeighborsBatched(
+    const HeteroGraphPtr hg,
+    const std::vector<std::vector<IdArray>>& nodes,
+    const std::vector<int64_t>& fanouts,
+    EdgeDir dir,
+    const std::vector<FloatArray>& prob,
+    bool replace) {
+  tracing::ScopedTimer timer("SampleNeighborsBatched");
+  // sanity check
+  for (const auto& nodes_of_set : nodes) {
+    CHECK_EQ(nodes_of_set.size(), hg->NumVertexTypes())
+      << "Number of node ID tensors must match the number of node types.";
+  }
+  CHECK_EQ(fanouts.size(), hg->NumEdgeTypes())
+    << "Number of fanout values must match the number of edge types.";
+  CHECK_EQ(prob.size(), hg->NumEdgeTypes())
+    << "Number of probability tensors must match the number of edge types.";
+
+  const int64_t num_sets = nodes.size();
+  std::vector<std::vector<HeteroGraphPtr>> subrels(
+      num_sets, std::vector<HeteroGraphPtr>(hg->NumEdgeTypes()));
+  std::vector<std::vector<IdArray>> induced_edges(
+      num_sets, std::vector<IdArray>(hg->NumEdgeTypes()));
+  for (dgl_type_t etype = 0; etype < hg->NumEdgeTypes(); ++etype) {
+    auto pair = hg->meta_graph()->FindEdge(etype);
+    const dgl_type_t vtype = (dir == EdgeDir::kOut)? pair.first : pair.second;
+    const auto req_fmt = (dir == EdgeDir::kOut)? csr_code : csc_code;
+    const auto rowwise_fmt = (dir == EdgeDir::kOut)? SparseFormat::kCSR : SparseFormat::kCSC;
+    std::vector<IdArray> nodes_ntype(num_sets);
+    std::vector<int64_t> offsets(num_sets + 1, 0);
+    for (int64_t b = 0; b < num_sets; ++b) {
+      nodes_ntype[b] = nodes[b][vtype];
+      offsets[b + 1] = offsets[b] + nodes_ntype[b]->shape[0];
+    }
+
+    const bool rowwise = offsets[num_sets] > 0 && fanouts[etype] > 0 &&
+      hg->Context().device_type == kDLCPU &&
+      !PicksAllNeighbors(hg, etype, dir, fanouts[etype], prob[etype], replace) &&
+      hg->SelectFormat(etype, req_fmt) == rowwise_fmt;
+    if (!rowwise) {
+      for (int64_t b = 0; b < num_sets; ++b) {
+        SampleNeighborsOfEtype(
+            hg, etype, nodes_ntype[b], fanouts[etype], dir, prob[etype], replace,
+            aten::NullArray(), &subrels[b][etype], &induced_edges[b][etype]);
+      }
+      continue;
+    }
+
+    // Sample the neighbors of all the sets at once, and split the edges afterwards:
+    // they are grouped by seed, in the order of the seeds.
+    const CSRMatrix mat = (dir == EdgeDir::kOut)?
+      hg->GetCSRMatrix(etype) : hg->GetCSCMatrix(etype);
+    const IdArray all_nodes = aten::Concat(nodes_ntype);
+    auto sampled = aten::CSRRowWiseSamplingWithCounts(
+        mat, all_nodes, fanouts[etype], prob[etype], replace);
+    COOMatrix sampled_coo = sampled.first;
+    if (dir == EdgeDir::kIn)
+      sampled_coo = aten::COOTranspose(sampled_coo);
+    const int64_t* row_counts = sampled.second.Ptr<int64_t>();
+    std::vector<int64_t> counts(num_sets, 0);
+    for (int64_t b = 0; b < num_sets; ++b) {
+      for (int64_t i = offsets[b]; i < offsets[b + 1]; ++i)
+        counts[b] += row_counts[i];
+    }
+
+    int64_t start = 0;
+    for (int64_t b = 0; b < num_sets; ++b) {
+      subrels[b][etype] = UnitGraph::CreateFromCOO(
+          hg->GetRelationGraph(etype)->NumVertexTypes(),
+          sampled_coo.num_rows, sampled_coo.num_cols,
+          Slice1D(sampled_coo.row, start, counts[b]),
+          Slice1D(sampled_coo.col, start, counts[b]));
+      induced_edges[b][etype] = Slice1D(sampled_coo.data, start, counts[b]);
+      start += counts[b];
+    }
+    CHECK_EQ(start, sampled_coo.row->shape[0]) << "Sampled edges do not match the seeds.";
+  }
+
+  std::vector<HeteroSubgraph> ret(num_sets);
+  for (int64_t b = 0; b < num_sets; ++b) {
+    if (timer.active()) {
+      for (const IdArray& eids : induced_edges[b])
+        timer.AddEdges(eids->shape[0]);
+    }
+    ret[b].graph = CreateHeteroGraph(hg->meta_graph(), subrels[b], hg->NumVerticesPerType());
+    ret[b].induced_vertices.resize(hg->NumVertexTypes());
+    ret[b].induced_edges = std::move(induced_edges[b]);
+  }
+  return ret;
+}
+
 HeteroSubgraph SampleNeighborsTopk(
     const HeteroGraphPtr hg,
     const std::vector<IdArray>& nodes,
@@ -111,6 +281,7 @@ HeteroSubgraph SampleNeighborsTopk(
     EdgeDir dir,
     const std::vector<FloatArray>& weight,
     bool ascending) {
+  tracing::ScopedTimer timer("SampleNeighborsTopk");
   // sanity check
   CHECK_EQ(nodes.size(), hg->NumVertexTypes())
     << "Number of node ID tensors must match the number of node types.";
@@ -183,6 +354,11 @@ HeteroSubgraph SampleNeighborsTopk(
     }
   }
 
+  if (timer.active()) {
+    for (const IdArray& eids : induced_edges)
+      timer.AddEdges(eids->shape[0]);
+  }
+
   HeteroSubgraph ret;
   ret.graph = CreateHeteroGraph(hg->meta_graph(), subrels, hg->NumVerticesPerType());
   ret.induced_vertices.resize(hg->NumVertexTypes());
@@ -199,6 +375,9 @@ DGL_REGISTER_GLOBAL("sampling.neighbor._CAPI_DGLSampleNeighbors")
     const std::string dir_str = args[3];
     const auto& prob = ListValueToVector<FloatArray>(args[4]);
     const bool replace = args[5];
+    // The IDs of the edges never to sample, for every edge type, if given.
+    const auto& exclude_edges = (args.size() > 6)?
+      ListValueToVector<IdArray>(args[6]) : std::vector<IdArray>();
 
     CHECK(dir_str == "in" || dir_str == "out")
       << "Invalid edge direction. Must be \"in\" or \"out\".";
@@ -206,11 +385,42 @@ DGL_REGISTER_GLOBAL("sampling.neighbor._CAPI_DGLSampleNeighbors")
 
     std::shared_ptr<HeteroSubgraph> subg(new HeteroSubgraph);
     *subg = sampling::SampleNeighbors(
-        hg.sptr(), nodes, fanouts, dir, prob, replace);
+        hg.sptr(), nodes, fanouts, dir, prob, replace, exclude_edges);
 
     *rv = HeteroSubgraphRef(subg);
   });
 
+DGL_REGISTER_GLOBAL("sampling.neighbor._CAPI_DGLSampleNeighborsBatched")
+.set_body([] (DGLArgs args, DGLRetValue *rv) {
+    HeteroGraphRef hg = args[0];
+    // The node IDs of all the sets, one array per node type for every set.
+    const auto& all_nodes = ListValueToVector<IdArray>(args[1]);
+    IdArray fanouts_array = args[2];
+    const auto& fanouts = fanouts_array.ToVector<int64_t>();
+    const std::string dir_str = args[3];
+    const auto& prob = ListValueToVector<FloatArray>(args[4]);
+    const bool replace = args[5];
+
+    CHECK(dir_str == "in" || dir_str == "out")
+      << "Invalid edge direction. Must be \"in\" or \"out\".";
+    EdgeDir dir = (dir_str == "in")? EdgeDir::kIn : EdgeDir::kOut;
+    const size_t num_ntypes = hg->NumVertexTypes();
+    CHECK_EQ(all_nodes.size() % num_ntypes, 0)
+      << "Number of node ID tensors must be a multiple of the number of node types.";
+
+    std::vector<std::vector<IdArray>> nodes;
+    for (size_t i = 0; i < all_nodes.size(); i += num_ntypes)
+      nodes.emplace_back(all_nodes.begin() + i, all_nodes.begin() + i + num_ntypes);
+
+    List<HeteroSubgraphRef> ret;
+    for (HeteroSubgraph& subg : sampling::SampleNeighborsBatched(
+             hg.sptr(), nodes, fanouts, dir, prob, replace)) {
+      std::shared_ptr<HeteroSubgraph> subg_ptr(new HeteroSubgraph(std::move(subg)));
+      ret.push_back(HeteroSubgraphRef(subg_ptr));
+    }
+    *rv = ret;
+  });
+
 DGL_REGISTER_GLOBAL("sampling.neighbor._CAPI_DGLSampleNeighborsTopk")
 .set_body([] (DGLArgs args, DGLRetValue *rv) {
     HeteroGraphRef hg = args[0];
@@ -5,6 +5,7 @@
  */
 
 #include <dgl/runtime/container.h>
+#include <dgl/runtime/tracing.h>
 #include <dgl/packed_func_ext.h>
 #include <dgl/array.h>
 #include <dgl/sampling/randomwalks.h>
@@ -47,6 +48,7 @@ std::pair<IdArray, TypeArray> RandomWalk(
     const IdArray seeds,
     const TypeArray metapath,
     const std::vector<FloatArray> &prob) {
+  tracing::ScopedTimer timer("RandomWalk");
   CheckRandomWalkInputs(hg, seeds, metapath, prob);
 
   TypeArray vtypes;
@@ -67,6 +69,7 @@ std::pair<IdArray, TypeArray> RandomWalkWithRestart(
     const TypeArray metapath,
     const std::vector<FloatArray> &prob,
     double restart_prob) {
+  tracing::ScopedTimer timer("RandomWalkWithRestart");
   CheckRandomWalkInputs(hg, seeds, metapath, prob);
   CHECK(restart_prob >= 0 && restart_prob < 1) << "restart probability must belong to [0, 1)";
 
@@ -88,6 +91,7 @@ std::pair<IdArray, TypeArray> RandomWalkWithStepwiseRestart(
     const TypeArray metapath,
     const std::vector<FloatArray> &prob,
     FloatArray restart_prob) {
+  tracing::ScopedTimer timer("RandomWalkWithStepwiseRestart");
   CheckRandomWalkInputs(hg, seeds, metapath, prob);
   // TODO(BarclayII): check the elements of restart probability
 
@@ -111,9 +115,7 @@ DGL_REGISTER_GLOBAL("sampling.randomwalks._CAPI_DGLSamplingRandomWalk")
     HeteroGraphRef hg = args[0];
     IdArray seeds = args[1];
     TypeArray metapath = args[2];
-    List<Value> prob = args[3];
-
-    const auto& prob_vec = ListValueToVector<FloatArray>(prob);
+    const auto& prob_vec = ListValueToVector<FloatArray>(args[3]);
 
     auto result = sampling::RandomWalk(hg.sptr(), seeds, metapath, prob_vec);
     List<Value> ret;
@@ -127,11 +129,9 @@ DGL_REGISTER_GLOBAL("sampling.randomwalks._CAPI_DGLSamplingRandomWalkWithRestart
     HeteroGraphRef hg = args[0];
     IdArray seeds = args[1];
     TypeArray metapath = args[2];
-    List<Value> prob = args[3];
+    const auto& prob_vec = ListValueToVector<FloatArray>(args[3]);
     double restart_prob = args[4];
 
-    const auto& prob_vec = ListValueToVector<FloatArray>(prob);
-
     auto result = sampling::RandomWalkWithRestart(
         hg.sptr(), seeds, metapath, prob_vec, restart_prob);
     List<Value> ret;
@@ -145,11 +145,9 @@ DGL_REGISTER_GLOBAL("sampling.randomwalks._CAPI_DGLSamplingRandomWalkWithStepwis
     HeteroGraphRef hg = args[0];
     IdArray seeds = args[1];
     TypeArray metapath = args[2];
-    List<Value> prob = args[3];
+    const auto& prob_vec = ListValueToVector<FloatArray>(args[3]);
     FloatArray restart_prob = args[4];
 
-    const auto& prob_vec = ListValueToVector<FloatArray>(prob);
-
     auto result = sampling::RandomWalkWithStepwiseRestart(
         hg.sptr(), seeds, metapath, prob_vec, restart_prob);
     List<Value> ret;
@@ -0,0 +1,313 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_feature_store.cc
+ * \brief Node and edge features shared among processes.
+ */
+#include "./shared_feature_store.h"
+
+#include <dgl/packed_func_ext.h>
+#include <dgl/runtime/container.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../c_api_common.h"
+#include "./shared_store_control.h"
+
+namespace dgl {
+
+using runtime::SharedMemory;
+using namespace dgl::runtime;
+
+namespace {
+
+constexpr int kMaxKeyLength = 127;
+constexpr int kMaxDims = 8;
+constexpr int64_t kMaxTensors = 256;
+// Space reserved for the header at the beginning of the catalog segment.
+constexpr size_t kHeaderSize = 256;
+
+}  // namespace
+
+/*! \brief Header at the beginning of the catalog segment */
+struct SharedFeatureStoreHeader {
+  /*! \brief Reference count and lock of the store, guarding the catalog */
+  SharedStoreControl control;
+  /*! \brief Number of published tensors */
+  int64_t num_tensors;
+  /*! \brief Number of reserved entries, which follow the header */
+  int64_t num_slots;
+};
+
+/*! \brief Catalog entry of a tensor */
+struct SharedFeatureEntry {
+  /*! \brief Name of the tensor */
+  char key[kMaxKeyLength + 1];
+  /*! \brief Data type */
+  DLDataType dtype;
+  /*! \brief Number of dimensions */
+  int32_t ndim;
+  /*! \brief Shape */
+  int64_t shape[kMaxDims];
+  /*! \brief Whether the tensor is complete; until then the entry only holds the key */
+  int32_t ready;
+
+  std::vector<int64_t> Shape() const {
+    return std::vector<int64_t>(shape, shape + ndim);
+  }
+};
+
+namespace {
+
+static_assert(sizeof(SharedFeatureStoreHeader) <= kHeaderSize,
+              "SharedFeatureStoreHeader does not fit in the reserved space");
+constexpr size_t kCatalogSize = kHeaderSize + kMaxTensors * sizeof(SharedFeatureEntry);
+
+SharedFeatureEntry* Entries(SharedFeatureStoreHeader* header) {
+  return reinterpret_cast<SharedFeatureEntry*>(reinterpret_cast<char*>(header) + kHeaderSize);
+}
+
+// Copy the given rows of src to dst and return the number of invalid row IDs,
+// whose rows are left untouched.
+template <typename IdType>
+int64_t GatherRowBytes(const char* src, int64_t num_rows, size_t row_bytes,
+                       const IdType* rows, int64_t len, char* dst) {
+  int64_t num_invalid = 0;
+#pragma omp parallel for reduction(+:num_invalid)
+  for (int64_t i = 0; i < len; ++i) {
+    const int64_t row = rows[i];
+    if (row < 0 || row >= num_rows) {
+      ++num_invalid;
+      continue;
+    }
+    memcpy(dst + i * row_bytes, src + row * row_bytes, row_bytes);
+  }
+  return num_invalid;
+}
+
+}  // namespace
+
+SharedFeatureStorePtr SharedFeatureStore::Create(const std::string& name) {
+#ifndef _WIN32
+  SharedFeatureStorePtr store(new SharedFeatureStore(name));
+  // Processes still attached to an old store of this name keep their mapping,
+  // while the name is taken over by the new store.
+  SharedMemory::Unlink(name);
+  store->catalog_mem_ = std::make_shared<SharedMemory>(name);
+  store->header_ = static_cast<SharedFeatureStoreHeader*>(
+      store->catalog_mem_->CreateNew(kCatalogSize));
+  store->catalog_mem_->Disown();
+  // A new shared memory is filled with zeros, so the catalog is empty.
+  InitSharedStoreControl(&store->header_->control);
+  store->prefix_ = SharedStorePrefix(name, &store->header_->control);
+  return store;
+#else
+  LOG(FATAL) << "Shared memory is not supported on Windows.";
+  return nullptr;
+#endif  // _WIN32
+}
+
+SharedFeatureStorePtr SharedFeatureStore::Open(const std::string& name) {
+  if (!SharedMemory::Exist(name))
+    return nullptr;
+  SharedFeatureStorePtr store(new SharedFeatureStore(name));
+  store->catalog_mem_ = std::make_shared<SharedMemory>(name);
+  auto* header = static_cast<SharedFeatureStoreHeader*>(store->catalog_mem_->Open(kCatalogSize));
+  if (!AttachSharedStore(&header->control))
+    return nullptr;
+  store->header_ = header;
+  store->prefix_ = SharedStorePrefix(name, &header->control);
+  return store;
+}
+
+SharedFeatureStore::~SharedFeatureStore() {
+  if (!header_ || !DetachSharedStore(&header_->control))
+    return;
+  // Tensors mapped by now, here or elsewhere, stay valid until released.
+  for (int64_t i = 0; i < header_->num_slots; ++i)
+    SharedMemory::Unlink(TensorName(i));
+  UnlinkSharedStore(name_, &header_->control);
+}
+
+std::string SharedFeatureStore::TensorName(int64_t i) const {
+  return prefix_ + "_" + std::to_string(i);
+}
+
+const SharedFeatureEntry* SharedFeatureStore::Find(const std::string& key, bool pending) const {
+  const SharedFeatureEntry* entries = Entries(header_);
+  for (int64_t i = 0; i < header_->num_slots; ++i)
+    if ((pending || entries[i].ready) && key == entries[i].key)
+      return entries + i;
+  return nullptr;
+}
+
+NDArray SharedFeatureStore::Add(const std::string& key, NDArray tensor) {
+  CHECK(!key.empty() && key.size() <= kMaxKeyLength)
+    << "The name of a shared tensor must have 1 to " << kMaxKeyLength << " characters";
+  CHECK(tensor.IsContiguous()) << "Only contiguous tensors can be shared";
+  CHECK_GE(tensor->ndim, 1) << "Cannot share a scalar";
+  CHECK_LE(tensor->ndim, kMaxDims) << "Cannot share a tensor of more than "
+                                   << kMaxDims << " dimensions";
+  const std::vector<int64_t> shape(tensor->shape, tensor->shape + tensor->ndim);
+  // Only reserve an entry under the lock; the tensor is copied without holding it,
+  // so that the other processes are not blocked for the whole copy.
+  int64_t idx;
+  {
+    SharedStoreLock lock(&header_->control);
+    CHECK(Find(key, true) == nullptr) << "Tensor " << key << " is already in the store";
+    CHECK_LT(header_->num_slots, kMaxTensors) << "Too many tensors in the store";
+    idx = header_->num_slots++;
+    strncpy(Entries(header_)[idx].key, key.c_str(), kMaxKeyLength);
+  }
+  NDArray shared;
+  try {
+    shared = NDArray::EmptyShared(TensorName(idx), shape, tensor->dtype,
+                                  DLContext{kDLCPU, 0}, true);
+    shared.CopyFrom(tensor);
+  } catch (...) {
+    // The segment is still owned here and goes away with shared; free the key.
+    SharedStoreLock lock(&header_->control);
+    Entries(header_)[idx].key[0] = '\0';
+    throw;
+  }
+  // From now on, the segment is removed by the last process detaching.
+  shared.GetSharedMem()->Disown();
+
+  // Publish the tensor once it is complete.
+  {
+    SharedStoreLock lock(&header_->control);
+    SharedFeatureEntry* entry = Entries(header_) + idx;
+    entry->dtype = tensor->dtype;
+    entry->ndim = tensor->ndim;
+    std::copy(shape.begin(), shape.end(), entry->shape);
+    entry->ready = 1;
+    ++header_->num_tensors;
+  }
+  std::lock_guard<std::mutex> guard(tensors_mutex_);
+  tensors_[key] = shared;
+  return shared;
+}
+
+bool SharedFeatureStore::Has(const std::string& key) {
+  SharedStoreLock lock(&header_->control);
+  return Find(key) != nullptr;
+}
+
+NDArray SharedFeatureStore::Get(const std::string& key) {
+  std::lock_guard<std::mutex> guard(tensors_mutex_);
+  auto it = tensors_.find(key);
+  if (it != tensors_.end())
+    return it->second;
+
+  SharedStoreLock lock(&header_->control);
+  const SharedFeatureEntry* entry = Find(key);
+  CHECK(entry != nullptr) << "Tensor " << key << " is not in the store";
+  NDArray tensor = NDArray::EmptyShared(TensorName(entry - Entries(header_)), entry->Shape(),
+                                        entry->dtype, DLContext{kDLCPU, 0}, false);
+  tensors_[key] = tensor;
+  return tensor;
+}
+
+std::vector<std::string> SharedFeatureStore::Keys() {
+  SharedStoreLock lock(&header_->control);
+  std::vector<std::string> keys;
+  keys.reserve(header_->num_tensors);
+  const SharedFeatureEntry* entries = Entries(header_);
+  for (int64_t i = 0; i < header_->num_slots; ++i) {
+    if (entries[i].ready)
+      keys.emplace_back(entries[i].key);
+  }
+  return keys;
+}
+
+void SharedFeatureStore::GatherRows(const std::string& key, IdArray rows, NDArray out) {
+  dgl::GatherRows(Get(key), rows, out);
+}
+
+void GatherRows(NDArray tensor, IdArray rows, NDArray out) {
+  CHECK_EQ(tensor->ctx.device_type, kDLCPU) << "The tensor must be on CPU";
+  CHECK_EQ(out->ctx.device_type, kDLCPU) << "The output buffer must be on CPU";
+  CHECK_EQ(rows->ctx.device_type, kDLCPU) << "The row IDs must be on CPU";
+  CHECK_EQ(rows->ndim, 1) << "The row IDs must be a vector";
+  CHECK(tensor.IsContiguous() && out.IsContiguous()) << "Expect contiguous tensors";
+  CHECK(tensor->dtype == out->dtype) << "The output buffer has a different data type";
+  CHECK_EQ(tensor->ndim, out->ndim) << "The output buffer has a different row shape";
+  CHECK_EQ(out->shape[0], rows->shape[0])
+    << "Expect an output buffer of " << rows->shape[0] << " rows, but got " << out->shape[0];
+  int64_t row_size = 1;
+  for (int i = 1; i < tensor->ndim; ++i) {
+    CHECK_EQ(tensor->shape[i], out->shape[i]) << "The output buffer has a different row shape";
+    row_size *= tensor->shape[i];
+  }
+  const size_t row_bytes = row_size * ((tensor->dtype.bits * tensor->dtype.lanes + 7) / 8);
+  const int64_t num_rows = tensor->shape[0];
+
+  int64_t num_invalid = 0;
+  ATEN_ID_TYPE_SWITCH(rows->dtype, IdType, {
+    num_invalid = GatherRowBytes(static_cast<const char*>(tensor->data), num_rows, row_bytes,
+                                 static_cast<IdType*>(rows->data), rows->shape[0],
+                                 static_cast<char*>(out->data));
+  });
+  CHECK_EQ(num_invalid, 0) << num_invalid << " row IDs are out of range [0, "
+                           << num_rows << ")";
+}
+
+///////////////////////// C APIs /////////////////////////
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreCreate")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const std::string name = args[0];
+    *rv = SharedFeatureStoreRef(SharedFeatureStore::Create(name));
+  });
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreOpen")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const std::string name = args[0];
+    auto store = SharedFeatureStore::Open(name);
+    CHECK(store) << "There is no shared feature store named " << name;
+    *rv = SharedFeatureStoreRef(store);
+  });
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreAdd")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    SharedFeatureStoreRef store = args[0];
+    const std::string key = args[1];
+    NDArray tensor = args[2];
+    *rv = store->Add(key, tensor);
+  });
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreHas")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    SharedFeatureStoreRef store = args[0];
+    const std::string key = args[1];
+    *rv = store->Has(key);
+  });
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreGet")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    SharedFeatureStoreRef store = args[0];
+    const std::string key = args[1];
+    *rv = store->Get(key);
+  });
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreKeys")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    SharedFeatureStoreRef store = args[0];
+    List<Value> keys;
+    for (const auto& key : store->Keys())
+      keys.push_back(Value(MakeValue(key)));
+    *rv = keys;
+  });
+
+DGL_REGISTER_GLOBAL("shared_feature_store._CAPI_DGLSharedFeatureStoreGatherRows")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    SharedFeatureStoreRef store = args[0];
+    const std::string key = args[1];
+    IdArray rows = args[2];
+    NDArray out = args[3];
+    store->GatherRows(key, rows, out);
+  });
+
+}  // namespace dgl
@@ -0,0 +1,124 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_feature_store.h
+ * \brief Node and edge features shared among processes.
+ */
+#ifndef DGL_GRAPH_SHARED_FEATURE_STORE_H_
+#define DGL_GRAPH_SHARED_FEATURE_STORE_H_
+
+#include <dgl/array.h>
+#include <dgl/runtime/object.h>
+#include <dgl/runtime/shared_mem.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dgl {
+
+struct SharedFeatureStoreHeader;
+struct SharedFeatureEntry;
+
+/*!
+ * \brief Named tensors in shared memory.
+ *
+ * The store consists of a catalog segment named after the store, holding the
+ * reference count, a process-shared lock and the name, data type and shape of
+ * every tensor, and of one segment per tensor. Processes attach to the store by
+ * name and map the tensors without copying them, so a feature matrix is held
+ * once in memory however many data loader workers read it.
+ *
+ * Tensors can be added by any process at any time, but cannot be replaced or
+ * removed. The last process to detach removes all the segments.
+ */
+class SharedFeatureStore : public runtime::Object {
+ public:
+  /*!
+   * \brief Create a new empty store, replacing the one with the same name if any.
+   * \param name The name of the shared memory.
+   */
+  static std::shared_ptr<SharedFeatureStore> Create(const std::string& name);
+
+  /*!
+   * \brief Attach to an existing store.
+   * \return The store, or nullptr if there is no store of that name.
+   */
+  static std::shared_ptr<SharedFeatureStore> Open(const std::string& name);
+
+  /*! \brief Detach from the store; the last process removes the segments. */
+  ~SharedFeatureStore();
+
+  /*! \return The name of the store. */
+  const std::string& name() const { return name_; }
+
+  /*!
+   * \brief Copy a tensor into the store.
+   * \param key The name of the tensor, unique in the store.
+   * \param tensor The tensor, which must be contiguous.
+   * \return The tensor in shared memory.
+   */
+  NDArray Add(const std::string& key, NDArray tensor);
+
+  /*! \return Whether the store has a tensor of the given name. */
+  bool Has(const std::string& key);
+
+  /*! \return The tensor of the given name in shared memory, without copy. */
+  NDArray Get(const std::string& key);
+
+  /*! \return The names of all the tensors in the store, in the order they were added. */
+  std::vector<std::string> Keys();
+
+  /*!
+   * \brief Copy rows of a tensor into a buffer, in parallel.
+   * \param key The name of the tensor.
+   * \param rows The IDs of the rows to copy.
+   * \param out The output buffer, a contiguous CPU tensor with as many rows as
+   *        \c rows and the data type and row shape of the tensor.
+   */
+  void GatherRows(const std::string& key, IdArray rows, NDArray out);
+
+  static constexpr const char* _type_key = "graph.SharedFeatureStore";
+  DGL_DECLARE_OBJECT_TYPE_INFO(SharedFeatureStore, runtime::Object);
+
+ private:
+  explicit SharedFeatureStore(const std::string& name) : name_(name) {}
+
+  /*!
+   * \brief The catalog entry of a tensor, or nullptr; must hold the store lock.
+   * \param pending Whether to also look at the tensors still being added.
+   */
+  const SharedFeatureEntry* Find(const std::string& key, bool pending = false) const;
+
+  /*! \brief The name of the segment of the i-th tensor */
+  std::string TensorName(int64_t i) const;
+
+  /*! \brief The name of the store, i.e. of its catalog segment */
+  std::string name_;
+  /*! \brief The prefix of the tensor segments */
+  std::string prefix_;
+  /*! \brief The catalog segment */
+  std::shared_ptr<runtime::SharedMemory> catalog_mem_;
+  /*! \brief The header of the catalog */
+  SharedFeatureStoreHeader* header_ = nullptr;
+  /*! \brief The tensors mapped by this object so far */
+  std::unordered_map<std::string, NDArray> tensors_;
+  /*! \brief Guard of tensors_ among the threads of a process */
+  std::mutex tensors_mutex_;
+};
+
+typedef std::shared_ptr<SharedFeatureStore> SharedFeatureStorePtr;
+DGL_DEFINE_OBJECT_REF(SharedFeatureStoreRef, SharedFeatureStore);
+
+/*!
+ * \brief Copy rows of a tensor into a buffer, in parallel.
+ * \param tensor The contiguous CPU tensor to read.
+ * \param rows The IDs of the rows to copy.
+ * \param out The output buffer, a contiguous CPU tensor with as many rows as
+ *        \c rows and the data type and row shape of \c tensor.
+ */
+void GatherRows(NDArray tensor, IdArray rows, NDArray out);
+
+}  // namespace dgl
+
+#endif  // DGL_GRAPH_SHARED_FEATURE_STORE_H_
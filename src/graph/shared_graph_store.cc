@@ -0,0 +1,221 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_graph_store.cc
+ * \brief Graph structure shared among processes.
+ */
+#include "./shared_graph_store.h"
+
+#include <algorithm>
+#include <string>
+
+#include "./shared_mem_manager.h"
+#include "./shared_store_control.h"
+
+namespace dgl {
+
+using runtime::SharedMemory;
+
+/*! \brief Header at the beginning of the metadata segment */
+struct SharedGraphStoreHeader {
+  /*! \brief Reference count and lock of the store, guarding the format slots */
+  SharedStoreControl control;
+  /*! \brief Number of edge types */
+  int64_t num_etypes;
+};
+
+namespace {
+
+// Space reserved for the header at the beginning of the metadata segment.
+constexpr size_t kHeaderSize = 256;
+static_assert(sizeof(SharedGraphStoreHeader) <= kHeaderSize,
+              "SharedGraphStoreHeader does not fit in the reserved space");
+
+// Size of the slot of one format of one edge type. The first byte tells
+// whether the format is published; the metadata of its arrays follow.
+constexpr size_t kSlotSize = 256;
+
+constexpr int kNumFormats = 3;
+const dgl_format_code_t kFormatCodes[kNumFormats] = {coo_code, csr_code, csc_code};
+const char* const kFormatNames[kNumFormats] = {"coo", "csr", "csc"};
+
+int FormatIndex(dgl_format_code_t code) {
+  for (int i = 0; i < kNumFormats; ++i)
+    if (code == kFormatCodes[i])
+      return i;
+  LOG(FATAL) << "Expect exactly one of coo, csr and csc, but got " << CodeToStr(code);
+  return -1;
+}
+
+// Name of the arrays of a format of an edge type, relative to the store prefix.
+std::string FormatSuffix(dgl_type_t etype, dgl_format_code_t code) {
+  return "_" + std::to_string(etype) + "_" + kFormatNames[FormatIndex(code)];
+}
+
+size_t SlotMemSize(int64_t num_etypes) {
+  return std::max<size_t>(1, num_etypes * kNumFormats) * kSlotSize;
+}
+
+void Disown(NDArray arr) {
+  auto mem = arr.GetSharedMem();
+  if (mem)
+    mem->Disown();
+}
+
+void DisownArrays(const aten::COOMatrix& coo) {
+  Disown(coo.row);
+  Disown(coo.col);
+  Disown(coo.data);
+}
+
+void DisownArrays(const aten::CSRMatrix& csr) {
+  Disown(csr.indptr);
+  Disown(csr.indices);
+  Disown(csr.data);
+}
+
+}  // namespace
+
+SharedGraphStorePtr SharedGraphStore::Create(const std::string& name, int64_t num_etypes) {
+#ifndef _WIN32
+  SharedGraphStorePtr store(new SharedGraphStore(name));
+  // Processes still attached to an old store of this name keep their mapping,
+  // while the name is taken over by the new store.
+  SharedMemory::Unlink(name);
+  store->meta_mem_ = std::make_shared<SharedMemory>(name);
+  char* buf = static_cast<char*>(store->meta_mem_->CreateNew(SHARED_MEM_METAINFO_SIZE_MAX));
+  store->meta_mem_->Disown();
+
+  // A new shared memory is filled with zeros, so every format is unpublished.
+  SharedGraphStoreHeader* header = reinterpret_cast<SharedGraphStoreHeader*>(buf);
+  InitSharedStoreControl(&header->control);
+  header->num_etypes = num_etypes;
+  store->header_ = header;
+
+  store->prefix_ = SharedStorePrefix(name, &header->control);
+  store->slot_mem_ = std::make_shared<SharedMemory>(store->prefix_ + "_formats");
+  store->slots_ = static_cast<char*>(store->slot_mem_->CreateNew(SlotMemSize(num_etypes)));
+  store->slot_mem_->Disown();
+  store->meta_strm_.reset(new dmlc::MemoryFixedSizeStream(
+      buf + kHeaderSize, SHARED_MEM_METAINFO_SIZE_MAX - kHeaderSize));
+  return store;
+#else
+  LOG(FATAL) << "Shared memory is not supported on Windows.";
+  return nullptr;
+#endif  // _WIN32
+}
+
+SharedGraphStorePtr SharedGraphStore::Open(const std::string& name) {
+  if (!SharedMemory::Exist(name))
+    return nullptr;
+  SharedGraphStorePtr store(new SharedGraphStore(name));
+  store->meta_mem_ = std::make_shared<SharedMemory>(name);
+  char* buf = static_cast<char*>(store->meta_mem_->Open(SHARED_MEM_METAINFO_SIZE_MAX));
+  SharedGraphStoreHeader* header = reinterpret_cast<SharedGraphStoreHeader*>(buf);
+  if (!AttachSharedStore(&header->control))
+    return nullptr;
+  store->header_ = header;
+
+  store->prefix_ = SharedStorePrefix(name, &header->control);
+  store->slot_mem_ = std::make_shared<SharedMemory>(store->prefix_ + "_formats");
+  store->slots_ = static_cast<char*>(store->slot_mem_->Open(SlotMemSize(header->num_etypes)));
+  store->meta_strm_.reset(new dmlc::MemoryFixedSizeStream(
+      buf + kHeaderSize, SHARED_MEM_METAINFO_SIZE_MAX - kHeaderSize));
+  return store;
+}
+
+SharedGraphStore::~SharedGraphStore() {
+  if (!header_)
+    return;
+  if (DetachSharedStore(&header_->control))
+    UnlinkAll();
+}
+
+int64_t SharedGraphStore::NumEdgeTypes() const {
+  return header_->num_etypes;
+}
+
+char* SharedGraphStore::Slot(dgl_type_t etype, dgl_format_code_t code) const {
+  CHECK_LT(etype, header_->num_etypes) << "Invalid edge type: " << etype;
+  return slots_ + (etype * kNumFormats + FormatIndex(code)) * kSlotSize;
+}
+
+dgl_format_code_t SharedGraphStore::PublishedFormats(dgl_type_t etype) {
+  SharedStoreLock lock(&header_->control);
+  dgl_format_code_t ret = 0;
+  for (int i = 0; i < kNumFormats; ++i)
+    if (Slot(etype, kFormatCodes[i])[0])
+      ret |= kFormatCodes[i];
+  return ret;
+}
+
+template <typename T>
+bool SharedGraphStore::Fetch(dgl_type_t etype, dgl_format_code_t code, T* out) {
+  SharedStoreLock lock(&header_->control);
+  char* slot = Slot(etype, code);
+  if (!slot[0])
+    return false;
+  dmlc::MemoryFixedSizeStream strm(slot + 1, kSlotSize - 1);
+  SharedMemManager shm(prefix_, &strm);
+  shm.CreateFromSharedMem(out, FormatSuffix(etype, code));
+  return true;
+}
+
+template <typename T>
+T SharedGraphStore::FetchOrBuild(
+    dgl_type_t etype, dgl_format_code_t code, const std::function<T()>& build) {
+  SharedStoreLock lock(&header_->control);
+  char* slot = Slot(etype, code);
+  dmlc::MemoryFixedSizeStream strm(slot + 1, kSlotSize - 1);
+  SharedMemManager shm(prefix_, &strm);
+  T ret;
+  if (slot[0]) {
+    shm.CreateFromSharedMem(&ret, FormatSuffix(etype, code));
+  } else {
+    // Other processes asking for the same format wait here instead of
+    // building their own copy.
+    ret = shm.CopyToSharedMem(build(), FormatSuffix(etype, code));
+    DisownArrays(ret);
+    slot[0] = 1;
+  }
+  return ret;
+}
+
+bool SharedGraphStore::FetchCOO(dgl_type_t etype, aten::COOMatrix* coo) {
+  return Fetch(etype, coo_code, coo);
+}
+
+bool SharedGraphStore::FetchCSR(
+    dgl_type_t etype, dgl_format_code_t code, aten::CSRMatrix* csr) {
+  CHECK(code == csr_code || code == csc_code) << "Expect csr or csc";
+  return Fetch(etype, code, csr);
+}
+
+aten::COOMatrix SharedGraphStore::FetchOrBuildCOO(
+    dgl_type_t etype, const std::function<aten::COOMatrix()>& build) {
+  return FetchOrBuild(etype, coo_code, build);
+}
+
+aten::CSRMatrix SharedGraphStore::FetchOrBuildCSR(
+    dgl_type_t etype, dgl_format_code_t code,
+    const std::function<aten::CSRMatrix()>& build) {
+  CHECK(code == csr_code || code == csc_code) << "Expect csr or csc";
+  return FetchOrBuild(etype, code, build);
+}
+
+void SharedGraphStore::UnlinkAll() const {
+  for (int64_t etype = 0; etype < header_->num_etypes; ++etype) {
+    for (int i = 0; i < kNumFormats; ++i) {
+      if (!Slot(etype, kFormatCodes[i])[0])
+        continue;
+      const std::string base = prefix_ + FormatSuffix(etype, kFormatCodes[i]);
+      const char* const suffixes[] = {"_row", "_col", "_indptr", "_indices", "_data"};
+      for (const char* suffix : suffixes)
+        SharedMemory::Unlink(base + suffix);
+    }
+  }
+  SharedMemory::Unlink(prefix_ + "_formats");
+
+  UnlinkSharedStore(name_, &header_->control);
+}
+
+}  // namespace dgl
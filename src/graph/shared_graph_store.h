@@ -0,0 +1,133 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_graph_store.h
+ * \brief Graph structure shared among processes.
+ */
+#ifndef DGL_GRAPH_SHARED_GRAPH_STORE_H_
+#define DGL_GRAPH_SHARED_GRAPH_STORE_H_
+
+#include <dgl/array.h>
+#include <dgl/runtime/shared_mem.h>
+#include <dmlc/memory_io.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace dgl {
+
+struct SharedGraphStoreHeader;
+
+/*!
+ * \brief Sparse formats of the relation graphs of a heterograph in shared memory.
+ *
+ * The store consists of
+ * (1) a metadata segment named after the graph, holding a control header
+ *     (reference count and a process-shared lock) followed by a stream for
+ *     the graph-level metadata such as the metagraph and the type names;
+ * (2) one fixed-size slot per edge type and sparse format recording whether
+ *     the format has been published and the metadata of its arrays;
+ * (3) the arrays of every published format.
+ *
+ * Formats are published on demand: the first process asking for a missing
+ * format builds it under the store lock and copies it to shared memory; all
+ * the others map the published copy. Every process attached to the store
+ * holds a reference, and the last one to detach removes all the segments.
+ *
+ * Segments other than the metadata one are named with a token unique to the
+ * store, so creating a new store under the name of a live one does not
+ * disturb the processes still attached to the old one.
+ */
+class SharedGraphStore {
+ public:
+  /*!
+   * \brief Create a new store, replacing the one with the same name if any.
+   * \param name The name of the shared memory.
+   * \param num_etypes The number of edge types of the graph.
+   */
+  static std::shared_ptr<SharedGraphStore> Create(const std::string& name, int64_t num_etypes);
+
+  /*!
+   * \brief Attach to an existing store.
+   * \return The store, or nullptr if there is no store of that name.
+   */
+  static std::shared_ptr<SharedGraphStore> Open(const std::string& name);
+
+  /*! \brief Detach from the store; the last process removes the segments. */
+  ~SharedGraphStore();
+
+  /*! \return The name of the store. */
+  const std::string& name() const { return name_; }
+
+  /*! \return The number of edge types of the graph. */
+  int64_t NumEdgeTypes() const;
+
+  /*! \return The stream of the graph-level metadata. */
+  dmlc::Stream* MetaStream() { return meta_strm_.get(); }
+
+  /*! \return The formats of the given edge type published so far. */
+  dgl_format_code_t PublishedFormats(dgl_type_t etype);
+
+  /*!
+   * \brief Map the COO matrix of the given edge type.
+   * \return false if it has not been published.
+   */
+  bool FetchCOO(dgl_type_t etype, aten::COOMatrix* coo);
+
+  /*!
+   * \brief Map the CSR or CSC matrix of the given edge type.
+   * \param code Either csr_code or csc_code.
+   * \return false if it has not been published.
+   */
+  bool FetchCSR(dgl_type_t etype, dgl_format_code_t code, aten::CSRMatrix* csr);
+
+  /*!
+   * \brief Map the COO matrix of the given edge type, building and publishing
+   *        it with the given function if no process has done so.
+   */
+  aten::COOMatrix FetchOrBuildCOO(
+      dgl_type_t etype, const std::function<aten::COOMatrix()>& build);
+
+  /*!
+   * \brief Map the CSR or CSC matrix of the given edge type, building and
+   *        publishing it with the given function if no process has done so.
+   */
+  aten::CSRMatrix FetchOrBuildCSR(
+      dgl_type_t etype, dgl_format_code_t code,
+      const std::function<aten::CSRMatrix()>& build);
+
+ private:
+  explicit SharedGraphStore(const std::string& name) : name_(name) {}
+
+  template <typename T>
+  bool Fetch(dgl_type_t etype, dgl_format_code_t code, T* out);
+
+  template <typename T>
+  T FetchOrBuild(dgl_type_t etype, dgl_format_code_t code, const std::function<T()>& build);
+
+  /*! \brief The slot of a format of an edge type */
+  char* Slot(dgl_type_t etype, dgl_format_code_t code) const;
+
+  /*! \brief Remove all the segments of the store */
+  void UnlinkAll() const;
+
+  /*! \brief The name of the store, i.e. of its metadata segment */
+  std::string name_;
+  /*! \brief The prefix of all the other segments */
+  std::string prefix_;
+  /*! \brief The metadata segment */
+  std::shared_ptr<runtime::SharedMemory> meta_mem_;
+  /*! \brief The segment of the format slots */
+  std::shared_ptr<runtime::SharedMemory> slot_mem_;
+  /*! \brief The control header at the beginning of the metadata segment */
+  SharedGraphStoreHeader* header_ = nullptr;
+  /*! \brief The format slots */
+  char* slots_ = nullptr;
+  /*! \brief The stream over the rest of the metadata segment */
+  std::unique_ptr<dmlc::MemoryFixedSizeStream> meta_strm_;
+};
+
+typedef std::shared_ptr<SharedGraphStore> SharedGraphStorePtr;
+
+}  // namespace dgl
+
+#endif  // DGL_GRAPH_SHARED_GRAPH_STORE_H_
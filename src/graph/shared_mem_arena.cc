@@ -0,0 +1,202 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_mem_arena.cc
+ * \brief Reusable shared memory arenas for pickling graphs.
+ */
+#include "./shared_mem_arena.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif  // _WIN32
+#include <dgl/packed_func_ext.h>
+#include <dgl/runtime/container.h>
+#include <dgl/runtime/registry.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include "../c_api_common.h"
+
+using namespace dgl::runtime;
+
+namespace dgl {
+
+namespace {
+
+/*! \brief Smallest arena created, so that small graphs share the same arenas. */
+constexpr int64_t kMinArenaSize = 1 << 20;
+
+bool PickleToSharedMemFromEnv() {
+  const char* val = getenv("DGL_PICKLE_SHARED_MEM");
+  return val != nullptr && (strcmp(val, "1") == 0 || strcmp(val, "true") == 0 ||
+                            strcmp(val, "True") == 0);
+}
+
+std::atomic<bool> pickle_to_shared_mem(PickleToSharedMemFromEnv());
+
+/*! \brief Returns the lease of an arena once the array covering it is freed. */
+struct ArenaRelease {
+  std::shared_ptr<MappedArena> arena;
+  int64_t lease;
+  int64_t shape;
+
+  ~ArenaRelease() {
+    int64_t expected = lease;
+    arena->header()->lease.compare_exchange_strong(expected, 0, std::memory_order_release);
+  }
+};
+
+void DeleteArenaTensor(DLManagedTensor* tensor) {
+  delete static_cast<ArenaRelease*>(tensor->manager_ctx);
+  delete tensor;
+}
+
+}  // namespace
+
+ArenaPool* ArenaPool::Global() {
+  // Destroyed at exit, which removes the arenas.
+  static ArenaPool pool;
+  return &pool;
+}
+
+ArenaPool::Lease ArenaPool::Acquire(int64_t size) {
+  const int64_t needed = size + kArenaHeaderSize;
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<MappedArena> best;
+  for (const auto& arena : arenas_) {
+    if (arena->capacity >= needed &&
+        arena->header()->lease.load(std::memory_order_acquire) == 0 &&
+        (!best || arena->capacity < best->capacity))
+      best = arena;
+  }
+
+  if (!best) {
+#ifndef _WIN32
+    if (prefix_.empty()) {
+      // The PID alone may be reused while another process still caches the mappings
+      // of the arenas of a previous one.
+      std::ostringstream oss;
+      oss << "/dgl_arena_" << getpid() << "_" << std::hex
+          << std::chrono::steady_clock::now().time_since_epoch().count() << "_";
+      prefix_ = oss.str();
+    }
+#endif  // _WIN32
+    int64_t capacity = kMinArenaSize;
+    while (capacity < needed)
+      capacity *= 2;
+    best = std::make_shared<MappedArena>();
+    best->name = prefix_ + std::to_string(next_arena_++);
+    best->mem = std::make_shared<SharedMemory>(best->name);
+    best->base = static_cast<char*>(best->mem->CreateNew(capacity));
+    best->capacity = capacity;
+    new (best->header()) ArenaHeader();
+    best->header()->capacity = capacity;
+    arenas_.push_back(best);
+  }
+
+  const int64_t id = next_lease_++;
+  best->header()->lease.store(id, std::memory_order_release);
+  return Lease{best, id};
+}
+
+void ArenaPool::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  arenas_.erase(std::remove_if(arenas_.begin(), arenas_.end(),
+                               [] (const std::shared_ptr<MappedArena>& arena) {
+                                 return arena->header()->lease.load(
+                                     std::memory_order_acquire) == 0;
+                               }),
+                arenas_.end());
+}
+
+ArenaPool::Stats ArenaPool::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats;
+  for (const auto& arena : arenas_) {
+    ++stats.num_arenas;
+    stats.capacity_bytes += arena->capacity;
+    if (arena->header()->lease.load(std::memory_order_acquire) == 0)
+      ++stats.num_free;
+  }
+  return stats;
+}
+
+ArenaMapper* ArenaMapper::Global() {
+  static ArenaMapper mapper;
+  return &mapper;
+}
+
+std::shared_ptr<MappedArena> ArenaMapper::Map(const std::string& name, int64_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = cache_.find(name);
+  if (it != cache_.end()) {
+    CHECK_EQ(it->second->capacity, capacity) << "Arena " << name << " changed its size.";
+    return it->second;
+  }
+
+  auto arena = std::make_shared<MappedArena>();
+  arena->name = name;
+  arena->mem = std::make_shared<SharedMemory>(name);
+  arena->base = static_cast<char*>(arena->mem->Open(capacity));
+  arena->capacity = capacity;
+  CHECK_EQ(arena->header()->capacity, capacity) << "Invalid arena " << name;
+
+  cache_[name] = arena;
+  order_.push_back(name);
+  if (order_.size() > kMaxCached) {
+    cache_.erase(order_.front());
+    order_.pop_front();
+  }
+  return arena;
+}
+
+NDArray ArenaMapper::Adopt(std::shared_ptr<MappedArena> arena, int64_t lease) {
+  ArenaRelease* release = new ArenaRelease{arena, lease, arena->capacity};
+  DLManagedTensor* tensor = new DLManagedTensor();
+  tensor->dl_tensor.data = arena->base;
+  tensor->dl_tensor.ctx = DLContext{kDLCPU, 0};
+  tensor->dl_tensor.ndim = 1;
+  tensor->dl_tensor.dtype = DLDataType{kDLUInt, 8, 1};
+  tensor->dl_tensor.shape = &release->shape;
+  tensor->dl_tensor.strides = nullptr;
+  tensor->dl_tensor.byte_offset = 0;
+  tensor->manager_ctx = release;
+  tensor->deleter = DeleteArenaTensor;
+  return NDArray::FromDLPack(tensor);
+}
+
+bool IsPicklingToSharedMem() {
+  return pickle_to_shared_mem.load(std::memory_order_relaxed);
+}
+
+void SetPicklingToSharedMem(bool enabled) {
+  pickle_to_shared_mem.store(enabled, std::memory_order_relaxed);
+}
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemorySetPickleToSharedMem")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const bool enabled = args[0];
+    SetPicklingToSharedMem(enabled);
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryIsPicklingToSharedMem")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    *rv = IsPicklingToSharedMem();
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryGetArenaPoolStats")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const ArenaPool::Stats stats = ArenaPool::Global()->GetStats();
+    const std::vector<int64_t> values = {
+      stats.num_arenas, stats.num_free, stats.capacity_bytes};
+    *rv = NDArray::FromVector(values);
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryClearArenaPool")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    ArenaPool::Global()->Clear();
+  });
+
+}  // namespace dgl
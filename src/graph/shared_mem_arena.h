@@ -0,0 +1,129 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_mem_arena.h
+ * \brief Reusable shared memory arenas for pickling graphs without copying their
+ *        arrays through the pipes of multi-process loaders.
+ *
+ * The process pickling a graph leases an arena from its ArenaPool, copies the arrays
+ * of the graph into it and pickles only the name of the arena and the offsets of the
+ * arrays. The process unpickling the graph maps the arena through its ArenaMapper and
+ * views the arrays in place. Once the last of these arrays is freed, the lease is
+ * returned, and the pickling process reuses the arena for a later graph.
+ *
+ * The lease lives in a header at the start of the arena, so it is visible to both
+ * processes. Every pickle must be unpickled exactly once: an arena whose pickle is
+ * never unpickled is not reused, and unpickling it twice returns it too early.
+ */
+#ifndef DGL_GRAPH_SHARED_MEM_ARENA_H_
+#define DGL_GRAPH_SHARED_MEM_ARENA_H_
+
+#include <dgl/runtime/ndarray.h>
+#include <dgl/runtime/shared_mem.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dgl {
+
+/*! \brief Header at the start of every arena, shared by the processes mapping it. */
+struct ArenaHeader {
+  /*! \brief ID of the lease holding the arena, or 0 if the arena is free */
+  std::atomic<int64_t> lease;
+  /*! \brief Size of the arena in bytes, header included */
+  int64_t capacity;
+};
+
+/*! \brief Size reserved for the header; the arrays start after it. */
+constexpr int64_t kArenaHeaderSize = 64;
+
+/*! \brief Alignment of the arrays in an arena. */
+constexpr int64_t kArenaAlignment = 64;
+
+/*! \brief An arena mapped in the calling process. */
+struct MappedArena {
+  std::shared_ptr<runtime::SharedMemory> mem;
+  std::string name;
+  char* base = nullptr;
+  int64_t capacity = 0;
+
+  ArenaHeader* header() const {
+    return reinterpret_cast<ArenaHeader*>(base);
+  }
+};
+
+/*! \brief The arenas created by this process for pickling, reused across pickles. */
+class ArenaPool {
+ public:
+  /*! \brief An arena leased for one pickle. */
+  struct Lease {
+    std::shared_ptr<MappedArena> arena;
+    int64_t id;
+  };
+
+  /*! \brief Statistics of the pool. */
+  struct Stats {
+    int64_t num_arenas = 0;
+    int64_t num_free = 0;
+    int64_t capacity_bytes = 0;
+  };
+
+  static ArenaPool* Global();
+
+  /*!
+   * \brief Lease the smallest free arena that fits size bytes after its header,
+   *        creating one if there is none.
+   */
+  Lease Acquire(int64_t size);
+
+  /*! \brief Remove the free arenas. The leased ones are kept. */
+  void Clear();
+
+  Stats GetStats();
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<MappedArena>> arenas_;
+  std::string prefix_;
+  int64_t next_arena_ = 0;
+  int64_t next_lease_ = 1;
+};
+
+/*! \brief The arenas of other processes mapped by this process for unpickling. */
+class ArenaMapper {
+ public:
+  static ArenaMapper* Global();
+
+  /*!
+   * \brief Map an arena, or return the mapping cached by a previous call. The mappings
+   *        of the least recently mapped arenas are dropped from the cache once there
+   *        are more than kMaxCached of them, and unmapped once no array uses them.
+   */
+  std::shared_ptr<MappedArena> Map(const std::string& name, int64_t capacity);
+
+  /*!
+   * \brief Create an array covering the whole arena, which returns the lease to the
+   *        pool of the pickling process once it and all its views are freed.
+   */
+  static runtime::NDArray Adopt(std::shared_ptr<MappedArena> arena, int64_t lease);
+
+ private:
+  static constexpr size_t kMaxCached = 64;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<MappedArena>> cache_;
+  std::deque<std::string> order_;
+};
+
+/*! \brief Whether graphs are pickled through shared memory arenas. */
+bool IsPicklingToSharedMem();
+
+/*! \brief Enable or disable pickling graphs through shared memory arenas. */
+void SetPicklingToSharedMem(bool enabled);
+
+}  // namespace dgl
+
+#endif  // DGL_GRAPH_SHARED_MEM_ARENA_H_
@@ -0,0 +1,105 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_store_control.cc
+ * \brief Lifecycle of data stores shared among processes.
+ */
+#include "./shared_store_control.h"
+
+#include <dgl/runtime/shared_mem.h>
+#include <dmlc/logging.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include <errno.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <sstream>
+
+namespace dgl {
+
+using runtime::SharedMemory;
+
+namespace {
+
+uint64_t NewToken() {
+  std::random_device rd;
+  uint64_t token = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+  token ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#ifndef _WIN32
+  token ^= static_cast<uint64_t>(getpid()) << 20;
+#endif
+  return token;
+}
+
+}  // namespace
+
+void InitSharedStoreControl(SharedStoreControl* control) {
+  control->token = NewToken();
+  control->refcount = 1;
+#ifndef _WIN32
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifdef __linux__
+  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif  // __linux__
+  CHECK_EQ(pthread_mutex_init(&control->lock, &attr), 0) << "Fail to create the store lock";
+  pthread_mutexattr_destroy(&attr);
+#else
+  LOG(FATAL) << "Shared memory is not supported on Windows.";
+#endif  // _WIN32
+}
+
+bool AttachSharedStore(SharedStoreControl* control) {
+  SharedStoreLock lock(control);
+  if (control->refcount <= 0)
+    return false;
+  ++control->refcount;
+  return true;
+}
+
+bool DetachSharedStore(SharedStoreControl* control) {
+  SharedStoreLock lock(control);
+  return --control->refcount == 0;
+}
+
+std::string SharedStorePrefix(const std::string& name, const SharedStoreControl* control) {
+  std::ostringstream os;
+  os << name << "_" << std::hex << control->token;
+  return os.str();
+}
+
+void UnlinkSharedStore(const std::string& name, const SharedStoreControl* control) {
+  if (!SharedMemory::Exist(name))
+    return;
+  SharedMemory current(name);
+  const auto* current_control =
+    static_cast<SharedStoreControl*>(current.Open(sizeof(SharedStoreControl)));
+  if (current_control->token == control->token)
+    SharedMemory::Unlink(name);
+}
+
+SharedStoreLock::SharedStoreLock(SharedStoreControl* control) : control_(control) {
+#ifndef _WIN32
+  int ret = pthread_mutex_lock(&control_->lock);
+#ifdef __linux__
+  // The previous holder died. Stores only mark their content as published
+  // once it is complete, so the state is consistent.
+  if (ret == EOWNERDEAD) {
+    pthread_mutex_consistent(&control_->lock);
+    ret = 0;
+  }
+#endif  // __linux__
+  CHECK_EQ(ret, 0) << "Fail to lock the shared store: " << strerror(ret);
+#endif  // _WIN32
+}
+
+SharedStoreLock::~SharedStoreLock() {
+#ifndef _WIN32
+  pthread_mutex_unlock(&control_->lock);
+#endif  // _WIN32
+}
+
+}  // namespace dgl
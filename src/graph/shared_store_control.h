@@ -0,0 +1,73 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph/shared_store_control.h
+ * \brief Lifecycle of data stores shared among processes.
+ */
+#ifndef DGL_GRAPH_SHARED_STORE_CONTROL_H_
+#define DGL_GRAPH_SHARED_STORE_CONTROL_H_
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include <stdint.h>
+#include <string>
+
+namespace dgl {
+
+/*!
+ * \brief Control block at the beginning of the main segment of a shared store.
+ *
+ * It counts the store objects attached to the store in all processes, and
+ * holds a process-shared lock for the bookkeeping of the store. The other
+ * segments of the store are named with the token, so that a new store created
+ * under the name of a live one does not disturb the processes still attached
+ * to the old one.
+ */
+struct SharedStoreControl {
+  /*! \brief Token naming the other segments of the store */
+  uint64_t token;
+  /*! \brief Number of attached store objects, in all processes */
+  int64_t refcount;
+#ifndef _WIN32
+  /*! \brief Lock guarding refcount and the content of the store */
+  pthread_mutex_t lock;
+#endif
+};
+
+/*! \brief Initialize the control block of a new store with one reference. */
+void InitSharedStoreControl(SharedStoreControl* control);
+
+/*!
+ * \brief Add a reference to a store.
+ * \return false if the last process is detaching and removing the store.
+ */
+bool AttachSharedStore(SharedStoreControl* control);
+
+/*!
+ * \brief Remove a reference from a store.
+ * \return true if it was the last one, in which case the caller removes the store.
+ */
+bool DetachSharedStore(SharedStoreControl* control);
+
+/*! \return The prefix of the names of the other segments of a store. */
+std::string SharedStorePrefix(const std::string& name, const SharedStoreControl* control);
+
+/*!
+ * \brief Remove the main segment of a store unless the name has been taken
+ *        over by a newer store in the meantime.
+ */
+void UnlinkSharedStore(const std::string& name, const SharedStoreControl* control);
+
+/*! \brief Hold the lock of a store within a scope */
+class SharedStoreLock {
+ public:
+  explicit SharedStoreLock(SharedStoreControl* control);
+  ~SharedStoreLock();
+
+ private:
+  SharedStoreControl* control_;
+};
+
+}  // namespace dgl
+
+#endif  // DGL_GRAPH_SHARED_STORE_CONTROL_H_
@@ -8,6 +8,7 @@
 #include <dgl/transform.h>
 #include <dgl/array.h>
 #include <dgl/packed_func_ext.h>
+#include <dgl/runtime/tracing.h>
 #include <vector>
 #include <utility>
 #include "../../c_api_common.h"
@@ -125,6 +126,13 @@ std::pair<std::vector<HeteroGraphPtr>, std::vector<IdArray>>
 CompactGraphs(
     const std::vector<HeteroGraphPtr> &graphs,
     const std::vector<IdArray> &always_preserve) {
+  tracing::ScopedTimer timer("CompactGraphs");
+  if (timer.active()) {
+    for (const HeteroGraphPtr& g : graphs) {
+      for (dgl_type_t etype = 0; etype < g->NumEdgeTypes(); ++etype)
+        timer.AddEdges(g->NumEdges(etype));
+    }
+  }
   std::pair<std::vector<HeteroGraphPtr>, std::vector<IdArray>> result;
   // TODO(BarclayII): check for all IdArrays
   CHECK(graphs[0]->DataType() == always_preserve[0]->dtype) << "data type mismatch.";
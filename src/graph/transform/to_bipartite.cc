@@ -11,6 +11,9 @@
 #include <dgl/immutable_graph.h>
 #include <dgl/runtime/registry.h>
 #include <dgl/runtime/container.h>
+#include <dgl/runtime/tracing.h>
+#include <algorithm>
+#include <numeric>
 #include <vector>
 #include <tuple>
 // TODO(BarclayII): currently ToBlock depend on IdHashMap<IdType> implementation which
@@ -26,6 +29,54 @@ namespace transform {
 
 namespace {
 
+/*!
+ * \brief Create the relation graph of a block from its relabeled edges, in CSC.
+ *
+ * The ID of every edge is its position in new_src and new_dst, as in the COO. The edges
+ * sampled on a CSC are already grouped by destination in the order of the seeds, in
+ * which case the relabeled sources are the indices as they are and the edge IDs are
+ * left implicit. Otherwise the edges are grouped with a stable counting sort.
+ */
+template<typename IdType>
+HeteroGraphPtr CreateBlockCSC(
+    int64_t num_src, int64_t num_dst, IdArray new_src, IdArray new_dst) {
+  const int64_t num_edges = new_dst->shape[0];
+  const IdType* src_data = new_src.Ptr<IdType>();
+  const IdType* dst_data = new_dst.Ptr<IdType>();
+  IdArray indptr = NewIdArray(num_dst + 1, new_dst->ctx, new_dst->dtype.bits);
+  IdType* indptr_data = indptr.Ptr<IdType>();
+
+  bool grouped = true;
+#pragma omp parallel for reduction(&&:grouped)
+  for (int64_t i = 1; i < num_edges; ++i)
+    grouped = grouped && dst_data[i - 1] <= dst_data[i];
+
+  if (grouped) {
+#pragma omp parallel for
+    for (int64_t v = 0; v <= num_dst; ++v)
+      indptr_data[v] = std::lower_bound(dst_data, dst_data + num_edges, v) - dst_data;
+    return CreateFromCSC(
+        2, CSRMatrix(num_dst, num_src, indptr, new_src, NullArray(), false));
+  }
+
+  std::fill(indptr_data, indptr_data + num_dst + 1, 0);
+  for (int64_t i = 0; i < num_edges; ++i)
+    ++indptr_data[dst_data[i] + 1];
+  std::partial_sum(indptr_data, indptr_data + num_dst + 1, indptr_data);
+  IdArray indices = NewIdArray(num_edges, new_dst->ctx, new_dst->dtype.bits);
+  IdArray eids = NewIdArray(num_edges, new_dst->ctx, new_dst->dtype.bits);
+  IdType* indices_data = indices.Ptr<IdType>();
+  IdType* eids_data = eids.Ptr<IdType>();
+  std::vector<IdType> fill(indptr_data, indptr_data + num_dst);
+  for (int64_t i = 0; i < num_edges; ++i) {
+    const IdType pos = fill[dst_data[i]]++;
+    indices_data[pos] = src_data[i];
+    eids_data[pos] = i;
+  }
+  return CreateFromCSC(
+      2, CSRMatrix(num_dst, num_src, indptr, indices, eids, false));
+}
+
 template<typename IdType>
 std::tuple<HeteroGraphPtr, std::vector<IdArray>, std::vector<IdArray>>
 ToBlock(HeteroGraphPtr graph, const std::vector<IdArray> &rhs_nodes, bool include_rhs_in_lhs) {
@@ -92,9 +143,10 @@ ToBlock(HeteroGraphPtr graph, const std::vector<IdArray> &rhs_nodes, bool includ
           << "Node " << edge_arrays[etype].dst.Ptr<IdType>()[i] << " does not exist"
           << " in `rhs_nodes`. Argument `rhs_nodes` must contain all the edge"
           << " destination nodes.";
-      rel_graphs.push_back(CreateFromCOO(
-          2, lhs_map.Size(), rhs_map.Size(),
-          new_src, new_dst));
+      // Message passing on a block reduces over the in-edges of its destination
+      // nodes, so build the CSC right away instead of converting the COO later.
+      rel_graphs.push_back(CreateBlockCSC<IdType>(
+          lhs_map.Size(), rhs_map.Size(), new_src, new_dst));
       induced_edges.push_back(edge_arrays[etype].id);
     }
   }
@@ -111,6 +163,11 @@ ToBlock(HeteroGraphPtr graph, const std::vector<IdArray> &rhs_nodes, bool includ
 
 std::tuple<HeteroGraphPtr, std::vector<IdArray>, std::vector<IdArray>>
 ToBlock(HeteroGraphPtr graph, const std::vector<IdArray> &rhs_nodes, bool include_rhs_in_lhs) {
+  tracing::ScopedTimer timer("ToBlock");
+  if (timer.active()) {
+    for (dgl_type_t etype = 0; etype < graph->NumEdgeTypes(); ++etype)
+      timer.AddEdges(graph->NumEdges(etype));
+  }
   std::tuple<HeteroGraphPtr, std::vector<IdArray>, std::vector<IdArray>> ret;
   ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
     ret = ToBlock<IdType>(graph, rhs_nodes, include_rhs_in_lhs);
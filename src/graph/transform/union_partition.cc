@@ -3,11 +3,113 @@
  * \file graph/transform/union_partition.cc
  * \brief Functions for partition, union multiple graphs.
  */
+#include <functional>
+#include <vector>
 #include "../heterograph.h"
 using namespace dgl::runtime;
 
 namespace dgl {
 
+namespace {
+
+/*!
+ * \brief Disjoint union of one relation graph of all the components.
+ *
+ * COO is preferred; CSR and CSC share the same storage and code path.
+ */
+HeteroGraphPtr DisjointUnionRelationGraph(
+    dgl_type_t etype, int64_t num_vtypes, dgl_format_code_t code,
+    const std::vector<HeteroGraphPtr>& component_graphs) {
+  const size_t batch_size = component_graphs.size();
+  if (FORMAT_HAS_COO(code)) {
+    std::vector<aten::COOMatrix> coos(batch_size);
+    for (size_t i = 0; i < batch_size; ++i)
+      coos[i] = component_graphs[i]->GetCOOMatrix(etype);
+    return UnitGraph::CreateFromCOO(num_vtypes, aten::DisjointUnionCoo(coos), code);
+  }
+
+  const bool use_csr = FORMAT_HAS_CSR(code);
+  std::vector<aten::CSRMatrix> csrs(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    csrs[i] = use_csr ? component_graphs[i]->GetCSRMatrix(etype)
+                      : component_graphs[i]->GetCSCMatrix(etype);
+  }
+  const aten::CSRMatrix res = aten::DisjointUnionCsr(csrs);
+  return use_csr ? UnitGraph::CreateFromCSR(num_vtypes, res, code)
+                 : UnitGraph::CreateFromCSC(num_vtypes, res, code);
+}
+
+/*!
+ * \brief Compute the prefix sums of the per-graph sizes, which are flattened
+ *        type by type, and check them against the batched totals.
+ */
+std::vector<std::vector<uint64_t>> SizesToCumsum(
+    IdArray sizes, uint64_t num_types, uint64_t batch_size,
+    const std::function<uint64_t(uint64_t)>& total, const char* what) {
+  const uint64_t* sizes_data = static_cast<uint64_t*>(sizes->data);
+  std::vector<std::vector<uint64_t>> cumsum(num_types, std::vector<uint64_t>(batch_size + 1, 0));
+  for (uint64_t type = 0; type < num_types; ++type) {
+    for (uint64_t g = 0; g < batch_size; ++g)
+      cumsum[type][g + 1] = cumsum[type][g] + sizes_data[type * batch_size + g];
+    CHECK_EQ(cumsum[type][batch_size], total(type))
+      << "Sum of the given sizes must equal to the number of " << what << " for type " << type;
+  }
+  return cumsum;
+}
+
+/*!
+ * \brief Split a batched graph into its components given the prefix sums of
+ *        the number of nodes and edges of every type.
+ */
+std::vector<HeteroGraphPtr> DisjointPartitionByCumsum(
+    GraphPtr meta_graph, HeteroGraphPtr batched_graph, dgl_format_code_t code,
+    const std::vector<std::vector<uint64_t>>& vertex_cumsum,
+    const std::vector<std::vector<uint64_t>>& edge_cumsum) {
+  const uint64_t num_vertex_types = meta_graph->NumVertices();
+  const uint64_t num_edge_types = meta_graph->NumEdges();
+  const uint64_t batch_size = vertex_cumsum[0].size() - 1;
+  std::vector<std::vector<HeteroGraphPtr>> rel_graphs(
+      batch_size, std::vector<HeteroGraphPtr>(num_edge_types));
+
+  for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
+    auto pair = meta_graph->FindEdge(etype);
+    const dgl_type_t src_vtype = pair.first;
+    const dgl_type_t dst_vtype = pair.second;
+    const int64_t num_vtypes = (src_vtype == dst_vtype) ? 1 : 2;
+    if (FORMAT_HAS_COO(code)) {
+      const auto res = aten::DisjointPartitionCooBySizes(
+          batched_graph->GetCOOMatrix(etype), batch_size, edge_cumsum[etype],
+          vertex_cumsum[src_vtype], vertex_cumsum[dst_vtype]);
+      for (uint64_t g = 0; g < batch_size; ++g)
+        rel_graphs[g][etype] = UnitGraph::CreateFromCOO(num_vtypes, res[g], code);
+    } else if (FORMAT_HAS_CSR(code)) {
+      const auto res = aten::DisjointPartitionCsrBySizes(
+          batched_graph->GetCSRMatrix(etype), batch_size, edge_cumsum[etype],
+          vertex_cumsum[src_vtype], vertex_cumsum[dst_vtype]);
+      for (uint64_t g = 0; g < batch_size; ++g)
+        rel_graphs[g][etype] = UnitGraph::CreateFromCSR(num_vtypes, res[g], code);
+    } else {
+      // CSR and CSC have the same storage format, i.e. CSRMatrix
+      const auto res = aten::DisjointPartitionCsrBySizes(
+          batched_graph->GetCSCMatrix(etype), batch_size, edge_cumsum[etype],
+          vertex_cumsum[dst_vtype], vertex_cumsum[src_vtype]);
+      for (uint64_t g = 0; g < batch_size; ++g)
+        rel_graphs[g][etype] = UnitGraph::CreateFromCSC(num_vtypes, res[g], code);
+    }
+  }
+
+  std::vector<HeteroGraphPtr> rst(batch_size);
+  std::vector<int64_t> num_nodes_per_type(num_vertex_types);
+  for (uint64_t g = 0; g < batch_size; ++g) {
+    for (uint64_t i = 0; i < num_vertex_types; ++i)
+      num_nodes_per_type[i] = vertex_cumsum[i][g + 1] - vertex_cumsum[i][g];
+    rst[g] = CreateHeteroGraph(meta_graph, rel_graphs[g], num_nodes_per_type);
+  }
+  return rst;
+}
+
+}  // namespace
+
 HeteroGraphPtr JointUnionHeteroGraph(
   GraphPtr meta_graph, const std::vector<HeteroGraphPtr>& component_graphs) {
   CHECK_GT(component_graphs.size(), 0) << "Input graph list has at least two graphs";
@@ -90,70 +192,22 @@ HeteroGraphPtr DisjointUnionHeteroGraph2(
   CHECK_GT(component_graphs.size(), 0) << "Input graph list is empty";
   std::vector<HeteroGraphPtr> rel_graphs(meta_graph->NumEdges());
   std::vector<int64_t> num_nodes_per_type(meta_graph->NumVertices(), 0);
+  for (const auto& cg : component_graphs) {
+    for (dgl_type_t vtype = 0; vtype < meta_graph->NumVertices(); ++vtype)
+      num_nodes_per_type[vtype] += cg->NumVertices(vtype);
+  }
 
   // Loop over all canonical etypes
   for (dgl_type_t etype = 0; etype < meta_graph->NumEdges(); ++etype) {
     auto pair = meta_graph->FindEdge(etype);
-    const dgl_type_t src_vtype = pair.first;
-    const dgl_type_t dst_vtype = pair.second;
-    uint64_t src_offset = 0, dst_offset = 0;
-    HeteroGraphPtr rgptr = nullptr;
-
     const dgl_format_code_t code =\
       component_graphs[0]->GetRelationGraph(etype)->GetAllowedFormats();
-    // do some preprocess
-    for (size_t i = 0; i < component_graphs.size(); ++i) {
-      const auto& cg = component_graphs[i];
-      const dgl_format_code_t cur_code = cg->GetRelationGraph(etype)->GetAllowedFormats();
-      if (cur_code != code)
+    for (const auto& cg : component_graphs) {
+      if (cg->GetRelationGraph(etype)->GetAllowedFormats() != code)
         LOG(FATAL) << "All components should have the same formats";
-
-      // Update offsets
-      src_offset += cg->NumVertices(src_vtype);
-      dst_offset += cg->NumVertices(dst_vtype);
     }
-
-    // prefer COO
-    if (FORMAT_HAS_COO(code)) {
-      std::vector<aten::COOMatrix> coos;
-      for (size_t i = 0; i < component_graphs.size(); ++i) {
-        const auto& cg = component_graphs[i];
-        aten::COOMatrix coo = cg->GetCOOMatrix(etype);
-        coos.push_back(coo);
-      }
-
-      aten::COOMatrix res = aten::DisjointUnionCoo(coos);
-
-      rgptr = UnitGraph::CreateFromCOO(
-          (src_vtype == dst_vtype) ? 1 : 2, res, code);
-    } else if (FORMAT_HAS_CSR(code)) {
-      std::vector<aten::CSRMatrix> csrs;
-      for (size_t i = 0; i < component_graphs.size(); ++i) {
-        const auto& cg = component_graphs[i];
-        aten::CSRMatrix csr = cg->GetCSRMatrix(etype);
-        csrs.push_back(csr);
-      }
-
-      aten::CSRMatrix res = aten::DisjointUnionCsr(csrs);
-
-      rgptr = UnitGraph::CreateFromCSR(
-        (src_vtype == dst_vtype) ? 1 : 2, res, code);
-    } else if (FORMAT_HAS_CSC(code)) {
-      // CSR and CSC have the same storage format, i.e. CSRMatrix
-      std::vector<aten::CSRMatrix> cscs;
-      for (size_t i = 0; i < component_graphs.size(); ++i) {
-        const auto& cg = component_graphs[i];
-        aten::CSRMatrix csc = cg->GetCSCMatrix(etype);
-        cscs.push_back(csc);
-      }
-
-      aten::CSRMatrix res = aten::DisjointUnionCsr(cscs);
-      rgptr = UnitGraph::CreateFromCSC(
-        (src_vtype == dst_vtype) ? 1 : 2, res, code);
-    }
-    rel_graphs[etype] = rgptr;
-    num_nodes_per_type[src_vtype] = src_offset;
-    num_nodes_per_type[dst_vtype] = dst_offset;
+    rel_graphs[etype] = DisjointUnionRelationGraph(
+        etype, (pair.first == pair.second) ? 1 : 2, code, component_graphs);
   }
 
   return CreateHeteroGraph(meta_graph, rel_graphs, std::move(num_nodes_per_type));
@@ -161,115 +215,21 @@ HeteroGraphPtr DisjointUnionHeteroGraph2(
 
 std::vector<HeteroGraphPtr> DisjointPartitionHeteroBySizes2(
     GraphPtr meta_graph, HeteroGraphPtr batched_graph, IdArray vertex_sizes, IdArray edge_sizes) {
-  // Sanity check for vertex sizes
   CHECK_EQ(vertex_sizes->dtype.bits, 64) << "dtype of vertex_sizes should be int64";
   CHECK_EQ(edge_sizes->dtype.bits, 64) << "dtype of edge_sizes should be int64";
-  const uint64_t len_vertex_sizes = vertex_sizes->shape[0];
-  const uint64_t* vertex_sizes_data = static_cast<uint64_t*>(vertex_sizes->data);
   const uint64_t num_vertex_types = meta_graph->NumVertices();
-  const uint64_t batch_size = len_vertex_sizes / num_vertex_types;
-
-  // Map vertex type to the corresponding node cum sum
-  std::vector<std::vector<uint64_t>> vertex_cumsum;
-  vertex_cumsum.resize(num_vertex_types);
-  // Loop over all vertex types
-  for (uint64_t vtype = 0; vtype < num_vertex_types; ++vtype) {
-    vertex_cumsum[vtype].push_back(0);
-    for (uint64_t g = 0; g < batch_size; ++g) {
-      // We've flattened the number of vertices in the batch for all types
-      vertex_cumsum[vtype].push_back(
-        vertex_cumsum[vtype][g] + vertex_sizes_data[vtype * batch_size + g]);
-    }
-    CHECK_EQ(vertex_cumsum[vtype][batch_size], batched_graph->NumVertices(vtype))
-      << "Sum of the given sizes must equal to the number of nodes for type " << vtype;
-  }
-
-  // Sanity check for edge sizes
-  const uint64_t* edge_sizes_data = static_cast<uint64_t*>(edge_sizes->data);
   const uint64_t num_edge_types = meta_graph->NumEdges();
-  // Map edge type to the corresponding edge cum sum
-  std::vector<std::vector<uint64_t>> edge_cumsum;
-  edge_cumsum.resize(num_edge_types);
-  // Loop over all edge types
-  for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
-    edge_cumsum[etype].push_back(0);
-    for (uint64_t g = 0; g < batch_size; ++g) {
-      // We've flattened the number of edges in the batch for all types
-      edge_cumsum[etype].push_back(
-        edge_cumsum[etype][g] + edge_sizes_data[etype * batch_size + g]);
-    }
-    CHECK_EQ(edge_cumsum[etype][batch_size], batched_graph->NumEdges(etype))
-      << "Sum of the given sizes must equal to the number of edges for type " << etype;
-  }
-
-  // Construct relation graphs for unbatched graphs
-  std::vector<std::vector<HeteroGraphPtr>> rel_graphs;
-  rel_graphs.resize(batch_size);
-  // Loop over all edge types
-  auto code = batched_graph->GetRelationGraph(0)->GetAllowedFormats();
-
-  if (FORMAT_HAS_COO(code)) {
-    for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
-      auto pair = meta_graph->FindEdge(etype);
-      const dgl_type_t src_vtype = pair.first;
-      const dgl_type_t dst_vtype = pair.second;
-      aten::COOMatrix coo = batched_graph->GetCOOMatrix(etype);
-      auto res = aten::DisjointPartitionCooBySizes(coo,
-                                                   batch_size,
-                                                   edge_cumsum[etype],
-                                                   vertex_cumsum[src_vtype],
-                                                   vertex_cumsum[dst_vtype]);
-      for (uint64_t g = 0; g < batch_size; ++g) {
-        HeteroGraphPtr rgptr = UnitGraph::CreateFromCOO(
-          (src_vtype == dst_vtype) ? 1 : 2, res[g], code);
-        rel_graphs[g].push_back(rgptr);
-      }
-    }
-  } else if (FORMAT_HAS_CSR(code)) {
-    for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
-      auto pair = meta_graph->FindEdge(etype);
-      const dgl_type_t src_vtype = pair.first;
-      const dgl_type_t dst_vtype = pair.second;
-      aten::CSRMatrix csr = batched_graph->GetCSRMatrix(etype);
-      auto res = aten::DisjointPartitionCsrBySizes(csr,
-                                                   batch_size,
-                                                   edge_cumsum[etype],
-                                                   vertex_cumsum[src_vtype],
-                                                   vertex_cumsum[dst_vtype]);
-      for (uint64_t g = 0; g < batch_size; ++g) {
-        HeteroGraphPtr rgptr = UnitGraph::CreateFromCSR(
-          (src_vtype == dst_vtype) ? 1 : 2, res[g], code);
-        rel_graphs[g].push_back(rgptr);
-      }
-    }
-  } else if (FORMAT_HAS_CSC(code)) {
-    for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
-      auto pair = meta_graph->FindEdge(etype);
-      const dgl_type_t src_vtype = pair.first;
-      const dgl_type_t dst_vtype = pair.second;
-      // CSR and CSC have the same storage format, i.e. CSRMatrix
-      aten::CSRMatrix csc = batched_graph->GetCSCMatrix(etype);
-      auto res = aten::DisjointPartitionCsrBySizes(csc,
-                                                   batch_size,
-                                                   edge_cumsum[etype],
-                                                   vertex_cumsum[dst_vtype],
-                                                   vertex_cumsum[src_vtype]);
-      for (uint64_t g = 0; g < batch_size; ++g) {
-        HeteroGraphPtr rgptr = UnitGraph::CreateFromCSC(
-          (src_vtype == dst_vtype) ? 1 : 2, res[g], code);
-        rel_graphs[g].push_back(rgptr);
-      }
-    }
-  }
-
-  std::vector<HeteroGraphPtr> rst;
-  std::vector<int64_t> num_nodes_per_type(num_vertex_types);
-  for (uint64_t g = 0; g < batch_size; ++g) {
-    for (uint64_t i = 0; i < num_vertex_types; ++i)
-      num_nodes_per_type[i] = vertex_sizes_data[i * batch_size + g];
-    rst.push_back(CreateHeteroGraph(meta_graph, rel_graphs[g], num_nodes_per_type));
-  }
-  return rst;
+  const uint64_t batch_size = vertex_sizes->shape[0] / num_vertex_types;
+  const auto vertex_cumsum = SizesToCumsum(
+      vertex_sizes, num_vertex_types, batch_size,
+      [&](uint64_t vtype) { return batched_graph->NumVertices(vtype); }, "nodes");
+  const auto edge_cumsum = SizesToCumsum(
+      edge_sizes, num_edge_types, batch_size,
+      [&](uint64_t etype) { return batched_graph->NumEdges(etype); }, "edges");
+
+  const auto code = batched_graph->GetRelationGraph(0)->GetAllowedFormats();
+  return DisjointPartitionByCumsum(
+      meta_graph, batched_graph, code, vertex_cumsum, edge_cumsum);
 }
 
 template <class IdType>
@@ -278,40 +238,27 @@ HeteroGraphPtr DisjointUnionHeteroGraph(
   CHECK_GT(component_graphs.size(), 0) << "Input graph list is empty";
   std::vector<HeteroGraphPtr> rel_graphs(meta_graph->NumEdges());
   std::vector<int64_t> num_nodes_per_type(meta_graph->NumVertices(), 0);
+  for (const auto& cg : component_graphs) {
+    for (dgl_type_t vtype = 0; vtype < meta_graph->NumVertices(); ++vtype)
+      num_nodes_per_type[vtype] += cg->NumVertices(vtype);
+  }
 
   // Loop over all canonical etypes
   for (dgl_type_t etype = 0; etype < meta_graph->NumEdges(); ++etype) {
     auto pair = meta_graph->FindEdge(etype);
     const dgl_type_t src_vtype = pair.first;
     const dgl_type_t dst_vtype = pair.second;
-    IdType src_offset = 0, dst_offset = 0;
-    std::vector<IdType> result_src, result_dst;
-
-    // Loop over all graphs
+    // Edges are taken in edge ID order so the union does not need a data array.
+    std::vector<aten::COOMatrix> coos(component_graphs.size());
     for (size_t i = 0; i < component_graphs.size(); ++i) {
       const auto& cg = component_graphs[i];
-      EdgeArray edges = cg->Edges(etype);
-      size_t num_edges = cg->NumEdges(etype);
-      const IdType* edges_src_data = static_cast<const IdType*>(edges.src->data);
-      const IdType* edges_dst_data = static_cast<const IdType*>(edges.dst->data);
-
-      // Loop over all edges
-      for (size_t j = 0; j < num_edges; ++j) {
-        // TODO(mufei): Should use array operations to implement this.
-        result_src.push_back(edges_src_data[j] + src_offset);
-        result_dst.push_back(edges_dst_data[j] + dst_offset);
-      }
-      // Update offsets
-      src_offset += cg->NumVertices(src_vtype);
-      dst_offset += cg->NumVertices(dst_vtype);
+      const EdgeArray edges = cg->Edges(etype);
+      coos[i] = aten::COOMatrix(
+          cg->NumVertices(src_vtype), cg->NumVertices(dst_vtype), edges.src, edges.dst);
     }
-    HeteroGraphPtr rgptr = UnitGraph::CreateFromCOO(
-        (src_vtype == dst_vtype) ? 1 : 2, src_offset, dst_offset,
-        aten::VecToIdArray(result_src, sizeof(IdType) * 8),
-        aten::VecToIdArray(result_dst, sizeof(IdType) * 8));
-    rel_graphs[etype] = rgptr;
-    num_nodes_per_type[src_vtype] = src_offset;
-    num_nodes_per_type[dst_vtype] = dst_offset;
+    const aten::COOMatrix res = (coos.size() > 1) ? aten::DisjointUnionCoo(coos) : coos[0];
+    rel_graphs[etype] = UnitGraph::CreateFromCOO(
+        (src_vtype == dst_vtype) ? 1 : 2, res.num_rows, res.num_cols, res.row, res.col);
   }
   return CreateHeteroGraph(meta_graph, rel_graphs, std::move(num_nodes_per_type));
 }
@@ -325,82 +272,32 @@ template HeteroGraphPtr DisjointUnionHeteroGraph<int64_t>(
 template <class IdType>
 std::vector<HeteroGraphPtr> DisjointPartitionHeteroBySizes(
     GraphPtr meta_graph, HeteroGraphPtr batched_graph, IdArray vertex_sizes, IdArray edge_sizes) {
-  // Sanity check for vertex sizes
-  const uint64_t len_vertex_sizes = vertex_sizes->shape[0];
-  const uint64_t* vertex_sizes_data = static_cast<uint64_t*>(vertex_sizes->data);
   const uint64_t num_vertex_types = meta_graph->NumVertices();
-  const uint64_t batch_size = len_vertex_sizes / num_vertex_types;
-  // Map vertex type to the corresponding node cum sum
-  std::vector<std::vector<uint64_t>> vertex_cumsum;
-  vertex_cumsum.resize(num_vertex_types);
-  // Loop over all vertex types
-  for (uint64_t vtype = 0; vtype < num_vertex_types; ++vtype) {
-    vertex_cumsum[vtype].push_back(0);
-    for (uint64_t g = 0; g < batch_size; ++g) {
-      // We've flattened the number of vertices in the batch for all types
-      vertex_cumsum[vtype].push_back(
-        vertex_cumsum[vtype][g] + vertex_sizes_data[vtype * batch_size + g]);
-    }
-    CHECK_EQ(vertex_cumsum[vtype][batch_size], batched_graph->NumVertices(vtype))
-      << "Sum of the given sizes must equal to the number of nodes for type " << vtype;
-  }
-
-  // Sanity check for edge sizes
-  const uint64_t* edge_sizes_data = static_cast<uint64_t*>(edge_sizes->data);
   const uint64_t num_edge_types = meta_graph->NumEdges();
-  // Map edge type to the corresponding edge cum sum
-  std::vector<std::vector<uint64_t>> edge_cumsum;
-  edge_cumsum.resize(num_edge_types);
-  // Loop over all edge types
-  for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
-    edge_cumsum[etype].push_back(0);
-    for (uint64_t g = 0; g < batch_size; ++g) {
-      // We've flattened the number of edges in the batch for all types
-      edge_cumsum[etype].push_back(
-        edge_cumsum[etype][g] + edge_sizes_data[etype * batch_size + g]);
-    }
-    CHECK_EQ(edge_cumsum[etype][batch_size], batched_graph->NumEdges(etype))
-      << "Sum of the given sizes must equal to the number of edges for type " << etype;
-  }
-
-  // Construct relation graphs for unbatched graphs
-  std::vector<std::vector<HeteroGraphPtr>> rel_graphs;
-  rel_graphs.resize(batch_size);
-  // Loop over all edge types
+  const uint64_t batch_size = vertex_sizes->shape[0] / num_vertex_types;
+  const auto vertex_cumsum = SizesToCumsum(
+      vertex_sizes, num_vertex_types, batch_size,
+      [&](uint64_t vtype) { return batched_graph->NumVertices(vtype); }, "nodes");
+  const auto edge_cumsum = SizesToCumsum(
+      edge_sizes, num_edge_types, batch_size,
+      [&](uint64_t etype) { return batched_graph->NumEdges(etype); }, "edges");
+
+  // Partition the edges in edge ID order, without a data array.
+  std::vector<HeteroGraphPtr> rel_graphs(num_edge_types);
   for (uint64_t etype = 0; etype < num_edge_types; ++etype) {
     auto pair = meta_graph->FindEdge(etype);
-    const dgl_type_t src_vtype = pair.first;
-    const dgl_type_t dst_vtype = pair.second;
-    EdgeArray edges = batched_graph->Edges(etype);
-    const IdType* edges_src_data = static_cast<const IdType*>(edges.src->data);
-    const IdType* edges_dst_data = static_cast<const IdType*>(edges.dst->data);
-    // Loop over all graphs to be unbatched
-    for (uint64_t g = 0; g < batch_size; ++g) {
-      std::vector<IdType> result_src, result_dst;
-      // Loop over the chunk of edges for the specified graph and edge type
-      for (uint64_t e = edge_cumsum[etype][g]; e < edge_cumsum[etype][g + 1]; ++e) {
-        // TODO(mufei): Should use array operations to implement this.
-        result_src.push_back(edges_src_data[e] - vertex_cumsum[src_vtype][g]);
-        result_dst.push_back(edges_dst_data[e] - vertex_cumsum[dst_vtype][g]);
-      }
-      HeteroGraphPtr rgptr = UnitGraph::CreateFromCOO(
-          (src_vtype == dst_vtype) ? 1 : 2,
-          vertex_sizes_data[src_vtype * batch_size + g],
-          vertex_sizes_data[dst_vtype * batch_size + g],
-          aten::VecToIdArray(result_src, sizeof(IdType) * 8),
-          aten::VecToIdArray(result_dst, sizeof(IdType) * 8));
-      rel_graphs[g].push_back(rgptr);
-    }
+    const EdgeArray edges = batched_graph->Edges(etype);
+    rel_graphs[etype] = UnitGraph::CreateFromCOO(
+        (pair.first == pair.second) ? 1 : 2,
+        batched_graph->NumVertices(pair.first), batched_graph->NumVertices(pair.second),
+        edges.src, edges.dst);
   }
-
-  std::vector<HeteroGraphPtr> rst;
   std::vector<int64_t> num_nodes_per_type(num_vertex_types);
-  for (uint64_t g = 0; g < batch_size; ++g) {
-    for (uint64_t i = 0; i < num_vertex_types; ++i)
-      num_nodes_per_type[i] = vertex_sizes_data[i * batch_size + g];
-    rst.push_back(CreateHeteroGraph(meta_graph, rel_graphs[g], num_nodes_per_type));
-  }
-  return rst;
+  for (uint64_t vtype = 0; vtype < num_vertex_types; ++vtype)
+    num_nodes_per_type[vtype] = batched_graph->NumVertices(vtype);
+  return DisjointPartitionByCumsum(
+      meta_graph, CreateHeteroGraph(meta_graph, rel_graphs, num_nodes_per_type), all_code,
+      vertex_cumsum, edge_cumsum);
 }
 
 template std::vector<HeteroGraphPtr> DisjointPartitionHeteroBySizes<int32_t>(
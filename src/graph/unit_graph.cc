@@ -7,9 +7,13 @@
 #include <dgl/base_heterograph.h>
 #include <dgl/immutable_graph.h>
 #include <dgl/lazy.h>
+#include <dgl/runtime/memory_tracker.h>
+
+#include <chrono>
 
 #include "../c_api_common.h"
 #include "./unit_graph.h"
+#include "./shared_graph_store.h"
 
 namespace dgl {
 
@@ -39,6 +43,26 @@ inline GraphPtr CreateUnitGraphMetaGraph2() {
   return g;
 }
 
+// milliseconds since the Unix epoch
+inline int64_t WallClockMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// bytes of the arrays of a format, and of those in shared memory
+inline void AddArrayBytes(const std::vector<IdArray>& arrays,
+                          UnitGraph::FormatFootprint* footprint) {
+  for (const IdArray& arr : arrays) {
+    if (aten::IsNullArray(arr))
+      continue;
+    footprint->arrays.push_back(arr);
+    const int64_t bytes = arr.GetSize();
+    footprint->bytes += bytes;
+    if (arr.IsSharedMem())
+      footprint->shared_bytes += bytes;
+  }
+}
+
 inline GraphPtr CreateUnitGraphMetaGraph(int num_vtypes) {
   static GraphPtr mg1 = CreateUnitGraphMetaGraph1();
   static GraphPtr mg2 = CreateUnitGraphMetaGraph2();
@@ -405,6 +429,15 @@ class UnitGraph::COO : public BaseHeteroGraph {
     return adj_;
   }
 
+  /*! \return Wall-clock time in ms when the format was built lazily, -1 if given at creation */
+  int64_t materialized_ms() const {
+    return materialized_ms_;
+  }
+
+  void set_materialized_ms(int64_t ms) {
+    materialized_ms_ = ms;
+  }
+
   /*!
    * \brief Determines whether the graph is "hypersparse", i.e. having significantly more
    * nodes than edges.
@@ -432,6 +465,8 @@ class UnitGraph::COO : public BaseHeteroGraph {
 
   /*! \brief internal adjacency matrix. Data array is empty */
   aten::COOMatrix adj_;
+  /*! \brief when the format was built lazily, -1 if given at creation */
+  int64_t materialized_ms_ = -1;
 };
 
 //////////////////////////////////////////////////////////
@@ -782,6 +817,15 @@ class UnitGraph::CSR : public BaseHeteroGraph {
     return adj_;
   }
 
+  /*! \return Wall-clock time in ms when the format was built lazily, -1 if given at creation */
+  int64_t materialized_ms() const {
+    return materialized_ms_;
+  }
+
+  void set_materialized_ms(int64_t ms) {
+    materialized_ms_ = ms;
+  }
+
   bool Load(dmlc::Stream* fs) {
     auto meta_imgraph = Serializer::make_shared<ImmutableGraph>();
     CHECK(fs->Read(&meta_imgraph)) << "Invalid meta graph";
@@ -800,6 +844,8 @@ class UnitGraph::CSR : public BaseHeteroGraph {
 
   /*! \brief internal adjacency matrix. Data array stores edge ids */
   aten::CSRMatrix adj_;
+  /*! \brief when the format was built lazily, -1 if given at creation */
+  int64_t materialized_ms_ = -1;
 };
 
 //////////////////////////////////////////////////////////
@@ -821,9 +867,7 @@ uint8_t UnitGraph::NumBits() const {
 }
 
 bool UnitGraph::IsMultigraph() const {
-  const SparseFormat fmt = SelectFormat(csc_code);
-  const auto ptr = GetFormat(fmt);
-  return ptr->IsMultigraph();
+  return stats_->HasDuplicate(*this);
 }
 
 uint64_t UnitGraph::NumVertices(dgl_type_t vtype) const {
@@ -989,8 +1033,11 @@ uint64_t UnitGraph::InDegree(dgl_type_t etype, dgl_id_t vid) const {
   const auto ptr = GetFormat(fmt);
   if (fmt == SparseFormat::kCSC)
     return ptr->OutDegree(etype, vid);
-  else
-    return ptr->InDegree(etype, vid);
+  if (Context().device_type == kDLCPU) {
+    CHECK(HasVertex(DstType(), vid)) << "Invalid dst vertex id: " << vid;
+    return aten::IndexSelect<int64_t>(stats_->InDegrees(*this), vid);
+  }
+  return ptr->InDegree(etype, vid);
 }
 
 DegreeArray UnitGraph::InDegrees(dgl_type_t etype, IdArray vids) const {
@@ -998,19 +1045,32 @@ DegreeArray UnitGraph::InDegrees(dgl_type_t etype, IdArray vids) const {
   const auto ptr = GetFormat(fmt);
   if (fmt == SparseFormat::kCSC)
     return ptr->OutDegrees(etype, vids);
-  else
-    return ptr->InDegrees(etype, vids);
+  // Counting the in-edges of a node takes a full scan of the other formats,
+  // so count the in-edges of all the nodes once.
+  if (Context().device_type == kDLCPU) {
+    CHECK(aten::IsValidIdArray(vids)) << "Invalid vertex id array.";
+    return aten::IndexSelect(stats_->InDegrees(*this), vids);
+  }
+  return ptr->InDegrees(etype, vids);
 }
 
 uint64_t UnitGraph::OutDegree(dgl_type_t etype, dgl_id_t vid) const {
   SparseFormat fmt = SelectFormat(csr_code);
   const auto ptr = GetFormat(fmt);
+  if (fmt != SparseFormat::kCSR && Context().device_type == kDLCPU) {
+    CHECK(HasVertex(SrcType(), vid)) << "Invalid src vertex id: " << vid;
+    return aten::IndexSelect<int64_t>(stats_->OutDegrees(*this), vid);
+  }
   return ptr->OutDegree(etype, vid);
 }
 
 DegreeArray UnitGraph::OutDegrees(dgl_type_t etype, IdArray vids) const {
   SparseFormat fmt = SelectFormat(csr_code);
   const auto ptr = GetFormat(fmt);
+  if (fmt != SparseFormat::kCSR && Context().device_type == kDLCPU) {
+    CHECK(aten::IsValidIdArray(vids)) << "Invalid vertex id array.";
+    return aten::IndexSelect(stats_->OutDegrees(*this), vids);
+  }
   return ptr->OutDegrees(etype, vids);
 }
 
@@ -1286,6 +1346,22 @@ HeteroGraphPtr UnitGraph::CreateHomographFrom(
   return HeteroGraphPtr(new UnitGraph(mg, in_csr_ptr, out_csr_ptr, coo_ptr, formats));
 }
 
+HeteroGraphPtr UnitGraph::CreateFromSharedStore(
+    std::shared_ptr<SharedGraphStore> store, dgl_type_t etype) {
+  aten::COOMatrix coo;
+  aten::CSRMatrix csr, csc;
+  const bool has_coo = store->FetchCOO(etype, &coo);
+  const bool has_csr = store->FetchCSR(etype, csr_code, &csr);
+  const bool has_csc = store->FetchCSR(etype, csc_code, &csc);
+  CHECK(has_coo || has_csr || has_csc)
+    << "No format of edge type " << etype << " is in shared memory " << store->name();
+  auto ret = std::dynamic_pointer_cast<UnitGraph>(
+      CreateHomographFrom(csc, csr, coo, has_csc, has_csr, has_coo));
+  ret->shared_store_ = store;
+  ret->shared_etype_ = etype;
+  return ret;
+}
+
 UnitGraph::CSRPtr UnitGraph::GetInCSR(bool inplace) const {
   if (inplace)
     if (!(formats_ & csc_code))
@@ -1293,22 +1369,21 @@ UnitGraph::CSRPtr UnitGraph::GetInCSR(bool inplace) const {
         CodeToStr(formats_) << ", cannot create CSC matrix.";
   CSRPtr ret = in_csr_;
   if (!in_csr_->defined()) {
-    if (out_csr_->defined()) {
-      const auto& newadj = aten::CSRSort(aten::CSRTranspose(out_csr_->adj()));
-
-      if (inplace)
-        *(const_cast<UnitGraph*>(this)->in_csr_) = CSR(meta_graph(), newadj);
-      else
-        ret = std::make_shared<CSR>(meta_graph(), newadj);
-    } else {
+    auto build = [this] () -> aten::CSRMatrix {
+      if (out_csr_->defined())
+        return aten::CSRSort(aten::CSRTranspose(out_csr_->adj()));
       CHECK(coo_->defined()) << "None of CSR, COO exist";
-      const auto& newadj = aten::CSRSort(aten::COOToCSR(
-            aten::COOTranspose(coo_->adj())));
-
-      if (inplace)
-        *(const_cast<UnitGraph*>(this)->in_csr_) = CSR(meta_graph(), newadj);
-      else
-        ret = std::make_shared<CSR>(meta_graph(), newadj);
+      return aten::CSRSort(aten::COOToCSR(aten::COOTranspose(coo_->adj())));
+    };
+
+    runtime::memory::ScopedTag tag("GraphFormat");
+    if (inplace) {
+      const auto& newadj = shared_store_ ?
+        shared_store_->FetchOrBuildCSR(shared_etype_, csc_code, build) : build();
+      *(const_cast<UnitGraph*>(this)->in_csr_) = CSR(meta_graph(), newadj);
+      in_csr_->set_materialized_ms(WallClockMs());
+    } else {
+      ret = std::make_shared<CSR>(meta_graph(), build());
     }
   }
   return ret;
@@ -1322,21 +1397,26 @@ UnitGraph::CSRPtr UnitGraph::GetOutCSR(bool inplace) const {
         CodeToStr(formats_) << ", cannot create CSR matrix.";
   CSRPtr ret = out_csr_;
   if (!out_csr_->defined()) {
-    if (in_csr_->defined()) {
-      const auto& newadj = aten::CSRSort(aten::CSRTranspose(in_csr_->adj()));
-
-      if (inplace)
-        *(const_cast<UnitGraph*>(this)->out_csr_) = CSR(meta_graph(), newadj);
-      else
-        ret = std::make_shared<CSR>(meta_graph(), newadj);
-    } else {
+    auto build = [this] () -> aten::CSRMatrix {
+      if (in_csr_->defined())
+        return aten::CSRSort(aten::CSRTranspose(in_csr_->adj()));
       CHECK(coo_->defined()) << "None of CSR, COO exist";
-      const auto& newadj = aten::CSRSort(aten::COOToCSR(coo_->adj()));
-
-      if (inplace)
-        *(const_cast<UnitGraph*>(this)->out_csr_) = CSR(meta_graph(), newadj);
-      else
-        ret = std::make_shared<CSR>(meta_graph(), newadj);
+      // Tell the conversion whether the COO is sorted so that it does not scan
+      // it again every time a CSR is built.
+      aten::COOMatrix coo = coo_->adj();
+      if (Context().device_type == kDLCPU)
+        std::tie(coo.row_sorted, coo.col_sorted) = stats_->COOSorted(*this);
+      return aten::CSRSort(aten::COOToCSR(coo));
+    };
+
+    runtime::memory::ScopedTag tag("GraphFormat");
+    if (inplace) {
+      const auto& newadj = shared_store_ ?
+        shared_store_->FetchOrBuildCSR(shared_etype_, csr_code, build) : build();
+      *(const_cast<UnitGraph*>(this)->out_csr_) = CSR(meta_graph(), newadj);
+      out_csr_->set_materialized_ms(WallClockMs());
+    } else {
+      ret = std::make_shared<CSR>(meta_graph(), build());
     }
   }
   return ret;
@@ -1350,21 +1430,21 @@ UnitGraph::COOPtr UnitGraph::GetCOO(bool inplace) const {
         CodeToStr(formats_) << ", cannot create COO matrix.";
   COOPtr ret = coo_;
   if (!coo_->defined()) {
-    if (in_csr_->defined()) {
-      const auto& newadj = aten::COOTranspose(aten::CSRToCOO(in_csr_->adj(), true));
-
-      if (inplace)
-        *(const_cast<UnitGraph*>(this)->coo_) = COO(meta_graph(), newadj);
-      else
-        ret = std::make_shared<COO>(meta_graph(), newadj);
-    } else {
+    auto build = [this] () -> aten::COOMatrix {
+      if (in_csr_->defined())
+        return aten::COOTranspose(aten::CSRToCOO(in_csr_->adj(), true));
       CHECK(out_csr_->defined()) << "Both CSR are missing.";
-      const auto& newadj = aten::CSRToCOO(out_csr_->adj(), true);
-
-      if (inplace)
-        *(const_cast<UnitGraph*>(this)->coo_) = COO(meta_graph(), newadj);
-      else
-        ret = std::make_shared<COO>(meta_graph(), newadj);
+      return aten::CSRToCOO(out_csr_->adj(), true);
+    };
+
+    runtime::memory::ScopedTag tag("GraphFormat");
+    if (inplace) {
+      const auto& newadj = shared_store_ ?
+        shared_store_->FetchOrBuildCOO(shared_etype_, build) : build();
+      *(const_cast<UnitGraph*>(this)->coo_) = COO(meta_graph(), newadj);
+      coo_->set_materialized_ms(WallClockMs());
+    } else {
+      ret = std::make_shared<COO>(meta_graph(), build());
     }
   }
   return ret;
@@ -1418,9 +1498,33 @@ HeteroGraphPtr UnitGraph::GetFormat(SparseFormat format) const {
   }
 }
 
+std::vector<UnitGraph::FormatFootprint> UnitGraph::GetMemoryFootprint() const {
+  std::vector<FormatFootprint> ret(3);
+  ret[0].format = SparseFormat::kCOO;
+  ret[1].format = SparseFormat::kCSR;
+  ret[2].format = SparseFormat::kCSC;
+  if (coo_->defined()) {
+    const aten::COOMatrix& adj = coo_->adj();
+    ret[0].created = true;
+    ret[0].materialized_ms = coo_->materialized_ms();
+    AddArrayBytes({adj.row, adj.col, adj.data}, &ret[0]);
+  }
+  const CSRPtr csrs[2] = {out_csr_, in_csr_};
+  for (int i = 0; i < 2; ++i) {
+    if (!csrs[i]->defined())
+      continue;
+    const aten::CSRMatrix& adj = csrs[i]->adj();
+    ret[i + 1].created = true;
+    ret[i + 1].materialized_ms = csrs[i]->materialized_ms();
+    AddArrayBytes({adj.indptr, adj.indices, adj.data}, &ret[i + 1]);
+  }
+  return ret;
+}
+
 HeteroGraphPtr UnitGraph::GetGraphInFormat(dgl_format_code_t formats) const {
-  if (formats == all_code)
-    return HeteroGraphPtr(
+  UnitGraphPtr ret;
+  if (formats == all_code) {
+    ret = UnitGraphPtr(
         // TODO(xiangsx) Make it as graph storage.Clone()
         new UnitGraph(meta_graph_,
                       (in_csr_->defined())
@@ -1433,12 +1537,20 @@ HeteroGraphPtr UnitGraph::GetGraphInFormat(dgl_format_code_t formats) const {
                           ? COOPtr(new COO(*coo_))
                           : nullptr,
                       formats));
-  int64_t num_vtypes = NumVertexTypes();
-  if (formats & coo_code)
-    return CreateFromCOO(num_vtypes, GetCOO(false)->adj(), formats);
-  if (formats & csr_code)
-    return CreateFromCSR(num_vtypes, GetOutCSR(false)->adj(), formats);
-  return CreateFromCSC(num_vtypes, GetInCSR(false)->adj(), formats);
+  } else {
+    int64_t num_vtypes = NumVertexTypes();
+    HeteroGraphPtr g;
+    if (formats & coo_code)
+      g = CreateFromCOO(num_vtypes, GetCOO(false)->adj(), formats);
+    else if (formats & csr_code)
+      g = CreateFromCSR(num_vtypes, GetOutCSR(false)->adj(), formats);
+    else
+      g = CreateFromCSC(num_vtypes, GetInCSR(false)->adj(), formats);
+    ret = std::dynamic_pointer_cast<UnitGraph>(g);
+  }
+  // same structure, same statistics
+  ret->stats_ = stats_;
+  return ret;
 }
 
 SparseFormat UnitGraph::SelectFormat(dgl_format_code_t preferred_formats) const {
@@ -1480,27 +1592,28 @@ GraphPtr UnitGraph::AsImmutableGraph() const {
 
 HeteroGraphPtr UnitGraph::LineGraph(bool backtracking) const {
   // TODO(xiangsx) currently we only support homogeneous graph
+  // The line graph is built from an index of the edges by source, i.e. an out-edge
+  // CSR, which is built but not cached if missing.
   auto fmt = SelectFormat(all_code);
+  aten::CSRMatrix csr;
   switch (fmt) {
     case SparseFormat::kCOO: {
-      return CreateFromCOO(1, aten::COOLineGraph(coo_->adj(), backtracking));
+      csr = aten::COOToCSR(coo_->adj());
+      break;
     }
     case SparseFormat::kCSR: {
-      const aten::CSRMatrix csr = GetCSRMatrix(0);
-      const aten::COOMatrix coo = aten::COOLineGraph(aten::CSRToCOO(csr, true), backtracking);
-      return CreateFromCOO(1, coo);
+      csr = GetCSRMatrix(0);
+      break;
     }
     case SparseFormat::kCSC: {
-      const aten::CSRMatrix csc = GetCSCMatrix(0);
-      const aten::CSRMatrix csr = aten::CSRTranspose(csc);
-      const aten::COOMatrix coo = aten::COOLineGraph(aten::CSRToCOO(csr, true), backtracking);
-      return CreateFromCOO(1, coo);
+      csr = aten::CSRTranspose(GetCSCMatrix(0));
+      break;
     }
     default:
       LOG(FATAL) << "None of CSC, CSR, COO exist";
-      break;
+      return nullptr;
   }
-  return nullptr;
+  return CreateFromCSR(1, aten::CSRLineGraph(csr, backtracking));
 }
 
 constexpr uint64_t kDGLSerialize_UnitGraphMagic = 0xDD2E60F0F6B4A127;
@@ -1537,6 +1650,7 @@ bool UnitGraph::Load(dmlc::Stream* fs) {
     }
   }
 
+  stats_ = std::make_shared<GraphStats>();
   switch (save_format) {
     case SparseFormat::kCOO:
       fs->Read(&coo_);
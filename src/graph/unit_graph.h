@@ -19,10 +19,12 @@
 #include <tuple>
 
 #include "../c_api_common.h"
+#include "./graph_stats.h"
 
 namespace dgl {
 
 class HeteroGraph;
+class SharedGraphStore;
 class UnitGraph;
 typedef std::shared_ptr<UnitGraph> UnitGraphPtr;
 
@@ -257,6 +259,32 @@ class UnitGraph : public BaseHeteroGraph {
 
   HeteroGraphPtr GetGraphInFormat(dgl_format_code_t formats) const override;
 
+  /*! \brief Memory used by one sparse format of the graph. */
+  struct FormatFootprint {
+    SparseFormat format;
+    /*! \brief whether the format exists */
+    bool created = false;
+    /*!
+     * \brief Wall-clock time in milliseconds since the Unix epoch when the format
+     *        was built from another one, -1 if it was given at creation.
+     */
+    int64_t materialized_ms = -1;
+    /*! \brief bytes of the arrays of the format, including the edge IDs */
+    int64_t bytes = 0;
+    /*! \brief bytes of the arrays that live in shared memory */
+    int64_t shared_bytes = 0;
+    /*! \brief the arrays counted, to find the ones shared with other formats */
+    std::vector<IdArray> arrays;
+  };
+
+  /*! \return The memory used by the COO, CSR and CSC formats, in this order. */
+  std::vector<FormatFootprint> GetMemoryFootprint() const;
+
+  /*! \return The structural statistics of the graph, computed on first use. */
+  GraphStats& Stats() const {
+    return *stats_;
+  }
+
   /*! \return Load UnitGraph from stream, using CSRMatrix*/
   bool Load(dmlc::Stream* fs);
 
@@ -279,6 +307,7 @@ class UnitGraph : public BaseHeteroGraph {
  private:
   friend class Serializer;
   friend class HeteroGraph;
+  friend class GraphStats;
   friend class ImmutableGraph;
 
   // private empty constructor
@@ -313,6 +342,17 @@ class UnitGraph : public BaseHeteroGraph {
       bool has_coo,
       dgl_format_code_t formats = all_code);
 
+  /*!
+   * \brief Create the graph of an edge type of a shared memory graph store.
+   *
+   * The published formats are mapped. A missing format is built and published
+   * to the store the first time it is used, so that other processes share it.
+   * \param store The shared memory graph store.
+   * \param etype The edge type.
+   */
+  static HeteroGraphPtr CreateFromSharedStore(
+      std::shared_ptr<SharedGraphStore> store, dgl_type_t etype);
+
   /*! \return Return any existing format. */
   HeteroGraphPtr GetAny() const;
 
@@ -344,6 +384,12 @@ class UnitGraph : public BaseHeteroGraph {
    * \brief Storage format restriction.
    */
   dgl_format_code_t formats_;
+  /*! \brief Shared memory store missing formats are published to, if any */
+  std::shared_ptr<SharedGraphStore> shared_store_;
+  /*! \brief Edge type of this graph in the shared memory store */
+  dgl_type_t shared_etype_ = 0;
+  /*! \brief Statistics, shared with the graphs of the same structure */
+  std::shared_ptr<GraphStats> stats_ = std::make_shared<GraphStats>();
 };
 
 };  // namespace dgl
@@ -0,0 +1,200 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file metrics.cc
+ * \brief Counters and latency histograms of the network communicators.
+ */
+#include "metrics.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace dgl {
+namespace network {
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kNumBuckets;
+
+int64_t LatencyHistogram::BucketUpperBound(int index) {
+  if (index < kSubBuckets)
+    return index;
+  const int exponent = index / kSubBuckets + kSubBucketBits - 1;
+  const int64_t mantissa = index % kSubBuckets + kSubBuckets;
+  const int shift = exponent - kSubBucketBits;
+  if (exponent >= 62 && mantissa == 2 * kSubBuckets - 1)
+    return INT64_MAX;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.buckets.resize(kNumBuckets);
+  for (int i = 0; i < kNumBuckets; ++i)
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  snapshot.max = max_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+  for (int i = 0; i < kNumBuckets; ++i)
+    buckets_[i].store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::Snapshot::Quantile(double q) const {
+  int64_t total = 0;
+  for (const int64_t c : buckets)
+    total += c;
+  if (total == 0)
+    return 0;
+  // The rank of the quantile, counting from 1.
+  const int64_t rank = std::max<int64_t>(1, static_cast<int64_t>(q * total + 0.5));
+  int64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::min(BucketUpperBound(i), max);
+  }
+  return max;
+}
+
+namespace {
+
+void WriteLatency(std::ostream& os, const LatencyHistogram& hist) {
+  const LatencyHistogram::Snapshot s = hist.GetSnapshot();
+  os << "{\"count\": " << s.count
+     << ", \"mean_us\": " << (s.count ? s.sum / 1e3 / s.count : 0.)
+     << ", \"p50_us\": " << s.Quantile(0.5) / 1e3
+     << ", \"p90_us\": " << s.Quantile(0.9) / 1e3
+     << ", \"p99_us\": " << s.Quantile(0.99) / 1e3
+     << ", \"p999_us\": " << s.Quantile(0.999) / 1e3
+     << ", \"max_us\": " << s.max / 1e3 << "}";
+}
+
+}  // namespace
+
+NetworkMetrics* NetworkMetrics::Global() {
+  static NetworkMetrics metrics;
+  return &metrics;
+}
+
+std::shared_ptr<ConnectionMetrics> NetworkMetrics::GetConnection(
+    const std::string& direction, int peer_id, const std::string& addr,
+    std::shared_ptr<QueueMetrics> queue) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& conn : connections_) {
+    if (conn->direction == direction && conn->peer_id == peer_id && conn->addr == addr) {
+      std::atomic_store(&conn->queue, queue);
+      return conn;
+    }
+  }
+  auto conn = std::make_shared<ConnectionMetrics>();
+  conn->direction = direction;
+  conn->peer_id = peer_id;
+  conn->addr = addr;
+  conn->queue = queue;
+  connections_.push_back(conn);
+  return conn;
+}
+
+MessageTypeMetrics* NetworkMetrics::GetMessageType(int32_t service_id) {
+  // Entries of this thread already looked up, for the registry that owns them.
+  struct Cache {
+    const NetworkMetrics* owner = nullptr;
+    std::unordered_map<int32_t, MessageTypeMetrics*> entries;
+  };
+  static thread_local Cache cache;
+  if (cache.owner == this) {
+    auto it = cache.entries.find(service_id);
+    if (it != cache.entries.end())
+      return it->second;
+  } else {
+    cache.owner = this;
+    cache.entries.clear();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<MessageTypeMetrics>& entry = message_types_[service_id];
+  if (!entry)
+    entry.reset(new MessageTypeMetrics());
+  cache.entries[service_id] = entry.get();
+  return entry.get();
+}
+
+std::string NetworkMetrics::SnapshotJSON() const {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  std::lock_guard<std::mutex> lock(mutex_);
+  os << "{\"connections\": [";
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    const ConnectionMetrics& conn = *connections_[i];
+    // Addresses are "ip:port" strings built by the communicators, so need no escaping.
+    os << (i ? ",\n" : "\n") << "{\"direction\": \"" << conn.direction
+       << "\", \"peer_id\": " << conn.peer_id
+       << ", \"addr\": \"" << conn.addr
+       << "\", \"msgs\": " << conn.msgs.load(std::memory_order_relaxed)
+       << ", \"bytes\": " << conn.bytes.load(std::memory_order_relaxed)
+       << ", \"latency\": ";
+    WriteLatency(os, conn.latency);
+    const std::shared_ptr<QueueMetrics> queue = std::atomic_load(&conn.queue);
+    if (queue) {
+      os << ", \"queue\": {\"capacity\": " << queue->capacity.load(std::memory_order_relaxed)
+         << ", \"used\": " << queue->used.load(std::memory_order_relaxed)
+         << ", \"high_water\": " << queue->high_water.load(std::memory_order_relaxed)
+         << ", \"blocked_add_ms\": "
+         << queue->blocked_add_ns.load(std::memory_order_relaxed) / 1e6
+         << ", \"blocked_remove_ms\": "
+         << queue->blocked_remove_ns.load(std::memory_order_relaxed) / 1e6 << "}";
+    }
+    os << "}";
+  }
+  os << "\n], \"message_types\": [";
+  bool first = true;
+  for (const auto& kv : message_types_) {
+    const MessageTypeMetrics& type = *kv.second;
+    os << (first ? "\n" : ",\n") << "{\"service_id\": " << kv.first
+       << ", \"sent_msgs\": " << type.sent_msgs.load(std::memory_order_relaxed)
+       << ", \"sent_bytes\": " << type.sent_bytes.load(std::memory_order_relaxed)
+       << ", \"recv_msgs\": " << type.recv_msgs.load(std::memory_order_relaxed)
+       << ", \"recv_bytes\": " << type.recv_bytes.load(std::memory_order_relaxed)
+       << ", \"send_latency\": ";
+    WriteLatency(os, type.send_latency);
+    os << "}";
+    first = false;
+  }
+  os << "\n]}";
+  return os.str();
+}
+
+void NetworkMetrics::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& conn : connections_) {
+    conn->msgs.store(0, std::memory_order_relaxed);
+    conn->bytes.store(0, std::memory_order_relaxed);
+    conn->latency.Reset();
+    const std::shared_ptr<QueueMetrics> queue = std::atomic_load(&conn->queue);
+    if (queue) {
+      // The high-water mark restarts from the current occupancy.
+      queue->high_water.store(queue->used.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+      queue->blocked_add_ns.store(0, std::memory_order_relaxed);
+      queue->blocked_remove_ns.store(0, std::memory_order_relaxed);
+    }
+  }
+  for (const auto& kv : message_types_) {
+    MessageTypeMetrics* type = kv.second.get();
+    type->sent_msgs.store(0, std::memory_order_relaxed);
+    type->sent_bytes.store(0, std::memory_order_relaxed);
+    type->recv_msgs.store(0, std::memory_order_relaxed);
+    type->recv_bytes.store(0, std::memory_order_relaxed);
+    type->send_latency.Reset();
+  }
+}
+
+}  // namespace network
+}  // namespace dgl
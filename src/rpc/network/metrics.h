@@ -0,0 +1,194 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file metrics.h
+ * \brief Counters and latency histograms of the network communicators.
+ */
+#ifndef DGL_RPC_NETWORK_METRICS_H_
+#define DGL_RPC_NETWORK_METRICS_H_
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif  // _WIN32
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dgl {
+namespace network {
+
+/*! \brief Monotonic time in nanoseconds, for measuring durations. */
+inline int64_t MonotonicNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+ * \brief Latency histogram with log-linear buckets, as in HdrHistogram.
+ *
+ * Every power of two is split into kSubBuckets linear buckets, so any value is
+ * counted in a bucket whose width is within 1/kSubBuckets of the value. Recording
+ * is a few relaxed atomic updates and never takes a lock, so it can be called from
+ * the send and receive loops directly.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  /*! \brief A consistent-enough copy of the histogram, read with relaxed loads. */
+  struct Snapshot {
+    int64_t count = 0;
+    int64_t sum = 0;
+    int64_t max = 0;
+    std::vector<int64_t> buckets;
+
+    /*! \return The upper bound of the bucket holding the q-quantile, capped by max. */
+    int64_t Quantile(double q) const;
+  };
+
+  /*! \brief Record a value, e.g. a latency in nanoseconds. Negative values count as 0. */
+  void Record(int64_t value) {
+    if (value < 0)
+      value = 0;
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    int64_t old_max = max_.load(std::memory_order_relaxed);
+    while (value > old_max &&
+           !max_.compare_exchange_weak(old_max, value, std::memory_order_relaxed)) {}
+  }
+
+  Snapshot GetSnapshot() const;
+
+  void Reset();
+
+  /*! \return The index of the bucket of a non-negative value. */
+  static int BucketIndex(int64_t value) {
+    if (value < kSubBuckets)
+      return static_cast<int>(value);
+#ifdef _WIN32
+    unsigned long msb;  // NOLINT(runtime/int)
+    _BitScanReverse64(&msb, static_cast<uint64_t>(value));
+    const int exponent = static_cast<int>(msb);
+#else   // !_WIN32
+    const int exponent = 63 - __builtin_clzll(static_cast<uint64_t>(value));
+#endif  // _WIN32
+    const int64_t mantissa = (value >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + static_cast<int>(mantissa);
+  }
+
+  /*! \return The largest value counted in a bucket. */
+  static int64_t BucketUpperBound(int index);
+
+ private:
+  std::atomic<int64_t> buckets_[kNumBuckets] = {};
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> sum_{0};
+  std::atomic<int64_t> max_{0};
+};
+
+/*! \brief Occupancy and blocking time of a message queue. */
+struct QueueMetrics {
+  /*! \brief Capacity in bytes. */
+  std::atomic<int64_t> capacity{0};
+  /*! \brief Bytes currently held. */
+  std::atomic<int64_t> used{0};
+  /*! \brief Largest number of bytes held since the last reset. */
+  std::atomic<int64_t> high_water{0};
+  /*! \brief Time producers spent waiting for room in Add. */
+  std::atomic<int64_t> blocked_add_ns{0};
+  /*! \brief Time consumers spent waiting for a message in a blocking Remove. */
+  std::atomic<int64_t> blocked_remove_ns{0};
+
+  void UpdateUsed(int64_t new_used) {
+    used.store(new_used, std::memory_order_relaxed);
+    int64_t old_high = high_water.load(std::memory_order_relaxed);
+    while (new_used > old_high &&
+           !high_water.compare_exchange_weak(old_high, new_used,
+                                             std::memory_order_relaxed)) {}
+  }
+};
+
+/*!
+ * \brief Metrics of one connection of a communicator.
+ *
+ * For a sender, latency is the time from adding a message to its queue until the
+ * message is written to the socket. For a receiver, it is the time from a message
+ * being fully read from the socket until it is taken by Recv or RecvFrom.
+ */
+struct ConnectionMetrics {
+  std::string direction;
+  int peer_id = 0;
+  std::string addr;
+  std::atomic<int64_t> msgs{0};
+  std::atomic<int64_t> bytes{0};
+  LatencyHistogram latency;
+  std::shared_ptr<QueueMetrics> queue;
+};
+
+/*! \brief Metrics of one RPC message type, i.e. service ID. */
+struct MessageTypeMetrics {
+  std::atomic<int64_t> sent_msgs{0};
+  std::atomic<int64_t> sent_bytes{0};
+  std::atomic<int64_t> recv_msgs{0};
+  std::atomic<int64_t> recv_bytes{0};
+  /*! \brief Time to serialize a message and hand it to the sender. */
+  LatencyHistogram send_latency;
+};
+
+/*!
+ * \brief Process-wide registry of the network metrics.
+ *
+ * The registry only locks to create or list entries. The entries are updated with
+ * atomics by the communicators and the RPC layer.
+ */
+class NetworkMetrics {
+ public:
+  static NetworkMetrics* Global();
+
+  /*!
+   * \brief Get the metrics of a connection, creating them on first use.
+   *
+   * Reconnecting to the same peer at the same address keeps counting into the same
+   * entry, with the new queue.
+   * \param direction "send" or "recv".
+   * \param peer_id The ID of the receiver or sender at the other end.
+   * \param addr The address of the other end.
+   * \param queue The metrics of the queue of the connection.
+   */
+  std::shared_ptr<ConnectionMetrics> GetConnection(
+      const std::string& direction, int peer_id, const std::string& addr,
+      std::shared_ptr<QueueMetrics> queue);
+
+  /*!
+   * \brief Get the metrics of an RPC message type, creating them on first use.
+   *
+   * The entries are never removed, so every thread caches the ones it has looked
+   * up and only locks the registry the first time it sees a message type.
+   */
+  MessageTypeMetrics* GetMessageType(int32_t service_id);
+
+  /*! \brief Dump all the metrics as a JSON string. */
+  std::string SnapshotJSON() const;
+
+  /*! \brief Reset all the counters, histograms and high-water marks. */
+  void Reset();
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<ConnectionMetrics>> connections_;
+  std::map<int32_t, std::unique_ptr<MessageTypeMetrics>> message_types_;
+};
+
+}  // namespace network
+}  // namespace dgl
+
+#endif  // DGL_RPC_NETWORK_METRICS_H_
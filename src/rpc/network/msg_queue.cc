@@ -19,6 +19,8 @@ MessageQueue::MessageQueue(int64_t queue_size, int num_producers) {
   queue_size_ = queue_size;
   free_size_ = queue_size;
   num_producers_ = num_producers;
+  metrics_ = std::make_shared<QueueMetrics>();
+  metrics_->capacity.store(queue_size);
 }
 
 STATUS MessageQueue::Add(Message msg, bool is_blocking) {
@@ -38,12 +40,19 @@ STATUS MessageQueue::Add(Message msg, bool is_blocking) {
   if (msg.size > free_size_ && !is_blocking) {
     return QUEUE_FULL;
   }
-  cond_not_full_.wait(lock, [&]() {
-    return msg.size <= free_size_;
-  });
+  if (msg.size > free_size_) {
+    const int64_t wait_start = MonotonicNs();
+    cond_not_full_.wait(lock, [&]() {
+      return msg.size <= free_size_;
+    });
+    metrics_->blocked_add_ns.fetch_add(MonotonicNs() - wait_start,
+                                       std::memory_order_relaxed);
+  }
   // Add data pointer to queue
+  msg.enqueue_ns = MonotonicNs();
   queue_.push(msg);
   free_size_ -= msg.size;
+  metrics_->UpdateUsed(queue_size_ - free_size_);
   // not empty signal
   cond_not_empty_.notify_one();
 
@@ -61,9 +70,14 @@ STATUS MessageQueue::Remove(Message* msg, bool is_blocking) {
     }
   }
 
-  cond_not_empty_.wait(lock, [this] {
-    return !queue_.empty() || exit_flag_.load();
-  });
+  if (queue_.empty()) {
+    const int64_t wait_start = MonotonicNs();
+    cond_not_empty_.wait(lock, [this] {
+      return !queue_.empty() || exit_flag_.load();
+    });
+    metrics_->blocked_remove_ns.fetch_add(MonotonicNs() - wait_start,
+                                          std::memory_order_relaxed);
+  }
   if (finished_producers_.size() >= num_producers_ && queue_.empty()) {
     return QUEUE_CLOSE;
   }
@@ -73,7 +87,9 @@ STATUS MessageQueue::Remove(Message* msg, bool is_blocking) {
   msg->data = old_msg.data;
   msg->size = old_msg.size;
   msg->deallocator = old_msg.deallocator;
+  msg->enqueue_ns = old_msg.enqueue_ns;
   free_size_ += old_msg.size;
+  metrics_->UpdateUsed(queue_size_ - free_size_);
   cond_not_full_.notify_one();
 
   return REMOVE_SUCCESS;
@@ -16,6 +16,9 @@
 #include <condition_variable>
 #include <atomic>
 #include <functional>
+#include <memory>
+
+#include "metrics.h"
 
 namespace dgl {
 namespace network {
@@ -60,6 +63,10 @@ struct Message {
    * \brief user-defined deallocator, which can be nullptr
    */
   std::function<void(Message*)> deallocator = nullptr;
+  /*!
+   * \brief time when the message was added to a queue, from MonotonicNs()
+   */
+  int64_t enqueue_ns = 0;
 };
 
 /*!
@@ -129,6 +136,11 @@ class MessageQueue {
    */
   bool EmptyAndNoMoreAdd() const;
 
+  /*!
+   * \brief Occupancy and blocking time of the queue, shared with the network metrics.
+   */
+  std::shared_ptr<QueueMetrics> metrics() const { return metrics_; }
+
  protected:
   /*! 
    * \brief message queue 
@@ -174,6 +186,11 @@ class MessageQueue {
    * \brief Protect all above data and conditions 
    */
   mutable std::mutex mutex_;
+
+  /*!
+   * \brief Occupancy and blocking time, updated under the lock and read without it
+   */
+  std::shared_ptr<QueueMetrics> metrics_;
 };
 
 }  // namespace network
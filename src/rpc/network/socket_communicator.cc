@@ -52,6 +52,8 @@ void SocketSender::AddReceiver(const char* addr, int recv_id) {
   address.port = std::stoi(ip_and_port[1]);
   receiver_addrs_[recv_id] = address;
   msg_queue_[recv_id] =  std::make_shared<MessageQueue>(queue_size_);
+  metrics_[recv_id] = NetworkMetrics::Global()->GetConnection(
+    "send", recv_id, ip_and_port[0] + ":" + ip_and_port[1], msg_queue_[recv_id]->metrics());
 }
 
 bool SocketSender::Connect() {
@@ -87,7 +89,8 @@ bool SocketSender::Connect() {
     threads_[ID] = std::make_shared<std::thread>(
       SendLoop,
       client_socket,
-      msg_queue_[ID].get());
+      msg_queue_[ID].get(),
+      metrics_[ID]);
   }
   return true;
 }
@@ -125,7 +128,8 @@ void SocketSender::Finalize() {
   }
 }
 
-void SocketSender::SendLoop(TCPSocket* socket, MessageQueue* queue) {
+void SocketSender::SendLoop(TCPSocket* socket, MessageQueue* queue,
+                            std::shared_ptr<ConnectionMetrics> metrics) {
   CHECK_NOTNULL(socket);
   CHECK_NOTNULL(queue);
   bool exit = false;
@@ -155,6 +159,11 @@ void SocketSender::SendLoop(TCPSocket* socket, MessageQueue* queue) {
       CHECK_NE(tmp, -1);
       sent_bytes += tmp;
     }
+    if (!exit) {
+      metrics->msgs.fetch_add(1, std::memory_order_relaxed);
+      metrics->bytes.fetch_add(msg.size, std::memory_order_relaxed);
+      metrics->latency.Record(MonotonicNs() - msg.enqueue_ns);
+    }
     // delete msg
     if (msg.deallocator != nullptr) {
       msg.deallocator(&msg);
@@ -209,11 +218,14 @@ bool SocketReceiver::Wait(const char* addr, int num_sender) {
       LOG(WARNING) << "Error on accept socket.";
       return false;
     }
+    metrics_[i] = NetworkMetrics::Global()->GetConnection(
+      "recv", i, accept_ip + ":" + std::to_string(accept_port), msg_queue_[i]->metrics());
     // create new thread for each socket
     threads_[i] = std::make_shared<std::thread>(
       RecvLoop,
       sockets_[i].get(),
-      msg_queue_[i].get());
+      msg_queue_[i].get(),
+      metrics_[i]);
   }
 
   return true;
@@ -229,6 +241,9 @@ STATUS SocketReceiver::Recv(Message* msg, int* send_id) {
       if (code == QUEUE_EMPTY) {
         continue;  // jump to the next queue
       } else {
+        if (code == REMOVE_SUCCESS) {
+          RecordRecvLatency(*msg, *send_id);
+        }
         return code;
       }
     }
@@ -238,9 +253,19 @@ STATUS SocketReceiver::Recv(Message* msg, int* send_id) {
 STATUS SocketReceiver::RecvFrom(Message* msg, int send_id) {
   // Get message from specified message queue
   STATUS code = msg_queue_[send_id]->Remove(msg);
+  if (code == REMOVE_SUCCESS) {
+    RecordRecvLatency(*msg, send_id);
+  }
   return code;
 }
 
+void SocketReceiver::RecordRecvLatency(const Message& msg, int send_id) {
+  auto it = metrics_.find(send_id);
+  if (it != metrics_.end()) {
+    it->second->latency.Record(MonotonicNs() - msg.enqueue_ns);
+  }
+}
+
 void SocketReceiver::Finalize() {
   // Send a signal to tell the message queue to finish its job
   for (auto& mq : msg_queue_) {
@@ -265,7 +290,8 @@ void SocketReceiver::Finalize() {
   }
 }
 
-void SocketReceiver::RecvLoop(TCPSocket* socket, MessageQueue* queue) {
+void SocketReceiver::RecvLoop(TCPSocket* socket, MessageQueue* queue,
+                              std::shared_ptr<ConnectionMetrics> metrics) {
   CHECK_NOTNULL(socket);
   CHECK_NOTNULL(queue);
   for (;;) {
@@ -308,6 +334,8 @@ void SocketReceiver::RecvLoop(TCPSocket* socket, MessageQueue* queue) {
       msg.data = buffer;
       msg.size = data_size;
       msg.deallocator = DefaultMessageDeleter;
+      metrics->msgs.fetch_add(1, std::memory_order_relaxed);
+      metrics->bytes.fetch_add(data_size, std::memory_order_relaxed);
       queue->Add(msg);
     }
   }
@@ -13,6 +13,7 @@
 #include <memory>
 
 #include "communicator.h"
+#include "metrics.h"
 #include "msg_queue.h"
 #include "tcp_socket.h"
 #include "common.h"
@@ -110,15 +111,22 @@ class SocketSender : public Sender {
    */ 
   std::unordered_map<int /* receiver ID */, std::shared_ptr<std::thread>> threads_;
 
+  /*!
+   * \brief Network metrics of each socket connection
+   */
+  std::unordered_map<int /* receiver ID */, std::shared_ptr<ConnectionMetrics>> metrics_;
+
   /*!
    * \brief Send-loop for each socket in per-thread
    * \param socket TCPSocket for current connection
    * \param queue message_queue for current connection
+   * \param metrics network metrics of current connection
    * 
    * Note that, the SendLoop will finish its loop-job and exit thread
    * when the main thread invokes Signal() API on the message queue.
    */
-  static void SendLoop(TCPSocket* socket, MessageQueue* queue);
+  static void SendLoop(TCPSocket* socket, MessageQueue* queue,
+                       std::shared_ptr<ConnectionMetrics> metrics);
 };
 
 /*!
@@ -208,15 +216,27 @@ class SocketReceiver : public Receiver {
    */ 
   std::unordered_map<int /* Sender (virtual) ID */, std::shared_ptr<std::thread>> threads_;
 
+  /*!
+   * \brief Network metrics of each socket connection
+   */
+  std::unordered_map<int /* Sender (virtual) ID */, std::shared_ptr<ConnectionMetrics>> metrics_;
+
   /*!
    * \brief Recv-loop for each socket in per-thread
    * \param socket client socket
    * \param queue message queue
+   * \param metrics network metrics of current connection
    *
    * Note that, the RecvLoop will finish its loop-job and exit thread
    * when the main thread invokes Signal() API on the message queue.
    */ 
-  static void RecvLoop(TCPSocket* socket, MessageQueue* queue);
+  static void RecvLoop(TCPSocket* socket, MessageQueue* queue,
+                       std::shared_ptr<ConnectionMetrics> metrics);
+
+  /*!
+   * \brief Record how long a message waited in the queue of sender send_id
+   */
+  void RecordRecvLatency(const Message& msg, int send_id);
 };
 
 }  // namespace network
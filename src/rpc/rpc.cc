@@ -14,8 +14,10 @@
 #include <dgl/packed_func_ext.h>
 #include <dgl/array.h>
 #include <dgl/random.h>
+#include <dgl/runtime/tracing.h>
 #include <dgl/zerocopy_serializer.h>
 #include "../c_api_common.h"
+#include "./network/metrics.h"
 
 using dgl::network::StringPrintf;
 using namespace dgl::runtime;
@@ -24,6 +26,9 @@ namespace dgl {
 namespace rpc {
 
 RPCStatus SendRPCMessage(const RPCMessage& msg, const int32_t target_id) {
+  tracing::ScopedTimer timer("SendRPCMessage");
+  const int64_t start_ns = network::MonotonicNs();
+  int64_t total_bytes = 0;
   std::shared_ptr<std::string> zerocopy_blob(new std::string());
   StreamWithBuffer zc_write_strm(zerocopy_blob.get(), true);
   zc_write_strm.Write(msg);
@@ -36,6 +41,8 @@ RPCStatus SendRPCMessage(const RPCMessage& msg, const int32_t target_id) {
   rpc_meta_msg.deallocator = [zerocopy_blob](network::Message*) {};
   CHECK_EQ(RPCContext::ThreadLocal()->sender->Send(
     rpc_meta_msg, target_id), ADD_SUCCESS);
+  timer.AddBytes(rpc_meta_msg.size);
+  total_bytes += rpc_meta_msg.size;
   // send real ndarray data
   for (auto ptr : zc_write_strm.buffer_list()) {
     network::Message ndarray_data_msg;
@@ -48,19 +55,29 @@ RPCStatus SendRPCMessage(const RPCMessage& msg, const int32_t target_id) {
     ndarray_data_msg.deallocator = [tensor](network::Message*) {};
     CHECK_EQ(RPCContext::ThreadLocal()->sender->Send(
       ndarray_data_msg, target_id), ADD_SUCCESS);
+    timer.AddBytes(ptr.size);
+    total_bytes += ptr.size;
   }
+  network::MessageTypeMetrics* metrics =
+    network::NetworkMetrics::Global()->GetMessageType(msg.service_id);
+  metrics->sent_msgs.fetch_add(1, std::memory_order_relaxed);
+  metrics->sent_bytes.fetch_add(total_bytes, std::memory_order_relaxed);
+  metrics->send_latency.Record(network::MonotonicNs() - start_ns);
   return kRPCSuccess;
 }
 
 RPCStatus RecvRPCMessage(RPCMessage* msg, int32_t timeout) {
   // ignore timeout now
   CHECK_EQ(timeout, 0) << "rpc cannot support timeout now.";
+  tracing::ScopedTimer timer("RecvRPCMessage");
   network::Message rpc_meta_msg;
   int send_id;
   CHECK_EQ(RPCContext::ThreadLocal()->receiver->Recv(
     &rpc_meta_msg, &send_id), REMOVE_SUCCESS);
   char* count_ptr = rpc_meta_msg.data+rpc_meta_msg.size-sizeof(int32_t);
   int32_t nonempty_ndarray_count = *(reinterpret_cast<int32_t*>(count_ptr));
+  timer.AddBytes(rpc_meta_msg.size);
+  int64_t total_bytes = rpc_meta_msg.size;
   // Recv real ndarray data
   std::vector<void*> buffer_list(nonempty_ndarray_count);
   for (int i = 0; i < nonempty_ndarray_count; ++i) {
@@ -68,10 +85,16 @@ RPCStatus RecvRPCMessage(RPCMessage* msg, int32_t timeout) {
     CHECK_EQ(RPCContext::ThreadLocal()->receiver->RecvFrom(
         &ndarray_data_msg, send_id), REMOVE_SUCCESS);
     buffer_list[i] = ndarray_data_msg.data;
+    timer.AddBytes(ndarray_data_msg.size);
+    total_bytes += ndarray_data_msg.size;
   }
   StreamWithBuffer zc_read_strm(rpc_meta_msg.data, rpc_meta_msg.size-sizeof(int32_t), buffer_list);
   zc_read_strm.Read(msg);
   rpc_meta_msg.deallocator(&rpc_meta_msg);
+  network::MessageTypeMetrics* metrics =
+    network::NetworkMetrics::Global()->GetMessageType(msg->service_id);
+  metrics->recv_msgs.fetch_add(1, std::memory_order_relaxed);
+  metrics->recv_bytes.fetch_add(total_bytes, std::memory_order_relaxed);
   return kRPCSuccess;
 }
 
@@ -243,6 +266,16 @@ DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCSetNumMachines")
   RPCContext::ThreadLocal()->num_machines = num_machines;
 });
 
+DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCGetNetworkMetrics")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+  *rv = network::NetworkMetrics::Global()->SnapshotJSON();
+});
+
+DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCResetNetworkMetrics")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+  network::NetworkMetrics::Global()->Reset();
+});
+
 DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCSendRPCMessage")
 .set_body([] (DGLArgs args, DGLRetValue* rv) {
   RPCMessageRef msg = args[0];
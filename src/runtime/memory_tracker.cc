@@ -0,0 +1,193 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file runtime/memory_tracker.cc
+ * \brief Implementation of the NDArray memory tracker and its C APIs.
+ */
+#include <dgl/runtime/memory_tracker.h>
+#include <dgl/runtime/container.h>
+#include <dgl/runtime/ndarray.h>
+#include <dgl/packed_func_ext.h>
+#include <dmlc/logging.h>
+#include <dmlc/thread_local.h>
+#include <mutex>
+#include <unordered_map>
+#include "../c_api_common.h"
+
+namespace dgl {
+namespace runtime {
+namespace memory {
+
+std::atomic<bool> tracking_flag(false);
+
+namespace {
+
+/*! \brief ID of the tag counting the tags beyond kMaxTags */
+constexpr int32_t kOtherTag = kMaxTags - 1;
+
+/*! \brief Counters of one tag, updated without locking */
+struct TagCounters {
+  std::atomic<int64_t> live_bytes{0};
+  std::atomic<int64_t> shared_live_bytes{0};
+  std::atomic<int64_t> peak_bytes{0};
+  std::atomic<int64_t> live_arrays{0};
+  std::atomic<int64_t> total_allocs{0};
+};
+
+struct Tracker {
+  std::mutex mutex;
+  std::vector<std::string> names = {"untagged"};
+  std::unordered_map<std::string, int32_t> ids = {{"untagged", kUntaggedTag}};
+  TagCounters counters[kMaxTags];
+
+  static Tracker* Global() {
+    // Never destroyed, as arrays may still be freed during the static destruction.
+    static Tracker* tracker = new Tracker();
+    return tracker;
+  }
+};
+
+struct ThreadTag {
+  int32_t tag = kUntaggedTag;
+};
+
+}  // namespace
+
+void EnableTracking() {
+  tracking_flag.store(true, std::memory_order_relaxed);
+}
+
+void DisableTracking() {
+  tracking_flag.store(false, std::memory_order_relaxed);
+}
+
+int32_t GetTagID(const std::string& name) {
+  Tracker* tracker = Tracker::Global();
+  std::lock_guard<std::mutex> lock(tracker->mutex);
+  auto it = tracker->ids.find(name);
+  if (it != tracker->ids.end())
+    return it->second;
+  if (static_cast<int32_t>(tracker->names.size()) >= kOtherTag) {
+    if (tracker->names.size() == static_cast<size_t>(kOtherTag)) {
+      LOG(WARNING) << "More than " << kOtherTag - 1 << " memory tags are used; "
+                   << "the arrays of the later ones are counted under \"other\".";
+      tracker->names.push_back("other");
+    }
+    return kOtherTag;
+  }
+  const int32_t id = tracker->names.size();
+  tracker->names.push_back(name);
+  tracker->ids[name] = id;
+  return id;
+}
+
+int32_t CurrentTag() {
+  return dmlc::ThreadLocalStore<ThreadTag>::Get()->tag;
+}
+
+int32_t SetCurrentTag(int32_t tag) {
+  CHECK(tag >= 0 && tag < kMaxTags) << "Invalid memory tag " << tag;
+  ThreadTag* state = dmlc::ThreadLocalStore<ThreadTag>::Get();
+  const int32_t prev = state->tag;
+  state->tag = tag;
+  return prev;
+}
+
+void RecordAlloc(int32_t tag, int64_t bytes, bool shared) {
+  TagCounters& c = Tracker::Global()->counters[tag];
+  const int64_t live = (shared ? c.shared_live_bytes : c.live_bytes).fetch_add(
+      bytes, std::memory_order_relaxed) + bytes;
+  const int64_t other = (shared ? c.live_bytes : c.shared_live_bytes).load(
+      std::memory_order_relaxed);
+  c.live_arrays.fetch_add(1, std::memory_order_relaxed);
+  c.total_allocs.fetch_add(1, std::memory_order_relaxed);
+  const int64_t total = live + other;
+  int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+  while (total > peak &&
+         !c.peak_bytes.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {}
+}
+
+void RecordFree(int32_t tag, int64_t bytes, bool shared) {
+  TagCounters& c = Tracker::Global()->counters[tag];
+  (shared ? c.shared_live_bytes : c.live_bytes).fetch_sub(bytes, std::memory_order_relaxed);
+  c.live_arrays.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::vector<TagStats> GetStats() {
+  Tracker* tracker = Tracker::Global();
+  std::lock_guard<std::mutex> lock(tracker->mutex);
+  std::vector<TagStats> ret;
+  for (size_t i = 0; i < tracker->names.size(); ++i) {
+    const TagCounters& c = tracker->counters[i];
+    TagStats stats;
+    stats.tag = tracker->names[i];
+    stats.live_bytes = c.live_bytes.load(std::memory_order_relaxed);
+    stats.shared_live_bytes = c.shared_live_bytes.load(std::memory_order_relaxed);
+    stats.peak_bytes = c.peak_bytes.load(std::memory_order_relaxed);
+    stats.live_arrays = c.live_arrays.load(std::memory_order_relaxed);
+    stats.total_allocs = c.total_allocs.load(std::memory_order_relaxed);
+    if (stats.total_allocs > 0 || stats.live_arrays > 0)
+      ret.push_back(stats);
+  }
+  return ret;
+}
+
+void ResetPeaks() {
+  Tracker* tracker = Tracker::Global();
+  std::lock_guard<std::mutex> lock(tracker->mutex);
+  for (TagCounters& c : tracker->counters) {
+    c.peak_bytes.store(c.live_bytes.load(std::memory_order_relaxed) +
+                       c.shared_live_bytes.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+    c.total_allocs.store(0, std::memory_order_relaxed);
+  }
+}
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryEnableTracking")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    EnableTracking();
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryDisableTracking")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    DisableTracking();
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryIsTracking")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    *rv = IsTracking();
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemorySetTag")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const std::string name = args[0];
+    const int64_t prev = SetCurrentTag(GetTagID(name));
+    *rv = prev;
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryRestoreTag")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const int64_t tag = args[0];
+    SetCurrentTag(tag);
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryGetStats")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    // Every tag maps to [live_bytes, shared_live_bytes, peak_bytes, live_arrays,
+    // total_allocs].
+    Map<std::string, Value> ret;
+    for (const TagStats& s : GetStats()) {
+      const std::vector<int64_t> values = {
+        s.live_bytes, s.shared_live_bytes, s.peak_bytes, s.live_arrays, s.total_allocs};
+      ret.Set(s.tag, Value(MakeValue(NDArray::FromVector(values))));
+    }
+    *rv = ret;
+  });
+
+DGL_REGISTER_GLOBAL("memory._CAPI_DGLMemoryResetPeaks")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    ResetPeaks();
+  });
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace dgl
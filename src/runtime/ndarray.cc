@@ -8,6 +8,7 @@
 #include <dgl/runtime/ndarray.h>
 #include <dgl/runtime/c_runtime_api.h>
 #include <dgl/runtime/device_api.h>
+#include <dgl/runtime/memory_tracker.h>
 #include <dgl/runtime/shared_mem.h>
 #include <dgl/zerocopy_serializer.h>
 #include "runtime_base.h"
@@ -47,6 +48,14 @@ struct NDArray::Internal {
   // Default deleter for the container
   static void DefaultDeleter(NDArray::Container* ptr) {
     using dgl::runtime::NDArray;
+    if (ptr->tracked_tag >= 0) {
+#ifndef _WIN32
+      const bool shared = ptr->mem != nullptr;
+#else
+      const bool shared = false;
+#endif  // _WIN32
+      memory::RecordFree(ptr->tracked_tag, ptr->tracked_bytes, shared);
+    }
     if (ptr->manager_ctx != nullptr) {
       static_cast<NDArray::Container*>(ptr->manager_ctx)->DecRef();
 #ifndef _WIN32
@@ -100,6 +109,14 @@ struct NDArray::Internal {
     data->dl_tensor.ctx = ctx;
     return ret;
   }
+  // Count the data of a new array under the tag of the calling thread
+  static void Track(NDArray::Container* data, size_t size, bool shared) {
+    if (memory::IsTracking()) {
+      data->tracked_tag = memory::CurrentTag();
+      data->tracked_bytes = size;
+      memory::RecordAlloc(data->tracked_tag, size, shared);
+    }
+  }
   // Implementation of API function
   static DLTensor* MoveAsDLTensor(NDArray arr) {
     DLTensor* tensor = const_cast<DLTensor*>(arr.operator->());
@@ -185,6 +202,7 @@ NDArray NDArray::EmptyShared(const std::string &name,
   }
 
   ret.data_->mem = mem;
+  Internal::Track(ret.data_, size, true);
 #else
   LOG(FATAL) << "Windows doesn't support NDArray with shared memory";
 #endif  // _WIN32
@@ -201,6 +219,7 @@ NDArray NDArray::Empty(std::vector<int64_t> shape,
   ret.data_->dl_tensor.data =
       DeviceAPI::Get(ret->ctx)->AllocDataSpace(
           ret->ctx, size, alignment, ret->dtype);
+  Internal::Track(ret.data_, size, false);
   return ret;
 }
 
@@ -296,6 +315,19 @@ std::shared_ptr<SharedMemory> NDArray::GetSharedMem() const {
 }
 #endif  // _WIN32
 
+bool NDArray::IsSharedMem() const {
+#ifndef _WIN32
+  // Follow the views to the array that owns the data.
+  for (const Container* c = data_; c != nullptr;
+       c = (c->deleter == Internal::DefaultDeleter) ?
+           static_cast<const Container*>(c->manager_ctx) : nullptr) {
+    if (c->mem)
+      return true;
+  }
+#endif  // _WIN32
+  return false;
+}
+
 
 void NDArray::Save(dmlc::Stream* strm) const {
   auto zc_strm = dynamic_cast<StreamWithBuffer*>(strm);
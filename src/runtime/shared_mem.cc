@@ -74,6 +74,14 @@ void *SharedMemory::Open(size_t size) {
 #endif  // _WIN32
 }
 
+void SharedMemory::Unlink(const std::string &name) {
+#ifndef _WIN32
+  shm_unlink(name.c_str());
+#else
+  LOG(FATAL) << "Shared memory is not supported on Windows.";
+#endif  // _WIN32
+}
+
 bool SharedMemory::Exist(const std::string &name) {
 #ifndef _WIN32
   int fd = shm_open(name.c_str(), O_RDONLY, S_IRUSR | S_IWUSR);
@@ -0,0 +1,271 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file runtime/tracing.cc
+ * \brief Implementation of the tracer and its C APIs.
+ */
+#include <dgl/runtime/tracing.h>
+#include <dgl/runtime/container.h>
+#include <dgl/runtime/ndarray.h>
+#include <dgl/packed_func_ext.h>
+#include <dmlc/logging.h>
+#include <dmlc/thread_local.h>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include "../c_api_common.h"
+
+namespace dgl {
+namespace runtime {
+namespace tracing {
+
+std::atomic<bool> enabled_flag(false);
+
+namespace {
+
+/*! \brief A finished scope. */
+struct Event {
+  const char* name;
+  int64_t start_ns;
+  int64_t dur_ns;
+  int64_t bytes;
+  int64_t edges;
+};
+
+/*!
+ * \brief The events and aggregates recorded by one thread.
+ *
+ * Only its own thread writes to a buffer; the lock is there for the readers and
+ * Clear, so it is uncontended while tracing.
+ */
+struct ThreadBuffer {
+  std::mutex mutex;
+  int64_t tid = 0;
+  int64_t capacity = 0;
+  std::vector<Event> events;
+  int64_t num_recorded = 0;
+  std::unordered_map<const char*, OpStats> stats;
+
+  void Reset(int64_t new_capacity) {
+    capacity = new_capacity;
+    events.clear();
+    events.shrink_to_fit();
+    events.reserve(capacity);
+    num_recorded = 0;
+    stats.clear();
+  }
+};
+
+/*! \brief The buffers of all the threads that have recorded events. */
+struct Tracer {
+  std::mutex mutex;
+  int64_t capacity = kDefaultCapacity;
+  // Buffers outlive their threads, so that the events of finished threads are kept.
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+  static Tracer* Global() {
+    static Tracer tracer;
+    return &tracer;
+  }
+};
+
+struct ThreadBufferRef {
+  std::shared_ptr<ThreadBuffer> buffer;
+};
+
+ThreadBuffer* GetThreadBuffer() {
+  ThreadBufferRef* ref = dmlc::ThreadLocalStore<ThreadBufferRef>::Get();
+  if (!ref->buffer) {
+    Tracer* tracer = Tracer::Global();
+    std::lock_guard<std::mutex> lock(tracer->mutex);
+    ref->buffer = std::make_shared<ThreadBuffer>();
+    ref->buffer->tid = tracer->buffers.size();
+    ref->buffer->Reset(tracer->capacity);
+    tracer->buffers.push_back(ref->buffer);
+  }
+  return ref->buffer.get();
+}
+
+std::chrono::steady_clock::time_point Epoch() {
+  static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+  return epoch;
+}
+
+int64_t ProcessId() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+void WriteJSONString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (const char c : str) {
+    if (c == '"' || c == '\\')
+      os << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+         << static_cast<int>(c) << std::dec << std::setfill(' ');
+    else
+      os << c;
+  }
+  os << '"';
+}
+
+}  // namespace
+
+void Enable(int64_t capacity) {
+  CHECK_GT(capacity, 0) << "The capacity of the trace buffers must be positive.";
+  {
+    std::lock_guard<std::mutex> lock(Tracer::Global()->mutex);
+    Tracer::Global()->capacity = capacity;
+  }
+  Clear();
+  enabled_flag.store(true, std::memory_order_relaxed);
+}
+
+void Disable() {
+  enabled_flag.store(false, std::memory_order_relaxed);
+}
+
+void Clear() {
+  Tracer* tracer = Tracer::Global();
+  std::lock_guard<std::mutex> lock(tracer->mutex);
+  for (const auto& buffer : tracer->buffers) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    buffer->Reset(tracer->capacity);
+  }
+}
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - Epoch()).count();
+}
+
+void Record(const char* name, int64_t start_ns, int64_t end_ns,
+            int64_t bytes, int64_t edges) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  const int64_t dur_ns = end_ns - start_ns;
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  const Event event = {name, start_ns, dur_ns, bytes, edges};
+  if (static_cast<int64_t>(buffer->events.size()) < buffer->capacity)
+    buffer->events.push_back(event);
+  else
+    buffer->events[buffer->num_recorded % buffer->capacity] = event;
+  ++buffer->num_recorded;
+
+  OpStats& stats = buffer->stats[name];
+  if (stats.count == 0 || dur_ns < stats.min_ns)
+    stats.min_ns = dur_ns;
+  stats.max_ns = std::max(stats.max_ns, dur_ns);
+  ++stats.count;
+  stats.total_ns += dur_ns;
+  stats.bytes += bytes;
+  stats.edges += edges;
+}
+
+std::vector<std::pair<std::string, OpStats>> GetStats() {
+  // Different pointers may hold the same name, so merge by string.
+  std::map<std::string, OpStats> merged;
+  Tracer* tracer = Tracer::Global();
+  std::lock_guard<std::mutex> lock(tracer->mutex);
+  for (const auto& buffer : tracer->buffers) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    for (const auto& kv : buffer->stats) {
+      OpStats& stats = merged[kv.first];
+      const OpStats& other = kv.second;
+      if (stats.count == 0 || other.min_ns < stats.min_ns)
+        stats.min_ns = other.min_ns;
+      stats.max_ns = std::max(stats.max_ns, other.max_ns);
+      stats.count += other.count;
+      stats.total_ns += other.total_ns;
+      stats.bytes += other.bytes;
+      stats.edges += other.edges;
+    }
+  }
+  return {merged.begin(), merged.end()};
+}
+
+std::string DumpChromeTrace() {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  const int64_t pid = ProcessId();
+  int64_t num_dropped = 0;
+  bool first = true;
+  os << "{\"traceEvents\": [";
+  Tracer* tracer = Tracer::Global();
+  std::lock_guard<std::mutex> lock(tracer->mutex);
+  for (const auto& buffer : tracer->buffers) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    const int64_t size = buffer->events.size();
+    num_dropped += buffer->num_recorded - size;
+    // Start from the oldest event once the ring buffer has wrapped around.
+    const int64_t begin = (buffer->num_recorded > size) ? buffer->num_recorded % size : 0;
+    for (int64_t i = 0; i < size; ++i) {
+      const Event& e = buffer->events[(begin + i) % size];
+      os << (first ? "\n" : ",\n") << "{\"name\": ";
+      WriteJSONString(os, e.name);
+      os << ", \"cat\": \"dgl\", \"ph\": \"X\", \"pid\": " << pid
+         << ", \"tid\": " << buffer->tid
+         << ", \"ts\": " << e.start_ns / 1e3 << ", \"dur\": " << e.dur_ns / 1e3
+         << ", \"args\": {\"bytes\": " << e.bytes << ", \"edges\": " << e.edges << "}}";
+      first = false;
+    }
+  }
+  os << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": "
+     << num_dropped << "}}";
+  return os.str();
+}
+
+DGL_REGISTER_GLOBAL("tracing._CAPI_DGLTracingEnable")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    const int64_t capacity = args[0];
+    Enable(capacity);
+  });
+
+DGL_REGISTER_GLOBAL("tracing._CAPI_DGLTracingDisable")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    Disable();
+  });
+
+DGL_REGISTER_GLOBAL("tracing._CAPI_DGLTracingIsEnabled")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    *rv = IsEnabled();
+  });
+
+DGL_REGISTER_GLOBAL("tracing._CAPI_DGLTracingClear")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    Clear();
+  });
+
+DGL_REGISTER_GLOBAL("tracing._CAPI_DGLTracingDumpChromeTrace")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    *rv = DumpChromeTrace();
+  });
+
+DGL_REGISTER_GLOBAL("tracing._CAPI_DGLTracingGetStats")
+.set_body([] (DGLArgs args, DGLRetValue* rv) {
+    // Every operator maps to [count, total_ns, min_ns, max_ns, bytes, edges].
+    Map<std::string, Value> ret;
+    for (const auto& kv : GetStats()) {
+      const OpStats& s = kv.second;
+      const std::vector<int64_t> values = {
+        s.count, s.total_ns, s.min_ns, s.max_ns, s.bytes, s.edges};
+      ret.Set(kv.first, Value(MakeValue(NDArray::FromVector(values))));
+    }
+    *rv = ret;
+  });
+
+}  // namespace tracing
+}  // namespace runtime
+}  // namespace dgl
@@ -4,93 +4,252 @@
  * \brief DGL Scheduler implementation
  */
 #include <dgl/scheduler.h>
-#include <unordered_map>
+#include <dmlc/omp.h>
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace dgl {
 namespace sched {
 
-template <class IdType>
-std::vector<IdArray> DegreeBucketing(const IdArray& msg_ids, const IdArray& vids,
-        const IdArray& recv_ids) {
-    auto n_msgs = msg_ids->shape[0];
+namespace {
 
-    const IdType* vid_data = static_cast<IdType*>(vids->data);
-    const IdType* msg_id_data = static_cast<IdType*>(msg_ids->data);
-    const IdType* recv_id_data = static_cast<IdType*>(recv_ids->data);
+/*!
+ * \brief Counting-sort a list of elements by the degree of their keys.
+ *
+ * The degree of a key is the number of elements carrying it. Keys are laid out
+ * bucket by bucket in ascending degree, and in ascending key order within a
+ * bucket. Elements of the same key are contiguous and keep their input order.
+ *
+ * \param keys The key of each element.
+ * \param num_elems Number of elements.
+ * \param num_slots Upper bound (exclusive) of the key values.
+ * \param slot_deg Output. On return, the degree of each key.
+ * \param bkt_degs Output. The degree of each non-empty bucket.
+ * \param bkt_sizes Output. The number of keys in each non-empty bucket.
+ * \param sorted_keys Output. The distinct keys in bucket order. Must hold at
+ *                    least as many entries as there are distinct keys.
+ * \param elem_pos Output. The sorted position of each element.
+ */
+template <typename IdType>
+void CountingSortByDegree(const IdType* keys, int64_t num_elems, int64_t num_slots,
+                          std::vector<IdType>* slot_deg,
+                          std::vector<IdType>* bkt_degs,
+                          std::vector<IdType>* bkt_sizes,
+                          IdType* sorted_keys,
+                          std::vector<IdType>* elem_pos) {
+  // histogram of keys
+  std::vector<IdType>& deg = *slot_deg;
+  deg.assign(num_slots, 0);
+#pragma omp parallel for
+  for (int64_t i = 0; i < num_elems; ++i) {
+    const IdType k = keys[i];
+#pragma omp atomic
+    deg[k]++;
+  }
 
-    // in edge: dst->msgs
-    std::unordered_map<IdType, std::vector<IdType>> in_edges;
-    for (IdType i = 0; i < n_msgs; ++i) {
-        in_edges[vid_data[i]].push_back(msg_id_data[i]);
+  // histogram of degrees
+  const IdType max_deg = (num_slots == 0) ? 0 : *std::max_element(deg.begin(), deg.end());
+  std::vector<IdType> deg_cnt(max_deg + 1, 0);
+#pragma omp parallel for
+  for (int64_t v = 0; v < num_slots; ++v) {
+    const IdType d = deg[v];
+    if (d > 0) {
+#pragma omp atomic
+      deg_cnt[d]++;
     }
+  }
 
-    // bkt: deg->dsts
-    std::unordered_map<IdType, std::vector<IdType>> bkt;
-    for (const auto& it : in_edges) {
-        bkt[it.second.size()].push_back(it.first);
-    }
+  // offsets of each bucket in the key and element outputs
+  std::vector<IdType> key_off(max_deg + 1, 0), elem_off(max_deg + 1, 0);
+  IdType key_cnt = 0, elem_cnt = 0;
+  bkt_degs->clear();
+  bkt_sizes->clear();
+  for (IdType d = 1; d <= max_deg; ++d) {
+    if (deg_cnt[d] == 0)
+      continue;
+    key_off[d] = key_cnt;
+    elem_off[d] = elem_cnt;
+    key_cnt += deg_cnt[d];
+    elem_cnt += d * deg_cnt[d];
+    bkt_degs->push_back(d);
+    bkt_sizes->push_back(deg_cnt[d]);
+  }
 
-    std::unordered_set<IdType> zero_deg_nodes;
-    for (IdType i = 0; i < recv_ids->shape[0]; ++i) {
-        if (in_edges.find(recv_id_data[i]) == in_edges.end()) {
-            zero_deg_nodes.insert(recv_id_data[i]);
-        }
-    }
-    auto n_zero_deg = zero_deg_nodes.size();
-
-    // calc output size
-    IdType n_deg = bkt.size();
-    IdType n_dst = in_edges.size();
-    IdType n_mid_sec = bkt.size();  // zero deg won't affect message size
-    if (n_zero_deg > 0) {
-        n_deg += 1;
-        n_dst += n_zero_deg;
-    }
+  // place keys in ascending order; reuse the key cursor to remember where the
+  // elements of each key start.
+  std::vector<IdType> cursor(num_slots);
+  for (int64_t v = 0; v < num_slots; ++v) {
+    const IdType d = deg[v];
+    if (d == 0)
+      continue;
+    const IdType rank = key_off[d]++;
+    sorted_keys[rank] = v;
+    cursor[v] = elem_off[d];
+    elem_off[d] += d;
+  }
 
-    // initialize output
-    IdArray degs = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
-    IdArray nids = IdArray::Empty({n_dst}, vids->dtype, vids->ctx);
-    IdArray nid_section = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
-    IdArray mids = IdArray::Empty({n_msgs}, vids->dtype, vids->ctx);
-    IdArray mid_section = IdArray::Empty({n_mid_sec}, vids->dtype, vids->ctx);
-    IdType* deg_ptr = static_cast<IdType*>(degs->data);
-    IdType* nid_ptr = static_cast<IdType*>(nids->data);
-    IdType* nsec_ptr = static_cast<IdType*>(nid_section->data);
-    IdType* mid_ptr = static_cast<IdType*>(mids->data);
-    IdType* msec_ptr = static_cast<IdType*>(mid_section->data);
-
-    // fill in bucketing ordering
-    for (const auto& it : bkt) {  // for each bucket
-        const IdType deg = it.first;
-        const IdType bucket_size = it.second.size();
-        *deg_ptr++ = deg;
-        *nsec_ptr++ = bucket_size;
-        *msec_ptr++ = deg * bucket_size;
-        for (const auto dst : it.second) {  // for each dst in this bucket
-            *nid_ptr++ = dst;
-            for (const auto mid : in_edges[dst]) {  // for each in edge of dst
-                *mid_ptr++ = mid;
-            }
-        }
+  // stable scatter of elements
+  elem_pos->resize(num_elems);
+  IdType* pos = elem_pos->data();
+  for (int64_t i = 0; i < num_elems; ++i)
+    pos[i] = cursor[keys[i]]++;
+}
+
+/*!
+ * \brief Beyond this many slots per id, the ids are too sparse to index the slots
+ *        directly, e.g. a small batch of messages on a large graph.
+ */
+constexpr int64_t kMaxSlotsPerId = 4;
+
+/*!
+ * \brief The slots of the counting sort of a set of node ids.
+ *
+ * The slot of an id is the id itself, unless the ids are sparse. They are then
+ * mapped to their rank among the distinct ids, so that the cost of the sort
+ * follows the number of ids rather than the largest one. Both mappings keep the
+ * ids in ascending order.
+ */
+template <typename IdType>
+class IdSlots {
+ public:
+  explicit IdSlots(const std::vector<IdArray>& arrays) {
+    int64_t num_ids = 0;
+    for (const IdArray& arr : arrays) {
+      const IdType* data = static_cast<IdType*>(arr->data);
+      const int64_t len = arr->shape[0];
+      num_ids += len;
+      if (len > 0)
+        num_slots_ = std::max(
+            num_slots_, static_cast<int64_t>(*std::max_element(data, data + len)) + 1);
     }
+    if (num_slots_ <= kMaxSlotsPerId * num_ids)
+      return;
 
-    if (n_zero_deg > 0) {
-        *deg_ptr = 0;
-        *nsec_ptr = n_zero_deg;
-        for (const auto dst : zero_deg_nodes) {
-            *nid_ptr++ = dst;
-        }
+    ids_.reserve(num_ids);
+    for (const IdArray& arr : arrays) {
+      const IdType* data = static_cast<IdType*>(arr->data);
+      ids_.insert(ids_.end(), data, data + arr->shape[0]);
     }
+    std::sort(ids_.begin(), ids_.end());
+    ids_.erase(std::unique(ids_.begin(), ids_.end()), ids_.end());
+    num_slots_ = ids_.size();
+  }
+
+  /*! \brief Number of slots. */
+  int64_t size() const {
+    return num_slots_;
+  }
+
+  /*!
+   * \brief Return the slot of every id of an array given to the constructor.
+   * \param buf Holds the slots if they differ from the ids.
+   */
+  const IdType* Slots(const IdArray& arr, std::vector<IdType>* buf) const {
+    const IdType* data = static_cast<IdType*>(arr->data);
+    if (ids_.empty())
+      return data;
+    const int64_t len = arr->shape[0];
+    buf->resize(len);
+    IdType* slots = buf->data();
+#pragma omp parallel for
+    for (int64_t i = 0; i < len; ++i)
+      slots[i] = std::lower_bound(ids_.begin(), ids_.end(), data[i]) - ids_.begin();
+    return slots;
+  }
+
+  /*! \brief Return the id of a slot. */
+  IdType Id(IdType slot) const {
+    return ids_.empty() ? slot : ids_[slot];
+  }
+
+ private:
+  int64_t num_slots_ = 0;
+  std::vector<IdType> ids_;
+};
+
+}  // namespace
+
+template <class IdType>
+std::vector<IdArray> DegreeBucketing(const IdArray& msg_ids, const IdArray& vids,
+        const IdArray& recv_ids) {
+  const int64_t n_msgs = msg_ids->shape[0];
+  const int64_t n_recv = recv_ids->shape[0];
+
+  const IdType* msg_id_data = static_cast<IdType*>(msg_ids->data);
+
+  const IdSlots<IdType> slots({vids, recv_ids});
+  const int64_t num_slots = slots.size();
+  std::vector<IdType> vid_buf, recv_id_buf;
+  const IdType* vid_data = slots.Slots(vids, &vid_buf);
+  const IdType* recv_id_data = slots.Slots(recv_ids, &recv_id_buf);
+
+  // bucket destinations by in-degree; the buffer is large enough for both the
+  // destinations with messages and the zero degree ones.
+  std::vector<IdType> in_deg, bkt_degs, bkt_sizes, msg_pos;
+  std::vector<IdType> dsts(n_msgs + n_recv);
+  CountingSortByDegree<IdType>(vid_data, n_msgs, num_slots,
+                               &in_deg, &bkt_degs, &bkt_sizes, dsts.data(), &msg_pos);
+  int64_t n_nonzero = 0;
+  for (const IdType sz : bkt_sizes)
+    n_nonzero += sz;
+
+  // zero degree nodes, deduplicated and in ascending order
+  std::vector<uint8_t> is_zero_deg(num_slots, 0);
+#pragma omp parallel for
+  for (int64_t i = 0; i < n_recv; ++i) {
+    const IdType v = recv_id_data[i];
+    if (in_deg[v] == 0)
+      is_zero_deg[v] = 1;
+  }
+  int64_t n_zero_deg = 0;
+  for (int64_t v = 0; v < num_slots; ++v) {
+    if (is_zero_deg[v])
+      dsts[n_nonzero + n_zero_deg++] = v;
+  }
+
+  // calc output size
+  const int64_t n_mid_sec = bkt_degs.size();  // zero deg won't affect message size
+  const int64_t n_deg = n_mid_sec + (n_zero_deg > 0 ? 1 : 0);
+  const int64_t n_dst = n_nonzero + n_zero_deg;
+
+  // initialize output
+  IdArray degs = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
+  IdArray nids = IdArray::Empty({n_dst}, vids->dtype, vids->ctx);
+  IdArray nid_section = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
+  IdArray mids = IdArray::Empty({n_msgs}, vids->dtype, vids->ctx);
+  IdArray mid_section = IdArray::Empty({n_mid_sec}, vids->dtype, vids->ctx);
+  IdType* deg_ptr = static_cast<IdType*>(degs->data);
+  IdType* nid_ptr = static_cast<IdType*>(nids->data);
+  IdType* nsec_ptr = static_cast<IdType*>(nid_section->data);
+  IdType* mid_ptr = static_cast<IdType*>(mids->data);
+  IdType* msec_ptr = static_cast<IdType*>(mid_section->data);
+
+  // fill in bucketing ordering
+  for (int64_t i = 0; i < n_mid_sec; ++i) {
+    deg_ptr[i] = bkt_degs[i];
+    nsec_ptr[i] = bkt_sizes[i];
+    msec_ptr[i] = bkt_degs[i] * bkt_sizes[i];
+  }
+  if (n_zero_deg > 0) {
+    deg_ptr[n_mid_sec] = 0;
+    nsec_ptr[n_mid_sec] = n_zero_deg;
+  }
+#pragma omp parallel for
+  for (int64_t i = 0; i < n_dst; ++i)
+    nid_ptr[i] = slots.Id(dsts[i]);
+#pragma omp parallel for
+  for (int64_t i = 0; i < n_msgs; ++i)
+    mid_ptr[msg_pos[i]] = msg_id_data[i];
 
-    std::vector<IdArray> ret;
-    ret.push_back(std::move(degs));
-    ret.push_back(std::move(nids));
-    ret.push_back(std::move(nid_section));
-    ret.push_back(std::move(mids));
-    ret.push_back(std::move(mid_section));
+  std::vector<IdArray> ret;
+  ret.push_back(std::move(degs));
+  ret.push_back(std::move(nids));
+  ret.push_back(std::move(nid_section));
+  ret.push_back(std::move(mids));
+  ret.push_back(std::move(mid_section));
 
-    return ret;
+  return ret;
 }
 
 template std::vector<IdArray> DegreeBucketing<int32_t>(const IdArray& msg_ids,
@@ -101,29 +260,203 @@ template std::vector<IdArray> DegreeBucketing<int64_t>(const IdArray& msg_ids,
                                                        const IdArray& vids,
                                                        const IdArray& recv_ids);
 
+namespace {
+
+/*! \brief Beyond this many distinct degrees, candidates are coarsened before the search. */
+constexpr int64_t kMaxPaddingCandidates = 512;
+
+/*! \brief Round a degree up to the next power of two. */
+inline int64_t NextPowerOfTwo(int64_t d) {
+  int64_t p = 1;
+  while (p < d)
+    p <<= 1;
+  return p;
+}
+
+/*! \brief Round a degree up to a value with at most three significant bits. */
+inline int64_t RoundUpDegree(int64_t d) {
+  int64_t shift = 0;
+  while ((d >> (shift + 3)) > 0)
+    ++shift;
+  return ((d + (1LL << shift) - 1) >> shift) << shift;
+}
+
+/*!
+ * \brief Decide how consecutive degree buckets are merged into padded buckets.
+ * \param degs Distinct degrees in ascending order.
+ * \param sizes Number of nodes of each degree.
+ * \param max_buckets See DegreePaddedBucketing.
+ * \return The exclusive end index (into degs) of each merged bucket.
+ */
+std::vector<int64_t> ChoosePaddedBuckets(const std::vector<int64_t>& degs,
+                                         const std::vector<int64_t>& sizes,
+                                         int64_t max_buckets) {
+  const int64_t n_degs = degs.size();
+  // group degrees into units that are never split
+  auto unit_key = [&] (int64_t d) {
+    if (max_buckets <= 0)
+      return NextPowerOfTwo(d);
+    return (n_degs > kMaxPaddingCandidates) ? RoundUpDegree(d) : d;
+  };
+  std::vector<int64_t> unit_end;
+  for (int64_t i = 0; i < n_degs; ++i) {
+    if (i + 1 == n_degs || unit_key(degs[i]) != unit_key(degs[i + 1]))
+      unit_end.push_back(i + 1);
+  }
+  const int64_t n_units = unit_end.size();
+  if (max_buckets <= 0 || n_units <= max_buckets)
+    return unit_end;
+
+  // Pick exactly max_buckets groups of consecutive units minimizing the number of
+  // padded messages: cost[k][j] covers the first j units with k buckets.
+  std::vector<int64_t> node_cnt(n_units + 1, 0), unit_deg(n_units);
+  for (int64_t u = 0, i = 0; u < n_units; ++u) {
+    node_cnt[u + 1] = node_cnt[u];
+    for (; i < unit_end[u]; ++i)
+      node_cnt[u + 1] += sizes[i];
+    unit_deg[u] = degs[unit_end[u] - 1];
+  }
+  const int64_t kInf = std::numeric_limits<int64_t>::max();
+  std::vector<std::vector<int64_t>> cost(max_buckets + 1, std::vector<int64_t>(n_units + 1, kInf));
+  std::vector<std::vector<int64_t>> split(max_buckets + 1, std::vector<int64_t>(n_units + 1, 0));
+  cost[0][0] = 0;
+  for (int64_t k = 1; k <= max_buckets; ++k) {
+    for (int64_t j = k; j <= n_units; ++j) {
+      for (int64_t i = k - 1; i < j; ++i) {
+        if (cost[k - 1][i] == kInf)
+          continue;
+        const int64_t c = cost[k - 1][i] + unit_deg[j - 1] * (node_cnt[j] - node_cnt[i]);
+        if (c < cost[k][j]) {
+          cost[k][j] = c;
+          split[k][j] = i;
+        }
+      }
+    }
+  }
+  std::vector<int64_t> ends(max_buckets);
+  for (int64_t k = max_buckets, j = n_units; k > 0; --k) {
+    ends[k - 1] = unit_end[j - 1];
+    j = split[k][j];
+  }
+  return ends;
+}
+
+}  // namespace
+
+template <class IdType>
+std::vector<IdArray> DegreePaddedBucketing(const IdArray& msg_ids, const IdArray& vids,
+        const IdArray& recv_ids, int64_t max_buckets) {
+  // start from the exact schedule; its buckets are in ascending degree order
+  const std::vector<IdArray> exact = DegreeBucketing<IdType>(msg_ids, vids, recv_ids);
+  const IdType* exact_deg = static_cast<IdType*>(exact[0]->data);
+  const IdType* exact_nsec = static_cast<IdType*>(exact[2]->data);
+  const IdType* exact_mid = static_cast<IdType*>(exact[3]->data);
+  const int64_t n_exact = exact[4]->shape[0];
+  const bool has_zero_deg = exact[0]->shape[0] > n_exact;
+
+  std::vector<int64_t> degs(n_exact), sizes(n_exact);
+  for (int64_t i = 0; i < n_exact; ++i) {
+    degs[i] = exact_deg[i];
+    sizes[i] = exact_nsec[i];
+  }
+  const std::vector<int64_t> ends = ChoosePaddedBuckets(degs, sizes, max_buckets);
+  const int64_t n_bkt = ends.size();
+  const int64_t n_deg = n_bkt + (has_zero_deg ? 1 : 0);
+
+  IdArray pdegs = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
+  IdArray nid_section = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
+  IdArray mid_section = IdArray::Empty({n_bkt}, vids->dtype, vids->ctx);
+  IdType* deg_ptr = static_cast<IdType*>(pdegs->data);
+  IdType* nsec_ptr = static_cast<IdType*>(nid_section->data);
+  IdType* msec_ptr = static_cast<IdType*>(mid_section->data);
+  int64_t n_padded = 0;
+  for (int64_t b = 0, i = 0; b < n_bkt; ++b) {
+    const int64_t pdeg = degs[ends[b] - 1];
+    int64_t n_nodes = 0;
+    for (; i < ends[b]; ++i)
+      n_nodes += sizes[i];
+    deg_ptr[b] = pdeg;
+    nsec_ptr[b] = n_nodes;
+    msec_ptr[b] = pdeg * n_nodes;
+    n_padded += pdeg * n_nodes;
+  }
+  if (has_zero_deg) {
+    deg_ptr[n_bkt] = 0;
+    nsec_ptr[n_bkt] = exact_nsec[n_exact];
+  }
+
+  // Merged buckets keep the node order of the exact schedule, so only the
+  // messages need to be spread out.
+  IdArray mids = IdArray::Empty({n_padded}, vids->dtype, vids->ctx);
+  IdArray mask = IdArray::Empty({n_padded}, vids->dtype, vids->ctx);
+  IdType* mid_ptr = static_cast<IdType*>(mids->data);
+  IdType* mask_ptr = static_cast<IdType*>(mask->data);
+  int64_t exact_off = 0, padded_off = 0;
+  for (int64_t b = 0, i = 0; b < n_bkt; ++b) {
+    const int64_t pdeg = deg_ptr[b];
+    for (; i < ends[b]; ++i) {
+      const int64_t deg = degs[i];
+#pragma omp parallel for
+      for (int64_t k = 0; k < sizes[i]; ++k) {
+        const IdType* src = exact_mid + exact_off + k * deg;
+        IdType* dst = mid_ptr + padded_off + k * pdeg;
+        IdType* msk = mask_ptr + padded_off + k * pdeg;
+        for (int64_t j = 0; j < deg; ++j) {
+          dst[j] = src[j];
+          msk[j] = 1;
+        }
+        for (int64_t j = deg; j < pdeg; ++j) {
+          dst[j] = src[0];
+          msk[j] = 0;
+        }
+      }
+      exact_off += deg * sizes[i];
+      padded_off += pdeg * sizes[i];
+    }
+  }
+
+  std::vector<IdArray> ret;
+  ret.push_back(std::move(pdegs));
+  ret.push_back(exact[1]);
+  ret.push_back(std::move(nid_section));
+  ret.push_back(std::move(mids));
+  ret.push_back(std::move(mid_section));
+  ret.push_back(std::move(mask));
+
+  return ret;
+}
+
+template std::vector<IdArray> DegreePaddedBucketing<int32_t>(const IdArray& msg_ids,
+                                                             const IdArray& vids,
+                                                             const IdArray& recv_ids,
+                                                             int64_t max_buckets);
+
+template std::vector<IdArray> DegreePaddedBucketing<int64_t>(const IdArray& msg_ids,
+                                                             const IdArray& vids,
+                                                             const IdArray& recv_ids,
+                                                             int64_t max_buckets);
+
 template <class IdType>
 std::vector<IdArray> GroupEdgeByNodeDegree(const IdArray& uids,
                                            const IdArray& vids,
                                            const IdArray& eids) {
-  auto n_edge = eids->shape[0];
+  const int64_t n_edge = eids->shape[0];
   const IdType* eid_data = static_cast<IdType*>(eids->data);
   const IdType* uid_data = static_cast<IdType*>(uids->data);
   const IdType* vid_data = static_cast<IdType*>(vids->data);
 
-  // node2edge: group_by nodes uid -> (eid, the other end vid)
-  std::unordered_map<IdType, std::vector<std::pair<IdType, IdType>>> node2edge;
-  for (IdType i = 0; i < n_edge; ++i) {
-    node2edge[uid_data[i]].emplace_back(eid_data[i], vid_data[i]);
-  }
+  const IdSlots<IdType> slots({uids});
+  std::vector<IdType> uid_buf;
+  const IdType* uid_slots = slots.Slots(uids, &uid_buf);
 
-  // bkt: deg -> group_by node uid
-  std::unordered_map<IdType, std::vector<IdType>> bkt;
-  for (const auto& it : node2edge) {
-    bkt[it.second.size()].push_back(it.first);
-  }
+  // bucket edges by the degree of uid
+  std::vector<IdType> node_deg, bkt_degs, bkt_sizes, edge_pos;
+  std::vector<IdType> nodes(n_edge);
+  CountingSortByDegree<IdType>(uid_slots, n_edge, slots.size(),
+                               &node_deg, &bkt_degs, &bkt_sizes, nodes.data(), &edge_pos);
 
   // number of unique degree
-  IdType n_deg = bkt.size();
+  const int64_t n_deg = bkt_degs.size();
 
   // initialize output
   IdArray degs = IdArray::Empty({n_deg}, eids->dtype, eids->ctx);
@@ -138,20 +471,16 @@ std::vector<IdArray> GroupEdgeByNodeDegree(const IdArray& uids,
   IdType* sec_ptr = static_cast<IdType*>(sections->data);
 
   // fill in bucketing ordering
-  for (const auto& it : bkt) {  // for each bucket
-    // degree of this bucket
-    const IdType deg = it.first;
-    // number of edges in this bucket
-    const IdType bucket_size = it.second.size();
-    *deg_ptr++ = deg;
-    *sec_ptr++ = deg * bucket_size;
-    for (const auto u : it.second) {           // for uid in this bucket
-      for (const auto& pair : node2edge[u]) {  // for each edge of uid
-        *uid_ptr++ = u;
-        *vid_ptr++ = pair.second;
-        *eid_ptr++ = pair.first;
-      }
-    }
+  for (int64_t i = 0; i < n_deg; ++i) {
+    deg_ptr[i] = bkt_degs[i];
+    sec_ptr[i] = bkt_degs[i] * bkt_sizes[i];
+  }
+#pragma omp parallel for
+  for (int64_t i = 0; i < n_edge; ++i) {
+    const IdType pos = edge_pos[i];
+    uid_ptr[pos] = uid_data[i];
+    vid_ptr[pos] = vid_data[i];
+    eid_ptr[pos] = eid_data[i];
   }
 
   std::vector<IdArray> ret;
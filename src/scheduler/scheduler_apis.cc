@@ -28,6 +28,20 @@ DGL_REGISTER_GLOBAL("_deprecate.runtime.degree_bucketing._CAPI_DGLDegreeBucketin
     });
   });
 
+DGL_REGISTER_GLOBAL("_deprecate.runtime.degree_bucketing._CAPI_DGLDegreePaddedBucketing")
+  .set_body([](DGLArgs args, DGLRetValue* rv) {
+    const IdArray msg_ids = args[0];
+    const IdArray vids = args[1];
+    const IdArray nids = args[2];
+    const int64_t max_buckets = args[3];
+    CHECK_SAME_DTYPE(msg_ids, vids);
+    CHECK_SAME_DTYPE(msg_ids, nids);
+    ATEN_ID_TYPE_SWITCH(msg_ids->dtype, IdType, {
+      *rv = ConvertNDArrayVectorToPackedFunc(
+        sched::DegreePaddedBucketing<IdType>(msg_ids, vids, nids, max_buckets));
+    });
+  });
+
 DGL_REGISTER_GLOBAL("_deprecate.runtime.degree_bucketing._CAPI_DGLGroupEdgeByNodeDegree")
 .set_body([] (DGLArgs args, DGLRetValue* rv) {
     const IdArray uids = args[0];
@@ -885,6 +885,13 @@ def test_flatten(idtype):
 
     check_mapping(g, fg)
 
+    # flattening the same relations again shares the structure but not the features
+    fg.edata['g'] = F.ones((6, 1))
+    fg2 = g['user', :, 'game']
+    assert 'g' not in fg2.edata
+    assert F.array_equal(fg2.edata[dgl.EID], fg.edata[dgl.EID])
+    check_mapping(g, fg2)
+
     fg = g['user', :, 'user']
     assert fg.idtype == g.idtype
     assert fg.device == g.device
@@ -1820,6 +1827,37 @@ def test_format(idtype):
     assert g.formats()['created'] == ['csr']
     assert len(g.formats()['not created']) == 0
 
+@parametrize_dtype
+def test_memory_footprint(idtype):
+    g = dgl.heterograph({
+        ('user', 'plays', 'game'): [(0, 0), (1, 0), (1, 1), (2, 1)],
+        ('developer', 'develops', 'game'): [(0, 0), (1, 1)],
+        }, idtype=idtype, device=F.ctx())
+    nbytes = 4 if idtype == F.int32 else 8
+    fp = g.memory_footprint()
+    plays = fp['relations'][('user', 'plays', 'game')]
+    assert list(plays) == ['coo']
+    assert plays['coo'] == {'bytes': 2 * 4 * nbytes, 'shared_bytes': 0, 'materialized_at': None}
+    assert fp['total_bytes'] == fp['private_bytes'] == 2 * 6 * nbytes
+    assert fp['shared_bytes'] == 0
+
+    dgl.memory.enable_tracking()
+    try:
+        g.create_format_()
+        stats = dgl.memory.get_allocation_stats()
+    finally:
+        dgl.memory.disable_tracking()
+    fp = g.memory_footprint()
+    plays = fp['relations'][('user', 'plays', 'game')]
+    assert list(plays) == ['coo', 'csr', 'csc']
+    # the CSR of 3 source nodes holds indptr, indices and edge IDs
+    assert plays['csr']['bytes'] == (4 + 4 + 4) * nbytes
+    assert plays['csr']['materialized_at'] is not None
+    assert fp['total_bytes'] > 2 * 6 * nbytes
+    if F.ctx() == F.cpu():
+        assert stats['GraphFormat']['live_bytes'] > 0
+        assert stats['GraphFormat']['total_allocs'] > 0
+
 @parametrize_dtype
 def test_edges_order(idtype):
     # (0, 2), (1, 2), (0, 1), (0, 1), (2, 1)
@@ -2528,6 +2566,7 @@ if __name__ == '__main__':
     # test_dtype_cast()
     # test_reverse("int32")
     # test_format()
+    # test_memory_footprint()
     #test_add_edges(F.int32)
     #test_add_nodes(F.int32)
     #test_remove_edges(F.int32)
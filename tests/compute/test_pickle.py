@@ -8,6 +8,8 @@ import backend as F
 import dgl.function as fn
 import pickle
 import io
+import os
+import gc
 import unittest, pytest
 import test_utils
 from test_utils import parametrize_dtype, get_cases
@@ -166,6 +168,39 @@ def test_pickling_batched_heterograph():
     new_bg = _reconstruct_pickle(bg)
     test_utils.check_graph_equal(bg, new_bg)
 
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU not implemented")
+@unittest.skipIf(os.name == 'nt', reason='Do not support windows yet')
+@parametrize_dtype
+def test_pickling_shared_memory(idtype):
+    g = dgl.heterograph({
+        ('user', 'follows', 'user'): ([0, 1, 2], [1, 2, 3]),
+        ('user', 'plays', 'game'): ([0, 1, 3], [1, 0, 0])}, idtype=idtype)
+    block = dgl.to_block(g, {'user': F.tensor([1, 2], dtype=idtype),
+                             'game': F.tensor([0], dtype=idtype)})
+    dgl.memory.set_shared_memory_pickling(True)
+    try:
+        new_g = _reconstruct_pickle(g)
+        test_utils.check_graph_equal(g, new_g)
+        new_block = _reconstruct_pickle(block)
+        for etype in block.canonical_etypes:
+            src, dst = block.all_edges(order='eid', etype=etype)
+            src2, dst2 = new_block.all_edges(order='eid', etype=etype)
+            assert F.array_equal(src, src2)
+            assert F.array_equal(dst, dst2)
+        stats = dgl.memory.get_arena_pool_stats()
+        assert stats['num_arenas'] >= 1
+        # The arenas are returned once the unpickled graphs are freed, and reused.
+        del new_g, new_block
+        gc.collect()
+        assert dgl.memory.get_arena_pool_stats()['num_free'] == stats['num_arenas']
+        new_g = _reconstruct_pickle(g)
+        assert dgl.memory.get_arena_pool_stats()['num_arenas'] == stats['num_arenas']
+        del new_g
+    finally:
+        dgl.memory.set_shared_memory_pickling(False)
+    dgl.memory.clear_arena_pool()
+    assert dgl.memory.get_arena_pool_stats()['num_arenas'] == 0
+
 @unittest.skipIf(F._default_context_str == 'gpu', reason="GPU not implemented")
 @unittest.skipIf(dgl.backend.backend_name != "pytorch", reason="Only test for pytorch format file")
 def test_pickling_heterograph_index_compatibility():
@@ -197,3 +232,4 @@ if __name__ == '__main__':
     test_pickling_batched_graph()
     test_pickling_heterograph()
     test_pickling_batched_heterograph()
+    test_pickling_shared_memory()
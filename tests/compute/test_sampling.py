@@ -551,6 +551,177 @@ def test_sample_neighbors_with_0deg():
     sg = dgl.sampling.sample_neighbors(g, F.tensor([1, 2], dtype=F.int64), 2, edge_dir='out', replace=True)
     assert sg.number_of_edges() == 0
 
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU sample neighbors not implemented")
+def test_sample_neighbors_batched():
+    _, hg = _gen_neighbor_sampling_test_graph(False, False)
+    nodes_list = [{'user': F.tensor([0, 1], dtype=F.int64)},
+                  {'user': F.tensor([], dtype=F.int64)},
+                  {'user': F.tensor([1, 2, 0], dtype=F.int64), 'game': F.tensor([0], dtype=F.int64)}]
+    for edge_dir in ['in', 'out']:
+        for replace in [False, True]:
+            subgs = dgl.sampling.sample_neighbors_batched(
+                hg, nodes_list, 2, edge_dir=edge_dir, replace=replace)
+            assert len(subgs) == len(nodes_list)
+            for nodes, subg in zip(nodes_list, subgs):
+                for etype in hg.canonical_etypes:
+                    ntype = etype[2] if edge_dir == 'in' else etype[0]
+                    seeds = F.asnumpy(nodes.get(ntype, F.tensor([], dtype=F.int64))).tolist()
+                    u, v = subg.all_edges(form='uv', order='eid', etype=etype)
+                    eid = subg.edges[etype].data[dgl.EID]
+                    u_ans, v_ans = hg.find_edges(eid, etype=etype)
+                    assert F.array_equal(u, u_ans)
+                    assert F.array_equal(v, v_ans)
+                    ends = F.asnumpy(v if edge_dir == 'in' else u).tolist()
+                    for seed in set(seeds):
+                        if edge_dir == 'in':
+                            degree = hg.in_degree(seed, etype=etype)
+                        else:
+                            degree = hg.out_degree(seed, etype=etype)
+                        expected = 0 if degree == 0 else (2 if replace else min(2, degree))
+                        assert ends.count(seed) == expected * seeds.count(seed)
+                    assert set(ends) <= set(seeds)
+            # The same as sampling the sets one by one.
+            for nodes, subg in zip(nodes_list, subgs):
+                ref = dgl.sampling.sample_neighbors(
+                    hg, nodes, 2, edge_dir=edge_dir, replace=replace)
+                for etype in hg.canonical_etypes:
+                    assert subg.number_of_edges(etype) == ref.number_of_edges(etype)
+
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU sample neighbors not implemented")
+def test_sample_neighbors_exclude_edges():
+    # Node 0 has in-edges 0..4 and node 1 has in-edges 5, 6.
+    g = dgl.graph(([1, 2, 3, 4, 5, 0, 2], [0, 0, 0, 0, 0, 1, 1]))
+    g.edata['prob'] = F.tensor([1., 1., 1., 1., 1., 1., 1.])
+    exclude = F.tensor([0, 2, 4, 5], dtype=g.idtype)
+    for fmt in ['coo', 'csc']:
+        fg = g.formats(fmt)
+        for prob in [None, 'prob']:
+            for replace in [False, True]:
+                for fanout in [2, -1]:
+                    sg = dgl.sampling.sample_neighbors(
+                        fg, [0, 1], fanout, prob=prob, replace=replace, exclude_edges=exclude)
+                    eid = F.asnumpy(sg.edata[dgl.EID]).tolist()
+                    assert not set(eid) & {0, 2, 4, 5}
+                    # Node 0 still gets its fanout from the edges left.
+                    _, dst = fg.find_edges(sg.edata[dgl.EID])
+                    dst = F.asnumpy(dst).tolist()
+                    assert dst.count(0) == 2
+                    assert dst.count(1) == (2 if replace and fanout == 2 else 1)
+
+    _, hg = _gen_neighbor_sampling_test_graph(False, False)
+    exclude = {('user', 'follow', 'user'): F.tensor([0, 1, 2], dtype=hg.idtype)}
+    sg = dgl.sampling.sample_neighbors(
+        hg, {'user': [0, 1, 2]}, -1, exclude_edges=exclude)
+    eid = F.asnumpy(sg.edges['follow'].data[dgl.EID]).tolist()
+    assert not set(eid) & {0, 1, 2}
+    # All the follow edges lead to users 0, 1 or 2.
+    assert len(eid) == hg.number_of_edges('follow') - 3
+    for etype in ['play', 'liked-by', 'flips']:
+        assert sg.number_of_edges(etype) == \
+            dgl.sampling.sample_neighbors(hg, {'user': [0, 1, 2]}, -1).number_of_edges(etype)
+
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU sample layer not implemented")
+def test_sample_layer():
+    g = dgl.rand_graph(100, 1000)
+    seeds = F.tensor([0, 3, 5, 9], dtype=F.int64)
+    src, dst, eid = g.in_edges(seeds, form='all')
+
+    # all the neighbors are taken without replacement when the layer is large enough
+    sg = dgl.sampling.sample_layer(g, seeds, 1000, replace=False)
+    assert set(F.asnumpy(sg.edata[dgl.EID]).tolist()) == set(F.asnumpy(eid).tolist())
+    assert np.allclose(F.asnumpy(sg.edata['w']), 1.)
+
+    for replace in [False, True]:
+        sg = dgl.sampling.sample_layer(g, seeds, 5, replace=replace)
+        u, v = sg.edges()
+        # sampled nodes are shared by the seeds and all their edges are kept
+        assert len(np.unique(F.asnumpy(u))) <= 5
+        assert F.array_equal(g.edge_ids(u, v), sg.edata[dgl.EID])
+        mask = np.isin(F.asnumpy(src), F.asnumpy(u))
+        assert mask.sum() == sg.number_of_edges()
+        assert np.all(F.asnumpy(sg.edata['w']) > 0)
+
+    # the weighted sum over the sampled edges estimates the in-degree
+    g = dgl.graph(([0, 1, 2, 2, 3, 4], [5, 5, 5, 6, 6, 6]))
+    g.edata['p'] = F.tensor([1., 2., 1., 1., 3., 1.])
+    seeds = F.tensor([5, 6], dtype=F.int64)
+    est = np.zeros(7)
+    num_trials = 2000
+    for _ in range(num_trials):
+        sg = dgl.sampling.sample_layer(g, seeds, 2, prob='p')
+        _, v = sg.edges()
+        np.add.at(est, F.asnumpy(v), F.asnumpy(sg.edata['w']))
+    assert np.allclose(est[5:] / num_trials, [4., 5.], rtol=0.1)
+
+    # without replacement, the weights of each seed sum to its weighted in-degree
+    for _ in range(10):
+        sg = dgl.sampling.sample_layer(g, seeds, 2, prob='p', replace=False)
+        _, v = sg.edges()
+        total = np.zeros(7)
+        np.add.at(total, F.asnumpy(v), F.asnumpy(sg.edata['w']))
+        for seed, expected in zip([5, 6], [4., 5.]):
+            if (F.asnumpy(v) == seed).any():
+                assert np.isclose(total[seed], expected)
+
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU sample layer not implemented")
+def test_sample_blocks():
+    g = dgl.rand_graph(100, 1000)
+    seeds = F.tensor([0, 3, 5, 9], dtype=F.int64)
+    blocks = dgl.sampling.sample_blocks(g, seeds, [20, 10])
+    assert len(blocks) == 2
+    assert F.array_equal(blocks[-1].dstdata[dgl.NID], seeds)
+    assert F.array_equal(blocks[0].dstdata[dgl.NID], blocks[1].srcdata[dgl.NID])
+    for block in blocks:
+        assert 'w' in block.edata
+        u, v = block.edges()
+        assert F.array_equal(
+            g.edge_ids(F.gather_row(block.srcdata[dgl.NID], u),
+                       F.gather_row(block.dstdata[dgl.NID], v)),
+            block.edata[dgl.EID])
+
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU negative sampling not implemented")
+def test_sample_negative_edges():
+    g = dgl.rand_graph(100, 2000)
+    src, dst = g.edges(order='eid')
+    eids = F.arange(0, 200)
+    adj = set(zip(F.asnumpy(src).tolist(), F.asnumpy(dst).tolist()))
+    for mode in ['uniform', 'degree', 'in_batch']:
+        for corrupt in ['src', 'dst']:
+            neg = dgl.sampling.sample_negative_edges(
+                g, eids, 8, mode=mode, corrupt=corrupt, chunk_size=50)
+            assert neg.number_of_nodes() == g.number_of_nodes()
+            u, v = neg.edges(order='eid')
+            u, v = F.asnumpy(u), F.asnumpy(v)
+            pos = F.asnumpy(neg.edata['pos'])
+            assert len(pos) <= 8 * 200
+            assert not any((a, b) in adj for a, b in zip(u.tolist(), v.tolist()))
+            # the uncorrupted endpoint is kept
+            kept = F.asnumpy(src if corrupt == 'dst' else dst)[pos]
+            assert np.array_equal(u if corrupt == 'dst' else v, kept)
+            if mode == 'in_batch':
+                # corrupted endpoints come from the same chunk of 50 edges
+                pool = F.asnumpy(dst if corrupt == 'dst' else src)
+                drawn = v if corrupt == 'dst' else u
+                for p, x in zip(pos.tolist(), drawn.tolist()):
+                    chunk = p // 50 * 50
+                    assert x in pool[chunk:chunk + 50]
+
+    # an edge alone in its chunk has no other edge to draw from, so it gets no
+    # negative edge rather than a copy of itself
+    neg = dgl.sampling.sample_negative_edges(
+        g, F.arange(0, 5), 4, mode='in_batch', chunk_size=2, exclude_positive=False)
+    pos = F.asnumpy(neg.edata['pos']).tolist()
+    assert len(pos) == 16
+    assert 4 not in pos
+
+    # nodes with zero degree are never drawn in degree mode
+    g = dgl.graph(([0, 1, 2, 3], [4, 4, 5, 5]), num_nodes=6)
+    neg = dgl.sampling.sample_negative_edges(
+        g, F.tensor([0, 1, 2, 3]), 16, mode='degree', exclude_positive=False)
+    _, v = neg.edges()
+    assert F.asnumpy(neg.edata['pos']).shape == (64,)
+    assert set(F.asnumpy(v).tolist()) <= {4, 5}
+
 if __name__ == '__main__':
     test_random_walk()
     test_pack_traces()
@@ -560,3 +731,7 @@ if __name__ == '__main__':
     test_sample_neighbors_topk()
     test_sample_neighbors_topk_outedge()
     test_sample_neighbors_with_0deg()
+    test_sample_neighbors_batched()
+    test_sample_layer()
+    test_sample_blocks()
+    test_sample_negative_edges()
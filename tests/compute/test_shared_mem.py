@@ -84,8 +84,34 @@ def test_copy_from_gpu():
     p.start()
     p.join()
 
+def sub_proc_feature_store(name, feat):
+    store = dgl.shared_feature_store.open_shared_feature_store(name)
+    assert store.keys() == ['feat']
+    assert F.array_equal(store['feat'], feat)
+    rows = F.copy_to(F.tensor([3, 0, 3], F.int64), F.cpu())
+    assert F.array_equal(store.gather_rows('feat', rows), F.gather_row(feat, rows))
+    store['label'] = F.copy_to(F.arange(0, 4), F.cpu())
+
+@unittest.skipIf(os.name == 'nt', reason='Do not support windows yet')
+def test_feature_store_multi_process():
+    import dgl.shared_feature_store
+    store = dgl.shared_feature_store.create_shared_feature_store("feat_store")
+    feat = F.copy_to(F.reshape(F.astype(F.arange(0, 12), F.float32), (4, 3)), F.cpu())
+    store['feat'] = feat
+    p = mp.Process(target=sub_proc_feature_store, args=("feat_store", feat))
+    p.start()
+    p.join()
+    assert p.exitcode == 0
+    assert 'label' in store
+    assert F.array_equal(store['label'], F.copy_to(F.arange(0, 4), F.cpu()))
+    rows = F.copy_to(F.tensor([1, 2], F.int64), F.cpu())
+    out = F.zeros((2, 3), F.float32, F.cpu())
+    store.gather_rows('feat', rows, out=out)
+    assert F.array_equal(out, F.gather_row(feat, rows))
+
 # TODO: Test calling shared_memory with Blocks (a subclass of HeteroGraph)
 if __name__ == "__main__":
     test_single_process(F.int64)
     test_multi_process(F.int32)
     test_copy_from_gpu()
+    test_feature_store_multi_process()
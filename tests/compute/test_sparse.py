@@ -1,8 +1,10 @@
-from dgl.ops import gspmm, gsddmm, edge_softmax
+from dgl.ops import gspmm, gsddmm, edge_softmax, spmm_linear, typed_spmm
+from dgl.ops.segment import segment_reduce, segment_softmax
 from test_utils.graph_cases import get_cases
 from utils import parametrize_dtype
 import dgl
 import random
+import unittest
 import pytest
 import networkx as nx
 import backend as F
@@ -254,5 +256,138 @@ def test_edge_softmax(g, norm_by, shp, idtype):
         assert F.allclose(F.grad(e2), grad_edata)
         print('backward passed')
 
+@unittest.skipIf(F._default_context_str == 'gpu', reason="SpMM linear is only implemented on CPU")
+@pytest.mark.parametrize('dims', [(10, 3), (3, 10)])
+@pytest.mark.parametrize('use_edge_weight', [True, False])
+@parametrize_dtype
+def test_spmm_linear(idtype, dims, use_edge_weight):
+    # both dims orders so that both the project-first and the aggregate-first
+    # kernels are covered
+    in_dim, out_dim = dims
+    g = dgl.rand_graph(30, 200).astype(idtype).to(F.ctx())
+    x = F.tensor(np.random.rand(g.number_of_src_nodes(), in_dim))
+    w = F.tensor(np.random.rand(in_dim, out_dim))
+    ew = F.tensor(np.random.rand(g.number_of_edges())) if use_edge_weight else None
+
+    x1, w1 = F.attach_grad(F.clone(x)), F.attach_grad(F.clone(w))
+    ew1 = F.attach_grad(F.clone(ew)) if use_edge_weight else None
+    with F.record_grad():
+        out1 = spmm_linear(g, x1, w1, ew1)
+        F.backward(F.reduce_sum(out1))
+        grad_x1, grad_w1 = F.grad(x1), F.grad(w1)
+        grad_ew1 = F.grad(ew1) if use_edge_weight else None
+
+    x2, w2 = F.attach_grad(F.clone(x)), F.attach_grad(F.clone(w))
+    ew2 = F.attach_grad(F.clone(ew)) if use_edge_weight else None
+    with F.record_grad():
+        if use_edge_weight:
+            h = gspmm(g, 'mul', 'sum', x2, F.reshape(ew2, (-1, 1)))
+        else:
+            h = gspmm(g, 'copy_lhs', 'sum', x2, None)
+        out2 = F.matmul(h, w2)
+        F.backward(F.reduce_sum(out2))
+    assert F.allclose(out1, out2)
+    assert F.allclose(grad_x1, F.grad(x2))
+    assert F.allclose(grad_w1, F.grad(w2))
+    if use_edge_weight:
+        assert F.allclose(grad_ew1, F.grad(ew2))
+
+@unittest.skipIf(F._default_context_str == 'gpu', reason="Typed SpMM is only implemented on CPU")
+@pytest.mark.parametrize('use_norm', [True, False])
+@parametrize_dtype
+def test_typed_spmm(idtype, use_norm):
+    num_types = 4
+    g = dgl.rand_graph(30, 200).astype(idtype).to(F.ctx())
+    etypes = F.tensor(np.random.randint(0, num_types, g.number_of_edges()), idtype)
+    x = F.tensor(np.random.rand(g.number_of_src_nodes(), 5))
+    w = F.tensor(np.random.rand(num_types, 5, 3))
+    norm = F.tensor(np.random.rand(g.number_of_edges(), 1)) if use_norm else None
+
+    x1, w1 = F.attach_grad(F.clone(x)), F.attach_grad(F.clone(w))
+    with F.record_grad():
+        out1 = typed_spmm(g, etypes, x1, w1, norm)
+        F.backward(F.reduce_sum(out1))
+        grad_x1, grad_w1 = F.grad(x1), F.grad(w1)
+
+    # reference: one gspmm per relation with the other relations masked out
+    x2, w2 = F.attach_grad(F.clone(x)), F.attach_grad(F.clone(w))
+    etypes_np = F.asnumpy(etypes)
+    norm_np = F.asnumpy(norm) if use_norm else np.ones((g.number_of_edges(), 1))
+    with F.record_grad():
+        out2 = None
+        for t in range(num_types):
+            mask = F.tensor((etypes_np == t)[:, None] * norm_np)
+            h = gspmm(g, 'mul', 'sum', F.matmul(x2, w2[t]), mask)
+            out2 = h if out2 is None else out2 + h
+        F.backward(F.reduce_sum(out2))
+    assert F.allclose(out1, out2)
+    assert F.allclose(grad_x1, F.grad(x2))
+    assert F.allclose(grad_w1, F.grad(w2))
+
+@pytest.mark.parametrize('reducer', ['sum', 'mean', 'max', 'min'])
+def test_segment_reduce(reducer):
+    seglen = np.array([3, 0, 5, 1, 4])
+    offsets = np.concatenate([[0], np.cumsum(seglen)])
+    x_np = np.random.rand(seglen.sum(), 2, 3)
+    dy_np = np.random.rand(len(seglen), 2, 3)
+    x = F.attach_grad(F.tensor(x_np))
+    with F.record_grad():
+        y = segment_reduce(F.tensor(seglen, F.int64), x, reducer)
+        F.backward(y, F.tensor(dy_np))
+
+    y_ref = np.zeros_like(dy_np)
+    dx_ref = np.zeros_like(x_np)
+    for i in range(len(seglen)):
+        seg = x_np[offsets[i]:offsets[i + 1]]
+        if len(seg) == 0:
+            continue
+        if reducer in ['sum', 'mean']:
+            scale = 1. / len(seg) if reducer == 'mean' else 1.
+            y_ref[i] = seg.sum(0) * scale
+            dx_ref[offsets[i]:offsets[i + 1]] = dy_np[i] * scale
+        else:
+            arg = seg.argmax(0) if reducer == 'max' else seg.argmin(0)
+            y_ref[i] = getattr(seg, reducer)(0)
+            np.put_along_axis(dx_ref[offsets[i]:offsets[i + 1]], arg[None], dy_np[i][None], 0)
+    assert F.allclose(y, F.tensor(y_ref))
+    assert F.allclose(F.grad(x), F.tensor(dx_ref))
+
+def test_segment_softmax():
+    seglen = np.array([3, 0, 5, 1, 4])
+    offsets = np.concatenate([[0], np.cumsum(seglen)])
+    x_np = np.random.rand(seglen.sum(), 3)
+    dy_np = np.random.rand(seglen.sum(), 3)
+    x = F.attach_grad(F.tensor(x_np))
+    with F.record_grad():
+        y = segment_softmax(F.tensor(seglen, F.int64), x)
+        F.backward(y, F.tensor(dy_np))
+
+    y_ref = np.zeros_like(x_np)
+    dx_ref = np.zeros_like(x_np)
+    for i in range(len(seglen)):
+        s = slice(offsets[i], offsets[i + 1])
+        if offsets[i] == offsets[i + 1]:
+            continue
+        e = np.exp(x_np[s] - x_np[s].max(0))
+        y_ref[s] = e / e.sum(0)
+        dx_ref[s] = y_ref[s] * (dy_np[s] - (y_ref[s] * dy_np[s]).sum(0))
+    assert F.allclose(y, F.tensor(y_ref))
+    assert F.allclose(F.grad(x), F.tensor(dx_ref))
+
+@unittest.skipIf(F._default_context_str == 'gpu', reason="Segment kernels are only implemented on CPU")
+def test_segment_invalid():
+    x = F.tensor(np.random.rand(6, 3))
+    # sums up to the number of rows, but a segment has a negative length
+    seglen = F.tensor([3, -2, 5], F.int64)
+    with pytest.raises(dgl.DGLError):
+        segment_reduce(seglen, x, 'sum')
+    with pytest.raises(dgl.DGLError):
+        segment_softmax(seglen, x)
+    # decreasing offsets are rejected by the kernel
+    offsets = F.tensor([0, 100, 6], F.int64)
+    for reducer in ['sum', 'max']:
+        with pytest.raises(dgl.DGLError):
+            dgl.backend.segment_reduce(reducer, x, offsets)
+
 if __name__ == '__main__':
     test_spmm(F.int32, graphs[0], spmm_shapes[5], 'copy_lhs', 'sum')
@@ -303,6 +303,38 @@ def test_spmv_3d_feat(idtype):
     g.update_all(message_func=src_mul_edge_udf, reduce_func=sum_udf) # 3
     assert F.allclose(g.ndata['h'], ans)
 
+def test_padded_degree_bucketing():
+    from dgl._deprecate.runtime import degree_bucketing
+    # node v receives a message from every u < v
+    src, dst = zip(*[(u, v) for v in range(10) for u in range(v)])
+    g = dgl.DGLGraphStale()
+    g.add_nodes(10)
+    g.add_edges(list(src), list(dst))
+    g.ndata['h'] = F.copy_to(F.tensor(np.arange(10, dtype=np.float32).reshape(10, 1)), F.ctx())
+    calls = []
+    def reduce_func(nodes):
+        mask = nodes.mailbox_mask
+        calls.append(mask)
+        msg = nodes.mailbox['m']
+        if mask is not None:
+            msg = msg * F.unsqueeze(mask, 2)
+        return {'s': F.sum(msg, 1)}
+    expected = np.arange(10) * (np.arange(10) - 1) / 2
+    try:
+        for max_buckets in [None, 3, 0]:
+            degree_bucketing.set_padded_bucketing(max_buckets)
+            del calls[:]
+            g.update_all(lambda edges: {'m': edges.src['h']}, reduce_func)
+            assert np.allclose(F.asnumpy(g.ndata['s'])[:, 0], expected)
+            if max_buckets is None:
+                assert len(calls) == 9 and all(m is None for m in calls)
+            else:
+                assert all(m is not None for m in calls)
+                if max_buckets > 0:
+                    assert len(calls) <= max_buckets
+    finally:
+        degree_bucketing.set_padded_bucketing(None)
+
 if __name__ == '__main__':
     test_v2v_update_all()
     test_v2v_snr()
@@ -315,3 +347,4 @@ if __name__ == '__main__':
     test_update_all_multi_fallback()
     test_pull_multi_fallback()
     test_spmv_3d_feat()
+    test_padded_degree_bucketing()
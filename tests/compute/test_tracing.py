@@ -0,0 +1,31 @@
+import json
+import dgl
+import dgl.function as fn
+import backend as F
+
+def test_tracing():
+    g = dgl.rand_graph(100, 1000)
+    g.ndata['h'] = F.randn((100, 8))
+    with dgl.tracing.trace():
+        assert dgl.tracing.is_enabled()
+        g.update_all(fn.copy_u('h', 'm'), fn.sum('m', 'h2'))
+        g.update_all(fn.copy_u('h', 'm'), fn.sum('m', 'h2'))
+    assert not dgl.tracing.is_enabled()
+
+    stats = dgl.tracing.get_stats()
+    assert stats['SpMM']['count'] == 2
+    assert stats['SpMM']['edges'] == 2000
+    assert stats['SpMM']['bytes'] > 0
+    assert stats['SpMM']['min_ms'] <= stats['SpMM']['max_ms']
+
+    trace = json.loads(dgl.tracing.dump_chrome_trace())
+    names = [e['name'] for e in trace['traceEvents']]
+    assert names.count('SpMM') == 2
+
+    # disabled tracing records nothing
+    dgl.tracing.clear()
+    g.update_all(fn.copy_u('h', 'm'), fn.sum('m', 'h2'))
+    assert 'SpMM' not in dgl.tracing.get_stats()
+
+if __name__ == '__main__':
+    test_tracing()
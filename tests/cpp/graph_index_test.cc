@@ -5,9 +5,76 @@
  */
 #include <gtest/gtest.h>
 #include <dgl/graph.h>
+#include <dgl/array.h>
+#include <vector>
 
 TEST(GraphTest, TestNumVertices){
   dgl::Graph g;
   g.AddVertices(10);
   ASSERT_EQ(g.NumVertices(), 10);
 };
+
+TEST(GraphTest, TestAddEdges) {
+  // a batch large enough to take the bulk path, then single edges that
+  // force slots to move
+  const int64_t num_nodes = 50, num_edges = 500;
+  std::vector<int64_t> src(num_edges), dst(num_edges);
+  for (int64_t i = 0; i < num_edges; ++i) {
+    src[i] = (i * 7) % num_nodes;
+    dst[i] = (i * 13 + 1) % num_nodes;
+  }
+  dgl::Graph g(dgl::aten::VecToIdArray(src), dgl::aten::VecToIdArray(dst), num_nodes);
+  for (int64_t i = 0; i < 20; ++i) {
+    g.AddEdge(3, i);
+    src.push_back(3);
+    dst.push_back(i);
+  }
+  // a second bulk batch touching a few vertices only, some of which must grow
+  std::vector<int64_t> batch_src, batch_dst;
+  for (int64_t i = 0; i < 100; ++i) {
+    batch_src.push_back((i % 4) * 11);
+    batch_dst.push_back(i % num_nodes);
+  }
+  g.AddEdges(dgl::aten::VecToIdArray(batch_src), dgl::aten::VecToIdArray(batch_dst));
+  src.insert(src.end(), batch_src.begin(), batch_src.end());
+  dst.insert(dst.end(), batch_dst.begin(), batch_dst.end());
+  g.AddVertices(2);
+  g.AddEdge(num_nodes, num_nodes + 1);
+  src.push_back(num_nodes);
+  dst.push_back(num_nodes + 1);
+  ASSERT_EQ(g.NumVertices(), num_nodes + 2);
+  ASSERT_EQ(g.NumEdges(), src.size());
+
+  // every vertex lists its edges in edge id order
+  std::vector<std::vector<dgl::dgl_id_t>> out(num_nodes + 2), in(num_nodes + 2);
+  for (size_t e = 0; e < src.size(); ++e) {
+    out[src[e]].push_back(e);
+    in[dst[e]].push_back(e);
+  }
+  for (int64_t v = 0; v < num_nodes + 2; ++v) {
+    const auto out_eids = g.OutEdgeVec(v);
+    const auto succ = g.SuccVec(v);
+    ASSERT_EQ(out_eids.size(), out[v].size());
+    for (size_t j = 0; j < out[v].size(); ++j) {
+      ASSERT_EQ(out_eids[j], out[v][j]);
+      ASSERT_EQ(succ[j], dst[out[v][j]]);
+    }
+    const auto in_eids = g.InEdgeVec(v);
+    ASSERT_EQ(in_eids.size(), in[v].size());
+    for (size_t j = 0; j < in[v].size(); ++j)
+      ASSERT_EQ(in_eids[j], in[v][j]);
+  }
+
+  // CSR export follows the same order
+  const auto adj = g.GetAdj(true, "csr");
+  const int64_t* indptr = static_cast<int64_t*>(adj[0]->data);
+  const int64_t* indices = static_cast<int64_t*>(adj[1]->data);
+  const int64_t* eids = static_cast<int64_t*>(adj[2]->data);
+  for (int64_t v = 0; v < num_nodes + 2; ++v) {
+    ASSERT_EQ(indptr[v + 1] - indptr[v], out[v].size());
+    for (int64_t j = indptr[v]; j < indptr[v + 1]; ++j) {
+      ASSERT_EQ(eids[j], out[v][j - indptr[v]]);
+      ASSERT_EQ(indices[j], dst[eids[j]]);
+    }
+  }
+}
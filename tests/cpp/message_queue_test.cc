@@ -4,6 +4,7 @@
  * \brief Message queue for DGL distributed training.
  */
 #include <gtest/gtest.h>
+#include <chrono>
 #include <string>
 #include <thread>
 #include <vector>
@@ -102,3 +103,31 @@ TEST(MessageQueueTest, MultiThread) {
   }
   EXPECT_EQ(queue.EmptyAndNoMoreAdd(), true);
 }
+
+TEST(MessageQueueTest, Metrics) {
+  MessageQueue queue(5, 1);
+  auto metrics = queue.metrics();
+  EXPECT_EQ(metrics->capacity.load(), 5);
+  std::string str("1111");
+  Message msg_1 = {const_cast<char*>(str.data()), 3};
+  Message msg_2 = {const_cast<char*>(str.data()), 2};
+  EXPECT_EQ(queue.Add(msg_1), ADD_SUCCESS);
+  EXPECT_EQ(queue.Add(msg_2), ADD_SUCCESS);
+  EXPECT_EQ(metrics->used.load(), 5);
+  EXPECT_EQ(metrics->high_water.load(), 5);
+  // the producer blocks until the consumer makes room
+  std::thread producer([&queue, &str] {
+    Message msg_3 = {const_cast<char*>(str.data()), 4};
+    EXPECT_EQ(queue.Add(msg_3), ADD_SUCCESS);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  Message msg;
+  EXPECT_EQ(queue.Remove(&msg), REMOVE_SUCCESS);
+  EXPECT_GT(msg.enqueue_ns, 0);
+  EXPECT_EQ(queue.Remove(&msg), REMOVE_SUCCESS);
+  producer.join();
+  EXPECT_EQ(metrics->used.load(), 4);
+  EXPECT_EQ(metrics->high_water.load(), 5);
+  EXPECT_GE(metrics->blocked_add_ns.load(), 10 * 1000 * 1000);
+  EXPECT_EQ(metrics->blocked_remove_ns.load(), 0);
+}
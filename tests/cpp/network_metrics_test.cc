@@ -0,0 +1,113 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file network_metrics_test.cc
+ * \brief Test the network metrics.
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/rpc/network/metrics.h"
+
+using dgl::network::LatencyHistogram;
+using dgl::network::NetworkMetrics;
+using dgl::network::QueueMetrics;
+
+TEST(NetworkMetricsTest, HistogramBuckets) {
+  // small values have exact buckets
+  for (int64_t v = 0; v < LatencyHistogram::kSubBuckets; ++v) {
+    EXPECT_EQ(LatencyHistogram::BucketIndex(v), v);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(v), v);
+  }
+  // every value is within its bucket, whose width is bounded relative to the value
+  int prev_index = 0;
+  for (int64_t v = 1; v < (int64_t(1) << 40); v = v * 3 / 2 + 1) {
+    const int index = LatencyHistogram::BucketIndex(v);
+    EXPECT_GE(index, prev_index);
+    EXPECT_LT(index, LatencyHistogram::kNumBuckets);
+    const int64_t upper = LatencyHistogram::BucketUpperBound(index);
+    EXPECT_GE(upper, v);
+    if (index > 0) {
+      EXPECT_LT(LatencyHistogram::BucketUpperBound(index - 1), v);
+    }
+    EXPECT_LE(upper - v, v / LatencyHistogram::kSubBuckets);
+    prev_index = index;
+  }
+  EXPECT_LT(LatencyHistogram::BucketIndex(INT64_MAX), LatencyHistogram::kNumBuckets);
+  EXPECT_EQ(LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketIndex(INT64_MAX)),
+            INT64_MAX);
+}
+
+TEST(NetworkMetricsTest, HistogramQuantile) {
+  LatencyHistogram hist;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&hist] {
+      for (int64_t v = 1; v <= 1000; ++v)
+        hist.Record(v * 1000);
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+  const LatencyHistogram::Snapshot s = hist.GetSnapshot();
+  EXPECT_EQ(s.count, 4000);
+  EXPECT_EQ(s.sum, 4 * 500500 * 1000);
+  EXPECT_EQ(s.max, 1000 * 1000);
+  EXPECT_EQ(s.Quantile(1.0), 1000 * 1000);
+  EXPECT_NEAR(s.Quantile(0.5), 500 * 1000, 500 * 1000 / 16);
+  EXPECT_NEAR(s.Quantile(0.99), 990 * 1000, 990 * 1000 / 16);
+  hist.Reset();
+  EXPECT_EQ(hist.GetSnapshot().count, 0);
+  EXPECT_EQ(hist.GetSnapshot().Quantile(0.5), 0);
+}
+
+TEST(NetworkMetricsTest, SnapshotAndReset) {
+  NetworkMetrics* registry = NetworkMetrics::Global();
+  auto queue = std::make_shared<QueueMetrics>();
+  queue->capacity = 100;
+  queue->UpdateUsed(60);
+  queue->UpdateUsed(10);
+  auto conn = registry->GetConnection("send", 7, "127.0.0.1:50091", queue);
+  // the same peer maps to the same entry
+  ASSERT_EQ(registry->GetConnection("send", 7, "127.0.0.1:50091", queue), conn);
+  conn->msgs += 2;
+  conn->bytes += 300;
+  conn->latency.Record(2000);
+  registry->GetMessageType(901231)->sent_msgs += 1;
+
+  std::string json = registry->SnapshotJSON();
+  EXPECT_NE(json.find("\"direction\": \"send\", \"peer_id\": 7, "
+                      "\"addr\": \"127.0.0.1:50091\", \"msgs\": 2, \"bytes\": 300"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"used\": 10, \"high_water\": 60"), std::string::npos);
+  EXPECT_NE(json.find("\"service_id\": 901231, \"sent_msgs\": 1"), std::string::npos);
+  EXPECT_NE(json.find("\"max_us\": 2.000"), std::string::npos);
+
+  registry->Reset();
+  EXPECT_EQ(conn->msgs.load(), 0);
+  EXPECT_EQ(conn->latency.GetSnapshot().count, 0);
+  EXPECT_EQ(queue->high_water.load(), 10);
+  json = registry->SnapshotJSON();
+  EXPECT_NE(json.find("\"service_id\": 901231, \"sent_msgs\": 0"), std::string::npos);
+}
+
+TEST(NetworkMetricsTest, MessageTypeFromThreads) {
+  NetworkMetrics* registry = NetworkMetrics::Global();
+  dgl::network::MessageTypeMetrics* type = registry->GetMessageType(901232);
+  const int64_t before = type->recv_msgs.load();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([registry, type] () {
+      for (int i = 0; i < 1000; ++i) {
+        // every thread resolves the same entry, from its cache after the first call
+        dgl::network::MessageTypeMetrics* entry = registry->GetMessageType(901232);
+        ASSERT_EQ(entry, type);
+        entry->recv_msgs.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (auto& th : threads)
+    th.join();
+  EXPECT_EQ(type->recv_msgs.load() - before, 4000);
+}
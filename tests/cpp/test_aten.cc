@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <dgl/array.h>
+#include <algorithm>
+#include <random>
 #include "./common.h"
 
 using namespace dgl;
@@ -781,6 +783,68 @@ TEST(DisjointUnionTest, TestDisjointUnionPartitionCsr) {
 #endif
 }
 
+template <typename IdType>
+void _TestDisjointUnionPartitionCsrNoData(DLContext ctx) {
+  /*
+   * A = [[0, 1],
+   *      [1, 1]]
+   *
+   * B is a 1x1 matrix with no entries.
+   *
+   * C = [[1, 0, 1]]
+   *
+   * ABC = [[0, 1, 0, 0, 0, 0],
+   *        [1, 1, 0, 0, 0, 0],
+   *        [0, 0, 0, 0, 0, 0],
+   *        [0, 0, 0, 1, 0, 1]]
+   */
+  const aten::CSRMatrix csr_a(
+    2, 2,
+    aten::VecToIdArray(std::vector<IdType>({0, 1, 3}), sizeof(IdType)*8, CTX),
+    aten::VecToIdArray(std::vector<IdType>({1, 0, 1}), sizeof(IdType)*8, CTX),
+    aten::NullArray(), true);
+  const aten::CSRMatrix csr_b(
+    1, 1,
+    aten::VecToIdArray(std::vector<IdType>({0, 0}), sizeof(IdType)*8, CTX),
+    aten::VecToIdArray(std::vector<IdType>({}), sizeof(IdType)*8, CTX),
+    aten::NullArray(), true);
+  const aten::CSRMatrix csr_c(
+    1, 3,
+    aten::VecToIdArray(std::vector<IdType>({0, 2}), sizeof(IdType)*8, CTX),
+    aten::VecToIdArray(std::vector<IdType>({0, 2}), sizeof(IdType)*8, CTX),
+    aten::NullArray(), true);
+
+  const aten::CSRMatrix csr_abc = aten::DisjointUnionCsr({csr_a, csr_b, csr_c});
+  ASSERT_EQ(csr_abc.num_rows, 4);
+  ASSERT_EQ(csr_abc.num_cols, 6);
+  ASSERT_TRUE(ArrayEQ<IdType>(csr_abc.indptr,
+      aten::VecToIdArray(std::vector<IdType>({0, 1, 3, 3, 5}), sizeof(IdType)*8, CTX)));
+  ASSERT_TRUE(ArrayEQ<IdType>(csr_abc.indices,
+      aten::VecToIdArray(std::vector<IdType>({1, 0, 1, 3, 5}), sizeof(IdType)*8, CTX)));
+  ASSERT_FALSE(aten::CSRHasData(csr_abc));
+  ASSERT_TRUE(csr_abc.sorted);
+
+  const auto p_csrs = aten::DisjointPartitionCsrBySizes(
+    csr_abc, 3, {0, 3, 3, 5}, {0, 2, 3, 4}, {0, 2, 3, 6});
+  ASSERT_EQ(p_csrs.size(), 3);
+  const std::vector<aten::CSRMatrix> csrs({csr_a, csr_b, csr_c});
+  for (size_t i = 0; i < csrs.size(); ++i) {
+    ASSERT_EQ(p_csrs[i].num_rows, csrs[i].num_rows);
+    ASSERT_EQ(p_csrs[i].num_cols, csrs[i].num_cols);
+    ASSERT_TRUE(ArrayEQ<IdType>(p_csrs[i].indptr, csrs[i].indptr));
+    ASSERT_TRUE(ArrayEQ<IdType>(p_csrs[i].indices, csrs[i].indices));
+    ASSERT_FALSE(aten::CSRHasData(p_csrs[i]));
+  }
+  // the first component needs no shifting and shares memory with the batch
+  ASSERT_EQ(p_csrs[0].indptr->data, csr_abc.indptr->data);
+  ASSERT_EQ(p_csrs[0].indices->data, csr_abc.indices->data);
+}
+
+TEST(DisjointUnionTest, TestDisjointUnionPartitionCsrNoData) {
+  _TestDisjointUnionPartitionCsrNoData<int32_t>(CPU);
+  _TestDisjointUnionPartitionCsrNoData<int64_t>(CPU);
+}
+
 template <typename IdType>
 void _TestMatrixUnionCsr(DLContext ctx) {
  /* 
@@ -1417,6 +1481,66 @@ TEST(LineGraphTest, LineGraphCOO) {
   _TestLineGraphCOO<int64_t>(CPU);
 }
 
+template <typename IdType>
+void _TestLineGraphCSR(DLContext ctx) {
+  // A random graph with self-loops, parallel and reciprocal edges, whose edge IDs
+  // are shuffled, against the definition of the line graph.
+  const int64_t num_nodes = 30, nnz = 200;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<IdType> node(0, num_nodes - 1);
+  std::vector<IdType> row(nnz), col(nnz), eid(nnz);
+  for (int64_t i = 0; i < nnz; ++i) {
+    row[i] = node(rng);
+    col[i] = node(rng);
+    eid[i] = i;
+  }
+  std::sort(row.begin(), row.end());
+  std::shuffle(eid.begin(), eid.end(), rng);
+  const aten::COOMatrix coo(
+    num_nodes, num_nodes,
+    aten::VecToIdArray(row, sizeof(IdType)*8, ctx),
+    aten::VecToIdArray(col, sizeof(IdType)*8, ctx),
+    aten::VecToIdArray(eid, sizeof(IdType)*8, ctx),
+    true, false);
+  const aten::CSRMatrix csr = aten::COOToCSR(coo);
+
+  for (bool backtracking : {false, true}) {
+    // edge IDs stand for the edges they are assigned to
+    std::vector<IdType> src(nnz), dst(nnz);
+    for (int64_t i = 0; i < nnz; ++i) {
+      src[eid[i]] = row[i];
+      dst[eid[i]] = col[i];
+    }
+    std::vector<IdType> indptr(1, 0), indices;
+    for (int64_t i = 0; i < nnz; ++i) {
+      for (int64_t j = 0; j < nnz; ++j) {
+        if (i != j && dst[i] == src[j] && (backtracking || dst[j] != src[i]))
+          indices.push_back(j);
+      }
+      indptr.push_back(indices.size());
+    }
+
+    const aten::CSRMatrix lg = aten::CSRLineGraph(csr, backtracking);
+    ASSERT_EQ(lg.num_rows, nnz);
+    ASSERT_EQ(lg.num_cols, nnz);
+    ASSERT_TRUE(lg.sorted);
+    ASSERT_FALSE(aten::CSRHasData(lg));
+    ASSERT_TRUE(ArrayEQ<IdType>(lg.indptr, aten::VecToIdArray(indptr, sizeof(IdType)*8, ctx)));
+    ASSERT_TRUE(ArrayEQ<IdType>(lg.indices, aten::VecToIdArray(indices, sizeof(IdType)*8, ctx)));
+
+    // the COO line graph, numbered by edge ID, has the same edges
+    const aten::COOMatrix lg_coo = aten::COOLineGraph(coo, backtracking);
+    const aten::CSRMatrix lg_coo_csr = aten::CSRSort(aten::COOToCSR(lg_coo));
+    ASSERT_TRUE(ArrayEQ<IdType>(lg_coo_csr.indptr, lg.indptr));
+    ASSERT_TRUE(ArrayEQ<IdType>(lg_coo_csr.indices, lg.indices));
+  }
+}
+
+TEST(LineGraphTest, LineGraphCSR) {
+  _TestLineGraphCSR<int32_t>(CPU);
+  _TestLineGraphCSR<int64_t>(CPU);
+}
+
 template <typename IDX>
 void _TestSort(DLContext ctx) {
   // case 1
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/packed_func_ext.h>
+#include <dgl/runtime/container.h>
+#include <vector>
+#include "./common.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+TEST(FFITest, TestNDArrayList) {
+  const std::vector<NDArray> arrays = {
+    aten::Range(0, 4, 64, CTX), aten::NullArray(), aten::Range(2, 5, 32, CTX)};
+  PackedFunc f([] (DGLArgs args, DGLRetValue* rv) {
+      const auto& vec = ListValueToVector<NDArray>(args[0]);
+      List<Value> ret;
+      for (const NDArray& arr : vec)
+        ret.push_back(Value(MakeValue(arr)));
+      *rv = ret;
+    });
+  auto check = [&arrays] (List<Value> ret) {
+    ASSERT_EQ(ret.size(), arrays.size());
+    for (size_t i = 0; i < arrays.size(); ++i) {
+      NDArray arr = ret[i]->data;
+      ASSERT_EQ(arr->data, arrays[i]->data);
+    }
+  };
+
+  List<Value> list;
+  for (const NDArray& arr : arrays)
+    list.push_back(Value(MakeValue(arr)));
+  check(f(list));
+
+  std::vector<DGLArrayHandle> handles;
+  for (const NDArray& arr : arrays)
+    handles.push_back(const_cast<DGLArrayHandle>(arr.operator->()));
+  DGLArrayHandleList packed{handles.data(), static_cast<int64_t>(handles.size())};
+  check(f(static_cast<void*>(&packed)));
+
+  DGLArrayHandleList empty{nullptr, 0};
+  List<Value> ret = f(static_cast<void*>(&empty));
+  ASSERT_EQ(ret.size(), 0);
+}
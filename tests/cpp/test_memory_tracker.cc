@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/runtime/memory_tracker.h>
+#include <string>
+#include "../../src/graph/unit_graph.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+namespace {
+
+memory::TagStats FindStats(const std::string& tag) {
+  for (const auto& stats : memory::GetStats()) {
+    if (stats.tag == tag)
+      return stats;
+  }
+  return memory::TagStats();
+}
+
+}  // namespace
+
+TEST(MemoryTrackerTest, TestTags) {
+  memory::EnableTracking();
+  {
+    memory::ScopedTag tag("TestTags");
+    IdArray arr = aten::NewIdArray(100);
+    IdArray view = arr.CreateView({50}, arr->dtype);
+    memory::TagStats stats = FindStats("TestTags");
+    // views are not counted
+    ASSERT_EQ(stats.live_bytes, 800);
+    ASSERT_EQ(stats.live_arrays, 1);
+    ASSERT_EQ(stats.total_allocs, 1);
+    {
+      memory::ScopedTag inner("TestTagsInner");
+      IdArray tmp = aten::NewIdArray(10);
+      ASSERT_EQ(FindStats("TestTagsInner").live_bytes, 80);
+    }
+    ASSERT_EQ(FindStats("TestTagsInner").live_bytes, 0);
+    ASSERT_EQ(FindStats("TestTagsInner").peak_bytes, 80);
+    // the tag of the outer scope is restored
+    IdArray arr2 = aten::NewIdArray(25);
+    ASSERT_EQ(FindStats("TestTags").live_bytes, 1000);
+    ASSERT_EQ(memory::CurrentTag(), memory::GetTagID("TestTags"));
+  }
+  ASSERT_EQ(memory::CurrentTag(), memory::kUntaggedTag);
+  memory::TagStats stats = FindStats("TestTags");
+  ASSERT_EQ(stats.live_bytes, 0);
+  ASSERT_EQ(stats.live_arrays, 0);
+  ASSERT_EQ(stats.peak_bytes, 1000);
+  ASSERT_EQ(stats.total_allocs, 2);
+
+  // arrays tracked before disabling are released when freed
+  IdArray arr;
+  {
+    memory::ScopedTag tag("TestTags");
+    arr = aten::NewIdArray(10);
+  }
+  memory::DisableTracking();
+  {
+    memory::ScopedTag tag("TestTags");
+    IdArray untracked = aten::NewIdArray(10);
+    ASSERT_EQ(FindStats("TestTags").live_bytes, 80);
+  }
+  arr = IdArray();
+  ASSERT_EQ(FindStats("TestTags").live_bytes, 0);
+  memory::ResetPeaks();
+  ASSERT_EQ(FindStats("TestTags").peak_bytes, 0);
+}
+
+TEST(MemoryTrackerTest, TestGraphFootprint) {
+  IdArray src = aten::VecToIdArray(std::vector<int64_t>({0, 0, 1, 2}));
+  IdArray dst = aten::VecToIdArray(std::vector<int64_t>({1, 2, 2, 0}));
+  auto g = std::dynamic_pointer_cast<UnitGraph>(UnitGraph::CreateFromCOO(1, 3, 3, src, dst));
+  auto fp = g->GetMemoryFootprint();
+  ASSERT_EQ(fp.size(), 3);
+  ASSERT_TRUE(fp[0].created);
+  ASSERT_EQ(fp[0].materialized_ms, -1);
+  ASSERT_EQ(fp[0].bytes, 64);
+  ASSERT_EQ(fp[0].shared_bytes, 0);
+  ASSERT_FALSE(fp[1].created);
+  ASSERT_FALSE(fp[2].created);
+
+  memory::EnableTracking();
+  g->GetInCSR();
+  memory::DisableTracking();
+  fp = g->GetMemoryFootprint();
+  ASSERT_FALSE(fp[1].created);
+  ASSERT_TRUE(fp[2].created);
+  ASSERT_GT(fp[2].materialized_ms, 0);
+  // indptr, indices and edge IDs
+  ASSERT_EQ(fp[2].bytes, (4 + 4 + 4) * 8);
+  ASSERT_GE(FindStats("GraphFormat").live_bytes, fp[2].bytes);
+}
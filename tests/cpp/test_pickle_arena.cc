@@ -0,0 +1,71 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file test_pickle_arena.cc
+ * \brief Test pickling graphs through shared memory arenas
+ */
+#ifndef _WIN32
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/base_heterograph.h>
+#include <vector>
+#include "./common.h"
+#include "../../src/graph/shared_mem_arena.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+namespace {
+
+template <typename IdType>
+void _TestPickleArena() {
+  const int nbits = sizeof(IdType) * 8;
+  const std::vector<IdType> src = {0, 1, 2, 3, 1}, dst = {1, 2, 3, 0, 3};
+  auto make_coo = [&] () {
+    return CreateFromCOO(1, 4, 4,
+                         aten::VecToIdArray(src, nbits, CTX),
+                         aten::VecToIdArray(dst, nbits, CTX));
+  };
+  auto coo_g = make_coo();
+  // A graph with only a CSC, like a block.
+  auto csc_g = CreateFromCSC(1, make_coo()->GetCSCMatrix(0));
+
+  ArenaPool::Global()->Clear();
+  for (auto g : {coo_g, csc_g}) {
+    const dgl_format_code_t created = g->GetRelationGraph(0)->GetCreatedFormats();
+    const HeteroPickleStates states = HeteroPickleToSharedMem(g);
+    ASSERT_EQ(states.version, 2);
+    ASSERT_TRUE(states.arrays.empty());
+    {
+      auto new_g = HeteroUnpickleFromSharedMem(states);
+      ASSERT_EQ(new_g->GetRelationGraph(0)->GetCreatedFormats(), created);
+      const EdgeArray edges = g->Edges(0, "eid");
+      const EdgeArray new_edges = new_g->Edges(0, "eid");
+      ASSERT_TRUE(ArrayEQ<IdType>(edges.src, new_edges.src));
+      ASSERT_TRUE(ArrayEQ<IdType>(edges.dst, new_edges.dst));
+      ASSERT_EQ(ArenaPool::Global()->GetStats().num_free, 0);
+    }
+    // The arena is returned once the unpickled graph is freed, and reused next.
+    const ArenaPool::Stats stats = ArenaPool::Global()->GetStats();
+    ASSERT_EQ(stats.num_arenas, 1);
+    ASSERT_EQ(stats.num_free, 1);
+  }
+
+  // A pickle that is not unpickled yet keeps its arena.
+  const HeteroPickleStates pending = HeteroPickleToSharedMem(coo_g);
+  const HeteroPickleStates other = HeteroPickleToSharedMem(coo_g);
+  ASSERT_EQ(ArenaPool::Global()->GetStats().num_arenas, 2);
+  HeteroUnpickleFromSharedMem(other);
+  ArenaPool::Global()->Clear();
+  ASSERT_EQ(ArenaPool::Global()->GetStats().num_arenas, 1);
+  HeteroUnpickleFromSharedMem(pending);
+  ArenaPool::Global()->Clear();
+  ASSERT_EQ(ArenaPool::Global()->GetStats().num_arenas, 0);
+}
+
+}  // namespace
+
+TEST(PickleArenaTest, TestPickleArena) {
+  _TestPickleArena<int32_t>();
+  _TestPickleArena<int64_t>();
+}
+#endif  // _WIN32
@@ -264,6 +264,86 @@ TEST(RowwiseTest, TestCOOSamplingUniform) {
   _TestCOOSamplingUniform<int64_t, double>(false);
 }
 
+template <typename Idx, typename FloatType>
+void _TestRowWiseSamplingExclude(bool has_data, bool uniform) {
+  const auto csr = CSR<Idx>(has_data);
+  const auto coo = COO<Idx>(has_data);
+  FloatArray prob = uniform? aten::NullArray() : NDArray::FromVector(
+      std::vector<FloatType>({.5, .5, .5, .5, .5}));
+  IdArray rows = NDArray::FromVector(std::vector<Idx>({0, 1, 3}));
+  // Exclude the first edge of rows 0 and 3 and the only edge of row 1, by their IDs.
+  IdArray exclude = has_data?
+    NDArray::FromVector(std::vector<Idx>({4, 2, 0, 2})) :
+    NDArray::FromVector(std::vector<Idx>({0, 2, 3}));
+  std::set<ETuple<Idx>> expected;
+  if (has_data) {
+    expected.insert(ETuple<Idx>{0, 1, 3});
+    expected.insert(ETuple<Idx>{3, 2, 1});
+  } else {
+    expected.insert(ETuple<Idx>{0, 1, 1});
+    expected.insert(ETuple<Idx>{3, 3, 4});
+  }
+  for (int k = 0; k < 10; ++k) {
+    for (bool replace : {true, false}) {
+      // Every row still gets one pick if it has any edge left.
+      auto rst = CSRRowWiseSampling(csr, rows, 1, prob, replace, exclude);
+      CheckSampledResult<Idx>(rst, rows, has_data);
+      ASSERT_EQ(ToEdgeSet<Idx>(rst), expected);
+      rst = COORowWiseSampling(coo, rows, 1, prob, replace, exclude);
+      CheckSampledResult<Idx>(rst, rows, has_data);
+      ASSERT_EQ(ToEdgeSet<Idx>(rst), expected);
+    }
+    // With replacement, no pick is ever an excluded edge.
+    auto rst = CSRRowWiseSampling(csr, rows, 2, prob, true, exclude);
+    ASSERT_EQ(rst.row->shape[0], 4);
+    ASSERT_EQ(ToEdgeSet<Idx>(rst), expected);
+  }
+}
+
+TEST(RowwiseTest, TestRowWiseSamplingExclude) {
+  for (bool uniform : {true, false}) {
+    _TestRowWiseSamplingExclude<int32_t, float>(true, uniform);
+    _TestRowWiseSamplingExclude<int64_t, float>(true, uniform);
+    _TestRowWiseSamplingExclude<int32_t, double>(false, uniform);
+    _TestRowWiseSamplingExclude<int64_t, double>(false, uniform);
+  }
+}
+
+template <typename Idx, typename FloatType>
+void _TestCSRSamplingWithCounts(bool has_data, bool uniform) {
+  const auto mat = CSR<Idx>(has_data);
+  FloatArray prob = uniform? aten::NullArray() : NDArray::FromVector(
+      std::vector<FloatType>({.5, .5, .5, .5, .5}));
+  // Repeated and empty rows still get a count each.
+  IdArray rows = NDArray::FromVector(std::vector<Idx>({0, 0, 2, 1, 3}));
+  for (bool replace : {true, false}) {
+    auto rst = CSRRowWiseSamplingWithCounts(mat, rows, 2, prob, replace);
+    CheckSampledResult<Idx>(rst.first, rows, has_data);
+    ASSERT_EQ(rst.second->shape[0], 5);
+    const int64_t* counts = static_cast<int64_t*>(rst.second->data);
+    const std::vector<int64_t> expected = replace?
+      std::vector<int64_t>({2, 2, 0, 2, 2}) : std::vector<int64_t>({2, 2, 0, 1, 2});
+    const Idx* row = static_cast<Idx*>(rst.first.row->data);
+    int64_t start = 0;
+    for (int64_t i = 0; i < 5; ++i) {
+      ASSERT_EQ(counts[i], expected[i]);
+      for (int64_t j = start; j < start + counts[i]; ++j)
+        ASSERT_EQ(row[j], rows.Ptr<Idx>()[i]);
+      start += counts[i];
+    }
+    ASSERT_EQ(start, rst.first.row->shape[0]);
+  }
+}
+
+TEST(RowwiseTest, TestCSRSamplingWithCounts) {
+  for (bool uniform : {true, false}) {
+    _TestCSRSamplingWithCounts<int32_t, float>(true, uniform);
+    _TestCSRSamplingWithCounts<int64_t, float>(true, uniform);
+    _TestCSRSamplingWithCounts<int32_t, double>(false, uniform);
+    _TestCSRSamplingWithCounts<int64_t, double>(false, uniform);
+  }
+}
+
 template <typename Idx, typename FloatType>
 void _TestCSRTopk(bool has_data) {
   auto mat = CSR<Idx>(has_data);
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/scheduler.h>
+#include <vector>
+#include "./common.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+template <typename IDX>
+void _TestDegreeBucketing() {
+  // messages 10..16 sent to dst 3,1,3,5,1,3,6; node 0 and 4 receive nothing
+  IdArray mids = NDArray::FromVector(std::vector<IDX>({10, 11, 12, 13, 14, 15, 16}));
+  IdArray vids = NDArray::FromVector(std::vector<IDX>({3, 1, 3, 5, 1, 3, 6}));
+  IdArray recv = NDArray::FromVector(std::vector<IDX>({0, 1, 3, 4, 5, 6}));
+  auto ret = sched::DegreeBucketing<IDX>(mids, vids, recv);
+  ASSERT_EQ(ret.size(), 5);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[0], NDArray::FromVector(std::vector<IDX>({1, 2, 3, 0}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[1], NDArray::FromVector(std::vector<IDX>({5, 6, 1, 3, 0, 4}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[2], NDArray::FromVector(std::vector<IDX>({2, 1, 1, 2}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[3],
+        NDArray::FromVector(std::vector<IDX>({13, 16, 11, 14, 10, 12, 15}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[4], NDArray::FromVector(std::vector<IDX>({2, 2, 3}))));
+
+  // no zero degree node
+  recv = NDArray::FromVector(std::vector<IDX>({1, 3, 5, 6}));
+  ret = sched::DegreeBucketing<IDX>(mids, vids, recv);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[0], NDArray::FromVector(std::vector<IDX>({1, 2, 3}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[1], NDArray::FromVector(std::vector<IDX>({5, 6, 1, 3}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[2], NDArray::FromVector(std::vector<IDX>({2, 1, 1}))));
+}
+
+template <typename IDX>
+void _TestGroupEdgeByNodeDegree() {
+  IdArray uids = NDArray::FromVector(std::vector<IDX>({2, 0, 2, 1, 0, 2}));
+  IdArray vids = NDArray::FromVector(std::vector<IDX>({5, 6, 7, 8, 9, 4}));
+  IdArray eids = NDArray::FromVector(std::vector<IDX>({0, 1, 2, 3, 4, 5}));
+  auto ret = sched::GroupEdgeByNodeDegree<IDX>(uids, vids, eids);
+  ASSERT_EQ(ret.size(), 5);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[0], NDArray::FromVector(std::vector<IDX>({1, 2, 3}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[1], NDArray::FromVector(std::vector<IDX>({1, 0, 0, 2, 2, 2}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[2], NDArray::FromVector(std::vector<IDX>({8, 6, 9, 5, 7, 4}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[3], NDArray::FromVector(std::vector<IDX>({3, 1, 4, 0, 2, 5}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[4], NDArray::FromVector(std::vector<IDX>({1, 2, 3}))));
+}
+
+template <typename IDX>
+void _TestDegreeBucketingSparseIds() {
+  // the same schedule as above with node ids far apart, which are mapped to
+  // slots instead of indexing them directly
+  const IDX k = 100000;
+  IdArray mids = NDArray::FromVector(std::vector<IDX>({10, 11, 12, 13, 14, 15, 16}));
+  IdArray vids = NDArray::FromVector(std::vector<IDX>({3*k, k, 3*k, 5*k, k, 3*k, 6*k}));
+  IdArray recv = NDArray::FromVector(std::vector<IDX>({0, k, 3*k, 4*k, 5*k, 6*k}));
+  auto ret = sched::DegreeBucketing<IDX>(mids, vids, recv);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[0], NDArray::FromVector(std::vector<IDX>({1, 2, 3, 0}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[1],
+        NDArray::FromVector(std::vector<IDX>({5*k, 6*k, k, 3*k, 0, 4*k}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[2], NDArray::FromVector(std::vector<IDX>({2, 1, 1, 2}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[3],
+        NDArray::FromVector(std::vector<IDX>({13, 16, 11, 14, 10, 12, 15}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[4], NDArray::FromVector(std::vector<IDX>({2, 2, 3}))));
+
+  IdArray uids = NDArray::FromVector(std::vector<IDX>({2*k, 0, 2*k, k, 0, 2*k}));
+  vids = NDArray::FromVector(std::vector<IDX>({5, 6, 7, 8, 9, 4}));
+  IdArray eids = NDArray::FromVector(std::vector<IDX>({0, 1, 2, 3, 4, 5}));
+  ret = sched::GroupEdgeByNodeDegree<IDX>(uids, vids, eids);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[1],
+        NDArray::FromVector(std::vector<IDX>({k, 0, 0, 2*k, 2*k, 2*k}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[3], NDArray::FromVector(std::vector<IDX>({3, 1, 4, 0, 2, 5}))));
+}
+
+TEST(SchedulerTest, TestDegreeBucketing) {
+  _TestDegreeBucketing<int32_t>();
+  _TestDegreeBucketing<int64_t>();
+  _TestDegreeBucketingSparseIds<int32_t>();
+  _TestDegreeBucketingSparseIds<int64_t>();
+}
+
+TEST(SchedulerTest, TestGroupEdgeByNodeDegree) {
+  _TestGroupEdgeByNodeDegree<int32_t>();
+  _TestGroupEdgeByNodeDegree<int64_t>();
+}
+
+template <typename IDX>
+void _TestDegreePaddedBucketing() {
+  // in-degrees: nodes 1 and 5 -> 1, node 3 -> 3, node 2 -> 4, node 4 -> 5;
+  // node 0 receives nothing
+  IdArray vids = NDArray::FromVector(std::vector<IDX>(
+      {4, 3, 2, 4, 1, 3, 4, 2, 4, 3, 4, 2, 2, 5}));
+  IdArray mids = NDArray::FromVector(std::vector<IDX>(
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13}));
+  IdArray recv = NDArray::FromVector(std::vector<IDX>({0, 1, 2, 3, 4, 5}));
+
+  // power-of-two boundaries: {1}, {3, 4}, {5}
+  auto ret = sched::DegreePaddedBucketing<IDX>(mids, vids, recv, 0);
+  ASSERT_EQ(ret.size(), 6);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[0], NDArray::FromVector(std::vector<IDX>({1, 4, 5, 0}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[1], NDArray::FromVector(std::vector<IDX>({1, 5, 3, 2, 4, 0}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[2], NDArray::FromVector(std::vector<IDX>({2, 2, 1, 1}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[3], NDArray::FromVector(std::vector<IDX>(
+      {4, 13, 1, 5, 9, 1, 2, 7, 11, 12, 0, 3, 6, 8, 10}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[4], NDArray::FromVector(std::vector<IDX>({2, 8, 5}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[5], NDArray::FromVector(std::vector<IDX>(
+      {1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1}))));
+
+  // at most two buckets: {1} and {3, 4, 5} pad the fewest messages
+  ret = sched::DegreePaddedBucketing<IDX>(mids, vids, recv, 2);
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[0], NDArray::FromVector(std::vector<IDX>({1, 5, 0}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[2], NDArray::FromVector(std::vector<IDX>({2, 3, 1}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[4], NDArray::FromVector(std::vector<IDX>({2, 15}))));
+  ASSERT_TRUE(ArrayEQ<IDX>(ret[5], NDArray::FromVector(std::vector<IDX>(
+      {1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1}))));
+
+  // enough buckets for every degree: same as the exact schedule, no padding
+  ret = sched::DegreePaddedBucketing<IDX>(mids, vids, recv, 8);
+  const auto exact = sched::DegreeBucketing<IDX>(mids, vids, recv);
+  for (int i = 0; i < 5; ++i)
+    ASSERT_TRUE(ArrayEQ<IDX>(ret[i], exact[i]));
+}
+
+TEST(SchedulerTest, TestDegreePaddedBucketing) {
+  _TestDegreePaddedBucketing<int32_t>();
+  _TestDegreePaddedBucketing<int64_t>();
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/runtime/shared_mem.h>
+#include <string>
+#include <vector>
+#include "../../src/graph/shared_feature_store.h"
+#include "./common.h"
+
+#ifndef _WIN32
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+TEST(SharedFeatureStoreTest, TestAddGet) {
+  const std::string name = "test_shared_feature_store_add_get";
+  auto store = SharedFeatureStore::Create(name);
+  auto feat = aten::Range(0, 12, 32, CTX).CreateView({4, 3}, DLDataType{kDLInt, 32, 1}, 0);
+  auto label = aten::VecToIdArray(std::vector<int64_t>({3, 1, 4, 1}));
+  store->Add("feat", feat);
+  store->Add("label", label);
+
+  auto other = SharedFeatureStore::Open(name);
+  ASSERT_NE(other, nullptr);
+  ASSERT_EQ(other->Keys(), std::vector<std::string>({"feat", "label"}));
+  ASSERT_TRUE(other->Has("feat"));
+  ASSERT_FALSE(other->Has("mask"));
+  auto shared_feat = other->Get("feat");
+  ASSERT_EQ(shared_feat->ndim, 2);
+  ASSERT_EQ(shared_feat->shape[1], 3);
+  ASSERT_TRUE(ArrayEQ<int32_t>(shared_feat, feat));
+  ASSERT_TRUE(ArrayEQ<int64_t>(other->Get("label"), label));
+
+  // the tensors are shared, not copied
+  static_cast<int32_t*>(store->Get("feat")->data)[4] = 100;
+  ASSERT_EQ(static_cast<int32_t*>(shared_feat->data)[4], 100);
+
+  // tensors added later are visible to the other processes
+  other->Add("mask", NDArray::FromVector(std::vector<float>({1., 0., 0., 1.})));
+  ASSERT_TRUE(store->Has("mask"));
+  ASSERT_EQ(store->Get("mask")->dtype.code, kDLFloat);
+  ASSERT_EQ(static_cast<float*>(store->Get("mask")->data)[3], 1.);
+}
+
+TEST(SharedFeatureStoreTest, TestGatherRows) {
+  const std::string name = "test_shared_feature_store_gather";
+  auto store = SharedFeatureStore::Create(name);
+  auto feat = aten::Range(0, 12, 64, CTX).CreateView({6, 2}, DLDataType{kDLInt, 64, 1}, 0);
+  store->Add("feat", feat);
+
+  auto rows = aten::VecToIdArray(std::vector<int32_t>({5, 0, 5, 2}), 32);
+  auto out = aten::NewIdArray(8).CreateView({4, 2}, DLDataType{kDLInt, 64, 1}, 0);
+  store->GatherRows("feat", rows, out);
+  ASSERT_TRUE(ArrayEQ<int64_t>(out.CreateView({8}, out->dtype, 0),
+        aten::VecToIdArray(std::vector<int64_t>({10, 11, 0, 1, 10, 11, 4, 5}))));
+
+  auto empty = aten::NewIdArray(0).CreateView({0, 2}, DLDataType{kDLInt, 64, 1}, 0);
+  GatherRows(feat, aten::NewIdArray(0), empty);
+}
+
+TEST(SharedFeatureStoreTest, TestRefCount) {
+  const std::string name = "test_shared_feature_store_refcount";
+  NDArray shared;
+  {
+    auto store = SharedFeatureStore::Create(name);
+    store->Add("x", aten::Range(0, 5, 64, CTX));
+    {
+      auto other = SharedFeatureStore::Open(name);
+      shared = other->Get("x");
+      store = nullptr;
+      ASSERT_TRUE(SharedMemory::Exist(name));
+    }
+    ASSERT_FALSE(SharedMemory::Exist(name));
+    ASSERT_EQ(SharedFeatureStore::Open(name), nullptr);
+  }
+  // the tensor mapped before the store is removed stays valid
+  ASSERT_TRUE(ArrayEQ<int64_t>(shared, aten::Range(0, 5, 64, CTX)));
+}
+
+#endif  // _WIN32
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/immutable_graph.h>
+#include <dgl/runtime/shared_mem.h>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../../src/graph/heterograph.h"
+#include "../../src/graph/shared_graph_store.h"
+#include "../../src/graph/unit_graph.h"
+#include "./common.h"
+
+#ifndef _WIN32
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+namespace {
+
+HeteroGraphPtr CreateTestGraph() {
+  // two node types and two edge types: 0 -> 0 and 0 -> 1
+  auto meta = ImmutableGraph::CreateFromCOO(
+      2, aten::VecToIdArray(std::vector<int64_t>({0, 0})),
+      aten::VecToIdArray(std::vector<int64_t>({0, 1})));
+  auto follows = UnitGraph::CreateFromCOO(
+      1, 3, 3,
+      aten::VecToIdArray(std::vector<int64_t>({0, 1, 2, 2})),
+      aten::VecToIdArray(std::vector<int64_t>({1, 2, 0, 1})));
+  auto plays = UnitGraph::CreateFromCOO(
+      2, 3, 2,
+      aten::VecToIdArray(std::vector<int64_t>({0, 2, 1})),
+      aten::VecToIdArray(std::vector<int64_t>({1, 0, 0})));
+  return CreateHeteroGraph(meta, {follows, plays}, {3, 2});
+}
+
+HeteroGraphPtr Attach(const std::string& name) {
+  return std::get<0>(HeteroGraph::CreateFromSharedMem(name));
+}
+
+}  // namespace
+
+TEST(SharedGraphStoreTest, TestFormatOnDemand) {
+  const std::string name = "test_shared_graph_store_on_demand";
+  auto g = CreateTestGraph();
+  auto shared = HeteroGraph::CopyToSharedMem(g, name, {"user", "game"}, {"follows", "plays"},
+                                             {"coo"});
+  auto store = SharedGraphStore::Open(name);
+  ASSERT_NE(store, nullptr);
+  ASSERT_EQ(store->NumEdgeTypes(), 2);
+  ASSERT_EQ(store->PublishedFormats(0), coo_code);
+  ASSERT_EQ(store->PublishedFormats(1), coo_code);
+
+  // the first graph asking for CSC builds and publishes it
+  auto g1 = Attach(name);
+  ASSERT_NE(g1, nullptr);
+  const auto csc = g1->GetCSCMatrix(1);
+  ASSERT_EQ(store->PublishedFormats(0), coo_code);
+  ASSERT_EQ(store->PublishedFormats(1), coo_code | csc_code);
+  ASSERT_TRUE(ArrayEQ<int64_t>(csc.indptr, g->GetCSCMatrix(1).indptr));
+  ASSERT_TRUE(ArrayEQ<int64_t>(csc.indices, g->GetCSCMatrix(1).indices));
+
+  // the following ones map it, including the creator
+  auto g2 = Attach(name);
+  aten::CSRMatrix published;
+  ASSERT_TRUE(store->FetchCSR(1, csc_code, &published));
+  ASSERT_TRUE(ArrayEQ<int64_t>(g2->GetCSCMatrix(1).indices, published.indices));
+  ASSERT_TRUE(ArrayEQ<int64_t>(shared->GetCSCMatrix(1).indices, published.indices));
+  ASSERT_FALSE(store->FetchCSR(0, csr_code, &published));
+
+  auto e1 = g->Edges(0, "eid");
+  auto e2 = g2->Edges(0, "eid");
+  ASSERT_TRUE(ArrayEQ<int64_t>(e1.src, e2.src));
+  ASSERT_TRUE(ArrayEQ<int64_t>(e1.dst, e2.dst));
+}
+
+TEST(SharedGraphStoreTest, TestRefCount) {
+  const std::string name = "test_shared_graph_store_refcount";
+  auto g = CreateTestGraph();
+  auto shared = HeteroGraph::CopyToSharedMem(g, name, {}, {}, {"csr"});
+  auto attached = Attach(name);
+  ASSERT_NE(attached, nullptr);
+
+  // the creator leaving does not remove the graph
+  shared = nullptr;
+  ASSERT_TRUE(SharedMemory::Exist(name));
+  auto again = Attach(name);
+  ASSERT_NE(again, nullptr);
+  ASSERT_EQ(again->NumEdges(0), 4);
+
+  // neither does building a format after the creator left
+  ASSERT_EQ(again->GetCOOMatrix(1).row->shape[0], 3);
+  again = nullptr;
+  ASSERT_TRUE(SharedMemory::Exist(name));
+
+  // the last one does
+  attached = nullptr;
+  ASSERT_FALSE(SharedMemory::Exist(name));
+  ASSERT_EQ(Attach(name), nullptr);
+}
+
+TEST(SharedGraphStoreTest, TestReplace) {
+  const std::string name = "test_shared_graph_store_replace";
+  auto g = CreateTestGraph();
+  auto old_graph = HeteroGraph::CopyToSharedMem(g, name, {}, {}, {"coo"});
+  auto new_graph = HeteroGraph::CopyToSharedMem(g, name, {}, {}, {"csc"});
+
+  // graphs attached to the old store keep working and leave the new one alone
+  ASSERT_EQ(old_graph->GetCSRMatrix(0).indices->shape[0], 4);
+  old_graph = nullptr;
+  auto store = SharedGraphStore::Open(name);
+  ASSERT_NE(store, nullptr);
+  ASSERT_EQ(store->PublishedFormats(0), csc_code);
+  store = nullptr;
+  new_graph = nullptr;
+  ASSERT_FALSE(SharedMemory::Exist(name));
+}
+
+#endif  // _WIN32
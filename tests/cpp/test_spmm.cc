@@ -0,0 +1,117 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file test_spmm.cc
+ * \brief Test the backward of SpMM-Min/Max
+ */
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "./common.h"
+#include "../../src/array/cpu/spmm.h"
+#include "../../src/graph/heterograph.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+namespace {
+
+// Edges from 4 source nodes to 3 destination nodes, with parallel edges.
+const std::vector<int64_t> kSrc = {0, 1, 0, 2, 3, 0, 2, 1, 3};
+const std::vector<int64_t> kDst = {0, 0, 0, 1, 1, 2, 1, 2, 0};
+const int64_t kNumSrc = 4, kNumDst = 3, kDim = 3;
+
+// The Csr matrix whose rows are the given nodes of the edges, with the edges of
+// every row rotated so that the columns are unsorted and parallel edges apart.
+template <typename IdType>
+aten::CSRMatrix UnsortedCSR(const std::vector<int64_t>& rows,
+                            const std::vector<int64_t>& cols,
+                            int64_t num_rows, int64_t num_cols) {
+  std::vector<std::vector<IdType>> row_eids(num_rows);
+  for (size_t e = 0; e < rows.size(); ++e)
+    row_eids[rows[e]].push_back(e);
+  std::vector<IdType> indptr = {0}, indices, eids;
+  for (auto& r : row_eids) {
+    if (!r.empty())
+      std::rotate(r.begin(), r.begin() + 1, r.end());
+    for (const IdType e : r) {
+      indices.push_back(cols[e]);
+      eids.push_back(e);
+    }
+    indptr.push_back(indices.size());
+  }
+  return aten::CSRMatrix(num_rows, num_cols, NDArray::FromVector(indptr),
+                         NDArray::FromVector(indices), NDArray::FromVector(eids), false);
+}
+
+template <typename IdType>
+void _TestSpMMCmpBackward(bool use_arge) {
+  const int64_t num_edges = kSrc.size();
+  // Pick one in-edge of every destination node for every feature element, as
+  // the forward pass would.
+  std::vector<std::vector<int64_t>> in_eids(kNumDst);
+  for (int64_t e = 0; e < num_edges; ++e)
+    in_eids[kDst[e]].push_back(e);
+  std::vector<IdType> argu(kNumDst * kDim), arge(kNumDst * kDim);
+  std::vector<float> grad(kNumDst * kDim);
+  for (int64_t v = 0; v < kNumDst; ++v) {
+    for (int64_t k = 0; k < kDim; ++k) {
+      const int64_t e = in_eids[v][(v + k) % in_eids[v].size()];
+      argu[v * kDim + k] = kSrc[e];
+      arge[v * kDim + k] = e;
+      grad[v * kDim + k] = 1 + v * kDim + k;
+    }
+  }
+
+  // The gradient scattered through the Arg-Min/Max, as the backend does.
+  std::vector<float> ref_u(kNumSrc * kDim, 0), ref_e(num_edges * kDim, 0);
+  for (int64_t i = 0; i < kNumDst * kDim; ++i) {
+    ref_u[argu[i] * kDim + i % kDim] += grad[i];
+    ref_e[arge[i] * kDim + i % kDim] += grad[i];
+  }
+
+  NDArray argu_arr = NDArray::FromVector(argu).CreateView(
+      {kNumDst, kDim}, DLDataType{kDLInt, sizeof(IdType) * 8, 1});
+  NDArray arge_arr = use_arge ? NDArray::FromVector(arge).CreateView(
+      {kNumDst, kDim}, DLDataType{kDLInt, sizeof(IdType) * 8, 1}) : aten::NullArray();
+  NDArray grad_arr = NDArray::FromVector(grad).CreateView(
+      {kNumDst, kDim}, DLDataType{kDLFloat, 32, 1});
+
+  NDArray out_u = NDArray::FromVector(std::vector<float>(kNumSrc * kDim, 0));
+  aten::cpu::SpMMCmpBackwardCsr<IdType, float>(
+      UnsortedCSR<IdType>(kSrc, kDst, kNumSrc, kNumDst), argu_arr, arge_arr,
+      grad_arr, out_u);
+  ASSERT_TRUE(ArrayEQ<float>(out_u, NDArray::FromVector(ref_u)));
+
+  if (use_arge) {
+    NDArray out_e = NDArray::FromVector(std::vector<float>(num_edges * kDim, 0));
+    aten::cpu::SpMMCmpBackwardEdgeCsr<IdType, float>(
+        UnsortedCSR<IdType>(kDst, kSrc, kNumDst, kNumSrc), arge_arr, grad_arr, out_e);
+    ASSERT_TRUE(ArrayEQ<float>(out_e, NDArray::FromVector(ref_e)));
+  }
+}
+
+}  // namespace
+
+TEST(SpMMTest, TestSpMMCmpBackward) {
+  _TestSpMMCmpBackward<int32_t>(false);
+  _TestSpMMCmpBackward<int64_t>(false);
+  _TestSpMMCmpBackward<int32_t>(true);
+  _TestSpMMCmpBackward<int64_t>(true);
+}
+
+TEST(SpMMTest, TestReverseCache) {
+  auto g = std::dynamic_pointer_cast<HeteroGraph>(CreateFromCOO(
+      2, kNumSrc, kNumDst, aten::VecToIdArray(kSrc), aten::VecToIdArray(kDst)));
+  ASSERT_TRUE(g != nullptr);
+  const HeteroGraphPtr rg = g->Reverse();
+  // The reversed graph is built once.
+  ASSERT_EQ(rg.get(), g->Reverse().get());
+  const EdgeArray edges = g->Edges(0, "eid");
+  const EdgeArray rev_edges = rg->Edges(0, "eid");
+  ASSERT_TRUE(ArrayEQ<int64_t>(edges.src, rev_edges.dst));
+  ASSERT_TRUE(ArrayEQ<int64_t>(edges.dst, rev_edges.src));
+  // Its Csc is the Csr of the graph, so the backward pass does not rebuild it.
+  ASSERT_EQ(rg->GetCSCMatrix(0).indptr->data, g->GetCSRMatrix(0).indptr->data);
+}
@@ -0,0 +1,59 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file test_to_block.cc
+ * \brief Test ToBlock
+ */
+#include <gtest/gtest.h>
+#include <dgl/array.h>
+#include <dgl/base_heterograph.h>
+#include <dgl/transform.h>
+#include <tuple>
+#include <vector>
+#include "./common.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+
+namespace {
+
+template <typename IdType>
+void _TestToBlock(const std::vector<IdType>& src, const std::vector<IdType>& dst,
+                  const std::vector<IdType>& rhs) {
+  const int nbits = sizeof(IdType) * 8;
+  auto g = CreateFromCOO(1, 6, 6,
+                         aten::VecToIdArray(src, nbits, CTX),
+                         aten::VecToIdArray(dst, nbits, CTX));
+
+  HeteroGraphPtr block;
+  std::vector<IdArray> lhs_nodes, induced_edges;
+  std::tie(block, lhs_nodes, induced_edges) = transform::ToBlock(
+      g, {aten::VecToIdArray(rhs, nbits, CTX)}, true);
+
+  // The block is created in CSC only.
+  ASSERT_EQ(block->GetRelationGraph(0)->GetCreatedFormats(), 4);
+  const aten::CSRMatrix csc = block->GetCSCMatrix(0);
+  ASSERT_EQ(csc.num_rows, static_cast<int64_t>(rhs.size()));
+  ASSERT_EQ(csc.num_cols, lhs_nodes[0]->shape[0]);
+
+  // Every edge of the block maps back to the edge of the graph it was induced from.
+  const EdgeArray edges = block->Edges(0, "eid");
+  ASSERT_EQ(edges.src->shape[0], static_cast<int64_t>(src.size()));
+  const IdType* lhs = lhs_nodes[0].Ptr<IdType>();
+  const IdType* eids = induced_edges[0].Ptr<IdType>();
+  for (int64_t i = 0; i < edges.src->shape[0]; ++i) {
+    ASSERT_EQ(i, edges.id.Ptr<IdType>()[i]);
+    ASSERT_EQ(lhs[edges.src.Ptr<IdType>()[i]], src[eids[i]]);
+    ASSERT_EQ(rhs[edges.dst.Ptr<IdType>()[i]], dst[eids[i]]);
+  }
+}
+
+}  // namespace
+
+TEST(ToBlockTest, TestToBlock) {
+  // Edges grouped by destination in the order of the destination nodes, as sampled.
+  _TestToBlock<int32_t>({1, 2, 0, 5, 3}, {4, 4, 1, 1, 3}, {4, 1, 3});
+  _TestToBlock<int64_t>({1, 2, 0, 5, 3}, {4, 4, 1, 1, 3}, {4, 1, 3});
+  // Edges in arbitrary order.
+  _TestToBlock<int32_t>({1, 0, 2, 3, 5, 4}, {4, 1, 4, 3, 1, 0}, {1, 4, 3, 0});
+  _TestToBlock<int64_t>({1, 0, 2, 3, 5, 4}, {4, 1, 4, 3, 1, 0}, {1, 4, 3, 0});
+}
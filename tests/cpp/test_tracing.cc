@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <dgl/runtime/tracing.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dgl::runtime;
+
+namespace {
+
+int64_t CountOccurrences(const std::string& str, const std::string& sub) {
+  int64_t count = 0;
+  for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + 1))
+    ++count;
+  return count;
+}
+
+tracing::OpStats FindStats(const std::string& name) {
+  for (const auto& kv : tracing::GetStats()) {
+    if (kv.first == name)
+      return kv.second;
+  }
+  return tracing::OpStats();
+}
+
+}  // namespace
+
+TEST(TracingTest, TestDisabled) {
+  tracing::Disable();
+  tracing::Clear();
+  {
+    tracing::ScopedTimer timer("TestDisabled");
+    ASSERT_FALSE(timer.active());
+  }
+  ASSERT_EQ(FindStats("TestDisabled").count, 0);
+}
+
+TEST(TracingTest, TestRecord) {
+  tracing::Enable();
+  for (int i = 0; i < 3; ++i) {
+    tracing::ScopedTimer timer("TestRecord");
+    ASSERT_TRUE(timer.active());
+    timer.AddBytes(100);
+    timer.AddEdges(10);
+  }
+  // records from other threads are merged
+  std::thread t([] {
+    tracing::ScopedTimer timer("TestRecord");
+    timer.AddEdges(1);
+  });
+  t.join();
+  tracing::Disable();
+
+  const tracing::OpStats stats = FindStats("TestRecord");
+  ASSERT_EQ(stats.count, 4);
+  ASSERT_EQ(stats.bytes, 300);
+  ASSERT_EQ(stats.edges, 31);
+  ASSERT_LE(stats.min_ns, stats.max_ns);
+  ASSERT_LE(stats.max_ns, stats.total_ns);
+
+  const std::string trace = tracing::DumpChromeTrace();
+  ASSERT_EQ(CountOccurrences(trace, "\"name\": \"TestRecord\""), 4);
+  ASSERT_EQ(CountOccurrences(trace, "\"ph\": \"X\""), 4);
+  ASSERT_NE(trace.find("\"dropped_events\": 0"), std::string::npos);
+
+  tracing::Clear();
+  ASSERT_EQ(FindStats("TestRecord").count, 0);
+}
+
+TEST(TracingTest, TestRingBuffer) {
+  tracing::Enable(4);
+  for (int i = 0; i < 10; ++i)
+    tracing::Record("TestRingBuffer", i, i + 1);
+  tracing::Disable();
+  // only the last 4 events are kept, but the aggregates count all of them
+  const std::string trace = tracing::DumpChromeTrace();
+  ASSERT_EQ(CountOccurrences(trace, "\"name\": \"TestRingBuffer\""), 4);
+  ASSERT_NE(trace.find("\"dropped_events\": 6"), std::string::npos);
+  const size_t first = trace.find("\"ts\": 0.006");
+  const size_t last = trace.find("\"ts\": 0.009");
+  ASSERT_NE(first, std::string::npos);
+  ASSERT_NE(last, std::string::npos);
+  ASSERT_LT(first, last);
+  ASSERT_EQ(FindStats("TestRingBuffer").count, 10);
+  tracing::Enable();
+  tracing::Disable();
+}
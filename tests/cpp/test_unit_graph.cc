@@ -298,6 +298,64 @@ void _TestUnitGraph_Reserve(DLContext ctx) {
   ASSERT_TRUE(g_out_csr.indices->data == r_g_in_csr.indices->data);
 }
 
+template <typename IdType>
+void _TestUnitGraph_Stats(DLContext ctx) {
+  const aten::CSRMatrix &csr = CSR1<IdType>(ctx);
+  const aten::COOMatrix &coo = aten::CSRToCOO(csr, false);
+  const int nbits = sizeof(IdType) * 8;
+  const IdArray in_degrees = aten::VecToIdArray(std::vector<IdType>({2, 1, 3}), nbits, ctx);
+  const IdArray out_degrees = aten::VecToIdArray(std::vector<IdType>({1, 2, 1, 2}), nbits, ctx);
+
+  // statistics are computed from whatever format exists, without creating others
+  std::vector<HeteroGraphPtr> graphs = {
+    UnitGraph::CreateFromCSR(2, csr, csr_code),
+    UnitGraph::CreateFromCSC(2, aten::CSRTranspose(csr), csc_code),
+    UnitGraph::CreateFromCOO(2, coo, coo_code)};
+  for (const auto& hg : graphs) {
+    auto g = std::dynamic_pointer_cast<UnitGraph>(hg);
+    const dgl_format_code_t created = g->GetCreatedFormats();
+    ASSERT_TRUE(ArrayEQ<IdType>(g->Stats().InDegrees(*g), in_degrees));
+    ASSERT_TRUE(ArrayEQ<IdType>(g->Stats().OutDegrees(*g), out_degrees));
+    ASSERT_EQ(g->Stats().MaxInDegree(*g), 3);
+    ASSERT_EQ(g->Stats().MaxOutDegree(*g), 2);
+    ASSERT_TRUE(ArrayEQ<int64_t>(g->Stats().InDegreeHistogram(*g),
+          aten::VecToIdArray(std::vector<int64_t>({0, 1, 1, 1}))));
+    ASSERT_TRUE(ArrayEQ<int64_t>(g->Stats().OutDegreeHistogram(*g),
+          aten::VecToIdArray(std::vector<int64_t>({0, 2, 2}))));
+    ASSERT_EQ(g->Stats().NumSelfLoops(*g), 0);
+    ASSERT_FALSE(g->IsMultigraph());
+    ASSERT_EQ(g->GetCreatedFormats(), created);
+
+    // degree queries work whatever the format
+    const IdArray vids = aten::VecToIdArray(std::vector<IdType>({2, 0, 2}), nbits, ctx);
+    ASSERT_TRUE(ArrayEQ<IdType>(g->InDegrees(0, vids),
+          aten::VecToIdArray(std::vector<IdType>({3, 2, 3}), nbits, ctx)));
+    ASSERT_EQ(g->InDegree(0, 1), 1);
+    ASSERT_TRUE(ArrayEQ<IdType>(g->OutDegrees(0, vids),
+          aten::VecToIdArray(std::vector<IdType>({1, 1, 1}), nbits, ctx)));
+    ASSERT_EQ(g->OutDegree(0, 3), 2);
+
+    // graphs of the same structure share the statistics
+    auto g2 = std::dynamic_pointer_cast<UnitGraph>(g->GetGraphInFormat(all_code));
+    ASSERT_EQ(&g2->Stats(), &g->Stats());
+  }
+
+  // self loops, parallel edges and sortedness
+  const aten::COOMatrix &coo2 = aten::COOMatrix(
+      3, 3,
+      aten::VecToIdArray(std::vector<IdType>({0, 0, 0, 2, 1}), nbits, ctx),
+      aten::VecToIdArray(std::vector<IdType>({0, 2, 2, 2, 1}), nbits, ctx));
+  auto g = std::dynamic_pointer_cast<UnitGraph>(UnitGraph::CreateFromCOO(1, coo2));
+  ASSERT_EQ(g->Stats().NumSelfLoops(*g), 3);
+  ASSERT_TRUE(g->Stats().HasDuplicate(*g));
+  ASSERT_FALSE(g->Stats().COOSorted(*g).first);
+  const aten::CSRMatrix &csr2 = g->GetCSRMatrix(0);
+  ASSERT_TRUE(ArrayEQ<IdType>(csr2.indptr,
+        aten::VecToIdArray(std::vector<IdType>({0, 3, 4, 5}), nbits, ctx)));
+  auto sorted = std::dynamic_pointer_cast<UnitGraph>(UnitGraph::CreateFromCOO(2, coo));
+  ASSERT_TRUE(sorted->Stats().COOSorted(*sorted).first);
+}
+
 TEST(UniGraphTest, TestUnitGraph_Create) {
   _TestUnitGraph<int32_t>(CPU);
   _TestUnitGraph<int64_t>(CPU);
@@ -342,3 +400,8 @@ TEST(UniGraphTest, TestUnitGraph_Reserve) {
   _TestUnitGraph_Reserve<int64_t>(GPU);
 #endif
 }
+
+TEST(UniGraphTest, TestUnitGraph_Stats) {
+  _TestUnitGraph_Stats<int32_t>(CPU);
+  _TestUnitGraph_Stats<int64_t>(CPU);
+}
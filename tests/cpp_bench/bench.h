@@ -0,0 +1,145 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file bench.h
+ * \brief A minimal harness for C++ micro-benchmarks.
+ *
+ * Every benchmark is a function registered with DGL_BENCHMARK. It builds its
+ * inputs for each combination of the parameters it cares about and hands the
+ * code to time to Runner::Run, which repeats it under every requested number of
+ * threads and writes one record per run, as JSON lines by default so that the
+ * results can be collected and compared over time.
+ */
+#ifndef DGL_BENCH_BENCH_H_
+#define DGL_BENCH_BENCH_H_
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dgl {
+namespace bench {
+
+/*! \brief Command line configuration shared by all the benchmarks. */
+struct Config {
+  /*! \brief Run the benchmarks whose name contains this string. */
+  std::string filter;
+  /*! \brief Output format: "json", "csv" or "text". */
+  std::string format = "json";
+  /*! \brief Number of nodes of the synthetic graphs. */
+  std::vector<int64_t> num_nodes = {100000};
+  /*! \brief Average degree of the synthetic graphs. */
+  std::vector<int64_t> avg_degree = {16};
+  /*! \brief Synthetic graph generators: "uniform" and/or "powerlaw". */
+  std::vector<std::string> graphs = {"uniform", "powerlaw"};
+  /*! \brief Exponent of the degree distribution of the power-law graphs. */
+  double alpha = 2.1;
+  /*! \brief Feature sizes of the kernel benchmarks. */
+  std::vector<int64_t> feat_dims = {16, 128};
+  /*! \brief Fanouts of the sampling benchmarks. */
+  std::vector<int64_t> fanouts = {10, 25};
+  /*! \brief Number of seed nodes of the sampling benchmarks. */
+  int64_t batch_size = 1024;
+  /*! \brief Message sizes in bytes of the network benchmarks. */
+  std::vector<int64_t> msg_sizes = {64, 65536};
+  /*! \brief Number of messages sent per run of the network benchmarks. */
+  int64_t num_msgs = 1000;
+  /*! \brief Port of the network benchmarks. */
+  int port = 50191;
+  /*! \brief Numbers of OpenMP threads to run every benchmark with. 0 means all. */
+  std::vector<int> threads = {0};
+  /*! \brief Number of untimed runs. */
+  int warmup = 1;
+  /*! \brief Number of timed runs. */
+  int repeat = 5;
+  /*! \brief Seed of the graph generators and of the random engine. */
+  uint64_t seed = 42;
+};
+
+/*! \brief Parameters of one run, written as they are in the records. */
+typedef std::vector<std::pair<std::string, std::string>> Params;
+
+/*! \brief Times the benchmarks and writes the records. */
+class Runner {
+ public:
+  Runner(const Config& config, std::ostream* os);
+
+  const Config& config() const { return config_; }
+
+  /*!
+   * \brief Time a function with all the configured thread counts.
+   * \param name The benchmark name.
+   * \param params The parameters of the run.
+   * \param items The number of items, e.g. edges, processed by one call, used to
+   *        report the throughput. 0 to omit it.
+   * \param fn The function to time.
+   */
+  void Run(const std::string& name, const Params& params, int64_t items,
+           const std::function<void()>& fn);
+
+  /*! \brief Time a function with the current thread count only. */
+  void RunOnce(const std::string& name, const Params& params, int64_t items,
+               const std::function<void()>& fn);
+
+ private:
+  void Write(const std::string& name, const Params& params, int threads,
+             int64_t items, std::vector<double> times);
+
+  Config config_;
+  std::ostream* os_;
+  bool header_written_ = false;
+};
+
+/*! \brief A registered benchmark. */
+struct Benchmark {
+  std::string name;
+  std::function<void(Runner*)> body;
+};
+
+/*! \brief All the registered benchmarks, in registration order. */
+std::vector<Benchmark>& Registry();
+
+/*! \brief Helper to register a benchmark from a static initializer. */
+struct BenchmarkRegisterer {
+  BenchmarkRegisterer(const std::string& name, std::function<void(Runner*)> body) {
+    Registry().push_back({name, std::move(body)});
+  }
+};
+
+/*! \brief Convert a value to a record parameter. */
+template <typename T>
+inline std::string ToParam(const T& value) {
+  return std::to_string(value);
+}
+
+inline std::string ToParam(const std::string& value) {
+  return value;
+}
+
+inline std::string ToParam(const char* value) {
+  return value;
+}
+
+}  // namespace bench
+}  // namespace dgl
+
+#define DGL_BENCH_CONCAT_(a, b) a##b
+#define DGL_BENCH_CONCAT(a, b) DGL_BENCH_CONCAT_(a, b)
+
+/*!
+ * \brief Register a benchmark function taking a Runner*.
+ *
+ * DGL_BENCHMARK(SpMM) {
+ *   runner->Run("spmm", {{"n", "10"}}, 0, [&] { ... });
+ * }
+ */
+#define DGL_BENCHMARK(Name)                                                 \
+  static void DGL_BENCH_CONCAT(DGLBench_, Name)(::dgl::bench::Runner* runner); \
+  static ::dgl::bench::BenchmarkRegisterer                                  \
+    DGL_BENCH_CONCAT(__dgl_bench_registerer_, Name)(                        \
+        #Name, DGL_BENCH_CONCAT(DGLBench_, Name));                          \
+  static void DGL_BENCH_CONCAT(DGLBench_, Name)(::dgl::bench::Runner* runner)
+
+#endif  // DGL_BENCH_BENCH_H_
@@ -0,0 +1,204 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file bench_main.cc
+ * \brief Entry point and runner of the C++ micro-benchmarks.
+ *
+ * Usage: runBenchmarks [--filter=spmm] [--threads=1,4,0] [--format=json|csv|text]
+ *                      [--output=FILE] [--num-nodes=N,...] [--avg-degree=D,...]
+ *                      [--graphs=uniform,powerlaw] [--alpha=2.1] [--feat-dims=F,...]
+ *                      [--fanouts=K,...] [--batch-size=B] [--msg-sizes=S,...]
+ *                      [--num-msgs=M] [--port=P] [--warmup=W] [--repeat=R]
+ *                      [--seed=S] [--list]
+ */
+#include <dgl/random.h>
+#include <dmlc/logging.h>
+#include <dmlc/omp.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include "./bench.h"
+
+namespace dgl {
+namespace bench {
+
+std::vector<Benchmark>& Registry() {
+  static std::vector<Benchmark> registry;
+  return registry;
+}
+
+Runner::Runner(const Config& config, std::ostream* os)
+  : config_(config), os_(os) {}
+
+void Runner::Run(const std::string& name, const Params& params, int64_t items,
+                 const std::function<void()>& fn) {
+  const int max_threads = omp_get_max_threads();
+  for (const int threads : config_.threads) {
+    omp_set_num_threads(threads > 0 ? threads : max_threads);
+    RunOnce(name, params, items, fn);
+  }
+  omp_set_num_threads(max_threads);
+}
+
+void Runner::RunOnce(const std::string& name, const Params& params, int64_t items,
+                     const std::function<void()>& fn) {
+  // Reseed every run so that the sampling benchmarks draw the same samples with
+  // the same number of threads.
+  const int threads = omp_get_max_threads();
+#pragma omp parallel for
+  for (int i = 0; i < threads; ++i)
+    RandomEngine::ThreadLocal()->SetSeed(config_.seed);
+
+  for (int i = 0; i < config_.warmup; ++i)
+    fn();
+  std::vector<double> times(config_.repeat);
+  for (int i = 0; i < config_.repeat; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    times[i] = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+  Write(name, params, threads, items, std::move(times));
+}
+
+void Runner::Write(const std::string& name, const Params& params, int threads,
+                   int64_t items, std::vector<double> times) {
+  std::sort(times.begin(), times.end());
+  const double min = times.empty() ? 0 : times.front();
+  const double median = times.empty() ? 0 : times[times.size() / 2];
+  const double mean = times.empty() ? 0 :
+    std::accumulate(times.begin(), times.end(), 0.) / times.size();
+  const double throughput = (items > 0 && median > 0) ? items / (median * 1e-3) : 0;
+
+  std::ostream& os = *os_;
+  if (config_.format == "json") {
+    os << "{\"name\": \"" << name << "\", \"params\": {";
+    for (size_t i = 0; i < params.size(); ++i)
+      os << (i ? ", " : "") << "\"" << params[i].first << "\": \"" << params[i].second << "\"";
+    os << "}, \"threads\": " << threads << ", \"repeat\": " << times.size()
+       << ", \"min_ms\": " << min << ", \"median_ms\": " << median
+       << ", \"mean_ms\": " << mean << ", \"items\": " << items
+       << ", \"items_per_sec\": " << throughput << "}" << std::endl;
+  } else if (config_.format == "csv") {
+    if (!header_written_) {
+      os << "name,params,threads,repeat,min_ms,median_ms,mean_ms,items,items_per_sec"
+         << std::endl;
+      header_written_ = true;
+    }
+    os << name << ",";
+    for (size_t i = 0; i < params.size(); ++i)
+      os << (i ? ";" : "") << params[i].first << "=" << params[i].second;
+    os << "," << threads << "," << times.size() << "," << min << "," << median << ","
+       << mean << "," << items << "," << throughput << std::endl;
+  } else {
+    std::ostringstream desc;
+    desc << name;
+    for (const auto& p : params)
+      desc << " " << p.first << "=" << p.second;
+    desc << " threads=" << threads;
+    os << desc.str() << ": median " << median << " ms, min " << min << " ms";
+    if (throughput > 0)
+      os << ", " << throughput << " items/s";
+    os << std::endl;
+  }
+}
+
+}  // namespace bench
+}  // namespace dgl
+
+namespace {
+
+template <typename T>
+std::vector<T> ParseList(const std::string& value) {
+  std::vector<T> ret;
+  std::istringstream ss(value);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    std::istringstream is(item);
+    T v;
+    is >> v;
+    CHECK(!is.fail()) << "Invalid list item: " << item;
+    ret.push_back(v);
+  }
+  return ret;
+}
+
+template <typename T>
+T ParseValue(const std::string& value) {
+  const auto list = ParseList<T>(value);
+  CHECK_EQ(list.size(), 1) << "Expect a single value: " << value;
+  return list[0];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  using dgl::bench::Config;
+  Config config;
+  std::string output;
+  bool list = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--filter") {
+      config.filter = value;
+    } else if (key == "--format") {
+      CHECK(value == "json" || value == "csv" || value == "text")
+        << "Invalid format: " << value;
+      config.format = value;
+    } else if (key == "--output") {
+      output = value;
+    } else if (key == "--num-nodes") {
+      config.num_nodes = ParseList<int64_t>(value);
+    } else if (key == "--avg-degree") {
+      config.avg_degree = ParseList<int64_t>(value);
+    } else if (key == "--graphs") {
+      config.graphs = ParseList<std::string>(value);
+    } else if (key == "--alpha") {
+      config.alpha = ParseValue<double>(value);
+    } else if (key == "--feat-dims") {
+      config.feat_dims = ParseList<int64_t>(value);
+    } else if (key == "--fanouts") {
+      config.fanouts = ParseList<int64_t>(value);
+    } else if (key == "--batch-size") {
+      config.batch_size = ParseValue<int64_t>(value);
+    } else if (key == "--msg-sizes") {
+      config.msg_sizes = ParseList<int64_t>(value);
+    } else if (key == "--num-msgs") {
+      config.num_msgs = ParseValue<int64_t>(value);
+    } else if (key == "--port") {
+      config.port = ParseValue<int>(value);
+    } else if (key == "--threads") {
+      config.threads = ParseList<int>(value);
+    } else if (key == "--warmup") {
+      config.warmup = ParseValue<int>(value);
+    } else if (key == "--repeat") {
+      config.repeat = ParseValue<int>(value);
+    } else if (key == "--seed") {
+      config.seed = ParseValue<uint64_t>(value);
+    } else if (key == "--list") {
+      list = true;
+    } else {
+      LOG(FATAL) << "Unknown argument: " << arg;
+    }
+  }
+
+  std::ofstream ofs;
+  if (!output.empty()) {
+    ofs.open(output);
+    CHECK(ofs) << "Cannot open " << output;
+  }
+  dgl::bench::Runner runner(config, output.empty() ? &std::cout : &ofs);
+  for (const auto& bench : dgl::bench::Registry()) {
+    if (list) {
+      std::cout << bench.name << std::endl;
+    } else if (bench.name.find(config.filter) != std::string::npos) {
+      LOG(INFO) << "Running " << bench.name;
+      bench.body(&runner);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file bench_network.cc
+ * \brief Benchmarks of the socket communicator over the loopback interface.
+ */
+#include <dmlc/logging.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "../../src/rpc/network/msg_queue.h"
+#include "../../src/rpc/network/socket_communicator.h"
+#include "./bench.h"
+
+using namespace dgl;
+using namespace dgl::bench;
+using dgl::network::DefaultMessageDeleter;
+using dgl::network::Message;
+using dgl::network::SocketReceiver;
+using dgl::network::SocketSender;
+
+#ifndef _WIN32
+
+DGL_BENCHMARK(SocketCommunicator) {
+  const Config& cfg = runner->config();
+  for (size_t i = 0; i < cfg.msg_sizes.size(); ++i) {
+    const int64_t size = cfg.msg_sizes[i];
+    // Leave room for all the messages of a run in the queues, so that the run
+    // measures the throughput of the sockets rather than the back pressure.
+    const int64_t queue_size = (size + 64) * cfg.num_msgs * 2;
+    // The listening sockets do not reuse addresses, so every size gets its own port.
+    const std::string addr = "socket://127.0.0.1:" + std::to_string(cfg.port + i);
+    SocketReceiver receiver(queue_size);
+    std::thread waiter([&] { CHECK(receiver.Wait(addr.c_str(), 1)); });
+    // Give the receiver time to listen, as Connect backs off for seconds.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    SocketSender sender(queue_size);
+    sender.AddReceiver(addr.c_str(), 0);
+    CHECK(sender.Connect()) << "Cannot connect to " << addr;
+    waiter.join();
+
+    const Params params = {
+      {"msg_size", ToParam(size)}, {"num_msgs", ToParam(cfg.num_msgs)}};
+    // The communicator runs its own threads, so the OpenMP thread count is moot.
+    runner->RunOnce("SocketCommunicator", params, size * cfg.num_msgs, [&] {
+      std::thread consumer([&] {
+        for (int64_t i = 0; i < cfg.num_msgs; ++i) {
+          Message msg;
+          CHECK_EQ(receiver.RecvFrom(&msg, 0), REMOVE_SUCCESS);
+          msg.deallocator(&msg);
+        }
+      });
+      for (int64_t i = 0; i < cfg.num_msgs; ++i) {
+        char* data = new char[size];
+        std::memset(data, 0, size);
+        Message msg = {data, size};
+        msg.deallocator = DefaultMessageDeleter;
+        CHECK_EQ(sender.Send(msg, 0), ADD_SUCCESS);
+      }
+      consumer.join();
+    });
+    sender.Finalize();
+    receiver.Finalize();
+  }
+}
+
+#endif  // _WIN32
@@ -0,0 +1,90 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file bench_sampling.cc
+ * \brief Benchmarks of neighbor sampling and of the degree bucketing scheduler.
+ */
+#include <dgl/array.h>
+#include <dgl/scheduler.h>
+#include <string>
+#include <vector>
+#include "./bench.h"
+#include "./graph_gen.h"
+
+using namespace dgl;
+using namespace dgl::bench;
+
+DGL_BENCHMARK(CSRRowWiseSampling) {
+  const Config& cfg = runner->config();
+  for (const auto& kind : cfg.graphs) {
+    for (const int64_t n : cfg.num_nodes) {
+      for (const int64_t d : cfg.avg_degree) {
+        const aten::CSRMatrix csr = aten::COOToCSR(
+            GenerateGraph<int64_t>(kind, n, n * d, cfg.alpha, cfg.seed));
+        const int64_t nnz = csr.indices->shape[0];
+        const IdArray seeds = RandomSeeds<int64_t>(n, cfg.batch_size, cfg.seed);
+        std::vector<float> weights(nnz);
+        for (int64_t i = 0; i < nnz; ++i)
+          weights[i] = 1 + i % 7;
+        const FloatArray prob = NDArray::FromVector(weights);
+        for (const int64_t fanout : cfg.fanouts) {
+          for (const bool weighted : {false, true}) {
+            for (const bool replace : {false, true}) {
+              const Params params = {
+                {"graph", kind}, {"num_nodes", ToParam(n)}, {"num_edges", ToParam(nnz)},
+                {"batch_size", ToParam(seeds->shape[0])}, {"fanout", ToParam(fanout)},
+                {"weighted", ToParam(static_cast<int>(weighted))},
+                {"replace", ToParam(static_cast<int>(replace))}};
+              runner->Run("CSRRowWiseSampling", params, seeds->shape[0], [&] {
+                aten::CSRRowWiseSampling(
+                    csr, seeds, fanout, weighted ? prob : aten::NullArray(), replace);
+              });
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+DGL_BENCHMARK(DegreeBucketing) {
+  const Config& cfg = runner->config();
+  for (const auto& kind : cfg.graphs) {
+    for (const int64_t n : cfg.num_nodes) {
+      for (const int64_t d : cfg.avg_degree) {
+        const aten::COOMatrix coo = GenerateGraph<int64_t>(
+            kind, n, n * d, cfg.alpha, cfg.seed);
+        const int64_t nnz = coo.row->shape[0];
+        const IdArray mids = aten::Range(0, nnz, 64, coo.row->ctx);
+        const IdArray recv = aten::Range(0, n, 64, coo.row->ctx);
+        const Params params = {
+          {"graph", kind}, {"num_nodes", ToParam(n)}, {"num_edges", ToParam(nnz)}};
+        runner->Run("DegreeBucketing", params, nnz, [&] {
+          sched::DegreeBucketing<int64_t>(mids, coo.col, recv);
+        });
+        for (const int64_t max_buckets : {0, 8}) {
+          Params padded = params;
+          padded.emplace_back("max_buckets", ToParam(max_buckets));
+          runner->Run("DegreePaddedBucketing", padded, nnz, [&] {
+            sched::DegreePaddedBucketing<int64_t>(mids, coo.col, recv, max_buckets);
+          });
+        }
+        runner->Run("GroupEdgeByNodeDegree", params, nnz, [&] {
+          sched::GroupEdgeByNodeDegree<int64_t>(coo.row, coo.col, mids);
+        });
+
+        // Messages to a mini-batch of the graph, whose node ids are sparse.
+        const IdArray seeds = RandomSeeds<int64_t>(n, cfg.batch_size, cfg.seed);
+        const aten::COOMatrix batch = aten::CSRRowWiseSampling(
+            aten::COOToCSR(aten::COOMatrix(n, n, coo.col, coo.row)), seeds,
+            cfg.fanouts.front(), aten::NullArray());
+        const int64_t num_msgs = batch.row->shape[0];
+        const Params batch_params = {
+          {"graph", kind}, {"num_nodes", ToParam(n)}, {"num_edges", ToParam(num_msgs)},
+          {"batch_size", ToParam(seeds->shape[0])}};
+        runner->Run("DegreeBucketing", batch_params, num_msgs, [&] {
+          sched::DegreeBucketing<int64_t>(batch.data, batch.row, seeds);
+        });
+      }
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file bench_spmm.cc
+ * \brief Benchmarks of the CPU SpMM kernels.
+ */
+#include <dgl/array.h>
+#include <dgl/bcast.h>
+#include <string>
+#include <vector>
+#include "../../src/array/kernel_decl.h"
+#include "./bench.h"
+#include "./graph_gen.h"
+
+using namespace dgl;
+using namespace dgl::bench;
+
+namespace {
+
+NDArray RandomFeature(int64_t num_rows, int64_t dim, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<float> data(num_rows * dim);
+  for (float& x : data)
+    x = dist(rng);
+  return NDArray::FromVector(data).CreateView({num_rows, dim}, DLDataType{kDLFloat, 32, 1});
+}
+
+}  // namespace
+
+DGL_BENCHMARK(SpMMCsr) {
+  const Config& cfg = runner->config();
+  const std::vector<std::pair<std::string, std::string>> kernels = {
+    {"copy_lhs", "sum"}, {"mul", "sum"}, {"copy_lhs", "max"}};
+  for (const auto& kind : cfg.graphs) {
+    for (const int64_t n : cfg.num_nodes) {
+      for (const int64_t d : cfg.avg_degree) {
+        // The rows of the CSR are the destination nodes, as in message passing.
+        const aten::CSRMatrix csr = aten::COOToCSR(
+            GenerateGraph<int64_t>(kind, n, n * d, cfg.alpha, cfg.seed));
+        const int64_t nnz = csr.indices->shape[0];
+        for (const int64_t dim : cfg.feat_dims) {
+          NDArray ufeat = RandomFeature(n, dim, cfg.seed);
+          NDArray efeat = RandomFeature(nnz, 1, cfg.seed + 1);
+          NDArray out = NDArray::Empty({n, dim}, DLDataType{kDLFloat, 32, 1}, ufeat->ctx);
+          NDArray argu = aten::Full(-1, n * dim, 64, ufeat->ctx).CreateView(
+              {n, dim}, DLDataType{kDLInt, 64, 1});
+          NDArray arge = aten::Full(-1, n * dim, 64, ufeat->ctx).CreateView(
+              {n, dim}, DLDataType{kDLInt, 64, 1});
+          for (const auto& kernel : kernels) {
+            const std::string& op = kernel.first;
+            const std::string& reduce = kernel.second;
+            NDArray lhs = (op == "copy_rhs") ? aten::NullArray() : ufeat;
+            NDArray rhs = (op == "copy_lhs") ? aten::NullArray() : efeat;
+            const BcastOff bcast = CalcBcastOff(op, lhs, rhs);
+            const Params params = {
+              {"op", op}, {"reduce", reduce}, {"graph", kind}, {"num_nodes", ToParam(n)},
+              {"num_edges", ToParam(nnz)}, {"feat_dim", ToParam(dim)}};
+            runner->Run("SpMMCsr", params, nnz, [&] {
+              aten::SpMMCsr<kDLCPU, int64_t, float>(
+                  op, reduce, bcast, csr, lhs, rhs, out, {argu, arge});
+            });
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,85 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file bench_transform.cc
+ * \brief Benchmarks of sparse format conversions and graph transforms.
+ */
+#include <dgl/array.h>
+#include <dgl/immutable_graph.h>
+#include <dgl/transform.h>
+#include <string>
+#include <vector>
+#include "../../src/graph/unit_graph.h"
+#include "./bench.h"
+#include "./graph_gen.h"
+
+using namespace dgl;
+using namespace dgl::bench;
+
+namespace {
+
+/*!
+ * \brief Sample the in-edges of the seeds from a graph whose CSR rows are the
+ * destination nodes, and return them as a homogeneous frontier graph.
+ */
+HeteroGraphPtr SampleFrontier(const aten::CSRMatrix& in_csr, IdArray seeds,
+                              int64_t fanout) {
+  const aten::COOMatrix sampled = aten::CSRRowWiseSampling(
+      in_csr, seeds, fanout, aten::NullArray());
+  const HeteroGraphPtr rel = UnitGraph::CreateFromCOO(
+      1, in_csr.num_cols, in_csr.num_rows, sampled.col, sampled.row);
+  const GraphPtr meta = ImmutableGraph::CreateFromCOO(
+      1, aten::VecToIdArray(std::vector<int64_t>({0})),
+      aten::VecToIdArray(std::vector<int64_t>({0})));
+  return CreateHeteroGraph(meta, {rel}, {in_csr.num_rows});
+}
+
+}  // namespace
+
+DGL_BENCHMARK(COOToCSR) {
+  const Config& cfg = runner->config();
+  for (const auto& kind : cfg.graphs) {
+    for (const int64_t n : cfg.num_nodes) {
+      for (const int64_t d : cfg.avg_degree) {
+        const aten::COOMatrix coo = GenerateGraph<int64_t>(
+            kind, n, n * d, cfg.alpha, cfg.seed);
+        const aten::COOMatrix sorted = aten::COOSort(coo, true);
+        const int64_t nnz = coo.row->shape[0];
+        for (const bool row_sorted : {false, true}) {
+          const Params params = {
+            {"graph", kind}, {"num_nodes", ToParam(n)}, {"num_edges", ToParam(nnz)},
+            {"row_sorted", ToParam(static_cast<int>(row_sorted))}};
+          runner->Run("COOToCSR", params, nnz, [&] {
+            aten::COOToCSR(row_sorted ? sorted : coo);
+          });
+        }
+      }
+    }
+  }
+}
+
+DGL_BENCHMARK(CompactGraphs) {
+  const Config& cfg = runner->config();
+  for (const auto& kind : cfg.graphs) {
+    for (const int64_t n : cfg.num_nodes) {
+      for (const int64_t d : cfg.avg_degree) {
+        const aten::CSRMatrix in_csr = aten::COOToCSR(
+            GenerateGraph<int64_t>(kind, n, n * d, cfg.alpha, cfg.seed));
+        const IdArray seeds = RandomSeeds<int64_t>(n, cfg.batch_size, cfg.seed);
+        for (const int64_t fanout : cfg.fanouts) {
+          const HeteroGraphPtr frontier = SampleFrontier(in_csr, seeds, fanout);
+          const int64_t num_edges = frontier->NumEdges(0);
+          const Params params = {
+            {"graph", kind}, {"num_nodes", ToParam(n)},
+            {"batch_size", ToParam(seeds->shape[0])}, {"fanout", ToParam(fanout)},
+            {"frontier_edges", ToParam(num_edges)}};
+          runner->Run("CompactGraphs", params, num_edges, [&] {
+            transform::CompactGraphs({frontier}, {seeds});
+          });
+          runner->Run("ToBlock", params, num_edges, [&] {
+            transform::ToBlock(frontier, {seeds}, true);
+          });
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,104 @@
+/*!
+ *  Copyright (c) 2020 by Contributors
+ * \file graph_gen.h
+ * \brief Synthetic graph generators of the C++ micro-benchmarks.
+ */
+#ifndef DGL_BENCH_GRAPH_GEN_H_
+#define DGL_BENCH_GRAPH_GEN_H_
+
+#include <dgl/array.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace dgl {
+namespace bench {
+
+/*!
+ * \brief Generate a graph whose endpoints are drawn uniformly, i.e. an
+ * Erdos-Renyi-like graph with a narrow degree distribution.
+ *
+ * The generators use their own engine rather than dgl::RandomEngine, so that the
+ * graphs only depend on the seed and not on the number of threads.
+ */
+template <typename IdType>
+aten::COOMatrix UniformGraph(int64_t num_nodes, int64_t num_edges, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<IdType> dist(0, num_nodes - 1);
+  std::vector<IdType> row(num_edges), col(num_edges);
+  for (int64_t i = 0; i < num_edges; ++i) {
+    row[i] = dist(rng);
+    col[i] = dist(rng);
+  }
+  return aten::COOMatrix(num_nodes, num_nodes,
+                         NDArray::FromVector(row), NDArray::FromVector(col));
+}
+
+/*!
+ * \brief Generate a graph with a power-law degree distribution.
+ *
+ * Follows the Chung-Lu model: the endpoints of every edge are drawn independently
+ * with probability proportional to the expected degree of the nodes, which is
+ * (i + 1)^(-1 / (alpha - 1)) for node i, so that the degrees follow a power law of
+ * exponent alpha. Node 0 is the hub, and the node IDs are not shuffled, which
+ * matches graphs reordered by degree.
+ */
+template <typename IdType>
+aten::COOMatrix PowerLawGraph(int64_t num_nodes, int64_t num_edges, double alpha,
+                              uint64_t seed) {
+  CHECK_GT(alpha, 1.) << "The exponent of the power law must be greater than 1.";
+  std::vector<double> cdf(num_nodes);
+  double total = 0;
+  for (int64_t i = 0; i < num_nodes; ++i) {
+    total += std::pow(static_cast<double>(i + 1), -1. / (alpha - 1.));
+    cdf[i] = total;
+  }
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> dist(0, total);
+  auto draw = [&] () {
+    const int64_t pos = std::upper_bound(cdf.begin(), cdf.end(), dist(rng)) - cdf.begin();
+    return static_cast<IdType>(std::min(pos, num_nodes - 1));
+  };
+  std::vector<IdType> row(num_edges), col(num_edges);
+  for (int64_t i = 0; i < num_edges; ++i) {
+    row[i] = draw();
+    col[i] = draw();
+  }
+  return aten::COOMatrix(num_nodes, num_nodes,
+                         NDArray::FromVector(row), NDArray::FromVector(col));
+}
+
+/*! \brief Generate a graph by the name of its generator, "uniform" or "powerlaw". */
+template <typename IdType>
+aten::COOMatrix GenerateGraph(const std::string& kind, int64_t num_nodes,
+                              int64_t num_edges, double alpha, uint64_t seed) {
+  if (kind == "uniform")
+    return UniformGraph<IdType>(num_nodes, num_edges, seed);
+  else if (kind == "powerlaw")
+    return PowerLawGraph<IdType>(num_nodes, num_edges, alpha, seed);
+  LOG(FATAL) << "Unknown graph generator: " << kind;
+  return {};
+}
+
+/*! \brief Draw distinct seed nodes uniformly. */
+template <typename IdType>
+IdArray RandomSeeds(int64_t num_nodes, int64_t num_seeds, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<IdType> perm(num_nodes);
+  for (int64_t i = 0; i < num_nodes; ++i)
+    perm[i] = i;
+  num_seeds = std::min(num_seeds, num_nodes);
+  for (int64_t i = 0; i < num_seeds; ++i) {
+    std::uniform_int_distribution<int64_t> dist(i, num_nodes - 1);
+    std::swap(perm[i], perm[dist(rng)]);
+  }
+  perm.resize(num_seeds);
+  return NDArray::FromVector(perm);
+}
+
+}  // namespace bench
+}  // namespace dgl
+
+#endif  // DGL_BENCH_GRAPH_GEN_H_
@@ -168,5 +168,30 @@ def test_neighbor_sampler_dataloader():
         _check_neighbor_sampling_dataloader(_g, nid, dl, mode)
 
 
+@unittest.skipIf(F._default_context_str == 'gpu', reason="GPU sample neighbors not implemented")
+def test_neighbor_sampler_subclass_exclude():
+    # A subclass overriding sample_frontier still gets called with excluded edges.
+    class CountingSampler(dgl.dataloading.MultiLayerNeighborSampler):
+        def __init__(self, fanouts):
+            super().__init__(fanouts, return_eids=True)
+            self.calls = 0
+
+        def sample_frontier(self, block_id, g, seed_nodes):
+            self.calls += 1
+            return super().sample_frontier(block_id, g, seed_nodes)
+
+    g = dgl.to_bidirected(dgl.graph([(0,1),(0,2),(0,3),(1,3),(1,4)], num_nodes=6)).long()
+    reverse_eids = F.tensor([5, 6, 7, 8, 9, 0, 1, 2, 3, 4], dtype=F.int64)
+    sampler = CountingSampler([2, 2])
+    collator = dgl.dataloading.EdgeCollator(
+        g, F.arange(0, 10), sampler, exclude='reverse_id', reverse_eids=reverse_eids)
+    for _, pair_graph, blocks in map(collator.collate, [[0, 1], [5, 6]]):
+        seed_eids = F.asnumpy(pair_graph.edata[dgl.EID])
+        excluded = set(seed_eids) | set(F.asnumpy(reverse_eids)[seed_eids])
+        for block in blocks:
+            assert not excluded & set(F.asnumpy(block.edata[dgl.EID]))
+    assert sampler.calls == 4
+
+
 if __name__ == '__main__':
     test_neighbor_sampler_dataloader()
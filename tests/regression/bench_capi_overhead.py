@@ -0,0 +1,49 @@
+# Write the benchmarking functions here.
+# See "Writing benchmarks" in the asv docs for more information.
+
+import subprocess
+import os
+from pathlib import Path
+import numpy as np
+import tempfile
+
+base_path = Path("~/regression/dgl/")
+
+class CAPIOverheadBenchmark:
+
+    params = [['pytorch'], [1, 8]]
+    param_names = ['backend', 'num_etypes']
+    timeout = 600
+
+    def __init__(self):
+        self.std_log = {}
+
+    def setup(self, backend, num_etypes):
+        key_name = "{}_{}".format(backend, num_etypes)
+        if key_name in self.std_log:
+            return
+        bench_path = base_path / "tests/regression/benchmarks/capi_overhead.py"
+        bashCommand = "/opt/conda/envs/{}-ci/bin/python {} --num_etypes {}".format(
+            backend, bench_path.expanduser(), num_etypes)
+        process = subprocess.Popen(bashCommand.split(), stdout=subprocess.PIPE,env=dict(os.environ, DGLBACKEND=backend))
+        output, error = process.communicate()
+        print(str(error))
+        self.std_log[key_name] = str(output)
+
+
+    def track_capi_overhead_time(self, backend, num_etypes):
+        key_name = "{}_{}".format(backend, num_etypes)
+        lines = self.std_log[key_name].split("\\n")
+
+        time_list = []
+        for line in lines:
+            # print(line)
+            if 'Time:' in line:
+                time_str = line.strip().split(' ')[1]
+                time = float(time_str)
+                time_list.append(time)
+        return np.array(time_list).mean()
+
+
+CAPIOverheadBenchmark.track_capi_overhead_time.unit = 's'
+
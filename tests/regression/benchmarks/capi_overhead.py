@@ -0,0 +1,45 @@
+import dgl
+from dgl import ndarray as nd
+from dgl.subgraph import _CAPI_DGLInSubgraph
+import dgl.backend as F
+import argparse, timeit
+import numpy as np
+
+parser = argparse.ArgumentParser(description='per-call overhead of C APIs')
+parser.add_argument("--num_etypes", type=int, default=8,
+                    help="the number of relations of the graph")
+parser.add_argument("--num_calls", type=int, default=10000,
+                    help="the number of calls to time for each API")
+args = parser.parse_args()
+
+def build_graph(num_etypes, num_nodes=100, num_edges=500):
+    data_dict = {}
+    for i in range(num_etypes):
+        src = np.random.randint(0, num_nodes, num_edges)
+        dst = np.random.randint(0, num_nodes, num_edges)
+        data_dict[('user', 'r{}'.format(i), 'user')] = (F.tensor(src), F.tensor(dst))
+    return dgl.heterograph(data_dict, {'user': num_nodes})
+
+def per_call(fn):
+    fn()    # warm up, e.g. materialize the sparse formats
+    return timeit.timeit(fn, number=args.num_calls) / args.num_calls
+
+if __name__ == '__main__':
+    g = build_graph(args.num_etypes)
+    seeds = F.tensor([0, 1, 2, 3])
+    seeds_nd = [F.to_dgl_nd(seeds)]
+    gidx = g._graph
+
+    benchmarks = {
+        'NumEdges': lambda: gidx.number_of_edges(0),
+        'InDegrees': lambda: g.in_degrees(seeds, etype='r0'),
+        'InSubgraph (list)': lambda: _CAPI_DGLInSubgraph(gidx, seeds_nd),
+        'InSubgraph (packed)': lambda: _CAPI_DGLInSubgraph(gidx, nd.pack_ndarrays(seeds_nd)),
+        'SampleNeighbors': lambda: dgl.sampling.sample_neighbors(g, {'user': seeds}, 2),
+    }
+    times = []
+    for name, fn in benchmarks.items():
+        t = per_call(fn)
+        times.append(t)
+        print('{}: {:.2f} us per call'.format(name, t * 1e6))
+    print('Time: {} seconds'.format(np.mean(times)))
@@ -0,0 +1,47 @@
+import dgl
+from dgl.heterograph import DGLHeteroGraph
+from dgl.heterograph_index import create_heterograph_from_shared_memory
+import argparse, time
+import multiprocessing as mp
+import numpy as np
+from utils import get_graph
+
+parser = argparse.ArgumentParser(description='shared memory graph')
+parser.add_argument("--dataset", type=str, default='livejournal',
+                    help="specify the graph to share")
+parser.add_argument("--num_workers", type=int, default=8,
+                    help="the number of worker processes")
+args = parser.parse_args()
+
+SHM_NAME = 'bench_shared_mem'
+
+def worker(barrier, queue):
+    gidx, ntypes, etypes = create_heterograph_from_shared_memory(SHM_NAME)
+    g = DGLHeteroGraph(gidx, ntypes, etypes)
+    barrier.wait()
+    start = time.time()
+    # none of the workers has CSC yet: one builds it, the others map it
+    g.in_degrees()
+    # every worker has its own view of the published format
+    g.out_degrees()
+    queue.put(time.time() - start)
+    barrier.wait()
+
+if __name__ == '__main__':
+    g = get_graph(args.dataset)
+    print('{}: |V|={}, |E|={}'.format(args.dataset, g.number_of_nodes(), g.number_of_edges()))
+    g = dgl.graph(g.edges())
+    shared_g = g.shared_memory(SHM_NAME, formats='coo')
+
+    ctx = mp.get_context('spawn')
+    barrier = ctx.Barrier(args.num_workers)
+    queue = ctx.Queue()
+    procs = [ctx.Process(target=worker, args=(barrier, queue)) for _ in range(args.num_workers)]
+    for p in procs:
+        p.start()
+    times = [queue.get() for _ in procs]
+    for p in procs:
+        p.join()
+    print('slowest worker: {:.3f} seconds, fastest worker: {:.3f} seconds'.format(
+        np.max(times), np.min(times)))
+    print('Time: {} seconds'.format(np.max(times)))